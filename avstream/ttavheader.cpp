@@ -51,12 +51,9 @@
 // -----------------------------------------------------------------------------
 TTAVHeader::TTAVHeader()
 {
-  str_description   = "unknown";
-  str_mode          = "unknown";
-  str_bit_rate      = "unknown";
-  str_sample_rate   = "unknown";
   header_start_code = 0xFF;
   header_offset     = 0;
+  arena_owned       = false;
 }
 
 // destructor
@@ -66,32 +63,40 @@ TTAVHeader::~TTAVHeader()
   //qDebug("TTAVHeader destructor...");
 }
 
+// description strings: only the audio headers have them
+// -----------------------------------------------------------------------------
+static const QString& unknownString()
+{
+  static const QString unknown("unknown");
+  return unknown;
+}
+
 // return header description string
 // -----------------------------------------------------------------------------
 const QString& TTAVHeader::descString()
 {
-  return str_description;
+  return unknownString();
 }
 
 // return header mode string
 // -----------------------------------------------------------------------------
 const QString& TTAVHeader::modeString()
 {
-  return str_mode;
+  return unknownString();
 }
 
 // return bit rate string
 // -----------------------------------------------------------------------------
 const QString& TTAVHeader::bitRateString()
 {
-  return str_bit_rate;
+  return unknownString();
 }
 
 // return sample rate string
 // -----------------------------------------------------------------------------
 const QString& TTAVHeader::sampleRateString()
 {
-  return str_sample_rate;
+  return unknownString();
 }
 
 // return header type (start code)
@@ -128,6 +133,11 @@ TTAudioHeader::TTAudioHeader()
   frame_time     = 0.0;
   abs_frame_time = 0.0;
   frame_length   = 0;
+
+  str_description = "unknown";
+  str_mode        = "unknown";
+  str_bit_rate    = "unknown";
+  str_sample_rate = "unknown";
 }
 
 // -----------------------------------------------------------------------------
@@ -165,6 +175,7 @@ int TTAudioHeader::frameLength()
 // -----------------------------------------------------------------------------
 TTVideoHeader::TTVideoHeader()
 {
+  list_index = -1;
 }
 
 // /////////////////////////////////////////////////////////////////////////////
@@ -177,7 +188,7 @@ void TTVideoIndex::setDisplayOrder(int value)
   display_order = value;
 }
 
-int TTVideoIndex::getDisplayOrder()
+int TTVideoIndex::getDisplayOrder() const
 {
   return display_order;
 }
@@ -187,7 +198,7 @@ void TTVideoIndex::setHeaderListIndex(int value)
   header_list_index = value;
 }
 
-int TTVideoIndex::getHeaderListIndex()
+int TTVideoIndex::getHeaderListIndex() const
 {
   return header_list_index;
 }
@@ -197,7 +208,7 @@ void TTVideoIndex::setPictureCodingType(int value)
   picture_coding_type = value;
 }
 
-int TTVideoIndex::getPictureCodingType()
+int TTVideoIndex::getPictureCodingType() const
 {
   return picture_coding_type;
 }
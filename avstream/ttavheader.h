@@ -72,14 +72,18 @@ public:
 
   virtual bool operator==(const TTAVHeader& test) const;
 
+  // Placed in a TTVideoHeaderList arena by create<T>(): the list destroys
+  // it in place, it must never be deleted
+  bool arenaOwned() const          { return arena_owned; }
+  void setArenaOwned(bool owned)   { arena_owned = owned; }
+
+// A long MPEG-2 recording holds hundreds of thousands of headers: no
+// per-header strings or logger pointer here. The audio headers, which
+// describe themselves, keep their strings in TTAudioHeader.
 protected:
   quint64          header_offset;
   quint8           header_start_code;
-  QString          str_description;
-  QString          str_mode;
-  QString          str_bit_rate;
-  QString          str_sample_rate;
-  TTMessageLogger* log;
+  bool             arena_owned;
 };
 
 
@@ -102,6 +106,12 @@ public:
   int    frame_length;
   int    bit_rate;
   int    sample_rate;
+
+protected:
+  QString str_description;
+  QString str_mode;
+  QString str_bit_rate;
+  QString str_sample_rate;
 };
 
 // -----------------------------------------------------------------------------
@@ -116,8 +126,13 @@ public:
   virtual bool readHeader(TTFileBuffer* mpeg2_stream, quint64 offset) = 0;
   virtual void parseBasicData(quint8* data, int offset=0) = 0;
 
+  // Position in the owning TTVideoHeaderList (set by add(), -1 if none)
+  int  listIndex() const         { return list_index; }
+  void setListIndex(int index)   { list_index = index; }
 
  protected:
+  int list_index;
+
   typedef struct
   {
     bool    drop_frame_flag;
@@ -136,13 +151,17 @@ class TTVideoIndex
 {
  public:
    TTVideoIndex(){};
+   TTVideoIndex(int displayOrder, int headerListIndex, int pictureCodingType)
+     : display_order(displayOrder),
+       header_list_index(headerListIndex),
+       picture_coding_type(pictureCodingType) {};
 
    void setDisplayOrder(int value);
-   int  getDisplayOrder();
+   int  getDisplayOrder() const;
    void setHeaderListIndex(int value);
-   int  getHeaderListIndex();
+   int  getHeaderListIndex() const;
    void setPictureCodingType(int value);
-   int  getPictureCodingType();
+   int  getPictureCodingType() const;
 
  protected:
    int display_order;
@@ -27,7 +27,6 @@
 //
 // -----------------------------------------------------------------------------
 
-#include <memory>
 #include "ttavstream.h"
 
 #include "../common/ttexception.h"
@@ -146,43 +145,36 @@ quint64 TTAVStream::streamLengthByte()
 // -----------------------------------------------------------------------------
 void TTAVStream::copySegment(TTFileBuffer* cut_stream, quint64 start_adr, quint64 end_adr)
 {
-  quint64 progress    = 0;
-  quint64 buffer_size = 65536;
-  // unique_ptr, not a raw new: two exits throw out of the loop below (the
-  // abort check, and TTFileBuffer::directWrite when the target cannot be
-  // written) and both used to leak this buffer.
-  std::unique_ptr<quint8[]> bufferOwner(new quint8[buffer_size]);
-  quint8* buffer      = bufferOwner.get();
-  quint64 count       = end_adr-start_adr+1;
-
-  stream_buffer->seekAbsolute( start_adr );
+  quint64 count = end_adr-start_adr+1;
 
   emit statusReport(StatusReportArgs::Start, tr("Cutting audio"), count);
   qApp->processEvents();
 
-  while( count > buffer_size )
-  {
-    if (mAbort) {
-      mAbort = false;
-      throw TTAbortException("User abort request in TTAVStream::copySegment!");
-    }
+  // The bytes stay in the kernel (copy_file_range/sendfile) where it can;
+  // the callback runs per chunk and stops the copy on an abort request.
+  const quint64 copied = cut_stream->directCopy(stream_buffer, start_adr, count,
+                                                 [this](qint64 done) {
+    emit statusReport(StatusReportArgs::Step, tr("Cutting audio"), done);
+    qApp->processEvents();
+    return !mAbort;
+  });
 
-    stream_buffer->readByte(buffer, buffer_size );
-    cut_stream->directWrite(buffer, (quint64)buffer_size );
+  if (mAbort) {
+    mAbort = false;
+    throw TTAbortException("User abort request in TTAVStream::copySegment!");
+  }
 
-    count   -= buffer_size;
-    progress = end_adr-start_adr+1-count;
-    emit statusReport(StatusReportArgs::Step, tr("Cutting audio"), progress);
-    qApp->processEvents();
+  // The source ended before end_adr: a truncated cut is an error, not a
+  // shorter result
+  if (copied < count) {
+    throw TTIOException(__FILE__, __LINE__,
+        QString("Source ended after %1 of %2 bytes (segment %3 - %4)")
+            .arg(copied).arg(count).arg(start_adr).arg(end_adr));
   }
 
-  stream_buffer->readByte(buffer, count);
-  cut_stream->directWrite(buffer, count);
-  emit statusReport(StatusReportArgs::Step, tr("Cutting audio"), end_adr-start_adr+1);
-  emit statusReport(StatusReportArgs::Finished, tr("Audio cut finished"), end_adr-start_adr+1);
+  emit statusReport(StatusReportArgs::Step, tr("Cutting audio"), count);
+  emit statusReport(StatusReportArgs::Finished, tr("Audio cut finished"), count);
   qApp->processEvents();
-
-  // buffer is owned by bufferOwner
 }
 
 
@@ -341,13 +333,11 @@ TTSequenceHeader* TTVideoStream::getSequenceHeader(int pos)
   //int head_index = index_list->headerListIndex(pic_index);
   int head_index = index_list->headerListIndex(pos);
 
-  while ((head_index >= 0) &&
-         (header_list->headerTypeAt(head_index) != TTMpeg2VideoHeader::sequence_start_code)) {
-      head_index--;
-  }
+  // The sequence header at or before head_index
+  TTVideoHeader* seq_head = header_list->getPrevHeader(head_index+1, TTMpeg2VideoHeader::sequence_start_code);
 
-  return (head_index > 0)
-      ? header_list->sequenceHeaderAt(head_index)
+  return (seq_head != NULL)
+      ? (TTSequenceHeader*)seq_head
       : header_list->firstSequenceHeader();
 }
 
@@ -40,6 +40,8 @@
 #include <QString>
 #include <QFileInfo>
 
+#include <atomic>
+
 class TTMessageLogger;
 class TTSequenceHeader;
 class TTVideoHeaderList;
@@ -84,7 +86,8 @@ protected:
 	TTAVTypes::AVStreamType stream_type;
   QFileInfo*              stream_info;
   TTFileBuffer*           stream_buffer;
-  bool                    mAbort;
+  // Set from the GUI thread, polled by the scan workers of the pool
+  std::atomic<bool>       mAbort;
   TTMessageLogger*        log;
 
 signals:
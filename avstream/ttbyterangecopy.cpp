@@ -0,0 +1,206 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttbyterangecopy.h"
+
+#include <QByteArray>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <sys/sendfile.h>
+#include <unistd.h>
+#define TT_COPY_SENDFILE 1
+// copy_file_range() has a glibc wrapper since 2.27 (kernel 4.5)
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define TT_COPY_FILE_RANGE 1
+#endif
+#endif
+
+static std::atomic<int>  firstMethod { TTByteRangeCopy::MethodCopyFileRange };
+// Set once the kernel says it has no copy_file_range(), so later copies
+// do not ask again
+static std::atomic<bool> copyFileRangeMissing { false };
+
+static thread_local TTByteRangeCopy::Method lastCopyMethod = TTByteRangeCopy::MethodBuffered;
+static thread_local QString                 lastCopyError;
+
+TTByteRangeCopy::Method TTByteRangeCopy::lastMethod()
+{
+    return lastCopyMethod;
+}
+
+QString TTByteRangeCopy::lastError()
+{
+    return lastCopyError;
+}
+
+void TTByteRangeCopy::setFirstMethod(Method method)
+{
+    firstMethod.store(method, std::memory_order_relaxed);
+}
+
+const char* TTByteRangeCopy::methodName(Method method)
+{
+    switch (method) {
+        case MethodCopyFileRange: return "copy_file_range";
+        case MethodSendFile:      return "sendfile";
+        case MethodBuffered:      return "buffered";
+    }
+    return "?";
+}
+
+// ----------------------------------------------------------------------------
+// Copy a byte range
+// The kernel paths work on the descriptors with explicit offsets; Qt's
+// buffers are emptied first (out) or bypassed (in), and out.seek() afterwards
+// re-syncs QFileDevice::pos() with what the kernel wrote - same contract as
+// TTH264CopyPatcher::flush().
+// ----------------------------------------------------------------------------
+qint64 TTByteRangeCopy::copy(QFileDevice& in, qint64 offset, QIODevice& out, qint64 length,
+                             const Progress& progress, const uchar* mapped)
+{
+    lastCopyError.clear();
+    lastCopyMethod = MethodBuffered;
+    if (length <= 0)
+        return 0;
+
+    qint64 done     = 0;
+    bool   stopped  = false;
+    Method method   = Method(firstMethod.load(std::memory_order_relaxed));
+
+    auto reportChunk = [&]() {
+        if (progress && !progress(done))
+            stopped = true;
+    };
+
+#if defined(TT_COPY_FILE_RANGE) || defined(TT_COPY_SENDFILE)
+    QFileDevice* outFile = qobject_cast<QFileDevice*>(&out);
+    const int inFd  = in.handle();
+    const int outFd = outFile ? outFile->handle() : -1;
+    const qint64 outStart = out.pos();
+    bool kernelUsed = false;
+
+    if (inFd < 0 || outFd < 0 || !outFile->flush())
+        method = MethodBuffered;
+
+#ifdef TT_COPY_FILE_RANGE
+    if (method == MethodCopyFileRange && copyFileRangeMissing.load(std::memory_order_relaxed))
+        method = MethodSendFile;
+
+    while (method == MethodCopyFileRange && done < length && !stopped) {
+        loff_t inOff  = offset + done;
+        loff_t outOff = outStart + done;
+        const ssize_t n = ::copy_file_range(inFd, &inOff, outFd, &outOff,
+                                            size_t(qMin(length - done, kChunkSize)), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            // Refused for this pair of files (other file system on an older
+            // kernel, special file, ...): the next method takes over from done
+            if (errno == ENOSYS)
+                copyFileRangeMissing.store(true, std::memory_order_relaxed);
+            if (errno == ENOSYS || errno == EXDEV || errno == EOPNOTSUPP ||
+                errno == EINVAL || errno == EBADF) {
+                method = MethodSendFile;
+                break;
+            }
+            lastCopyError = QString("copy_file_range: %1").arg(strerror(errno));
+            out.seek(outStart + done);
+            return -1;
+        }
+        if (n == 0)
+            break;              // end of in
+        kernelUsed = true;
+        done += n;
+        reportChunk();
+    }
+    if (method == MethodCopyFileRange) {
+        lastCopyMethod = MethodCopyFileRange;
+        return out.seek(outStart + done) ? done : -1;
+    }
+#else
+    if (method == MethodCopyFileRange)
+        method = MethodSendFile;
+#endif
+
+#ifdef TT_COPY_SENDFILE
+    // sendfile() writes at the descriptor's offset, not Qt's position
+    if (method == MethodSendFile && ::lseek(outFd, outStart + done, SEEK_SET) < 0)
+        method = MethodBuffered;
+
+    while (method == MethodSendFile && done < length && !stopped) {
+        off_t inOff = offset + done;
+        const ssize_t n = ::sendfile(outFd, inFd, &inOff, size_t(qMin(length - done, kChunkSize)));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EINVAL || errno == ENOSYS || errno == EOPNOTSUPP) {
+                method = MethodBuffered;
+                break;
+            }
+            lastCopyError = QString("sendfile: %1").arg(strerror(errno));
+            out.seek(outStart + done);
+            return -1;
+        }
+        if (n == 0)
+            break;
+        kernelUsed = true;
+        done += n;
+        reportChunk();
+    }
+    if (method == MethodSendFile) {
+        lastCopyMethod = MethodSendFile;
+        return out.seek(outStart + done) ? done : -1;
+    }
+#endif
+
+    if (kernelUsed && !out.seek(outStart + done)) {
+        lastCopyError = QString("seek: %1").arg(out.errorString());
+        return -1;
+    }
+#endif
+
+    // Buffered: from the mapping if there is one, else read() in chunks
+    lastCopyMethod = MethodBuffered;
+    QByteArray chunk;
+    if (!mapped) {
+        chunk.resize(int(qMin(length - done, kChunkSize)));
+        if (!in.seek(offset + done)) {
+            lastCopyError = QString("seek: %1").arg(in.errorString());
+            return -1;
+        }
+    }
+
+    while (done < length && !stopped) {
+        const qint64 want = qMin(length - done, kChunkSize);
+        const char*  data;
+        qint64       got;
+        if (mapped) {
+            data = reinterpret_cast<const char*>(mapped) + done;
+            got  = want;
+        } else {
+            got = in.read(chunk.data(), want);
+            if (got < 0) {
+                lastCopyError = QString("read: %1").arg(in.errorString());
+                return -1;
+            }
+            if (got == 0)
+                break;
+            data = chunk.constData();
+        }
+        if (out.write(data, got) != got) {
+            lastCopyError = QString("write: %1").arg(out.errorString());
+            return -1;
+        }
+        done += got;
+        reportChunk();
+    }
+    return done;
+}
@@ -0,0 +1,71 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTBYTERANGECOPY
+// Copy of a byte range from one file into another that stays in the kernel
+// where it can: copy_file_range() first (a reflink on btrfs/XFS when the
+// range is block aligned, an in-kernel copy otherwise), sendfile() where
+// that is refused (e.g. across file systems on older kernels), and
+// read()/write() through a user-space buffer as the last resort - or when
+// the target is not a file at all (packet sink, QBuffer).
+//
+// The interior of a cut - whole GOPs of a multi-GB recording - is this kind
+// of copy in every engine: TTAVStream::copySegment(), the MPEG-2
+// transferCutObjects() between the headers it patches, and TTESSmartCut's
+// bulk stream copy.
+
+#ifndef TTBYTERANGECOPY_H
+#define TTBYTERANGECOPY_H
+
+#include <QFileDevice>
+#include <QString>
+
+#include <functional>
+
+class TTByteRangeCopy
+{
+public:
+    enum Method {
+        MethodCopyFileRange = 0,
+        MethodSendFile,
+        MethodBuffered
+    };
+
+    // Bytes per kernel call / buffered chunk, and so the progress and abort
+    // granularity
+    static constexpr qint64 kChunkSize = 8 * 1024 * 1024;
+
+    // Called after every chunk with the bytes copied so far; false stops
+    // the copy (abort)
+    using Progress = std::function<bool(qint64 done)>;
+
+    // Copy length bytes of in, starting at offset, to the current position
+    // of out; out's position advances by what was copied, in's position is
+    // left undefined. mapped, if given, points at the range in a mapping of
+    // in (byte offset): the buffered fallback writes from there instead of
+    // reading. Returns the bytes copied - fewer than length when
+    // in ends early or progress stopped the copy - or -1 on an I/O error
+    // (lastError()).
+    static qint64 copy(QFileDevice& in, qint64 offset, QIODevice& out, qint64 length,
+                       const Progress& progress = Progress(),
+                       const uchar* mapped = nullptr);
+
+    // The method the last copy() on this thread finished with, and its error
+    static Method  lastMethod();
+    static QString lastError();
+
+    // The first method copy() tries (default MethodCopyFileRange); a later
+    // one skips the kernel paths before it. Diagnostics: exercises the
+    // fallbacks on a system where the first one works.
+    static void setFirstMethod(Method method);
+
+    static const char* methodName(Method method);
+};
+
+#endif // TTBYTERANGECOPY_H
@@ -9,6 +9,7 @@
 
 #include "ttdisplayordermap.h"
 #include "ttnaluparser.h"
+#include "ttstreamindexcache.h"
 
 #include "../common/ttmessagelogger.h"
 
@@ -233,6 +234,18 @@ TTDisplayOrderMap TTDisplayOrderMap::buildFromFile(const QString& filePath)
 {
     TTDisplayOrderMap map;
 
+    // Ranks of an earlier run. Own section: this pass pairs PAFF fields
+    // differently from the wrapper's merged index, so the two never share.
+    static const uint32_t kRanksTag = TTStreamIndexCache::tag("DMAP");
+    TTStreamIndexCache cache(filePath);
+    if (cache.load()) {
+        QVector<int> ranks;
+        if (cache.readArray(kRanksTag, ranks)) {
+            map.buildFromRanks(ranks);
+            if (map.isValid()) return map;
+        }
+    }
+
     AVFormatContext* fmt = nullptr;
     if (avformat_open_input(&fmt, filePath.toUtf8().constData(), nullptr, nullptr) < 0) {
         // avformat_open_input already freed fmt on failure; do NOT call avformat_close_input.
@@ -319,6 +332,10 @@ TTDisplayOrderMap TTDisplayOrderMap::buildFromFile(const QString& filePath)
     }
 
     map.build(entries);
+    if (map.isValid() && TTStreamIndexCache::isEnabled()) {
+        cache.setArray(kRanksTag, map.decodeToDisplayRanks());
+        cache.save();
+    }
     return map;
 }
 
@@ -60,7 +60,8 @@ public:
 
     // Standalone build: own libav parser pass over an ES file (H.264/H.265).
     // Used by TTESSmartCut when no wrapper map was injected (--auto-cut etc.).
-    // Returns an invalid map on failure.
+    // The ranks are kept in the stream's index sidecar (TTStreamIndexCache),
+    // so the pass only runs once per stream. Returns an invalid map on failure.
     static TTDisplayOrderMap buildFromFile(const QString& filePath);
 
     bool isValid() const        { return !mDecodeToDisplay.isEmpty(); }
@@ -72,6 +73,9 @@ public:
     int decodeToDisplay(int decodeIdx) const;
     int displayToDecode(int displayPos) const;
 
+    // Decode-order rank table as built (input for buildFromRanks()).
+    const QVector<int>& decodeToDisplayRanks() const { return mDecodeToDisplay; }
+
 private:
     QVector<int> mDecodeToDisplay;
     QVector<int> mDisplayToDecode;
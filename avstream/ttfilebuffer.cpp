@@ -377,6 +377,29 @@ quint64 TTFileBuffer::directWrite(const quint8* w_buffer, int w_length)
   return (quint64)result;
 }
 
+/* /////////////////////////////////////////////////////////////////////////////
+ * Copies length bytes of source, starting at offset, to the stream; the copy
+ * stays in the kernel where it can (TTByteRangeCopy). The source is left
+ * positioned behind the bytes copied. Returns fewer than length bytes when
+ * the source ends early or progress returned false.
+ */
+quint64 TTFileBuffer::directCopy(TTFileBuffer* source, quint64 offset, quint64 length,
+                                 const TTByteRangeCopy::Progress& progress)
+{
+  const qint64 result = TTByteRangeCopy::copy(*source->file, (qint64)offset,
+                                              *file, (qint64)length, progress);
+
+  if (result < 0) {
+    throw TTIOException(__FILE__, __LINE__,
+        QString("Could not copy %1 bytes from %2 to %3: %4")
+            .arg(length).arg(source->file->fileName(), file->fileName(),
+                             TTByteRangeCopy::lastError()));
+  }
+
+  source->seekAbsolute(offset + (quint64)result);
+  return (quint64)result;
+}
+
 /* /////////////////////////////////////////////////////////////////////////////
  * Writes an quint8 to stream
  */
@@ -16,6 +16,8 @@
 #include <QFile>
 #include <QByteArray>
 
+#include "ttbyterangecopy.h"
+
 // -----------------------------------------------------------------------------
 // TTFileBuffer: class declaration
 // -----------------------------------------------------------------------------
@@ -53,6 +55,8 @@ public:
 
   quint64 directWrite(quint8 byte1);
   quint64 directWrite(const quint8* w_buffer, int w_length);
+  quint64 directCopy(TTFileBuffer* source, quint64 offset, quint64 length,
+                     const TTByteRangeCopy::Progress& progress = TTByteRangeCopy::Progress());
 
  protected:
   void    initInstance();
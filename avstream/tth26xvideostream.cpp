@@ -146,7 +146,10 @@ int TTH26xVideoStream::createHeaderList()
 
     emit statusReport(StatusReportArgs::Step, tr("Building frame index..."), 10 * total / 100);
 
-    if (!mFFmpeg->buildFrameIndex(videoStreamIdx)) {
+    // The NAL index rides along for the cutter (naluIndex()); a cancelled
+    // open stops that parse too
+    mFFmpeg->setIndexAbortCallback([this]() { return bool(mAbort); });
+    if (!mFFmpeg->buildFrameIndex(videoStreamIdx, true)) {
         mLog->errorMsg(__FILE__, __LINE__,
             QString("Failed to build frame index: %1").arg(mFFmpeg->lastError()));
         disconnect(mFFmpeg, &TTFFmpegWrapper::progressChanged, this, nullptr);
@@ -199,21 +202,18 @@ int TTH26xVideoStream::createIndexList()
     }
 
     int n = accessUnitCount();
+    index_list->reserve(n);
     for (int i = 0; i < n; ++i) {
         const int disp = decodeToDisplayIndex(i);
         // Dropped RASL leading pics (NoRaslOutputFlag, HEVC) have no display
         // position and are not output by any decoder -> not navigable/cuttable.
         // Excluding them makes frameCount() == the decoder/playback frame count.
         if (disp < 0) continue;
-        TTVideoIndex* vidIndex = new TTVideoIndex();
         // Real display rank from the POC map (identity for streams without
         // B-reorder, and for MPEG-2). sortDisplayOrder() at open then makes
         // list position == display position, and headerListIndex(pos) ==
         // decode-order AU — the same semantics MPEG-2 has via temporal_reference.
-        vidIndex->setDisplayOrder(disp);
-        vidIndex->setHeaderListIndex(i);
-        vidIndex->setPictureCodingType(accessUnitToCodingType(i));
-        index_list->add(vidIndex);
+        index_list->add(disp, i, accessUnitToCodingType(i));
     }
 
     mLog->infoMsg(__FILE__, __LINE__,
@@ -295,6 +295,12 @@ const TTDisplayOrderMap& TTH26xVideoStream::displayOrderMap() const
     return mFFmpeg ? mFFmpeg->displayOrderMap() : empty;
 }
 
+const TTNaluIndex& TTH26xVideoStream::naluIndex() const
+{
+    static const TTNaluIndex empty;
+    return mFFmpeg ? mFFmpeg->naluIndex() : empty;
+}
+
 const QList<TTFrameInfo>& TTH26xVideoStream::ffmpegFrameIndex() const
 {
     return mFFmpeg->frameIndex();
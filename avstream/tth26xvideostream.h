@@ -58,6 +58,11 @@ public:
     // would mismatch the parser's frame count).
     const TTDisplayOrderMap& displayOrderMap() const;
 
+    // NAL/AU index built alongside the frame index (empty for container
+    // sources or if that parse failed). Injected into TTESSmartCut so cut and
+    // preview skip their own TTNaluParser scan.
+    const TTNaluIndex& naluIndex() const;
+
     // --- Canonical frame-index owner ("Owner A") ---
     // This stream builds the FFmpeg frame index ONCE at stream-open
     // (createHeaderList). Other wrappers of the same file should adopt it instead
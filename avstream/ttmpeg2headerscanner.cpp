@@ -0,0 +1,174 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttmpeg2headerscanner.h"
+#include "ttstartcodescanner.h"
+
+#include "../common/ttsettings.h"
+
+#include <QDebug>
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+TTMpeg2HeaderScanner::TTMpeg2HeaderScanner(const QString& filePath)
+    : mFilePath(filePath),
+      mFileSize(0),
+      mPos(0),
+      mRangeEnd(-1),
+      mMapped(nullptr),
+      mWindowed(false),
+      mWindowSize(8 * 1024 * 1024),
+      mWindowBase(0)
+{
+}
+
+TTMpeg2HeaderScanner::~TTMpeg2HeaderScanner()
+{
+    close();
+}
+
+void TTMpeg2HeaderScanner::setWindowed(bool windowed, int windowSize)
+{
+    mWindowed   = windowed;
+    mWindowSize = qMax(windowSize, 4 * kMaxHeaderSpan);
+}
+
+void TTMpeg2HeaderScanner::setRange(int64_t begin, int64_t end)
+{
+    mPos      = qBound<int64_t>(0, begin, mFileSize);
+    mRangeEnd = end;
+}
+
+// ----------------------------------------------------------------------------
+// Open: map the file, or fall back to windowed reads
+// ----------------------------------------------------------------------------
+bool TTMpeg2HeaderScanner::open()
+{
+    close();
+
+    mFile.setFileName(mFilePath);
+    if (!mFile.open(QIODevice::ReadOnly)) {
+        mLastError = QString("Cannot open %1: %2").arg(mFilePath, mFile.errorString());
+        return false;
+    }
+    mFileSize = mFile.size();
+    mPos      = 0;
+
+    if (!mWindowed && mFileSize > 0)
+        mMapped = mFile.map(0, mFileSize);
+    if (!mMapped && mFileSize > 0 && !loadWindow(0)) {
+        mLastError = QString("Cannot read %1: %2").arg(mFilePath, mFile.errorString());
+        close();
+        return false;
+    }
+
+    if (TTSettings::instance()->logAVStream())
+        qDebug() << "TTMpeg2HeaderScanner:" << (mMapped ? "mapped" : "windowed reads,")
+                 << (mFileSize / (1024 * 1024)) << "MB, start-code scan:"
+                 << TTStartCodeScanner::implName(TTStartCodeScanner::activeImpl());
+    return true;
+}
+
+void TTMpeg2HeaderScanner::close()
+{
+    if (mMapped) {
+        mFile.unmap(mMapped);
+        mMapped = nullptr;
+    }
+    if (mFile.isOpen())
+        mFile.close();
+    mWindow.clear();
+    mWindowBase = 0;
+}
+
+// Read the window starting at file offset from
+bool TTMpeg2HeaderScanner::loadWindow(int64_t from)
+{
+    const int64_t want = qMin<int64_t>(mWindowSize, mFileSize - from);
+    mWindowBase = from;
+    mWindow.resize(int(qMax<int64_t>(want, 0)));
+    if (want <= 0 || !mFile.seek(from)) {
+        mWindow.clear();
+        return false;
+    }
+    const qint64 got = mFile.read(mWindow.data(), want);
+    mWindow.resize(int(qMax<qint64>(got, 0)));
+    return got > 0;
+}
+
+// ----------------------------------------------------------------------------
+// Search
+// ----------------------------------------------------------------------------
+int TTMpeg2HeaderScanner::nextHeader()
+{
+    forever {
+        // A start code needs its type byte inside the file
+        if (mPos + 4 > mFileSize) {
+            mPos = mFileSize;
+            return -1;
+        }
+
+        const uint8_t* data;
+        int64_t base, length;
+        if (mMapped) {
+            data   = mMapped;
+            base   = 0;
+            length = mFileSize;
+        } else {
+            if ((mPos < mWindowBase || mPos + 4 > mWindowBase + mWindow.size())
+                && !loadWindow(mPos))
+                return -1;
+            data   = reinterpret_cast<const uint8_t*>(mWindow.constData());
+            base   = mWindowBase;
+            length = mWindow.size();
+        }
+
+        // Prefixes whose type byte lies inside the view
+        const int64_t i = TTStartCodeScanner::findPrefix(data, mPos - base, length - 3);
+        if (i < 0) {
+            if (base + length >= mFileSize) {
+                mPos = mFileSize;
+                return -1;
+            }
+            // The next window repeats the last three bytes: a prefix
+            // straddling the seam is found there
+            mPos = base + length - 3;
+            continue;
+        }
+
+        mPos = base + i;
+        const int type = data[i + 3];
+        switch (type) {
+            case 0xb3:   // sequence
+            case 0xb8:   // GOP
+            case 0x00:   // picture
+            case 0xb7:   // sequence end
+                if (mRangeEnd >= 0 && mPos >= mRangeEnd)
+                    return -1;
+                return type;
+            default:
+                // Slices, extensions, user data: step over the start code
+                mPos += 4;
+                break;
+        }
+    }
+}
+
+const uint8_t* TTMpeg2HeaderScanner::span(int wanted, int& length)
+{
+    length = int(qBound<int64_t>(0, mFileSize - mPos, qMin(wanted, int(kMaxHeaderSpan))));
+    if (mMapped)
+        return mMapped + mPos;
+
+    if (mPos < mWindowBase || mPos + length > mWindowBase + mWindow.size())
+        loadWindow(mPos);
+    length = int(qMin<int64_t>(length, mWindowBase + mWindow.size() - mPos));
+    return reinterpret_cast<const uint8_t*>(mWindow.constData()) + (mPos - mWindowBase);
+}
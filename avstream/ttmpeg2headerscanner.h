@@ -0,0 +1,86 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTMPEG2HEADERSCANNER
+// Start-code walk for the MPEG-2 header list. The file is mapped as a whole
+// (windowed reads if the mapping fails, e.g. on a 32-bit build), the 00 00 01
+// prefixes are found with TTStartCodeScanner (SSE2/AVX2) and the header
+// classes parse their fields straight from the span (parseHeader()). It
+// replaces TTFileBuffer's ring buffer, whose byte-wise search and readByte()
+// made opening a multi-GB .m2v CPU-bound.
+//
+// Reports sequence (B3), GOP (B8), picture (00) and sequence end (B7) start
+// codes at the positions TTFileBuffer::nextStartCodeTS() would: the caller
+// advances by what the header parser consumed, the search resumes from there,
+// and any other start code is stepped over by its four bytes.
+
+#ifndef TTMPEG2HEADERSCANNER_H
+#define TTMPEG2HEADERSCANNER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <cstdint>
+
+class TTMpeg2HeaderScanner
+{
+public:
+    // The most a header parser reads from its start code on (sequence header
+    // + bounded search for its extension), see TTMpeg2VideoHeader::parseHeader
+    static constexpr int kMaxHeaderSpan = 2048;
+
+    explicit TTMpeg2HeaderScanner(const QString& filePath);
+    ~TTMpeg2HeaderScanner();
+
+    // Windowed reads instead of the mapping (diagnostics: exercises the
+    // window seams). Before open(); windowSize >= 4 * kMaxHeaderSpan.
+    void setWindowed(bool windowed, int windowSize = 8 * 1024 * 1024);
+
+    bool open();
+    void close();
+    bool isMapped() const { return mMapped != nullptr; }
+
+    int64_t size() const     { return mFileSize; }
+    int64_t position() const { return mPos; }
+
+    // Scan from begin on; headers starting at or after end (-1: the end of
+    // the file) are not reported. After open(); one partition of a
+    // parallel scan.
+    void setRange(int64_t begin, int64_t end);
+
+    // Move to the next sequence/GOP/picture/sequence end start code at or
+    // after position(). Returns its type byte (position() is then the
+    // offset of the 00 00 01), or -1 at the end of the file or range (a
+    // header past the range end is left at position()).
+    int  nextHeader();
+
+    // Bytes from position() on, at least min(wanted, bytes left) of them;
+    // wanted <= kMaxHeaderSpan. Valid until the next call.
+    const uint8_t* span(int wanted, int& length);
+    void advance(int64_t bytes) { mPos += bytes; }
+
+    QString lastError() const { return mLastError; }
+
+private:
+    bool loadWindow(int64_t from);
+
+    QString     mFilePath;
+    QFile       mFile;
+    int64_t     mFileSize;
+    int64_t     mPos;
+    int64_t     mRangeEnd;
+    uchar*      mMapped;
+    bool        mWindowed;
+    int         mWindowSize;
+    QByteArray  mWindow;       // windowed mode: file bytes [mWindowBase, + size)
+    int64_t     mWindowBase;
+    QString     mLastError;
+};
+
+#endif // TTMPEG2HEADERSCANNER_H
@@ -41,15 +41,55 @@
 
 #include "ttmpeg2videoheader.h"
 
+#include <cstring>
+
 const char cName[] = "MPEGVIDEOHEADER";
 
+/* /////////////////////////////////////////////////////////////////////////////
+ * Span counterpart of the bounded start-code search in readHeader(): the
+ * same byte loop, at most 1024 bytes from pos. Returns 1 with pos after the
+ * 0x01, 0 if the limit ran out or -1 at the end of the span.
+ */
+static int findNextStartCode( const quint8* data, int length, int& pos )
+{
+  int count_zeros = 0;
+  int searchLimit = 1024;
+  quint8 value;
+  do
+  {
+    if ( pos >= length ) return -1;
+    value = data[pos++];
+    if ( value == 0x00 )
+    {
+      count_zeros++;
+    }
+    else if ( value != 1 )
+    {
+      count_zeros = 0;
+    }
+    if (--searchLimit <= 0) return 0;
+  }
+  while ( value != 0x01 || count_zeros < 2 );
+
+  return 1;
+}
+
+/* /////////////////////////////////////////////////////////////////////////////
+ * Copy count bytes from data[pos] into buffer, zero-filled past length
+ */
+static void copyHeaderBytes( quint8* buffer, int count, const quint8* data, int length, int pos )
+{
+  memset( buffer, 0, count );
+  if ( pos < length )
+    memcpy( buffer, data + pos, qMin(count, length - pos) );
+}
+
 /* /////////////////////////////////////////////////////////////////////////////
  * TTMpeg2VideoHeader
  * Base class for all MPEG2 video header
  */
 TTMpeg2VideoHeader::TTMpeg2VideoHeader()
 {
-  log = TTMessageLogger::getInstance();
 }
 
 
@@ -123,6 +163,33 @@ bool TTSequenceHeader::readHeader( TTFileBuffer* mpeg2_stream )
   return true;
 }
 
+/* /////////////////////////////////////////////////////////////////////////////
+ * Parse sequence header (and sequence_extension) from a span
+ */
+int TTSequenceHeader::parseHeader( const quint8* data, int length, quint64 offset )
+{
+  quint8 header_data[8];
+
+  header_offset = offset;
+  copyHeaderBytes( header_data, 8, data, length, 4 );
+  parseBasicData( header_data );
+
+  int pos = qMin( 12, length );
+  if ( findNextStartCode( data, length, pos ) <= 0 || pos >= length )
+    return pos;
+
+  if ( data[pos++] != extension_start_code ) return pos;
+  if ( length - pos < 6 ) return length;
+
+  quint8 ext_data[6];
+  copyHeaderBytes( ext_data, 6, data, length, pos );
+  pos += 6;
+  if ((ext_data[0] & 0xF0) != 0x10) return pos;
+
+  parseExtensionData( ext_data );
+  return pos;
+}
+
 /* /////////////////////////////////////////////////////////////////////////////
  * Read sequence header at given offset
  */
@@ -213,7 +280,7 @@ float TTSequenceHeader::frameRateValue()
   if ( frame_rate_code == 5 ) value = 30.0;
 
   if ( frame_rate_code < 2 || frame_rate_code > 5 )
-    log->errorMsg(cName, __LINE__, "Couldn't determine the correct frame rate: assume 25 fps!");
+    TTMessageLogger::getInstance()->errorMsg(cName, __LINE__, "Couldn't determine the correct frame rate: assume 25 fps!");
 
   return value;
 }
@@ -259,6 +326,12 @@ bool TTSequenceEndHeader::readHeader( TTFileBuffer* mpeg2_stream, quint64 offset
   return readHeader( mpeg2_stream );
 }
 
+int TTSequenceEndHeader::parseHeader( __attribute__ ((unused))const quint8* data, int length, quint64 offset )
+{
+  header_offset = offset;
+  return qMin( 4, length );
+}
+
 void TTSequenceEndHeader::parseBasicData( __attribute__ ((unused))quint8* data, __attribute__ ((unused))int offset )
 {
 
@@ -296,6 +369,20 @@ bool TTGOPHeader::readHeader( TTFileBuffer* mpeg2_stream )
   }
 }
 
+/* /////////////////////////////////////////////////////////////////////////////
+ * Parse the GOP header from a span
+ */
+int TTGOPHeader::parseHeader( const quint8* data, int length, quint64 offset )
+{
+  quint8 header_data[4];
+
+  header_offset = offset;
+  copyHeaderBytes( header_data, 4, data, length, 4 );
+  parseBasicData( header_data );
+
+  return qMin( 8, length );
+}
+
 /* /////////////////////////////////////////////////////////////////////////////
  * Read the GOP header at given offset
  */
@@ -380,6 +467,31 @@ bool TTPicturesHeader::readHeader( TTFileBuffer* mpeg2_stream )
   }
 }
 
+/* /////////////////////////////////////////////////////////////////////////////
+ * Parse picture header (and picture coding extension) from a span. Like
+ * readHeader() it takes the next start code for the extension unchecked.
+ */
+int TTPicturesHeader::parseHeader( const quint8* data, int length, quint64 offset )
+{
+  quint8 header_data[5];
+
+  header_offset = offset;
+  copyHeaderBytes( header_data, 4, data, length, 4 );
+  parseBasicData( header_data );
+
+  int pos = qMin( 8, length );
+  if ( findNextStartCode( data, length, pos ) <= 0 )
+    return pos;
+
+  pos += 1;
+  if ( length - pos < 5 ) return length;
+
+  copyHeaderBytes( header_data, 5, data, length, pos );
+  parseExtensionData( header_data );
+
+  return pos + 5;
+}
+
 /* /////////////////////////////////////////////////////////////////////////////
  * Read picture header at given offset.
  */
@@ -58,6 +58,10 @@ public:
   virtual bool readHeader( TTFileBuffer* mpeg2_stream ) = 0;
   virtual bool readHeader( TTFileBuffer* mpeg2_stream, quint64 offset ) = 0;
   virtual void parseBasicData( quint8* data, int offset=0 ) = 0;
+  // Parse the header from a span starting at its start code (file offset
+  // 'offset', 'length' bytes available). Reads the same bytes readHeader()
+  // does and returns how many: the position the stream would be left at.
+  virtual int  parseHeader( const quint8* data, int length, quint64 offset ) = 0;
 
 enum mpeg2StartCodes
   {
@@ -85,6 +89,7 @@ class TTSequenceHeader : public TTMpeg2VideoHeader
   bool readHeader( TTFileBuffer* mpeg2_stream );
   bool readHeader( TTFileBuffer* mpeg2_stream, quint64 offset );
   void parseBasicData( quint8* data, int offset=0);
+  int  parseHeader( const quint8* data, int length, quint64 offset );
 
   int     horizontalSize();
   int     verticalSize();
@@ -120,6 +125,7 @@ class TTSequenceEndHeader : public TTMpeg2VideoHeader
   bool readHeader( TTFileBuffer* mpeg2_stream );
   bool readHeader( TTFileBuffer* mpeg2_stream, quint64 offset );
   void parseBasicData( quint8* data, int offset=0);
+  int  parseHeader( const quint8* data, int length, quint64 offset );
 };
 
 // -----------------------------------------------------------------------------
@@ -133,6 +139,7 @@ public:
   bool readHeader( TTFileBuffer* mpeg2_stream );
   bool readHeader( TTFileBuffer* mpeg2_stream, quint64 offset );
   void parseBasicData( quint8* data, int offset=0 );
+  int  parseHeader( const quint8* data, int length, quint64 offset );
 
    // from group_of_pictures_header [B8]
    TTimeCode time_code;
@@ -159,6 +166,7 @@ class TTPicturesHeader : public TTMpeg2VideoHeader
   bool    readHeader( TTFileBuffer* mpeg2_stream, quint64 offset );
   void    parseBasicData( quint8* data, int offset=0 );
   void    parseExtensionData( quint8* data, int offset=0 );
+  int     parseHeader( const quint8* data, int length, quint64 offset );
 
   // from picture_header [00]
   int     temporal_reference;
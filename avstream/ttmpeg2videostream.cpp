@@ -26,6 +26,7 @@
 // -----------------------------------------------------------------------------
 
 #include "ttmpeg2videostream.h"
+#include "ttmpeg2headerscanner.h"
 
 #include "../common/ttexception.h"
 #include "../common/istatusreporter.h"
@@ -36,11 +37,15 @@
 #include <QElapsedTimer>
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 #include <QDir>
+#include <QRunnable>
 #include <QScopeGuard>
+#include <QSemaphore>
 #include <QStack>
 #include <QTemporaryDir>
 #include <QThread>
+#include <QThreadPool>
 
 /*! ////////////////////////////////////////////////////////////////////////////
  * Constructor with QFileInfo
@@ -53,6 +58,9 @@ TTMpeg2VideoStream::TTMpeg2VideoStream( const QFileInfo &f_info )
   stream_type   = TTAVTypes::mpeg2_demuxed_video;
   header_list   = NULL;
   index_list    = NULL;
+
+  mHeaderScanWorkers = 0;
+  mMinScanPartition  = 64*1024*1024;
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
@@ -102,6 +110,7 @@ int TTMpeg2VideoStream::createIndexList()
   TTPicturesHeader* current_pic  = NULL;
 
   index_list  = new TTVideoIndexList();
+  index_list->reserve( header_list->count() );
 
   // Field-picture pair tracking for extra-index detection
   // (per spec docs/superpowers/specs/2026-05-12-mpeg2-field-picture-fix-design.md)
@@ -144,13 +153,9 @@ int TTMpeg2VideoStream::createIndexList()
         current_pic = (TTPicturesHeader*)header_list->at(index);
         if ( current_pic != NULL )
         {
-          TTVideoIndex* video_index = new TTVideoIndex();
-
-          video_index->setDisplayOrder(base_number+current_pic->temporal_reference);
-          video_index->setHeaderListIndex(index);
-          video_index->setPictureCodingType(current_pic->picture_coding_type);
+          const int display_order = base_number+current_pic->temporal_reference;
 
-          index_list->add( video_index );
+          index_list->add( display_order, index, current_pic->picture_coding_type );
 
           // Field-picture pair detection (Variante 2A per spec).
           // When two consecutive field-pictures appear, the second one's
@@ -176,8 +181,8 @@ int TTMpeg2VideoStream::createIndexList()
          if(TTSettings::instance()->logVideoIndexInfo()) {
             log->infoMsg(__FILE__, __LINE__,
                     QString("stream-order;%1;display-order;%2;frame-type;%3;offset;%4").
-                    arg(current_pic_num).arg(video_index->getDisplayOrder()).
-                    arg(video_index->getPictureCodingType()).arg(current_pic->headerOffset()));
+                    arg(current_pic_num).arg(display_order).
+                    arg(current_pic->picture_coding_type).arg(current_pic->headerOffset()));
          }
          current_pic_num++;
         }
@@ -222,85 +227,206 @@ bool TTMpeg2VideoStream::closeStream()
 
 /*! ////////////////////////////////////////////////////////////////////////////
  * Create the mpeg2 header-list from mpeg2 stream
+ * The start codes are found by TTMpeg2HeaderScanner (mapped file, vectorised
+ * search) and every header parses its fields from the span; the list is the
+ * one the TTFileBuffer walk produced (see tools/diag/test_mpeg2_headerscan).
+ * The headers are placed in the list's arena, not allocated one by one.
+ * A large file is cut into partitions at sequence headers (broadcast streams
+ * repeat them every GOP), scanned on a core each and merged; the result is
+ * the serial one (see tools/diag/test_mpeg2_parallelscan).
  */
 bool TTMpeg2VideoStream::createHeaderListFromMpeg2()
 {
-  quint8         headerType;
-  TTVideoHeader* newHeader;
-  QElapsedTimer  time;
-  QElapsedTimer  updateTime;
-  const int      updateIntervalMs = 1000;  // Only update UI every 1 second
+  QElapsedTimer time;
+
+  header_list->deleteAll();
 
-  header_list->clear();
+  TTMpeg2HeaderScanner scanner(filePath());
+  if (!scanner.open()) {
+    log->errorMsg(__FILE__, __LINE__, scanner.lastError());
+    return false;
+  }
+
+  time.start();
+  emit statusReport(StatusReportArgs::Start, tr("Creating MPEG-2 header list"), scanner.size());
+
+  // Same worker count as the search tasks: 0 = auto (idealThreadCount/2 cap
+  // 4), clamp [1, 16]; no partition smaller than mMinScanPartition
+  int workers = (mHeaderScanWorkers > 0) ? mHeaderScanWorkers : TTSettings::instance()->searchWorkerCount();
+  if (workers <= 0) workers = qBound(1, QThread::idealThreadCount() / 2, 4);
+  workers = qBound(1, workers, 16);
+
+  const int partitions = int(qBound<qint64>(1, scanner.size() / qMax<qint64>(1, mMinScanPartition), workers));
+  const QVector<qint64> seams = headerScanSeams(scanner, partitions);
+  const qint64 fileSize = scanner.size();
+  scanner.close();
+
+  bool scanned = scanPartitions(seams);
+  if (!scanned && !mAbort && seams.size() > 2) {
+    log->warningMsg(__FILE__, __LINE__, "MPEG-2 header partitions do not join, scanning serially");
+    scanned = scanPartitions(QVector<qint64>() << 0 << fileSize);
+  }
 
-  try
+  if (mAbort) {
+    mAbort = false;
+    throw TTAbortException(tr("Headerlist creation aborted by user!"));
+  }
+
+  log->debugMsg(__FILE__, __LINE__, QString("time for creating header list %1ms (%2 partitions)").
+      arg(time.elapsed()).arg(seams.size()-1));
+
+  emit statusReport(StatusReportArgs::Finished, tr("MPEG-2 header list created"), fileSize);
+
+  return (scanned && header_list->count() > 0);
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Partition bounds for the header scan: 0, the sequence headers found from
+ * each n-th of the file on, the file size
+ */
+QVector<qint64> TTMpeg2VideoStream::headerScanSeams(TTMpeg2HeaderScanner& scanner, int partitions)
+{
+  QVector<qint64> seams;
+  seams.append(0);
+
+  for (int i = 1; i < partitions; i++)
   {
-    time.start();
-    updateTime.start();
-    emit statusReport(StatusReportArgs::Start, tr("Creating MPEG-2 header list"), stream_buffer->size());
+    int headerType;
+    scanner.setRange(scanner.size() / partitions * i, -1);
 
-    while(!stream_buffer->atEnd())
-    {
-    	if (mAbort) {
-    		mAbort = false;
-    		throw TTAbortException(tr("Headerlist creation aborted by user!"));
-    	}
-
-      headerType = 0xFF;
-
-      // search next header (start code)
-      while (headerType != TTMpeg2VideoHeader::picture_start_code  &&
-             headerType != TTMpeg2VideoHeader::sequence_start_code &&
-             headerType != TTMpeg2VideoHeader::group_start_code    &&
-             headerType != TTMpeg2VideoHeader::sequence_end_code  &&
-            !stream_buffer->atEnd() )
-      {
-        stream_buffer->nextStartCodeTS();
-        stream_buffer->readByte(headerType);
-      }
+    while ((headerType = scanner.nextHeader()) >= 0 &&
+           headerType != TTMpeg2VideoHeader::sequence_start_code)
+      scanner.advance(4);
 
-      newHeader = 0;
+    if (headerType < 0)
+      break;
+    if (scanner.position() > seams.last())
+      seams.append(scanner.position());
+  }
+  seams.append(scanner.size());
 
-      // create the appropriate header object
-      switch ( headerType )
-      {
-        case TTMpeg2VideoHeader::sequence_start_code:
-          newHeader = new TTSequenceHeader();
-          break;
-        case TTMpeg2VideoHeader::picture_start_code:
-          newHeader = new TTPicturesHeader();
-          break;
-        case TTMpeg2VideoHeader::group_start_code:
-          newHeader = new TTGOPHeader();
-          break;
-        case TTMpeg2VideoHeader::sequence_end_code:
-          newHeader = new TTSequenceEndHeader();
-          break;
-      }
+  return seams;
+}
 
-      if ( newHeader != 0 )
-      {
-        newHeader->readHeader( stream_buffer );
-        header_list->add( newHeader );
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Scan the partitions between seams on a thread each and append their headers
+ * to the header list. A partition stops at the first header past its end -
+ * where the serial walk arrives as well - so that header has to be the
+ * sequence header the next partition starts with. Returns false (header list
+ * empty) if a seam does not join or a partition failed.
+ */
+bool TTMpeg2VideoStream::scanPartitions(const QVector<qint64>& seams)
+{
+  const int                   n = seams.size() - 1;
+  QVector<TTVideoHeaderList*> parts;
+  std::vector<qint64>         endPos(n, -1);
+  std::vector<int>            succeeded(n, 0);
+  QAtomicInteger<qint64>      scanned(0);
+  QAtomicInt                  headers(0);
+  const int                   updateIntervalMs = 1000;  // Only update UI every 1 second
+
+  for (int i = 0; i < n; i++)
+    parts.append(new TTVideoHeaderList(2000));
+
+  QThreadPool pool;
+  pool.setMaxThreadCount(n);
+  QSemaphore finished(0);
+  for (int i = 0; i < n; i++) {
+    auto* runnable = QRunnable::create([&, i]() {
+      try {
+        succeeded[i] = scanHeaderRange(seams[i], seams[i+1], parts[i], endPos[i], scanned, headers);
+      } catch (...) {
+        succeeded[i] = false;
       }
+      finished.release(1);
+    });
+    runnable->setAutoDelete(true);
+    pool.start(runnable);
+  }
 
-      // Throttle status updates to reduce UI flickering
-      if (updateTime.elapsed() >= updateIntervalMs) {
-        emit statusReport(StatusReportArgs::Step, tr("Found %1 headers").arg(header_list->count()), stream_buffer->position());
-        updateTime.restart();
-      }
-    }
-    log->debugMsg(__FILE__, __LINE__, QString("time for creating header list %1ms").
-        arg(time.elapsed()));
+  // Throttle status updates to reduce UI flickering
+  while (!finished.tryAcquire(n, updateIntervalMs))
+    emit statusReport(StatusReportArgs::Step, tr("Found %1 headers").arg(headers.loadRelaxed()), scanned.loadRelaxed());
+
+  bool joined = true;
+  for (int i = 0; i < n; i++) {
+    joined = joined && succeeded[i];
+    if (i+1 < n)
+      joined = joined && (endPos[i] == seams[i+1]);
+  }
+
+  for (int i = 0; i < n; i++) {
+    if (joined)
+      header_list->takeHeaders(parts[i]);
+    parts[i]->deleteAll();
+    delete parts[i];
   }
-  catch (const TTFileBufferException&)
+
+  return joined;
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Scan the headers of [begin, end[ into list (one partition, on a pool thread).
+ * endPos is where the scan stopped: the start code of the first header past
+ * end, or the end of the file. Returns false on abort or error.
+ */
+bool TTMpeg2VideoStream::scanHeaderRange(qint64 begin, qint64 end, TTVideoHeaderList* list,
+                                         qint64& endPos, QAtomicInteger<qint64>& scanned, QAtomicInt& headers)
+{
+  int                 headerType;
+  TTMpeg2VideoHeader* newHeader;
+  qint64              reported = begin;
+  int                 found    = 0;
+
+  TTMpeg2HeaderScanner scanner(filePath());
+  if (!scanner.open())
+    return false;
+  scanner.setRange(begin, (end < scanner.size()) ? end : -1);
+
+  while ((headerType = scanner.nextHeader()) >= 0)
   {
-    qDebug("ttfilebuffer exception...");
+    if (mAbort)
+      return false;
+
+    newHeader = 0;
+
+    // create the appropriate header object
+    switch ( headerType )
+    {
+      case TTMpeg2VideoHeader::sequence_start_code:
+        newHeader = list->create<TTSequenceHeader>();
+        break;
+      case TTMpeg2VideoHeader::picture_start_code:
+        newHeader = list->create<TTPicturesHeader>();
+        break;
+      case TTMpeg2VideoHeader::group_start_code:
+        newHeader = list->create<TTGOPHeader>();
+        break;
+      case TTMpeg2VideoHeader::sequence_end_code:
+        newHeader = list->create<TTSequenceEndHeader>();
+        break;
+    }
+
+    if ( newHeader != 0 )
+    {
+      int length;
+      const quint8* data = scanner.span(TTMpeg2HeaderScanner::kMaxHeaderSpan, length);
+      scanner.advance(newHeader->parseHeader(data, length, scanner.position()));
+      list->add( newHeader );
+    }
+
+    if (++found % 4096 == 0) {
+      scanned.fetchAndAddRelaxed(scanner.position() - reported);
+      headers.fetchAndAddRelaxed(4096);
+      reported = scanner.position();
+    }
   }
 
-  emit statusReport(StatusReportArgs::Finished, tr("MPEG-2 header list created"), stream_buffer->size());
+  endPos = scanner.position();
+  scanned.fetchAndAddRelaxed(qMax<qint64>(0, qMin(endPos, end) - reported));
+  headers.fetchAndAddRelaxed(found % 4096);
 
-  return (header_list->count() > 0);
+  return true;
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
@@ -527,20 +653,24 @@ quint64 TTMpeg2VideoStream::getByteCount(TTVideoHeader* startObject, TTVideoHead
 /*! /////////////////////////////////////////////////////////////////////////////
  * Transfers the cuts objects to the target stream
  * Remark: [startObject, endObject[
+ * The byte ranges between the headers that must change (GOP time codes, the
+ * temporal references after a closed GOP) and the ranges that are dropped
+ * (sequence end codes, orphaned B-frames) are copied by the kernel
+ * (TTFileBuffer::directCopy); only the patched header bytes pass through
+ * user space.
  */
 void TTMpeg2VideoStream::transferCutObjects(TTVideoHeader* startObject, TTVideoHeader* endObject, TTCutParameter* cr)
 {
-  QByteArray bufferStorage(262144, '\0');
-  quint8*   buffer = reinterpret_cast<quint8*>(bufferStorage.data());
-  quint64   bytesToWrite      = getByteCount(startObject, endObject);
-  quint64   bufferStartOffset = startObject->headerOffset();
-  int       numPicsWritten    = cr->getNumPicturesWritten();
-  quint64   process           = 0;
-  bool      closeNextGOP      = true;  // remove B-frames
-  int       tempRefDelta      = 0;     // delta for temporal reference if closed GOP
-  const int watermark         = 12;    // size of header type-code (12 byte)
-  bool      objectProcessed   = false;
-  bool      isContinue        = false;
+  TTFileBuffer* target            = cr->getTargetStreamBuffer();
+  quint64       bytesToWrite      = getByteCount(startObject, endObject);
+  quint64       endOffset         = startObject->headerOffset()+bytesToWrite;
+  quint64       rangeStart        = startObject->headerOffset(); // first byte not yet written
+  int           numPicsWritten    = cr->getNumPicturesWritten();
+  quint64       process           = 0;
+  bool          closeNextGOP      = true;  // remove B-frames
+  int           tempRefDelta      = 0;     // delta for temporal reference if closed GOP
+  quint8        header[8];                 // GOP header / start of picture header
+  bool          isContinue        = false;
 
   log->debugMsg(__FILE__, __LINE__, QString("transferCutObjects::bytesToWrite %1").
       arg(bytesToWrite));
@@ -548,166 +678,170 @@ void TTMpeg2VideoStream::transferCutObjects(TTVideoHeader* startObject, TTVideoH
   TTVideoHeader*          currentObject = startObject;
   QStack<TTBreakObject*>* break_objects = new QStack<TTBreakObject*>;
 
-  stream_buffer->seekAbsolute( startObject->headerOffset() );
+  // Kernel copy of [rangeStart, offset[; the callback runs per chunk and
+  // stops the copy on an abort request
+  auto copyRange = [&](quint64 offset) {
+    if (offset <= rangeStart)
+      return;
+
+    quint64 length = offset-rangeStart;
+    quint64 copied = target->directCopy(stream_buffer, rangeStart, length, [&](qint64 done) {
+      emit statusReport(StatusReportArgs::Step, tr("Transfer objects"), process+done);
+      qApp->processEvents();
+      return !mAbort;
+    });
+
+    if (mAbort) {
+      mAbort = false;
+      throw TTAbortException(tr("Transfer cut objects aborted!"));
+    }
+    if (copied < length)
+      throw TTIOException(tr("%1 of %2 bytes from stream buffer copied").arg(copied).arg(length));
+
+    process    += copied;
+    rangeStart  = offset;
+  };
+
+  // Reads length header bytes at offset into header[], for patching
+  auto readHeader = [&](quint64 offset, int length) {
+    copyRange(offset);
+    stream_buffer->seekAbsolute(offset);
+    int bytesRead = stream_buffer->readByte(header, length);
+    if (bytesRead != length)
+      throw TTIOException(tr("%1 bytes from stream buffer read").arg(bytesRead));
+  };
+
+  // Writes the patched header[] and continues the copy behind it
+  auto writeHeader = [&](quint64 offset, int length) {
+    target->directWrite(header, length);
+    process    += length;
+    rangeStart  = offset+length;
+  };
 
   //qDebug(qPrintable(QString("transferCutObjects -> emit start in thread %1").arg(QThread::currentThreadId())));
   emit statusReport(StatusReportArgs::Start, tr("Transfer objects"), bytesToWrite);
   qApp->processEvents();
 
-  while( bytesToWrite > 0 )
+  while (ttAssigned(currentObject))
   {
-   int bytesProcessed = (bytesToWrite < 262144)
-        ? stream_buffer->readByte(buffer, bytesToWrite)
-        : stream_buffer->readByte(buffer, 262144);
+    if (mAbort) {
+      mAbort = false;
+      throw TTAbortException(tr("Transfer cut objects aborted!"));
+    }
 
-    if (bytesProcessed <= 0)
-      throw TTIOException(tr("%1 bytes from stream buffer read").arg(bytesProcessed));
+    isContinue = false;
 
-    do
+    // removing unwanted objects
+    if ( break_objects->count() > 0 )
     {
-    	if (mAbort) {
-    		mAbort = false;
-    		throw TTAbortException(tr("Transfer cut objects aborted!"));
-    	}
-
-      isContinue = false;
-
-      // is start address not in current buffer
-      if (currentObject->headerOffset() < bufferStartOffset || currentObject->headerOffset() > (bufferStartOffset+bytesProcessed-1)) {
-        break;
-      }
+      TTBreakObject* current_break = (TTBreakObject*)break_objects->top();
 
+      if ( current_break->stopObject() != NULL &&
+          current_break->stopObject()->headerOffset() == currentObject->headerOffset() )
+      {
+        TTVideoHeader* restartObject = current_break->restartObject();
 
-      objectProcessed = (currentObject->headerOffset() < bufferStartOffset+bytesProcessed-watermark);
+        copyRange(currentObject->headerOffset());
+        current_break->setStopObject((TTVideoHeader*)NULL );
 
-      if (!objectProcessed) {
-        // End-of-stream guard: if the entire remaining stream is in the buffer
-        // already (no more chunks to read), don't seekBackward — that creates
-        // an infinite loop where each iteration re-reads the same trailing
-        // bytes without making progress. Just process and exit the inner loop.
-        if (static_cast<quint64>(bytesProcessed) >= bytesToWrite) {
+        // nothing left to write behind the removed objects
+        if (!ttAssigned(restartObject) || restartObject->headerOffset() >= endOffset) {
+          rangeStart = endOffset;
           break;
         }
-        stream_buffer->seekBackward(watermark);
-        bytesProcessed -= watermark;
-        break;
+
+        rangeStart    = restartObject->headerOffset();
+        currentObject = restartObject; // hier gehts weiter
+        continue;
       }
 
-      // removing unwanted objects
-      if ( break_objects->count() > 0 )
+      if (current_break->restartObject() != NULL &&
+          current_break->restartObject()->headerOffset() == currentObject->headerOffset())
       {
-        TTBreakObject* current_break = (TTBreakObject*)break_objects->top();
-
-        if ( current_break->stopObject() != NULL &&
-            current_break->stopObject()->headerOffset() == currentObject->headerOffset() )
-        {
-          quint64 adress_delta = current_break->restartObject()->headerOffset()-currentObject->headerOffset();
-          bytesProcessed       = (int)(currentObject->headerOffset()-bufferStartOffset);
-          bytesToWrite        -= adress_delta;
-          bufferStartOffset   += adress_delta;
-          currentObject        = current_break->restartObject(); // hier gehts weiter
-
-          stream_buffer->seekAbsolute(current_break->restartObject()->headerOffset());
-          current_break->setStopObject((TTVideoHeader*)NULL );
+        TTBreakObject* tmpBreak = break_objects->pop();
+        if (ttAssigned(tmpBreak))
+          delete tmpBreak;
+      }
+    }
 
-          objectProcessed = false;
-          continue;
-        }
+    switch(currentObject->headerType())
+    {
+      case TTMpeg2VideoHeader::sequence_start_code:
+         break;
 
+      case TTMpeg2VideoHeader::sequence_end_code: {
+        //remove sequence end code
+        TTBreakObject* new_break = new TTBreakObject();
 
-        if (current_break->restartObject()->headerOffset() == currentObject->headerOffset())
-        {
-          TTBreakObject* tmpBreak = break_objects->pop();
-          if (ttAssigned(tmpBreak))
-            delete tmpBreak;
-        }
+        new_break->setStopObject(currentObject);
+        new_break->setRestartObject(header_list->getNextHeader(currentObject));
+        break_objects->push( new_break );
+        isContinue = true;
       }
+        break;
 
-      switch(currentObject->headerType())
-      {
-        case TTMpeg2VideoHeader::sequence_start_code:
-           break;
-
-        case TTMpeg2VideoHeader::sequence_end_code: {
-          //remove sequence end code
-          TTBreakObject* new_break = new TTBreakObject();
+      case TTMpeg2VideoHeader::group_start_code:
+        {
+          TTPicturesHeader* nextPic = (TTPicturesHeader*)header_list->getNextHeader(
+            currentObject, TTMpeg2VideoHeader::picture_start_code);
 
-          new_break->setStopObject(currentObject);
-          new_break->setRestartObject(header_list->getNextHeader(currentObject));
-          break_objects->push( new_break );
-          isContinue = true;
-        }
-          break;
+        if (closeNextGOP && (ttAssigned(nextPic)) && (nextPic->temporal_reference == 0))
+          closeNextGOP = false;
 
-        case TTMpeg2VideoHeader::group_start_code:
-          {
-            TTPicturesHeader* nextPic = (TTPicturesHeader*)header_list->getNextHeader(
-              currentObject, TTMpeg2VideoHeader::picture_start_code);
+        readHeader(currentObject->headerOffset(), 8);
+        rewriteGOP(header, 8, currentObject->headerOffset(), (TTGOPHeader*)currentObject, closeNextGOP, cr);
+        writeHeader(currentObject->headerOffset(), 8);
+      }
+        break;
 
-          if (closeNextGOP && (ttAssigned(nextPic)) && (nextPic->temporal_reference == 0))
-            closeNextGOP = false;
+      case TTMpeg2VideoHeader::picture_start_code: {
+        TTPicturesHeader* currentPicture = (TTPicturesHeader*)currentObject;
 
-          rewriteGOP(buffer, bufferStartOffset, (TTGOPHeader*)currentObject, closeNextGOP, cr);
-        }
+        if (closeNextGOP       &&
+            tempRefDelta  != 0 &&
+            currentPicture->picture_coding_type == MPEG2_PIC_B)
+        {
+          removeOrphanedBFrames(break_objects, currentObject);
+          closeNextGOP = false;
+          isContinue   = true;
           break;
+        }
 
-        case TTMpeg2VideoHeader::picture_start_code: {
-          TTPicturesHeader* currentPicture = (TTPicturesHeader*)currentObject;
-
-          if (closeNextGOP       &&
-              tempRefDelta  != 0 &&
-              currentPicture->picture_coding_type == MPEG2_PIC_B)
-          {
-            removeOrphanedBFrames(break_objects, currentObject);
-            closeNextGOP = false;
-            isContinue   = true;
-            break;
-            //continue;
-          }
-
-          numPicsWritten++;
-          //log->debugMsg(__FILE__, __LINE__, QString("picture %1 transfered %2").
-          //    arg(numPicsWritten).arg(currentPicture->headerOffset()));
-          cr->setNumPicturesWritten(numPicsWritten);
+        numPicsWritten++;
+        //log->debugMsg(__FILE__, __LINE__, QString("picture %1 transfered %2").
+        //    arg(numPicsWritten).arg(currentPicture->headerOffset()));
+        cr->setNumPicturesWritten(numPicsWritten);
 
-          if (currentPicture->picture_coding_type == MPEG2_PIC_I) {
-            tempRefDelta = (closeNextGOP)
-              ? currentPicture->temporal_reference
-              : 0;
-          }
+        if (currentPicture->picture_coding_type == MPEG2_PIC_I) {
+          tempRefDelta = (closeNextGOP)
+            ? currentPicture->temporal_reference
+            : 0;
+        }
 
-          // M�ssen neue tempor�rere Referenzen geschrieben werden?
-          if ( tempRefDelta != 0)
-          {
-            rewriteTempRefData(buffer, currentPicture, bufferStartOffset, tempRefDelta);
-          }
+        // M�ssen neue tempor�rere Referenzen geschrieben werden?
+        if ( tempRefDelta != 0)
+        {
+          readHeader(currentPicture->headerOffset(), 6);
+          rewriteTempRefData(header, 6, currentPicture, currentPicture->headerOffset(), tempRefDelta);
+          writeHeader(currentPicture->headerOffset(), 6);
         }
-          break;
       }
-
-      if (isContinue)
-        continue;
-
-
-      if (currentObject == endObject) {
         break;
-      }
-
-      currentObject = header_list->getNextHeader(currentObject);
-
-     }while(objectProcessed);
-
-    cr->getTargetStreamBuffer()->directWrite(buffer, bytesProcessed);
+    }
 
-    process           += bytesProcessed;
-    bytesToWrite      -= bytesProcessed;
-    bufferStartOffset += bytesProcessed;
+    // the object becomes the stop object of the break just pushed
+    if (isContinue)
+      continue;
 
-    emit statusReport(StatusReportArgs::Step, tr("Transfer objects"), process);
-    qApp->processEvents();
+    if (currentObject == endObject) {
+      break;
+    }
 
+    currentObject = header_list->getNextHeader(currentObject);
   }
 
+  copyRange(endOffset);
+
   emit statusReport(StatusReportArgs::Finished, tr("Transfer complete"), process);
   qApp->processEvents();
 
@@ -755,7 +889,7 @@ void TTMpeg2VideoStream::removeOrphanedBFrames(QStack<TTBreakObject*>* breakObje
 /*! /////////////////////////////////////////////////////////////////////////////
  * Rewrites the time codes in GOP header
  */
-void TTMpeg2VideoStream::rewriteGOP(quint8* buffer, quint64 abs_pos, TTGOPHeader* gop, bool close_gop, TTCutParameter* cr)
+void TTMpeg2VideoStream::rewriteGOP(quint8* buffer, int bufferLength, quint64 abs_pos, TTGOPHeader* gop, bool close_gop, TTCutParameter* cr)
 {
   if (abs_pos > gop->headerOffset()) {
     log->errorMsg(__FILE__, __LINE__, "buffer position is invalid in rewrite GOP!!!");
@@ -763,7 +897,7 @@ void TTMpeg2VideoStream::rewriteGOP(quint8* buffer, quint64 abs_pos, TTGOPHeader
   }
 
   int idx = (int)(gop->headerOffset() - abs_pos);
-  if (idx < 0 || idx + 7 >= 262144) {
+  if (idx < 0 || idx + 7 >= bufferLength) {
     log->errorMsg(__FILE__, __LINE__, "GOP time code index out of buffer bounds!");
     return;
   }
@@ -791,7 +925,7 @@ void TTMpeg2VideoStream::rewriteGOP(quint8* buffer, quint64 abs_pos, TTGOPHeader
 /* /////////////////////////////////////////////////////////////////////////////
  * Rewrite temporal references
  */
-void TTMpeg2VideoStream::rewriteTempRefData(quint8* buffer, TTPicturesHeader* currentPicture, quint64 bufferStartOffset, int tempRefDelta)
+void TTMpeg2VideoStream::rewriteTempRefData(quint8* buffer, int bufferLength, TTPicturesHeader* currentPicture, quint64 bufferStartOffset, int tempRefDelta)
 {
   // Bounds-check before computing offset: a malformed picture-header offset
   // smaller than bufferStartOffset would underflow the unsigned subtraction
@@ -804,7 +938,7 @@ void TTMpeg2VideoStream::rewriteTempRefData(quint8* buffer, TTPicturesHeader* cu
   qint16 newTempRef = (qint16)(currentPicture->temporal_reference-tempRefDelta);
   int    offset     = (int)(currentPicture->headerOffset()-bufferStartOffset)+4; // Hier rein damit!
 
-  if (offset < 0 || offset + 1 >= 262144) {
+  if (offset < 0 || offset + 1 >= bufferLength) {
     log->errorMsg(__FILE__, __LINE__, "temporal-ref index out of buffer bounds!");
     return;
   }
@@ -35,13 +35,16 @@
 #include "../common/ttmessagelogger.h"
 #include "../extern/tttranscode.h"
 
+#include <QAtomicInteger>
 #include <QList>
 #include <QString>
 #include <QFileInfo>
 #include <QStack>
+#include <QVector>
 
 class TTAudioList;
 class TTCutList;
+class TTMpeg2HeaderScanner;
 
 // -----------------------------------------------------------------------------
 // TTMpeg2VideoStream
@@ -58,6 +61,11 @@ class TTMpeg2VideoStream : public TTVideoStream
     virtual int createHeaderList();
     virtual int createIndexList();
 
+    // Threads for the header scan (0: the search worker count, 1: serial)
+    // and the smallest partition worth a thread of its own
+    void setHeaderScanWorkers(int workers, qint64 minPartitionSize = 64*1024*1024)
+    { mHeaderScanWorkers = workers; mMinScanPartition = minPartitionSize; }
+
     virtual TTAVTypes::AVStreamType streamType() const;
 
     // Field-picture extra indices: second field of each top/bottom pair.
@@ -75,9 +83,9 @@ class TTMpeg2VideoStream : public TTVideoStream
     void transferCutObjects(TTVideoHeader* startObject, TTVideoHeader* endObject, TTCutParameter* cutParams);
     void writeSequenceEndHeader();
 
-    void rewriteGOP(quint8* buffer, quint64 absPos, TTGOPHeader* gop, bool closeGOP, TTCutParameter* cr);
+    void rewriteGOP(quint8* buffer, int bufferLength, quint64 absPos, TTGOPHeader* gop, bool closeGOP, TTCutParameter* cr);
     void removeOrphanedBFrames(QStack<TTBreakObject*>* breakObjects, TTVideoHeader* currentObject);
-    void rewriteTempRefData(quint8* buffer, TTPicturesHeader* currentPicture, quint64 bufferStartOffset, int tempRefDelta);
+    void rewriteTempRefData(quint8* buffer, int bufferLength, TTPicturesHeader* currentPicture, quint64 bufferStartOffset, int tempRefDelta);
     void encodePart( int start, int end, TTCutParameter* cr);
 
     //Test!
@@ -90,7 +98,14 @@ class TTMpeg2VideoStream : public TTVideoStream
     // log is inherited from TTAVStream — do not redeclare here.
 
   private:
+    QVector<qint64> headerScanSeams(TTMpeg2HeaderScanner& scanner, int partitions);
+    bool            scanPartitions(const QVector<qint64>& seams);
+    bool            scanHeaderRange(qint64 begin, qint64 end, TTVideoHeaderList* list,
+                                    qint64& endPos, QAtomicInteger<qint64>& scanned, QAtomicInt& headers);
+
     QList<int> mExtraIndices;
+    int        mHeaderScanWorkers;
+    qint64     mMinScanPartition;
 };
 
 #endif //TTMPEG2VIDEOSTREAM_H
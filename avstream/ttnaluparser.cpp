@@ -8,19 +8,158 @@
 /*----------------------------------------------------------------------------*/
 
 #include "ttnaluparser.h"
+#include "ttstartcodescanner.h"
+#include "ttstreamindexcache.h"
 
 #include "../common/ttmessagelogger.h"
 #include "../common/ttsettings.h"
 
 #include <QDebug>
 #include <QFileInfo>
+#include <QRunnable>
+#include <QSemaphore>
 #include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
 #include <algorithm>
+#include <atomic>
 
 // Start code patterns
 static const uint8_t START_CODE_3[3] = {0x00, 0x00, 0x01};
 static const uint8_t START_CODE_4[4] = {0x00, 0x00, 0x00, 0x01};
 
+// Parallel NAL scan: smallest slice of the file worth a worker of its own.
+// Below two of these the thread start-up costs more than it saves.
+static const int64_t PARALLEL_MIN_CHUNK_BYTES = 32LL * 1024 * 1024;
+
+// ----------------------------------------------------------------------------
+// Reset a NAL record for the start code at offset (sizes are set later, once
+// the following start code is known)
+// ----------------------------------------------------------------------------
+static void ttInitNalUnit(TTNalUnit& nal, int64_t offset, int startCodeLen)
+{
+    nal.fileOffset = offset;
+    nal.dataOffset = offset + startCodeLen;
+    nal.size = 0;  // Will be set later
+    nal.dataSize = 0;
+
+    // Initialize flags
+    nal.isKeyframe = false;
+    nal.isIDR = false;
+    nal.isSlice = false;
+    nal.isSPS = false;
+    nal.isPPS = false;
+    nal.isVPS = false;
+    nal.isSEI = false;
+    nal.isFiller = false;
+    nal.isAUD = false;
+
+    nal.sliceType = -1;
+    nal.frameNum = -1;
+    nal.poc = -1;
+    nal.firstMbInSlice = -1;
+    nal.ppsId = -1;
+    nal.isField = false;
+    nal.isBottomField = false;
+}
+
+// ----------------------------------------------------------------------------
+// Packed NAL/AU flags (TTNalHeader::flags, TTAuRecord::flags). A NAL is at
+// most one of slice/SPS/PPS/VPS/SEI/filler/AUD, so that is a 3-bit kind;
+// the start-code length (3 or 4) is one more bit.
+// ----------------------------------------------------------------------------
+enum {
+    NAL_KIND_OTHER = 0,
+    NAL_KIND_SLICE,
+    NAL_KIND_SPS,
+    NAL_KIND_PPS,
+    NAL_KIND_VPS,
+    NAL_KIND_SEI,
+    NAL_KIND_FILLER,
+    NAL_KIND_AUD,
+    NAL_KIND_MASK            = 0x07,
+
+    NAL_FLAG_KEYFRAME        = 0x08,
+    NAL_FLAG_IDR             = 0x10,
+    NAL_FLAG_FIELD           = 0x20,
+    NAL_FLAG_BOTTOM_FIELD    = 0x40,
+    NAL_FLAG_LONG_START_CODE = 0x80
+};
+
+enum {
+    AU_FLAG_KEYFRAME     = 0x01,
+    AU_FLAG_IDR          = 0x02,
+    AU_FLAG_FIELD_CODED  = 0x04
+};
+
+static inline int ttNalKind(const TTNalHeader& h)
+{
+    return h.flags & NAL_KIND_MASK;
+}
+
+// ----------------------------------------------------------------------------
+// TTNalUnit -> TTNalHeader (offsets and sizes are not part of the header)
+// ----------------------------------------------------------------------------
+static TTNalHeader ttPackNalHeader(const TTNalUnit& nal)
+{
+    TTNalHeader h;
+    h.sliceType      = nal.sliceType;
+    h.frameNum       = nal.frameNum;
+    h.firstMbInSlice = nal.firstMbInSlice;
+    h.ppsId          = nal.ppsId;
+    h.type           = nal.type;
+    h.refIdc         = nal.refIdc;
+    h.temporalId     = nal.temporalId;
+
+    int kind = nal.isSlice  ? NAL_KIND_SLICE
+             : nal.isSPS    ? NAL_KIND_SPS
+             : nal.isPPS    ? NAL_KIND_PPS
+             : nal.isVPS    ? NAL_KIND_VPS
+             : nal.isSEI    ? NAL_KIND_SEI
+             : nal.isFiller ? NAL_KIND_FILLER
+             : nal.isAUD    ? NAL_KIND_AUD
+             : NAL_KIND_OTHER;
+    h.flags = static_cast<uint8_t>(kind
+            | (nal.isKeyframe    ? NAL_FLAG_KEYFRAME : 0)
+            | (nal.isIDR         ? NAL_FLAG_IDR : 0)
+            | (nal.isField       ? NAL_FLAG_FIELD : 0)
+            | (nal.isBottomField ? NAL_FLAG_BOTTOM_FIELD : 0)
+            | ((nal.dataOffset - nal.fileOffset == 4) ? NAL_FLAG_LONG_START_CODE : 0));
+    return h;
+}
+
+// ----------------------------------------------------------------------------
+// TTNalHeader + start-code offset -> TTNalUnit (size/dataSize left at 0)
+// ----------------------------------------------------------------------------
+static void ttUnpackNalHeader(const TTNalHeader& h, int64_t offset, TTNalUnit& nal)
+{
+    ttInitNalUnit(nal, offset, (h.flags & NAL_FLAG_LONG_START_CODE) ? 4 : 3);
+
+    nal.type       = h.type;
+    nal.refIdc     = h.refIdc;
+    nal.temporalId = h.temporalId;
+
+    const int kind = ttNalKind(h);
+    nal.isSlice  = (kind == NAL_KIND_SLICE);
+    nal.isSPS    = (kind == NAL_KIND_SPS);
+    nal.isPPS    = (kind == NAL_KIND_PPS);
+    nal.isVPS    = (kind == NAL_KIND_VPS);
+    nal.isSEI    = (kind == NAL_KIND_SEI);
+    nal.isFiller = (kind == NAL_KIND_FILLER);
+    nal.isAUD    = (kind == NAL_KIND_AUD);
+
+    nal.isKeyframe    = (h.flags & NAL_FLAG_KEYFRAME) != 0;
+    nal.isIDR         = (h.flags & NAL_FLAG_IDR) != 0;
+    nal.isField       = (h.flags & NAL_FLAG_FIELD) != 0;
+    nal.isBottomField = (h.flags & NAL_FLAG_BOTTOM_FIELD) != 0;
+
+    nal.sliceType      = h.sliceType;
+    nal.frameNum       = h.frameNum;
+    nal.firstMbInSlice = h.firstMbInSlice;
+    nal.ppsId          = h.ppsId;
+}
+
 // ----------------------------------------------------------------------------
 // Constructor
 // ----------------------------------------------------------------------------
@@ -29,6 +168,7 @@ TTNaluParser::TTNaluParser()
     , mCodecType(NALU_CODEC_UNKNOWN)
     , mMappedFile(nullptr)
     , mIsPAFF(false)
+    , mParseThreads(0)
 {
 }
 
@@ -87,7 +227,8 @@ void TTNaluParser::closeFile()
         mFile.close();
     }
 
-    mNalUnits.clear();
+    mNalOffsets.clear();
+    mNalHeaders.clear();
     mAccessUnits.clear();
     mGops.clear();
     mSPSList.clear();
@@ -185,19 +326,227 @@ bool TTNaluParser::parseFile()
         return false;
     }
 
-    mNalUnits.clear();
+    mNalOffsets.clear();
+    mNalHeaders.clear();
     mAccessUnits.clear();
     mGops.clear();
     mSPSList.clear();
     mPPSList.clear();
     mVPSList.clear();
 
+    if (loadIndexCache()) {
+        mapFile();
+        if (TTSettings::instance()->logAVStream())
+            qDebug() << "TTNaluParser: Index loaded from sidecar:" << mNalOffsets.size() << "NAL units,"
+                     << mAccessUnits.size() << "access units," << mGops.size() << "GOPs";
+        return true;
+    }
+
     if (TTSettings::instance()->logAVStream())
         qDebug() << "TTNaluParser: Parsing file...";
 
-    // Find all NAL units
+    // Find all NAL units. Both paths produce the identical NAL list, SPS/
+    // PPS/VPS lists and SPS/PPS maps; the parallel one needs the mapping.
     mFile.seek(0);
 
+    const int chunks = parallelChunkCount();
+    const bool found = (chunks > 1) ? scanNalUnitsParallel(chunks) : scanNalUnitsSerial();
+    if (!found) {
+        return false;
+    }
+    const int nalCount = mNalOffsets.size();
+
+    if (TTSettings::instance()->logAVStream()) {
+        qDebug() << "  NAL units found:" << nalCount;
+        qDebug() << "  SPS:" << mSPSList.size() << ", PPS:" << mPPSList.size() << "(before dedup)";
+    }
+
+    // Deduplicate parameter sets (now that all NAL sizes are set)
+    deduplicateList(mSPSList);
+    deduplicateList(mPPSList);
+    deduplicateList(mVPSList);
+
+    if (TTSettings::instance()->logAVStream())
+        qDebug() << "  SPS:" << mSPSList.size() << "(unique), PPS:" << mPPSList.size() << "(unique)";
+    if (mCodecType == NALU_CODEC_H265) {
+        if (TTSettings::instance()->logAVStream())
+            qDebug() << "  VPS:" << mVPSList.size() << "(unique)";
+    }
+
+    // Build access units (group NALs into frames)
+    buildAccessUnits();
+
+    // Build GOP structure
+    buildGOPs();
+
+    // The tables are complete: drop their append growth slack
+    mNalOffsets.squeeze();
+    mNalHeaders.squeeze();
+    mAccessUnits.squeeze();
+
+    if (TTSettings::instance()->logAVStream()) {
+        qDebug() << "TTNaluParser: Parsing complete";
+        qDebug() << "  Access Units (frames):" << mAccessUnits.size();
+        qDebug() << "  GOPs:" << mGops.size();
+        qDebug() << "  Index memory:" << (indexMemoryBytes() / 1024) << "KB"
+                 << "(unpacked layout:" << (unpackedIndexMemoryBytes() / 1024) << "KB)";
+    }
+
+    storeIndexCache();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Index sidecar: the packed tables are stored as-is, parameter-set state as
+// flat arrays. NMET carries the record sizes so a layout change in one of
+// the structs reads as a stale sidecar rather than as garbage.
+// ----------------------------------------------------------------------------
+static const uint32_t kNalMetaTag    = TTStreamIndexCache::tag("NMET");
+static const uint32_t kNalOffsetsTag = TTStreamIndexCache::tag("NALO");
+static const uint32_t kNalHeadersTag = TTStreamIndexCache::tag("NALH");
+static const uint32_t kAuTableTag    = TTStreamIndexCache::tag("AUTB");
+static const uint32_t kGopTableTag   = TTStreamIndexCache::tag("GOPT");
+static const uint32_t kSpsListTag    = TTStreamIndexCache::tag("NSPS");
+static const uint32_t kPpsListTag    = TTStreamIndexCache::tag("NPPS");
+static const uint32_t kVpsListTag    = TTStreamIndexCache::tag("NVPS");
+static const uint32_t kSpsInfoTag    = TTStreamIndexCache::tag("NSPI");
+static const uint32_t kPpsToSpsTag   = TTStreamIndexCache::tag("NPPM");
+
+enum { kNalMetaCodec, kNalMetaPAFF, kNalMetaHeaderSize, kNalMetaAuSize,
+       kNalMetaGopSize, kNalMetaSpsInfoSize, kNalMetaCount };
+
+bool TTNaluParser::loadIndexCache()
+{
+    TTStreamIndexCache cache(mFilePath);
+    if (!cache.load()) return false;
+
+    QVector<int32_t> meta;
+    if (!cache.readArray(kNalMetaTag, meta) || meta.size() != kNalMetaCount
+        || meta[kNalMetaCodec] != int32_t(mCodecType)
+        || meta[kNalMetaHeaderSize] != int32_t(sizeof(TTNalHeader))
+        || meta[kNalMetaAuSize] != int32_t(sizeof(TTAuRecord))
+        || meta[kNalMetaGopSize] != int32_t(sizeof(TTGopInfo))
+        || meta[kNalMetaSpsInfoSize] != int32_t(sizeof(TTSpsInfo)))
+        return false;
+
+    QVector<TTSpsInfo> spsInfo;
+    QVector<int32_t> ppsToSps;
+    const bool ok = cache.readArray(kNalOffsetsTag, mNalOffsets)
+                 && cache.readArray(kNalHeadersTag, mNalHeaders)
+                 && cache.readArray(kAuTableTag, mAccessUnits)
+                 && cache.readArray(kGopTableTag, mGops)
+                 && cache.readArray(kSpsListTag, mSPSList)
+                 && cache.readArray(kPpsListTag, mPPSList)
+                 && cache.readArray(kVpsListTag, mVPSList)
+                 && cache.readArray(kSpsInfoTag, spsInfo)
+                 && cache.readArray(kPpsToSpsTag, ppsToSps)
+                 && mNalOffsets.size() == mNalHeaders.size()
+                 && ppsToSps.size() % 2 == 0;
+    if (!ok) {
+        mNalOffsets.clear();
+        mNalHeaders.clear();
+        mAccessUnits.clear();
+        mGops.clear();
+        mSPSList.clear();
+        mPPSList.clear();
+        mVPSList.clear();
+        return false;
+    }
+
+    mSpsInfoMap.clear();
+    for (const TTSpsInfo& info : spsInfo)
+        mSpsInfoMap.insert(info.spsId, info);
+    mPpsToSpsMap.clear();
+    for (int i = 0; i < ppsToSps.size(); i += 2)
+        mPpsToSpsMap.insert(ppsToSps[i], ppsToSps[i + 1]);
+    mIsPAFF = meta[kNalMetaPAFF] != 0;
+    return true;
+}
+
+void TTNaluParser::storeIndexCache()
+{
+    if (!TTStreamIndexCache::isEnabled() || mNalOffsets.isEmpty()) return;
+
+    QVector<int32_t> meta(kNalMetaCount);
+    meta[kNalMetaCodec]       = int32_t(mCodecType);
+    meta[kNalMetaPAFF]        = mIsPAFF ? 1 : 0;
+    meta[kNalMetaHeaderSize]  = int32_t(sizeof(TTNalHeader));
+    meta[kNalMetaAuSize]      = int32_t(sizeof(TTAuRecord));
+    meta[kNalMetaGopSize]     = int32_t(sizeof(TTGopInfo));
+    meta[kNalMetaSpsInfoSize] = int32_t(sizeof(TTSpsInfo));
+
+    QVector<TTSpsInfo> spsInfo;
+    for (const TTSpsInfo& info : mSpsInfoMap)
+        spsInfo.append(info);
+    QVector<int32_t> ppsToSps;
+    for (auto it = mPpsToSpsMap.constBegin(); it != mPpsToSpsMap.constEnd(); ++it)
+        ppsToSps << it.key() << it.value();
+
+    TTStreamIndexCache cache(mFilePath);
+    cache.setArray(kNalMetaTag, meta);
+    cache.setArray(kNalOffsetsTag, mNalOffsets);
+    cache.setArray(kNalHeadersTag, mNalHeaders);
+    cache.setArray(kAuTableTag, mAccessUnits);
+    cache.setArray(kGopTableTag, mGops);
+    cache.setArray(kSpsListTag, mSPSList);
+    cache.setArray(kPpsListTag, mPPSList);
+    cache.setArray(kVpsListTag, mVPSList);
+    cache.setArray(kSpsInfoTag, spsInfo);
+    cache.setArray(kPpsToSpsTag, ppsToSps);
+    cache.save();
+}
+
+// ----------------------------------------------------------------------------
+// Index hand-over between parsers of the same file
+// ----------------------------------------------------------------------------
+TTNaluIndex TTNaluParser::index() const
+{
+    TTNaluIndex idx;
+    idx.codecType   = mCodecType;
+    idx.fileSize    = mFileSize;
+    idx.isPAFF      = mIsPAFF;
+    idx.nalOffsets  = mNalOffsets;
+    idx.nalHeaders  = mNalHeaders;
+    idx.accessUnits = mAccessUnits;
+    idx.gops        = mGops;
+    idx.spsList     = mSPSList;
+    idx.ppsList     = mPPSList;
+    idx.vpsList     = mVPSList;
+    idx.spsInfoMap  = mSpsInfoMap;
+    idx.ppsToSpsMap = mPpsToSpsMap;
+    return idx;
+}
+
+bool TTNaluParser::adoptIndex(const TTNaluIndex& index)
+{
+    if (!mFile.isOpen() || index.isEmpty()
+        || index.codecType != mCodecType || index.fileSize != mFileSize)
+        return false;
+
+    mNalOffsets  = index.nalOffsets;
+    mNalHeaders  = index.nalHeaders;
+    mAccessUnits = index.accessUnits;
+    mGops        = index.gops;
+    mSPSList     = index.spsList;
+    mPPSList     = index.ppsList;
+    mVPSList     = index.vpsList;
+    mSpsInfoMap  = index.spsInfoMap;
+    mPpsToSpsMap = index.ppsToSpsMap;
+    mIsPAFF      = index.isPAFF;
+    mapFile();
+
+    if (TTSettings::instance()->logAVStream())
+        qDebug() << "TTNaluParser: Adopted index:" << mNalOffsets.size() << "NAL units,"
+                 << mAccessUnits.size() << "access units," << mGops.size() << "GOPs";
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Serial NAL scan: one start code at a time, SPS/PPS parsed as they appear.
+// Used for small files, the unmapped fallback and setParseThreadCount(1).
+// ----------------------------------------------------------------------------
+bool TTNaluParser::scanNalUnitsSerial()
+{
     int64_t currentPos = 0;
     int64_t startCodePos = 0;
     int startCodeLen = 0;
@@ -217,38 +566,32 @@ bool TTNaluParser::parseFile()
             break;  // No more start codes
         }
 
-        // If we have a previous NAL unit, set its size
-        if (nalCount > 0) {
-            TTNalUnit& prevNal = mNalUnits[nalCount - 1];
-            prevNal.size = startCodePos - prevNal.fileOffset;
-            prevNal.dataSize = prevNal.size - (prevNal.dataOffset - prevNal.fileOffset);
-        }
-
-        // Parse this NAL unit
+        // Parse this NAL unit (its size is implied by the next start code)
         TTNalUnit nal;
         if (parseNalUnit(startCodePos, startCodeLen, nal)) {
-            mNalUnits.append(nal);
+            mNalOffsets.append(nal.fileOffset);
+            mNalHeaders.append(ttPackNalHeader(nal));
             nalCount++;
 
             // Track parameter sets (deduplicated after parse loop when sizes are set)
             if (nal.isSPS) {
                 mSPSList.append(nalCount - 1);
                 // Parse SPS for PAFF detection (H.264 only)
-                // Note: nal.dataSize may be 0 here (set when next NAL is found),
-                // so we read a fixed amount from dataOffset directly
+                // Note: the NAL's end is not known yet (next start code),
+                // so we take a fixed-size span from dataOffset directly
                 if (mCodecType == NALU_CODEC_H264) {
-                    mFile.seek(nal.dataOffset);
-                    QByteArray spsData = mFile.read(512);
-                    parseH264SpsData(spsData);
+                    int spsLen = 0;
+                    const uint8_t* spsData = bytesAt(nal.dataOffset, 512, spsLen);
+                    parseH264SpsData(spsData, spsLen);
                 }
             }
             if (nal.isPPS) {
                 mPPSList.append(nalCount - 1);
                 // Parse PPS for PPS->SPS mapping (H.264 only)
                 if (mCodecType == NALU_CODEC_H264) {
-                    mFile.seek(nal.dataOffset);
-                    QByteArray ppsData = mFile.read(64);
-                    parseH264PpsData(ppsData);
+                    int ppsLen = 0;
+                    const uint8_t* ppsData = bytesAt(nal.dataOffset, 64, ppsLen);
+                    parseH264PpsData(ppsData, ppsLen);
                 }
             }
             if (nal.isVPS) mVPSList.append(nalCount - 1);
@@ -263,40 +606,260 @@ bool TTNaluParser::parseFile()
         currentPos = startCodePos + startCodeLen;
     }
 
-    // Set size of last NAL unit
-    if (nalCount > 0) {
-        TTNalUnit& lastNal = mNalUnits[nalCount - 1];
-        lastNal.size = mFileSize - lastNal.fileOffset;
-        lastNal.dataSize = lastNal.size - (lastNal.dataOffset - lastNal.fileOffset);
-    }
+    return true;
+}
 
-    if (TTSettings::instance()->logAVStream()) {
-        qDebug() << "  NAL units found:" << nalCount;
-        qDebug() << "  SPS:" << mSPSList.size() << ", PPS:" << mPPSList.size() << "(before dedup)";
-    }
+// ----------------------------------------------------------------------------
+// Map the entire file (stays mapped until closeFile()). False if the mapping
+// failed; callers fall back to chunked reads.
+// ----------------------------------------------------------------------------
+bool TTNaluParser::mapFile()
+{
+    if (mMappedFile) return true;
+    if (mFileSize <= 0) return false;
 
-    // Deduplicate parameter sets (now that all NAL sizes are set)
-    deduplicateList(mSPSList);
-    deduplicateList(mPPSList);
-    deduplicateList(mVPSList);
+    mMappedFile = mFile.map(0, mFileSize);
+    if (!mMappedFile) return false;
 
     if (TTSettings::instance()->logAVStream())
-        qDebug() << "  SPS:" << mSPSList.size() << "(unique), PPS:" << mPPSList.size() << "(unique)";
-    if (mCodecType == NALU_CODEC_H265) {
-        if (TTSettings::instance()->logAVStream())
-            qDebug() << "  VPS:" << mVPSList.size() << "(unique)";
-    }
+        qDebug() << "TTNaluParser: Mapped entire file to memory (" << (mFileSize / (1024*1024)) << "MB),"
+                 << "start-code scan:" << TTStartCodeScanner::implName(TTStartCodeScanner::activeImpl());
+    return true;
+}
 
-    // Build access units (group NALs into frames)
-    buildAccessUnits();
+// ----------------------------------------------------------------------------
+// Number of scan chunks parseFile() should use; <= 1 selects the serial scan
+// ----------------------------------------------------------------------------
+int TTNaluParser::parallelChunkCount()
+{
+    int threads = (mParseThreads > 0) ? mParseThreads : QThread::idealThreadCount();
+    if (threads <= 1) return 1;
 
-    // Build GOP structure
-    buildGOPs();
+    int64_t bySize = mFileSize / PARALLEL_MIN_CHUNK_BYTES;
+    if (bySize < 2) return 1;
 
-    if (TTSettings::instance()->logAVStream()) {
-        qDebug() << "TTNaluParser: Parsing complete";
-        qDebug() << "  Access Units (frames):" << mAccessUnits.size();
-        qDebug() << "  GOPs:" << mGops.size();
+    // The chunk workers read straight from the mapping
+    if (!mapFile()) return 1;
+
+    return static_cast<int>(qMin<int64_t>(threads, bySize));
+}
+
+// ----------------------------------------------------------------------------
+// Parallel NAL scan over the mapped file.
+//
+// Start-code prefixes (00 00 01) can never overlap, so the serial scan finds
+// exactly every prefix in the file; splitting the file at arbitrary byte
+// boundaries and letting chunk k own the prefixes that START inside it is
+// therefore an exact partition. Three phases:
+//   1. (parallel) each chunk scans its prefixes and parses the NAL headers.
+//      H.265 slice headers need no parameter-set state and are finished
+//      here; H.264 slice headers are left for phase 3.
+//   2. (serial, cheap) stitch the chunk columns, collect SPS/PPS/VPS in
+//      file order and build the SPS/PPS maps exactly as the
+//      serial scan would, snapshotting them at each chunk start.
+//   3. (parallel, H.264 only) each chunk replays its SPS/PPS on a copy of
+//      its snapshot and finishes its slice headers.
+// The abort callback is polled on the calling thread only (it may not be
+// thread-safe); workers see an atomic flag.
+// ----------------------------------------------------------------------------
+bool TTNaluParser::scanNalUnitsParallel(int chunkCount)
+{
+    const bool log = TTSettings::instance()->logAVStream();
+    const uchar* base = mMappedFile;
+    const int64_t fileSize = mFileSize;
+    const TTNaluCodecType codec = mCodecType;
+
+    if (log)
+        qDebug() << "  Parallel NAL scan:" << chunkCount << "chunks";
+
+    QVector<int64_t> bounds(chunkCount + 1);
+    for (int k = 0; k <= chunkCount; ++k)
+        bounds[k] = fileSize * k / chunkCount;
+
+    QVector<QVector<int64_t>> chunkOffsets(chunkCount);
+    QVector<QVector<TTNalHeader>> chunkHeaders(chunkCount);
+    // Workers index these through raw pointers only: a non-const QVector
+    // operator[] from several threads would race on the detach check.
+    const int64_t* chunkBounds = bounds.constData();
+    QVector<int64_t>* offsetsOut = chunkOffsets.data();
+    QVector<TTNalHeader>* headersOut = chunkHeaders.data();
+    std::atomic<bool> stop(false);
+    std::atomic<int64_t> nalsFound(0);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(chunkCount);
+
+    // Runs count jobs on the local pool, polling the abort callback on this
+    // thread while they work. False if the user aborted.
+    auto runChunks = [&](int count, const std::function<void(int)>& job) -> bool {
+        QSemaphore done(0);
+        for (int k = 0; k < count; ++k) {
+            auto* runnable = QRunnable::create([&, k]() {
+                job(k);
+                done.release(1);
+            });
+            runnable->setAutoDelete(true);
+            pool.start(runnable);
+        }
+        int64_t nextLog = 10000;
+        while (!done.tryAcquire(count, 50)) {
+            if (!stop.load(std::memory_order_relaxed) && mAbortCallback && mAbortCallback())
+                stop.store(true, std::memory_order_relaxed);
+            if (log) {
+                int64_t n = nalsFound.load(std::memory_order_relaxed);
+                if (n >= nextLog) {
+                    qDebug() << "  Parsed" << n << "NAL units...";
+                    nextLog = (n / 10000 + 1) * 10000;
+                }
+            }
+        }
+        if (!stop.load(std::memory_order_relaxed) && mAbortCallback && mAbortCallback())
+            stop.store(true, std::memory_order_relaxed);
+        return !stop.load(std::memory_order_relaxed);
+    };
+
+    // Phase 1: scan + NAL headers
+    bool ok = runChunks(chunkCount, [&](int k) {
+        QVector<int64_t>& offsets = offsetsOut[k];
+        QVector<TTNalHeader>& out = headersOut[k];
+        const int expected = static_cast<int>((chunkBounds[k + 1] - chunkBounds[k]) / 2048) + 16;
+        offsets.reserve(expected);
+        out.reserve(expected);
+
+        // Prefixes starting in [bounds[k], bounds[k+1]); the scanner bound
+        // (fileSize - 3) is the same one findNextStartCode() uses.
+        const int64_t end = qMin(chunkBounds[k + 1], fileSize - 3);
+        int64_t pos = chunkBounds[k];
+        while (pos < end) {
+            if ((out.size() & 4095) == 0 && stop.load(std::memory_order_relaxed))
+                return;
+
+            int64_t i = TTStartCodeScanner::findPrefix(base, pos, end);
+            if (i < 0) break;
+
+            int64_t codePos = i;
+            int codeLen = 3;
+            if (i > 0 && base[i-1] == 0) {
+                codePos = i - 1;
+                codeLen = 4;
+            }
+
+            TTNalUnit nal;
+            ttInitNalUnit(nal, codePos, codeLen);
+            const int len = static_cast<int>(qMin<int64_t>(128, fileSize - nal.dataOffset));
+            const uint8_t* header = base + nal.dataOffset;
+            bool parsed = (codec == NALU_CODEC_H264) ? parseH264NalHeader(header, len, nal)
+                        : (codec == NALU_CODEC_H265) ? parseH265NalUnit(header, len, nal)
+                        : false;
+            if (parsed) {
+                offsets.append(nal.fileOffset);
+                out.append(ttPackNalHeader(nal));
+                if ((out.size() & 1023) == 0)
+                    nalsFound.fetch_add(1024, std::memory_order_relaxed);
+            }
+
+            pos = codePos + codeLen;
+        }
+    });
+    if (!ok) {
+        mLastError = "aborted by user";  // not setError(), see scanNalUnitsSerial()
+        return false;
+    }
+
+    // Phase 2: stitch, parameter sets and per-chunk SPS/PPS snapshots
+    int total = 0;
+    for (const QVector<int64_t>& c : chunkOffsets) total += c.size();
+    mNalOffsets.reserve(total);
+    mNalHeaders.reserve(total);
+
+    QVector<int> chunkFirstNal(chunkCount + 1);
+    QVector<QMap<int, TTSpsInfo>> spsSnapshot(chunkCount);
+    QVector<QMap<int, int>> ppsSnapshot(chunkCount);
+
+    for (int k = 0; k < chunkCount; ++k) {
+        chunkFirstNal[k] = mNalOffsets.size();
+        spsSnapshot[k] = mSpsInfoMap;     // implicitly shared, copied on write
+        ppsSnapshot[k] = mPpsToSpsMap;
+
+        const QVector<int64_t>& offsets = chunkOffsets[k];
+        const QVector<TTNalHeader>& headers = chunkHeaders[k];
+        for (int n = 0; n < headers.size(); ++n) {
+            const int idx = mNalOffsets.size();
+            const TTNalHeader& h = headers[n];
+            const int64_t dataOffset = offsets[n] + ((h.flags & NAL_FLAG_LONG_START_CODE) ? 4 : 3);
+            mNalOffsets.append(offsets[n]);
+            mNalHeaders.append(h);
+
+            if (ttNalKind(h) == NAL_KIND_SPS) {
+                mSPSList.append(idx);
+                if (codec == NALU_CODEC_H264) {
+                    int spsLen = 0;
+                    const uint8_t* spsData = bytesAt(dataOffset, 512, spsLen);
+                    parseH264SpsData(spsData, spsLen);
+                }
+            }
+            if (ttNalKind(h) == NAL_KIND_PPS) {
+                mPPSList.append(idx);
+                if (codec == NALU_CODEC_H264) {
+                    int ppsLen = 0;
+                    const uint8_t* ppsData = bytesAt(dataOffset, 64, ppsLen);
+                    parseH264PpsData(ppsData, ppsLen);
+                }
+            }
+            if (ttNalKind(h) == NAL_KIND_VPS) mVPSList.append(idx);
+        }
+        chunkOffsets[k].clear();
+        chunkOffsets[k].squeeze();
+        chunkHeaders[k].clear();
+        chunkHeaders[k].squeeze();
+    }
+    chunkFirstNal[chunkCount] = mNalOffsets.size();
+
+    if (codec != NALU_CODEC_H264)
+        return true;
+
+    // Phase 3: H.264 slice headers against the SPS/PPS state of their position
+    const int64_t* nalOffsets = mNalOffsets.constData();
+    TTNalHeader* nalHeaders = mNalHeaders.data();
+    const int* firstNal = chunkFirstNal.constData();
+    const QMap<int, TTSpsInfo>* spsStart = spsSnapshot.constData();
+    const QMap<int, int>* ppsStart = ppsSnapshot.constData();
+    ok = runChunks(chunkCount, [&](int k) {
+        QMap<int, TTSpsInfo> spsInfo = spsStart[k];
+        QMap<int, int> ppsToSps = ppsStart[k];
+        QByteArray rbsp;
+
+        for (int idx = firstNal[k]; idx < firstNal[k + 1]; ++idx) {
+            if (((idx - firstNal[k]) & 4095) == 0 && stop.load(std::memory_order_relaxed))
+                return;
+
+            TTNalHeader& h = nalHeaders[idx];
+            const int kind = ttNalKind(h);
+            const int64_t dataOffset = nalOffsets[idx] + ((h.flags & NAL_FLAG_LONG_START_CODE) ? 4 : 3);
+            const uint8_t* data = base + dataOffset;
+            const int64_t avail = fileSize - dataOffset;
+
+            if (kind == NAL_KIND_SPS) {
+                TTSpsInfo info;
+                if (parseH264Sps(data, static_cast<int>(qMin<int64_t>(512, avail)), rbsp, info))
+                    spsInfo[info.spsId] = info;
+            } else if (kind == NAL_KIND_PPS) {
+                int ppsId = -1;
+                int spsId = -1;
+                if (parseH264Pps(data, static_cast<int>(qMin<int64_t>(64, avail)), ppsId, spsId))
+                    ppsToSps[ppsId] = spsId;
+            } else if (kind == NAL_KIND_SLICE) {
+                TTNalUnit nal;
+                ttUnpackNalHeader(h, nalOffsets[idx], nal);
+                finishH264Slice(data, static_cast<int>(qMin<int64_t>(128, avail)), nal,
+                                spsInfo, ppsToSps);
+                h = ttPackNalHeader(nal);
+            }
+        }
+    });
+    if (!ok) {
+        mLastError = "aborted by user";  // not setError(), see scanNalUnitsSerial()
+        return false;
     }
 
     return true;
@@ -305,15 +868,15 @@ bool TTNaluParser::parseFile()
 // ----------------------------------------------------------------------------
 // Find next start code (0x000001 or 0x00000001)
 // Returns: 0 on success, -1 if no more start codes
-// ULTRA-OPTIMIZED: Memory-maps entire file (you have 96GB RAM!)
+// Memory-maps the entire file on first call; the prefix search itself runs
+// through TTStartCodeScanner (SSE2/AVX2 with scalar fallback) on both the
+// mapped and the chunked fallback path.
 // ----------------------------------------------------------------------------
 int TTNaluParser::findNextStartCode(int64_t startPos, int64_t& codePos, int& codeLen)
 {
     // Map entire file on first call (stays mapped until file is closed)
     if (!mMappedFile) {
-        mMappedFile = mFile.map(0, mFileSize);
-
-        if (!mMappedFile) {
+        if (!mapFile()) {
             TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
                 QString("Could not map entire file, falling back to chunk mode"));
             // Fallback to chunk-based reading
@@ -321,48 +884,64 @@ int TTNaluParser::findNextStartCode(int64_t startPos, int64_t& codePos, int& cod
             QByteArray buffer = mFile.read(qMin((int64_t)(64 * 1024 * 1024), mFileSize - startPos));
             if (buffer.isEmpty()) return -1;
 
-            const char* data = buffer.constData();
-            for (int i = 0; i < buffer.size() - 3; i++) {
-                if (data[i] == 0 && data[i+1] == 0 && data[i+2] == 1) {
-                    if (i > 0 && data[i-1] == 0) {
-                        codePos = startPos + i - 1;
-                        codeLen = 4;
-                    } else {
-                        codePos = startPos + i;
-                        codeLen = 3;
-                    }
-                    return 0;
-                }
-            }
-            return -1;
-        }
-        if (TTSettings::instance()->logAVStream())
-            qDebug() << "TTNaluParser: Mapped entire file to memory (" << (mFileSize / (1024*1024)) << "MB)";
-    }
-
-    // Direct memory search - FAST!
-    const uchar* data = mMappedFile;
-    int64_t end = mFileSize - 3;
-
-    for (int64_t i = startPos; i < end; i++) {
-        // Fast skip: most bytes are not 0
-        if (data[i] != 0) continue;
-
-        // Check for 3-byte start code: 0x000001
-        if (data[i+1] == 0 && data[i+2] == 1) {
-            // Check if it's actually a 4-byte start code: 0x00000001
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.constData());
+            int64_t i = TTStartCodeScanner::findPrefix(data, 0, buffer.size() - 3);
+            if (i < 0) return -1;
             if (i > 0 && data[i-1] == 0) {
-                codePos = i - 1;
+                codePos = startPos + i - 1;
                 codeLen = 4;
             } else {
-                codePos = i;
+                codePos = startPos + i;
                 codeLen = 3;
             }
             return 0;
         }
     }
 
-    return -1;  // No more start codes
+    // Direct memory search, vectorised (see TTStartCodeScanner)
+    const uchar* data = mMappedFile;
+    int64_t i = TTStartCodeScanner::findPrefix(data, startPos, mFileSize - 3);
+    if (i < 0) {
+        return -1;  // No more start codes
+    }
+
+    // Check if it's actually a 4-byte start code: 0x00000001
+    if (i > 0 && data[i-1] == 0) {
+        codePos = i - 1;
+        codeLen = 4;
+    } else {
+        codePos = i;
+        codeLen = 3;
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Span of up to maxLen bytes at offset (clipped at EOF).
+// Zero-copy into the mapping when the file is mapped; otherwise one seek+read
+// into the reused mScratch buffer (unmapped fallback only). The returned
+// pointer stays valid until the next bytesAt() call.
+// ----------------------------------------------------------------------------
+const uint8_t* TTNaluParser::bytesAt(int64_t offset, int maxLen, int& len)
+{
+    len = 0;
+    if (offset < 0 || offset >= mFileSize) return nullptr;
+
+    int64_t avail = mFileSize - offset;
+    int want = static_cast<int>(qMin<int64_t>(maxLen, avail));
+
+    if (mMappedFile) {
+        len = want;
+        return mMappedFile + offset;
+    }
+
+    if (mScratch.size() < maxLen)
+        mScratch.resize(maxLen);
+    if (!mFile.seek(offset)) return nullptr;
+    int64_t got = mFile.read(mScratch.data(), want);
+    if (got <= 0) return nullptr;
+    len = static_cast<int>(got);
+    return reinterpret_cast<const uint8_t*>(mScratch.constData());
 }
 
 // ----------------------------------------------------------------------------
@@ -370,55 +949,45 @@ int TTNaluParser::findNextStartCode(int64_t startPos, int64_t& codePos, int& cod
 // ----------------------------------------------------------------------------
 bool TTNaluParser::parseNalUnit(int64_t offset, int startCodeLen, TTNalUnit& nal)
 {
-    nal.fileOffset = offset;
-    nal.dataOffset = offset + startCodeLen;
-    nal.size = 0;  // Will be set later
-    nal.dataSize = 0;
+    ttInitNalUnit(nal, offset, startCodeLen);
 
-    // Initialize flags
-    nal.isKeyframe = false;
-    nal.isIDR = false;
-    nal.isSlice = false;
-    nal.isSPS = false;
-    nal.isPPS = false;
-    nal.isVPS = false;
-    nal.isSEI = false;
-    nal.isFiller = false;
-    nal.isAUD = false;
+    // NAL header (first 1-2 bytes after start code) plus enough for the
+    // slice header (4K first_mb_in_slice needs >32 bytes)
+    int headerLen = 0;
+    const uint8_t* header = bytesAt(nal.dataOffset, 128, headerLen);
 
-    nal.sliceType = -1;
-    nal.frameNum = -1;
-    nal.poc = -1;
-    nal.firstMbInSlice = -1;
-    nal.ppsId = -1;
-    nal.isField = false;
-    nal.isBottomField = false;
-
-    // Read NAL header (first 1-2 bytes after start code)
-    mFile.seek(nal.dataOffset);
-    QByteArray header = mFile.read(128);  // Read enough for slice header (4K first_mb_in_slice needs >32 bytes)
-
-    if (header.isEmpty()) {
+    if (!header || headerLen <= 0) {
         return false;
     }
 
     if (mCodecType == NALU_CODEC_H264) {
-        return parseH264NalUnit(header, nal);
+        return parseH264NalUnit(header, headerLen, nal);
     } else if (mCodecType == NALU_CODEC_H265) {
-        return parseH265NalUnit(header, nal);
+        return parseH265NalUnit(header, headerLen, nal);
     }
 
     return false;
 }
 
 // ----------------------------------------------------------------------------
-// Parse H.264 NAL unit header
+// Parse H.264 NAL unit: header, then the slice header against the current
+// SPS/PPS state
 // ----------------------------------------------------------------------------
-bool TTNaluParser::parseH264NalUnit(const QByteArray& data, TTNalUnit& nal)
+bool TTNaluParser::parseH264NalUnit(const uint8_t* data, int size, TTNalUnit& nal)
 {
-    if (data.isEmpty()) return false;
+    if (!parseH264NalHeader(data, size, nal)) return false;
+    finishH264Slice(data, size, nal, mSpsInfoMap, mPpsToSpsMap);
+    return true;
+}
 
-    uint8_t firstByte = static_cast<uint8_t>(data[0]);
+// ----------------------------------------------------------------------------
+// Parse H.264 NAL unit header (type classification only, no SPS/PPS state)
+// ----------------------------------------------------------------------------
+bool TTNaluParser::parseH264NalHeader(const uint8_t* data, int size, TTNalUnit& nal)
+{
+    if (!data || size <= 0) return false;
+
+    uint8_t firstByte = data[0];
 
     // H.264 NAL header: forbidden_zero_bit (1) + nal_ref_idc (2) + nal_unit_type (5)
     // int forbiddenBit = (firstByte >> 7) & 0x01;
@@ -453,9 +1022,21 @@ bool TTNaluParser::parseH264NalUnit(const QByteArray& data, TTNalUnit& nal)
             break;
     }
 
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Slice-header part of an H.264 NAL. Needs the SPS/PPS state in effect at
+// this NAL's position in the file, passed explicitly so the parallel scan
+// can finish each chunk against its own snapshot.
+// ----------------------------------------------------------------------------
+void TTNaluParser::finishH264Slice(const uint8_t* data, int size, TTNalUnit& nal,
+                                   const QMap<int, TTSpsInfo>& spsInfo,
+                                   const QMap<int, int>& ppsToSps)
+{
     // Parse slice header for additional info
-    if (nal.isSlice && data.size() > 1) {
-        parseH264SliceHeader(data, nal);
+    if (nal.isSlice && size > 1) {
+        parseH264SliceHeader(data, size, nal, spsInfo, ppsToSps);
 
         // Also mark I-slices as keyframes for GOP detection
         // Many streams use non-IDR I-frames (Open GOPs)
@@ -463,8 +1044,6 @@ bool TTNaluParser::parseH264NalUnit(const QByteArray& data, TTNalUnit& nal)
             nal.isKeyframe = true;
         }
     }
-
-    return true;
 }
 
 // ----------------------------------------------------------------------------
@@ -476,47 +1055,68 @@ bool TTNaluParser::parseH264NalUnit(const QByteArray& data, TTNalUnit& nal)
 // a NAL unit body. Required before parsing any field that lives past the
 // first ~3 bytes of the NAL, since 00 00 03 escapes can otherwise shift the
 // bit position and produce wrong field values.
-static QByteArray ttNaluRemoveEpb(const QByteArray& nal)
+// Writes the RBSP into rbsp (resized to fit, capacity reused across calls)
+// and returns its length.
+static int ttNaluRemoveEpb(const uint8_t* nal, int size, QByteArray& rbsp)
 {
-    QByteArray rbsp;
-    rbsp.reserve(nal.size());
-    for (int i = 0; i < nal.size(); ++i) {
-        if (i + 2 < nal.size() &&
-            (uint8_t)nal[i] == 0x00 &&
-            (uint8_t)nal[i+1] == 0x00 &&
-            (uint8_t)nal[i+2] == 0x03) {
-            rbsp.append(nal[i]);
-            rbsp.append(nal[i+1]);
+    if (rbsp.size() < size)
+        rbsp.resize(size);
+    uint8_t* out = reinterpret_cast<uint8_t*>(rbsp.data());
+    int n = 0;
+    for (int i = 0; i < size; ++i) {
+        if (i + 2 < size &&
+            nal[i] == 0x00 &&
+            nal[i+1] == 0x00 &&
+            nal[i+2] == 0x03) {
+            out[n++] = nal[i];
+            out[n++] = nal[i+1];
             i += 2;  // skip the 0x03 escape byte
         } else {
-            rbsp.append(nal[i]);
+            out[n++] = nal[i];
         }
     }
-    return rbsp;
+    return n;
+}
+
+void TTNaluParser::parseH264SpsData(const uint8_t* rawNal, int rawSize)
+{
+    TTSpsInfo info;
+    if (!parseH264Sps(rawNal, rawSize, mRbspScratch, info)) return;
+
+    mSpsInfoMap[info.spsId] = info;
+
+    if (!info.frameMbsOnlyFlag) {
+        if (TTSettings::instance()->logAVStream())
+            qDebug() << "  SPS" << info.spsId << ": frame_mbs_only_flag=0 (may contain field pictures)"
+                     << "log2_max_frame_num_minus4=" << info.log2MaxFrameNumMinus4;
+    }
 }
 
-void TTNaluParser::parseH264SpsData(const QByteArray& rawNal)
+// Stateless SPS field extraction behind parseH264SpsData(); false when the
+// SPS is too short or malformed (no map update in that case).
+bool TTNaluParser::parseH264Sps(const uint8_t* rawNal, int rawSize, QByteArray& rbsp, TTSpsInfo& info)
 {
     // Strip emulation-prevention bytes before parsing — scaling lists and
     // VUI HRD parameters can extend past EP escapes, and reading them
     // bit-aligned without stripping shifts every following field.
-    QByteArray data = ttNaluRemoveEpb(rawNal);
-    if (data.size() < 5) return;
+    if (!rawNal) return false;
+    const int size = ttNaluRemoveEpb(rawNal, rawSize, rbsp);
+    if (size < 5) return false;
 
-    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.constData());
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(rbsp.constData());
     int bitPos = 8;  // Skip NAL header byte
 
     // profile_idc (8 bits)
-    int profileIdc = static_cast<int>(readBits(bytes, data.size(), bitPos, 8));
+    int profileIdc = static_cast<int>(readBits(bytes, size, bitPos, 8));
 
     // constraint_set0..5_flags (6 bits) + reserved (2 bits) = 8 bits
-    readBits(bytes, data.size(), bitPos, 8);
+    readBits(bytes, size, bitPos, 8);
 
     // level_idc (8 bits)
-    readBits(bytes, data.size(), bitPos, 8);
+    readBits(bytes, size, bitPos, 8);
 
     // seq_parameter_set_id (ue(v))
-    int spsId = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+    int spsId = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
 
     // For High profile and above, parse chroma_format_idc etc.
     if (profileIdc == 100 || profileIdc == 110 || profileIdc == 122 ||
@@ -526,33 +1126,33 @@ void TTNaluParser::parseH264SpsData(const QByteArray& rawNal)
         profileIdc == 135) {
 
         // chroma_format_idc (ue(v))
-        int chromaFormatIdc = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+        int chromaFormatIdc = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
         if (chromaFormatIdc == 3) {
             // separate_colour_plane_flag (1 bit)
-            readBits(bytes, data.size(), bitPos, 1);
+            readBits(bytes, size, bitPos, 1);
         }
 
         // bit_depth_luma_minus8 (ue(v))
-        readExpGolombUE(bytes, data.size(), bitPos);
+        readExpGolombUE(bytes, size, bitPos);
         // bit_depth_chroma_minus8 (ue(v))
-        readExpGolombUE(bytes, data.size(), bitPos);
+        readExpGolombUE(bytes, size, bitPos);
 
         // qpprime_y_zero_transform_bypass_flag (1 bit)
-        readBits(bytes, data.size(), bitPos, 1);
+        readBits(bytes, size, bitPos, 1);
 
         // seq_scaling_matrix_present_flag (1 bit)
-        uint32_t scalingMatrixPresent = readBits(bytes, data.size(), bitPos, 1);
+        uint32_t scalingMatrixPresent = readBits(bytes, size, bitPos, 1);
         if (scalingMatrixPresent) {
             int numLists = (chromaFormatIdc != 3) ? 8 : 12;
             for (int i = 0; i < numLists; i++) {
-                uint32_t listPresent = readBits(bytes, data.size(), bitPos, 1);
+                uint32_t listPresent = readBits(bytes, size, bitPos, 1);
                 if (listPresent) {
                     int sizeOfList = (i < 6) ? 16 : 64;
                     int lastScale = 8;
                     int nextScale = 8;
                     for (int j = 0; j < sizeOfList; j++) {
                         if (nextScale != 0) {
-                            int deltaScale = readExpGolombSE(bytes, data.size(), bitPos);
+                            int deltaScale = readExpGolombSE(bytes, size, bitPos);
                             nextScale = (lastScale + deltaScale + 256) % 256;
                         }
                         lastScale = (nextScale == 0) ? lastScale : nextScale;
@@ -563,60 +1163,59 @@ void TTNaluParser::parseH264SpsData(const QByteArray& rawNal)
     }
 
     // log2_max_frame_num_minus4 (ue(v))
-    int log2MaxFrameNumMinus4 = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+    int log2MaxFrameNumMinus4 = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
 
     // pic_order_cnt_type (ue(v))
-    int pocType = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+    int pocType = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
     if (pocType == 0) {
-        readExpGolombUE(bytes, data.size(), bitPos);
+        readExpGolombUE(bytes, size, bitPos);
     } else if (pocType == 1) {
-        readBits(bytes, data.size(), bitPos, 1);
-        readExpGolombSE(bytes, data.size(), bitPos);
-        readExpGolombSE(bytes, data.size(), bitPos);
-        int numRefFrames = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+        readBits(bytes, size, bitPos, 1);
+        readExpGolombSE(bytes, size, bitPos);
+        readExpGolombSE(bytes, size, bitPos);
+        int numRefFrames = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
         // Spec H.264 7.4.2.1.1: num_ref_frames_in_pic_order_cnt_cycle <= 255.
         // Cap to bound CPU time for malicious SPS values up to ~2^31.
-        if (numRefFrames > 256) return;
+        if (numRefFrames > 256) return false;
         for (int i = 0; i < numRefFrames; i++) {
-            readExpGolombSE(bytes, data.size(), bitPos);
+            readExpGolombSE(bytes, size, bitPos);
         }
     }
 
-    readExpGolombUE(bytes, data.size(), bitPos);  // max_num_ref_frames
-    readBits(bytes, data.size(), bitPos, 1);       // gaps_in_frame_num
-    readExpGolombUE(bytes, data.size(), bitPos);   // pic_width
-    readExpGolombUE(bytes, data.size(), bitPos);   // pic_height
+    readExpGolombUE(bytes, size, bitPos);  // max_num_ref_frames
+    readBits(bytes, size, bitPos, 1);       // gaps_in_frame_num
+    readExpGolombUE(bytes, size, bitPos);   // pic_width
+    readExpGolombUE(bytes, size, bitPos);   // pic_height
 
     // frame_mbs_only_flag (1 bit) -- THIS IS WHAT WE NEED
-    bool frameMbsOnlyFlag = (readBits(bytes, data.size(), bitPos, 1) == 1);
+    bool frameMbsOnlyFlag = (readBits(bytes, size, bitPos, 1) == 1);
 
-    TTSpsInfo info;
     info.spsId = spsId;
     info.log2MaxFrameNumMinus4 = log2MaxFrameNumMinus4;
     info.frameMbsOnlyFlag = frameMbsOnlyFlag;
-    mSpsInfoMap[spsId] = info;
-
-    if (!frameMbsOnlyFlag) {
-        if (TTSettings::instance()->logAVStream())
-            qDebug() << "  SPS" << spsId << ": frame_mbs_only_flag=0 (may contain field pictures)"
-                     << "log2_max_frame_num_minus4=" << log2MaxFrameNumMinus4;
-    }
+    return true;
 }
 
 // ----------------------------------------------------------------------------
 // Parse H.264 PPS to extract PPS ID -> SPS ID mapping
 // ----------------------------------------------------------------------------
-void TTNaluParser::parseH264PpsData(const QByteArray& data)
+void TTNaluParser::parseH264PpsData(const uint8_t* data, int size)
 {
-    if (data.size() < 2) return;
+    int ppsId = -1;
+    int spsId = -1;
+    if (parseH264Pps(data, size, ppsId, spsId))
+        mPpsToSpsMap[ppsId] = spsId;
+}
 
-    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.constData());
-    int bitPos = 8;  // Skip NAL header byte
+bool TTNaluParser::parseH264Pps(const uint8_t* data, int size, int& ppsId, int& spsId)
+{
+    if (!data || size < 2) return false;
 
-    int ppsId = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
-    int spsId = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+    int bitPos = 8;  // Skip NAL header byte
 
-    mPpsToSpsMap[ppsId] = spsId;
+    ppsId = static_cast<int>(readExpGolombUE(data, size, bitPos));
+    spsId = static_cast<int>(readExpGolombUE(data, size, bitPos));
+    return true;
 }
 
 // ----------------------------------------------------------------------------
@@ -624,42 +1223,45 @@ void TTNaluParser::parseH264PpsData(const QByteArray& data)
 // Extracts: first_mb_in_slice, slice_type, pps_id, frame_num,
 //           field_pic_flag, bottom_field_flag (for PAFF detection)
 // ----------------------------------------------------------------------------
-bool TTNaluParser::parseH264SliceHeader(const QByteArray& data, TTNalUnit& nal)
+bool TTNaluParser::parseH264SliceHeader(const uint8_t* data, int size, TTNalUnit& nal,
+                                        const QMap<int, TTSpsInfo>& spsInfo,
+                                        const QMap<int, int>& ppsToSps)
 {
-    if (data.size() < 3) return false;
+    if (size < 3) return false;
 
-    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.constData());
+    const uint8_t* bytes = data;
     int bitPos = 8;  // Skip NAL header byte
 
     // first_mb_in_slice (ue(v))
-    nal.firstMbInSlice = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+    nal.firstMbInSlice = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
 
     // slice_type (ue(v))
-    uint32_t sliceType = readExpGolombUE(bytes, data.size(), bitPos);
+    uint32_t sliceType = readExpGolombUE(bytes, size, bitPos);
     // Normalize slice type (0-4 and 5-9 mean the same thing)
     if (sliceType > 4) sliceType -= 5;
     nal.sliceType = static_cast<int>(sliceType);
 
     // pic_parameter_set_id (ue(v))
-    nal.ppsId = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+    nal.ppsId = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
 
     // Look up SPS via PPS -> SPS chain for frame_num bit-width and field info
-    int spsId = mPpsToSpsMap.value(nal.ppsId, -1);
-    if (spsId < 0 || !mSpsInfoMap.contains(spsId)) {
+    int spsId = ppsToSps.value(nal.ppsId, -1);
+    auto spsIt = (spsId < 0) ? spsInfo.constEnd() : spsInfo.constFind(spsId);
+    if (spsIt == spsInfo.constEnd()) {
         return true;  // Can't parse further without SPS info -- still valid
     }
 
-    const TTSpsInfo& sps = mSpsInfoMap[spsId];
+    const TTSpsInfo& sps = spsIt.value();
 
     // frame_num -- u(log2_max_frame_num_minus4 + 4) bits
     int frameNumBits = sps.log2MaxFrameNumMinus4 + 4;
-    nal.frameNum = static_cast<int>(readBits(bytes, data.size(), bitPos, frameNumBits));
+    nal.frameNum = static_cast<int>(readBits(bytes, size, bitPos, frameNumBits));
 
     // field_pic_flag -- only present if frame_mbs_only_flag == 0
     if (!sps.frameMbsOnlyFlag) {
-        nal.isField = (readBits(bytes, data.size(), bitPos, 1) == 1);
+        nal.isField = (readBits(bytes, size, bitPos, 1) == 1);
         if (nal.isField) {
-            nal.isBottomField = (readBits(bytes, data.size(), bitPos, 1) == 1);
+            nal.isBottomField = (readBits(bytes, size, bitPos, 1) == 1);
         }
     }
 
@@ -669,12 +1271,12 @@ bool TTNaluParser::parseH264SliceHeader(const QByteArray& data, TTNalUnit& nal)
 // ----------------------------------------------------------------------------
 // Parse H.265 NAL unit header
 // ----------------------------------------------------------------------------
-bool TTNaluParser::parseH265NalUnit(const QByteArray& data, TTNalUnit& nal)
+bool TTNaluParser::parseH265NalUnit(const uint8_t* data, int size, TTNalUnit& nal)
 {
-    if (data.size() < 2) return false;
+    if (!data || size < 2) return false;
 
-    uint8_t byte0 = static_cast<uint8_t>(data[0]);
-    uint8_t byte1 = static_cast<uint8_t>(data[1]);
+    uint8_t byte0 = data[0];
+    uint8_t byte1 = data[1];
 
     // H.265 NAL header (2 bytes):
     // forbidden_zero_bit (1) + nal_unit_type (6) + nuh_layer_id (6) + nuh_temporal_id_plus1 (3)
@@ -739,8 +1341,8 @@ bool TTNaluParser::parseH265NalUnit(const QByteArray& data, TTNalUnit& nal)
     }
 
     // Parse slice header for additional info
-    if (nal.isSlice && data.size() > 2) {
-        parseH265SliceHeader(data, nal);
+    if (nal.isSlice && size > 2) {
+        parseH265SliceHeader(data, size, nal);
 
         // Also mark I-slices as keyframes for GOP detection
         if (nal.sliceType == H265::SLICE_I) {
@@ -754,24 +1356,24 @@ bool TTNaluParser::parseH265NalUnit(const QByteArray& data, TTNalUnit& nal)
 // ----------------------------------------------------------------------------
 // Parse H.265 slice header (basic info only)
 // ----------------------------------------------------------------------------
-bool TTNaluParser::parseH265SliceHeader(const QByteArray& data, TTNalUnit& nal)
+bool TTNaluParser::parseH265SliceHeader(const uint8_t* data, int size, TTNalUnit& nal)
 {
-    if (data.size() < 4) return false;
+    if (size < 4) return false;
 
-    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.constData());
+    const uint8_t* bytes = data;
     int bitPos = 16;  // Skip 2-byte NAL header
 
     // first_slice_segment_in_pic_flag (1 bit)
-    uint32_t firstSliceFlag = readBits(bytes, data.size(), bitPos, 1);
+    uint32_t firstSliceFlag = readBits(bytes, size, bitPos, 1);
     nal.firstMbInSlice = (firstSliceFlag == 1) ? 0 : -1;
 
     // For BLA/IDR/CRA: no_output_of_prior_pics_flag (1 bit)
     if (nal.type >= H265::NAL_BLA_W_LP && nal.type <= H265::NAL_CRA_NUT) {
-        readBits(bytes, data.size(), bitPos, 1);  // no_output_of_prior_pics_flag
+        readBits(bytes, size, bitPos, 1);  // no_output_of_prior_pics_flag
     }
 
     // slice_pic_parameter_set_id (ue(v))
-    nal.ppsId = static_cast<int>(readExpGolombUE(bytes, data.size(), bitPos));
+    nal.ppsId = static_cast<int>(readExpGolombUE(bytes, size, bitPos));
 
     // For first slice in picture, we can read slice_type directly from the bitstream.
     // For dependent slices (firstSliceFlag == 0), we'd need PPS data we don't have,
@@ -779,7 +1381,7 @@ bool TTNaluParser::parseH265SliceHeader(const QByteArray& data, TTNalUnit& nal)
     if (firstSliceFlag == 1) {
         // HEVC spec: slice_type is ue(v) right after slice_pic_parameter_set_id
         // (assuming num_extra_slice_header_bits == 0, which is standard for DVB)
-        uint32_t sliceType = readExpGolombUE(bytes, data.size(), bitPos);
+        uint32_t sliceType = readExpGolombUE(bytes, size, bitPos);
         if (sliceType <= 2) {
             nal.sliceType = static_cast<int>(sliceType);
         } else {
@@ -813,23 +1415,22 @@ void TTNaluParser::buildAccessUnits()
 {
     mAccessUnits.clear();
 
-    if (mNalUnits.isEmpty()) return;
+    const int nalCount = mNalOffsets.size();
+    if (nalCount == 0) return;
 
-    TTAccessUnit currentAU;
-    currentAU.index = 0;
-    currentAU.decodeIndex = 0;
-    currentAU.isKeyframe = false;
-    currentAU.isIDR = false;
-    currentAU.sliceType = -1;
-    currentAU.poc = -1;
+    TTAuRecord currentAU;
+    currentAU.firstNal = 0;
+    currentAU.nalCount = 0;
     currentAU.gopIndex = 0;
-    currentAU.isFieldCoded = false;
+    currentAU.sliceType = -1;
+    currentAU.flags = 0;
 
-    int auCount = 0;
+    bool currentHasSlice = false;
     int currentGop = 0;
 
-    for (int i = 0; i < mNalUnits.size(); i++) {
-        const TTNalUnit& nal = mNalUnits[i];
+    for (int i = 0; i < nalCount; i++) {
+        const TTNalHeader& nal = mNalHeaders[i];
+        const int kind = ttNalKind(nal);
 
         // Check for AU boundary
         // An AU starts with:
@@ -839,73 +1440,54 @@ void TTNaluParser::buildAccessUnits()
 
         bool isAUStart = false;
 
-        if (nal.isAUD) {
+        if (kind == NAL_KIND_AUD) {
             isAUStart = true;
-        } else if (nal.isSlice && nal.firstMbInSlice == 0) {
-            // First slice of a new picture
-            if (!currentAU.nalIndices.isEmpty()) {
-                // Check if we already have slices in current AU
-                bool hasSlice = false;
-                for (int idx : currentAU.nalIndices) {
-                    if (mNalUnits[idx].isSlice) {
-                        hasSlice = true;
-                        break;
-                    }
-                }
-                if (hasSlice) {
-                    isAUStart = true;
-                }
+        } else if (kind == NAL_KIND_SLICE && nal.firstMbInSlice == 0) {
+            // First slice of a new picture, if we already have slices in
+            // the current AU
+            if (currentHasSlice) {
+                isAUStart = true;
             }
         }
 
-        if (isAUStart && !currentAU.nalIndices.isEmpty()) {
+        if (isAUStart && currentAU.nalCount > 0) {
             // Save current AU
-            currentAU.startOffset = mNalUnits[currentAU.nalIndices.first()].fileOffset;
-            int lastIdx = currentAU.nalIndices.last();
-            currentAU.endOffset = mNalUnits[lastIdx].fileOffset + mNalUnits[lastIdx].size;
-            currentAU.decodeIndex = auCount;
-
             mAccessUnits.append(currentAU);
-            auCount++;
 
             // Start new AU
-            currentAU.index = auCount;
-            currentAU.nalIndices.clear();
-            currentAU.isKeyframe = false;
-            currentAU.isIDR = false;
+            currentAU.firstNal = i;
+            currentAU.nalCount = 0;
             currentAU.sliceType = -1;
-            currentAU.poc = -1;
-            currentAU.isFieldCoded = false;
+            currentAU.flags = 0;
+            currentHasSlice = false;
 
             // Check for new GOP
-            if (nal.isKeyframe) {
+            if (nal.flags & NAL_FLAG_KEYFRAME) {
                 currentGop++;
             }
             currentAU.gopIndex = currentGop;
         }
 
-        // Add NAL to current AU
-        currentAU.nalIndices.append(i);
+        // Add NAL to current AU (AUs are consecutive runs of NALs)
+        currentAU.nalCount++;
 
         // Update AU properties from slice info
-        if (nal.isKeyframe) {
-            currentAU.isKeyframe = true;
+        if (nal.flags & NAL_FLAG_KEYFRAME) {
+            currentAU.flags |= AU_FLAG_KEYFRAME;
             currentAU.gopIndex = currentGop;
         }
-        if (nal.isIDR) {
-            currentAU.isIDR = true;
+        if (nal.flags & NAL_FLAG_IDR) {
+            currentAU.flags |= AU_FLAG_IDR;
         }
-        if (nal.isSlice && currentAU.sliceType < 0) {
-            currentAU.sliceType = nal.sliceType;
+        if (kind == NAL_KIND_SLICE) {
+            if (currentAU.sliceType < 0)
+                currentAU.sliceType = nal.sliceType;
+            currentHasSlice = true;
         }
     }
 
     // Save last AU
-    if (!currentAU.nalIndices.isEmpty()) {
-        currentAU.startOffset = mNalUnits[currentAU.nalIndices.first()].fileOffset;
-        int lastIdx = currentAU.nalIndices.last();
-        currentAU.endOffset = mNalUnits[lastIdx].fileOffset + mNalUnits[lastIdx].size;
-        currentAU.decodeIndex = auCount;
+    if (currentAU.nalCount > 0) {
         mAccessUnits.append(currentAU);
     }
 
@@ -924,69 +1506,55 @@ void TTNaluParser::buildAccessUnits()
         }
 
         if (spsAllowsFields) {
-            int mergeCount = 0;
-            int i = 0;
-            while (i < mAccessUnits.size() - 1) {
-                TTAccessUnit& topAU = mAccessUnits[i];
-                TTAccessUnit& botAU = mAccessUnits[i + 1];
-
-                bool topIsField = false;
-                bool botIsField = false;
-                int topFrameNum = -1;
-                int botFrameNum = -1;
-
-                for (int idx : topAU.nalIndices) {
-                    if (mNalUnits[idx].isSlice) {
-                        topIsField = mNalUnits[idx].isField;
-                        topFrameNum = mNalUnits[idx].frameNum;
-                        break;
-                    }
-                }
-                for (int idx : botAU.nalIndices) {
-                    if (mNalUnits[idx].isSlice) {
-                        botIsField = mNalUnits[idx].isField;
-                        botFrameNum = mNalUnits[idx].frameNum;
-                        break;
-                    }
+            // First slice of an AU, and its first field slice (-1 if none)
+            auto firstSlice = [this](const TTAuRecord& au, bool fieldOnly) -> int {
+                for (int idx = au.firstNal; idx < au.firstNal + au.nalCount; idx++) {
+                    const TTNalHeader& h = mNalHeaders[idx];
+                    if (ttNalKind(h) == NAL_KIND_SLICE && (!fieldOnly || (h.flags & NAL_FLAG_FIELD)))
+                        return idx;
                 }
+                return -1;
+            };
 
-                bool topIsTop = false;
-                bool botIsBot = false;
-                for (int idx : topAU.nalIndices) {
-                    if (mNalUnits[idx].isSlice && mNalUnits[idx].isField) {
-                        topIsTop = !mNalUnits[idx].isBottomField;
-                        break;
-                    }
-                }
-                for (int idx : botAU.nalIndices) {
-                    if (mNalUnits[idx].isSlice && mNalUnits[idx].isField) {
-                        botIsBot = mNalUnits[idx].isBottomField;
-                        break;
+            // Compact in place: the last kept AU absorbs the next one when
+            // the two are a top/bottom field pair of the same frame_num.
+            // Adjacent AUs are adjacent NAL runs, so a merge just extends
+            // the range.
+            int mergeCount = 0;
+            int kept = 0;
+            TTAuRecord* aus = mAccessUnits.data();
+            for (int i = 0; i < mAccessUnits.size(); i++) {
+                if (kept > 0) {
+                    TTAuRecord& topAU = aus[kept - 1];
+                    const TTAuRecord& botAU = aus[i];
+
+                    const int topSlice = firstSlice(topAU, false);
+                    const int botSlice = firstSlice(botAU, false);
+                    const bool topIsField = topSlice >= 0 && (mNalHeaders[topSlice].flags & NAL_FLAG_FIELD);
+                    const bool botIsField = botSlice >= 0 && (mNalHeaders[botSlice].flags & NAL_FLAG_FIELD);
+                    const int topFrameNum = topSlice >= 0 ? mNalHeaders[topSlice].frameNum : -1;
+                    const int botFrameNum = botSlice >= 0 ? mNalHeaders[botSlice].frameNum : -1;
+
+                    const int topField = firstSlice(topAU, true);
+                    const int botField = firstSlice(botAU, true);
+                    const bool topIsTop = topField >= 0 && !(mNalHeaders[topField].flags & NAL_FLAG_BOTTOM_FIELD);
+                    const bool botIsBot = botField >= 0 && (mNalHeaders[botField].flags & NAL_FLAG_BOTTOM_FIELD);
+
+                    if (topIsField && botIsField && topIsTop && botIsBot &&
+                        topFrameNum >= 0 && topFrameNum == botFrameNum) {
+                        topAU.nalCount += botAU.nalCount;
+                        topAU.flags |= AU_FLAG_FIELD_CODED
+                                     | (botAU.flags & (AU_FLAG_KEYFRAME | AU_FLAG_IDR));
+                        hasFieldSlices = true;
+                        mergeCount++;
+                        continue;
                     }
                 }
-
-                if (topIsField && botIsField && topIsTop && botIsBot &&
-                    topFrameNum >= 0 && topFrameNum == botFrameNum) {
-                    topAU.nalIndices.append(botAU.nalIndices);
-                    topAU.endOffset = botAU.endOffset;
-                    topAU.isFieldCoded = true;
-                    hasFieldSlices = true;
-
-                    if (botAU.isKeyframe) topAU.isKeyframe = true;
-                    if (botAU.isIDR) topAU.isIDR = true;
-
-                    mAccessUnits.removeAt(i + 1);
-                    mergeCount++;
-                } else {
-                    i++;
-                }
+                aus[kept++] = aus[i];
             }
 
             if (mergeCount > 0) {
-                for (int j = 0; j < mAccessUnits.size(); j++) {
-                    mAccessUnits[j].index = j;
-                    mAccessUnits[j].decodeIndex = j;
-                }
+                mAccessUnits.resize(kept);
                 mIsPAFF = true;
                 if (TTSettings::instance()->logAVStream())
                     qDebug() << "  PAFF detected: merged" << mergeCount << "field pairs"
@@ -1017,9 +1585,9 @@ void TTNaluParser::buildGOPs()
     currentGop.isClosed = true;
 
     for (int i = 0; i < mAccessUnits.size(); i++) {
-        const TTAccessUnit& au = mAccessUnits[i];
+        const bool isKeyframe = (mAccessUnits[i].flags & AU_FLAG_KEYFRAME) != 0;
 
-        if (au.isKeyframe && i > 0) {
+        if (isKeyframe && i > 0) {
             // End current GOP
             currentGop.endAU = i - 1;
             currentGop.frameCount = currentGop.endAU - currentGop.startAU + 1;
@@ -1032,7 +1600,7 @@ void TTNaluParser::buildGOPs()
             currentGop.isClosed = true;
         }
 
-        if (au.isKeyframe) {
+        if (isKeyframe) {
             currentGop.keyframeAU = i;
         }
     }
@@ -1046,13 +1614,35 @@ void TTNaluParser::buildGOPs()
         qDebug() << "  Built" << mGops.size() << "GOPs";
 }
 
+// ----------------------------------------------------------------------------
+// End offset of a NAL unit: the next NAL's start code, EOF for the last one.
+// The scan only drops a start code it cannot parse at the very end of the
+// file, so this equals the size the serial scan used to record per NAL.
+// ----------------------------------------------------------------------------
+int64_t TTNaluParser::nalEndOffset(int index) const
+{
+    return (index + 1 < mNalOffsets.size()) ? mNalOffsets[index + 1] : mFileSize;
+}
+
+// ----------------------------------------------------------------------------
+// Unpack NAL unit at a valid index
+// ----------------------------------------------------------------------------
+TTNalUnit TTNaluParser::unpackNalUnit(int index) const
+{
+    TTNalUnit nal;
+    ttUnpackNalHeader(mNalHeaders[index], mNalOffsets[index], nal);
+    nal.size = nalEndOffset(index) - nal.fileOffset;
+    nal.dataSize = nal.size - (nal.dataOffset - nal.fileOffset);
+    return nal;
+}
+
 // ----------------------------------------------------------------------------
 // Get NAL unit at index
 // ----------------------------------------------------------------------------
 TTNalUnit TTNaluParser::nalUnitAt(int index) const
 {
-    if (index >= 0 && index < mNalUnits.size()) {
-        return mNalUnits[index];
+    if (index >= 0 && index < mNalOffsets.size()) {
+        return unpackNalUnit(index);
     }
     return TTNalUnit();
 }
@@ -1062,11 +1652,11 @@ TTNalUnit TTNaluParser::nalUnitAt(int index) const
 // ----------------------------------------------------------------------------
 QByteArray TTNaluParser::readNalData(int index)
 {
-    if (index < 0 || index >= mNalUnits.size()) {
+    if (index < 0 || index >= mNalOffsets.size()) {
         return QByteArray();
     }
 
-    const TTNalUnit& nal = mNalUnits[index];
+    const TTNalUnit nal = unpackNalUnit(index);
     mFile.seek(nal.dataOffset);
     return mFile.read(nal.dataSize);
 }
@@ -1076,13 +1666,13 @@ QByteArray TTNaluParser::readNalData(int index)
 // ----------------------------------------------------------------------------
 QByteArray TTNaluParser::readNalDataWithStartCode(int index)
 {
-    if (index < 0 || index >= mNalUnits.size()) {
+    if (index < 0 || index >= mNalOffsets.size()) {
         return QByteArray();
     }
 
-    const TTNalUnit& nal = mNalUnits[index];
-    mFile.seek(nal.fileOffset);
-    return mFile.read(nal.size);
+    const int64_t offset = mNalOffsets[index];
+    mFile.seek(offset);
+    return mFile.read(nalEndOffset(index) - offset);
 }
 
 // ----------------------------------------------------------------------------
@@ -1101,7 +1691,14 @@ void TTNaluParser::deduplicateList(QList<int>& list)
     QSet<QByteArray> seen;
 
     for (int nalIdx : list) {
-        QByteArray data = readNalDataWithStartCode(nalIdx);
+        // Mapped: hash the parameter set in place (fromRawData does not copy;
+        // 'seen' dies before the mapping does).
+        const int64_t offset = mNalOffsets[nalIdx];
+        const int64_t size = nalEndOffset(nalIdx) - offset;
+        QByteArray data = (mMappedFile && size > 0)
+            ? QByteArray::fromRawData(reinterpret_cast<const char*>(mMappedFile + offset),
+                                      static_cast<qsizetype>(size))
+            : readNalDataWithStartCode(nalIdx);
         if (data.isEmpty())
             continue;
 
@@ -1119,7 +1716,21 @@ void TTNaluParser::deduplicateList(QList<int>& list)
 TTAccessUnit TTNaluParser::accessUnitAt(int index) const
 {
     if (index >= 0 && index < mAccessUnits.size()) {
-        return mAccessUnits[index];
+        const TTAuRecord& rec = mAccessUnits[index];
+        TTAccessUnit au;
+        au.index = index;
+        au.decodeIndex = index;
+        au.firstNal = rec.firstNal;
+        au.nalCount = rec.nalCount;
+        au.startOffset = mNalOffsets[rec.firstNal];
+        au.endOffset = nalEndOffset(rec.firstNal + rec.nalCount - 1);
+        au.isKeyframe = (rec.flags & AU_FLAG_KEYFRAME) != 0;
+        au.isIDR = (rec.flags & AU_FLAG_IDR) != 0;
+        au.sliceType = rec.sliceType;
+        au.poc = -1;
+        au.gopIndex = rec.gopIndex;
+        au.isFieldCoded = (rec.flags & AU_FLAG_FIELD_CODED) != 0;
+        return au;
     }
     return TTAccessUnit();
 }
@@ -1133,9 +1744,21 @@ QByteArray TTNaluParser::readAccessUnitData(int index)
         return QByteArray();
     }
 
-    const TTAccessUnit& au = mAccessUnits[index];
-    mFile.seek(au.startOffset);
-    return mFile.read(au.endOffset - au.startOffset);
+    const TTAuRecord& au = mAccessUnits[index];
+    const int64_t startOffset = mNalOffsets[au.firstNal];
+    mFile.seek(startOffset);
+    return mFile.read(nalEndOffset(au.firstNal + au.nalCount - 1) - startOffset);
+}
+
+// ----------------------------------------------------------------------------
+// File offset of an Access Unit's first NAL (-1 if index is invalid)
+// ----------------------------------------------------------------------------
+int64_t TTNaluParser::accessUnitOffset(int index) const
+{
+    if (index < 0 || index >= mAccessUnits.size())
+        return -1;
+
+    return mNalOffsets[mAccessUnits[index].firstNal];
 }
 
 // ----------------------------------------------------------------------------
@@ -1149,9 +1772,34 @@ const uchar* TTNaluParser::accessUnitPtr(int index, int64_t& size) const
         return nullptr;
     }
 
-    const TTAccessUnit& au = mAccessUnits[index];
-    size = au.endOffset - au.startOffset;
-    return mMappedFile + au.startOffset;
+    const TTAuRecord& au = mAccessUnits[index];
+    const int64_t startOffset = mNalOffsets[au.firstNal];
+    size = nalEndOffset(au.firstNal + au.nalCount - 1) - startOffset;
+    return mMappedFile + startOffset;
+}
+
+// ----------------------------------------------------------------------------
+// Index memory: packed tables as held, and the equivalent unpacked lists
+// (one TTNalUnit per NAL, one TTAccessUnit plus a QList<int> of NAL indices
+// per AU; QListData header estimated at 16 bytes per list allocation).
+// ----------------------------------------------------------------------------
+int64_t TTNaluParser::indexMemoryBytes() const
+{
+    return static_cast<int64_t>(mNalOffsets.capacity()) * sizeof(int64_t)
+         + static_cast<int64_t>(mNalHeaders.capacity()) * sizeof(TTNalHeader)
+         + static_cast<int64_t>(mAccessUnits.capacity()) * sizeof(TTAuRecord)
+         + static_cast<int64_t>(mGops.capacity()) * sizeof(TTGopInfo);
+}
+
+int64_t TTNaluParser::unpackedIndexMemoryBytes() const
+{
+    const int64_t listHeader = 16;
+    const int64_t auBytes = sizeof(TTAccessUnit) - 2 * sizeof(int) + sizeof(QList<int>) + listHeader;
+
+    return static_cast<int64_t>(mNalOffsets.size()) * sizeof(TTNalUnit)
+         + static_cast<int64_t>(mAccessUnits.size()) * auBytes
+         + static_cast<int64_t>(mNalOffsets.size()) * sizeof(int)
+         + static_cast<int64_t>(mGops.size()) * sizeof(TTGopInfo);
 }
 
 // ----------------------------------------------------------------------------
@@ -1193,7 +1841,7 @@ QByteArray TTNaluParser::getVPS(int index) const
 int TTNaluParser::findKeyframeBefore(int auIndex) const
 {
     for (int i = auIndex; i >= 0; i--) {
-        if (mAccessUnits[i].isKeyframe) {
+        if (mAccessUnits[i].flags & AU_FLAG_KEYFRAME) {
             return i;
         }
     }
@@ -1206,7 +1854,7 @@ int TTNaluParser::findKeyframeBefore(int auIndex) const
 int TTNaluParser::findKeyframeAfter(int auIndex) const
 {
     for (int i = auIndex; i < mAccessUnits.size(); i++) {
-        if (mAccessUnits[i].isKeyframe) {
+        if (mAccessUnits[i].flags & AU_FLAG_KEYFRAME) {
             return i;
         }
     }
@@ -1220,7 +1868,7 @@ int TTNaluParser::findKeyframeAfter(int auIndex) const
 int TTNaluParser::findIDRAfter(int auIndex) const
 {
     for (int i = auIndex; i < mAccessUnits.size(); i++) {
-        if (mAccessUnits[i].isIDR) {
+        if (mAccessUnits[i].flags & AU_FLAG_IDR) {
             return i;
         }
     }
@@ -1269,7 +1917,7 @@ int TTNaluParser::computeReorderDelay() const
         int consecutiveB = 0;
 
         for (int i = gop.startAU; i <= gop.endAU && i < mAccessUnits.size(); i++) {
-            const TTAccessUnit& au = mAccessUnits[i];
+            const TTAuRecord& au = mAccessUnits[i];
             bool isB = false;
             if (mCodecType == NALU_CODEC_H265) {
                 isB = (au.sliceType == H265::SLICE_B);
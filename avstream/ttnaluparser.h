@@ -18,6 +18,7 @@
 
 #include <QString>
 #include <QList>
+#include <QVector>
 #include <QByteArray>
 #include <QFile>
 #include <QMap>
@@ -146,12 +147,15 @@ struct TTNalUnit {
 
 // ----------------------------------------------------------------------------
 // Access Unit (Frame) information
-// Groups NAL units that belong to the same picture
+// Groups NAL units that belong to the same picture. The NALs of an AU are
+// always consecutive in the file (a PAFF field pair is two adjacent runs),
+// so the AU refers to them as the range [firstNal, firstNal + nalCount).
 // ----------------------------------------------------------------------------
 struct TTAccessUnit {
     int index;                   // Frame index (display order based on POC)
     int decodeIndex;             // Decode order index
-    QList<int> nalIndices;       // Indices of NAL units in this AU
+    int firstNal;                // Index of the first NAL unit in this AU
+    int nalCount;                // Number of NAL units in this AU
 
     int64_t startOffset;         // Start offset of first NAL
     int64_t endOffset;           // End offset of last NAL
@@ -176,6 +180,32 @@ struct TTGopInfo {
     bool isClosed;               // No references outside GOP
 };
 
+// ----------------------------------------------------------------------------
+// Packed storage behind TTNalUnit / TTAccessUnit.
+// TTNaluParser keeps one int64 start-code offset per NAL in its own column
+// plus this 20-byte header; sizes, data offsets and AU start/end offsets are
+// derived from the offset column (a NAL ends where the next one starts, the
+// last one at EOF). nalUnitAt()/accessUnitAt() unpack on demand.
+// ----------------------------------------------------------------------------
+struct TTNalHeader {
+    int32_t sliceType;
+    int32_t frameNum;
+    int32_t firstMbInSlice;
+    int32_t ppsId;
+    uint8_t type;
+    uint8_t refIdc;
+    uint8_t temporalId;
+    uint8_t flags;               // NAL kind (bits 0-2) + boolean properties
+};
+
+struct TTAuRecord {
+    int32_t firstNal;
+    int32_t nalCount;
+    int32_t gopIndex;
+    int32_t sliceType;           // from the first slice's header
+    uint8_t flags;               // keyframe / IDR / field-coded
+};
+
 // ----------------------------------------------------------------------------
 // Codec type enumeration
 // ----------------------------------------------------------------------------
@@ -185,6 +215,31 @@ enum TTNaluCodecType {
     NALU_CODEC_H265
 };
 
+// ----------------------------------------------------------------------------
+// A finished TTNaluParser index as a value. The tables are implicitly shared,
+// so a copy costs a few reference counts: the stream's indexing pass
+// (TTFFmpegWrapper::buildFrameIndex) builds it once and every parser of the
+// same file adopts it via TTNaluParser::adoptIndex() instead of rescanning.
+// ----------------------------------------------------------------------------
+struct TTNaluIndex {
+    TTNaluCodecType codecType = NALU_CODEC_UNKNOWN;
+    int64_t fileSize = 0;
+    bool isPAFF = false;
+
+    QVector<int64_t> nalOffsets;
+    QVector<TTNalHeader> nalHeaders;
+    QVector<TTAuRecord> accessUnits;
+    QList<TTGopInfo> gops;
+
+    QList<int> spsList;
+    QList<int> ppsList;
+    QList<int> vpsList;
+    QMap<int, TTSpsInfo> spsInfoMap;
+    QMap<int, int> ppsToSpsMap;
+
+    bool isEmpty() const { return nalOffsets.isEmpty(); }
+};
+
 // ----------------------------------------------------------------------------
 // TTNaluParser class
 // ----------------------------------------------------------------------------
@@ -199,7 +254,9 @@ public:
     void closeFile();
     bool isOpen() const { return mFile.isOpen(); }
 
-    // Full file parsing
+    // Full file parsing. The finished index is kept in the stream's .ttidx
+    // sidecar (TTStreamIndexCache); a later parseFile() on the unchanged
+    // stream adopts it instead of rescanning.
     bool parseFile();
 
     // Cooperative-abort poll hook. When set, parseFile() calls it once per
@@ -208,14 +265,24 @@ public:
     // error-level log line -- mirrors TTESSmartCut::checkAbort()).
     void setAbortCallback(std::function<bool()> cb) { mAbortCallback = std::move(cb); }
 
+    // Snapshot of the parsed index, and the reverse: take over an index
+    // another parser built for the same file (open it first). False, with
+    // nothing changed, if codec or file size do not match.
+    TTNaluIndex index() const;
+    bool adoptIndex(const TTNaluIndex& index);
+
+    // Worker threads for the NAL scan in parseFile(): 0 = auto (one per
+    // core), 1 = always serial. The parallel scan only runs on a mapped
+    // file of at least two scan chunks; its result (NAL/AU/GOP lists,
+    // parameter sets, PAFF merge) is identical to the serial one.
+    void setParseThreadCount(int threads) { mParseThreads = threads; }
+    int parseThreadCount() const { return mParseThreads; }
+
     // Accessors
     TTNaluCodecType codecType() const { return mCodecType; }
     QString codecName() const;
 
-    const QList<TTNalUnit>& nalUnits() const { return mNalUnits; }
-    int nalUnitCount() const { return mNalUnits.size(); }
-
-    const QList<TTAccessUnit>& accessUnits() const { return mAccessUnits; }
+    int nalUnitCount() const { return mNalOffsets.size(); }
     int accessUnitCount() const { return mAccessUnits.size(); }
 
     const QList<TTGopInfo>& gops() const { return mGops; }
@@ -234,6 +301,17 @@ public:
     const uchar* accessUnitPtr(int index, int64_t& size) const;
     bool isMapped() const { return mMappedFile != nullptr; }
 
+    // The open stream file and an AU's byte offset in it, for copies that
+    // stay in the kernel (TTByteRangeCopy)
+    QFile& file() { return mFile; }
+    int64_t accessUnitOffset(int index) const;
+
+    // Heap bytes held by the NAL/AU/GOP index, and what the same index
+    // would cost as QList<TTNalUnit> + QList<TTAccessUnit> with one
+    // QList<int> of NAL indices per AU (the layout before the packed tables).
+    int64_t indexMemoryBytes() const;
+    int64_t unpackedIndexMemoryBytes() const;
+
     // Parameter sets
     QByteArray getSPS(int index = 0) const;
     QByteArray getPPS(int index = 0) const;
@@ -277,6 +355,10 @@ public:
     // 12-value list so future profile additions need only one edit.
     static bool isH264HighProfile(uint32_t profile_idc);
 
+    // H.264 SPS fields for slice-header parsing. rawNal is the NAL including
+    // its header byte, EP bytes still in (stripped into rbsp).
+    static bool parseH264Sps(const uint8_t* rawNal, int size, QByteArray& rbsp, TTSpsInfo& info);
+
     // Error handling
     QString lastError() const { return mLastError; }
 
@@ -292,12 +374,14 @@ private:
     // Memory-mapped file pointer (for fast access)
     uchar* mMappedFile;
 
-    // Parsed data
-    QList<TTNalUnit> mNalUnits;
-    QList<TTAccessUnit> mAccessUnits;
+    // Parsed data, packed (see TTNalHeader / TTAuRecord). mNalOffsets and
+    // mNalHeaders are parallel columns indexed by NAL number.
+    QVector<int64_t> mNalOffsets;
+    QVector<TTNalHeader> mNalHeaders;
+    QVector<TTAuRecord> mAccessUnits;
     QList<TTGopInfo> mGops;
 
-    // Parameter sets (indices into mNalUnits)
+    // Parameter sets (NAL indices)
     QList<int> mSPSList;
     QList<int> mPPSList;
     QList<int> mVPSList;
@@ -310,29 +394,56 @@ private:
     // Cooperative-abort poll hook (see setAbortCallback())
     std::function<bool()> mAbortCallback;
 
+    // NAL scan worker count (see setParseThreadCount())
+    int mParseThreads;
+
     // Error handling
     QString mLastError;
     void setError(const QString& error);
 
+    // Scratch buffers for the unmapped fallback and the SPS RBSP. Reused for
+    // every NAL so the parse loop does no per-NAL heap allocation.
+    QByteArray mScratch;
+    QByteArray mRbspScratch;
+
     // Parsing helpers
     bool detectCodecType();
+    bool mapFile();
+    bool loadIndexCache();
+    void storeIndexCache();
+    int parallelChunkCount();
+    bool scanNalUnitsSerial();
+    bool scanNalUnitsParallel(int chunkCount);
     int findNextStartCode(int64_t startPos, int64_t& codePos, int& codeLen);
+    const uint8_t* bytesAt(int64_t offset, int maxLen, int& len);
     bool parseNalUnit(int64_t offset, int startCodeLen, TTNalUnit& nal);
-    bool parseSliceHeader(const QByteArray& data, TTNalUnit& nal);
+    int64_t nalEndOffset(int index) const;
+    TTNalUnit unpackNalUnit(int index) const;
     void buildAccessUnits();
     void buildGOPs();
 
-    // H.264 specific parsing
-    bool parseH264NalUnit(const QByteArray& data, TTNalUnit& nal);
-    bool parseH264SliceHeader(const QByteArray& data, TTNalUnit& nal);
+    // The NAL/slice/SPS/PPS parsers work on spans: a pointer straight into
+    // mMappedFile, or into mScratch when the file could not be mapped.
+
+    // H.264 specific parsing. The static parts take the SPS/PPS state as
+    // arguments so the parallel scan can run them off-thread.
+    bool parseH264NalUnit(const uint8_t* data, int size, TTNalUnit& nal);
+    static bool parseH264NalHeader(const uint8_t* data, int size, TTNalUnit& nal);
+    static void finishH264Slice(const uint8_t* data, int size, TTNalUnit& nal,
+                                const QMap<int, TTSpsInfo>& spsInfo,
+                                const QMap<int, int>& ppsToSps);
+    static bool parseH264SliceHeader(const uint8_t* data, int size, TTNalUnit& nal,
+                                     const QMap<int, TTSpsInfo>& spsInfo,
+                                     const QMap<int, int>& ppsToSps);
 
     // SPS/PPS parsing for PAFF (raw NAL body in, EP bytes are stripped internally)
-    void parseH264SpsData(const QByteArray& rawNal);
-    void parseH264PpsData(const QByteArray& data);
+    void parseH264SpsData(const uint8_t* rawNal, int size);
+    void parseH264PpsData(const uint8_t* data, int size);
+    static bool parseH264Pps(const uint8_t* data, int size, int& ppsId, int& spsId);
 
-    // H.265 specific parsing
-    bool parseH265NalUnit(const QByteArray& data, TTNalUnit& nal);
-    bool parseH265SliceHeader(const QByteArray& data, TTNalUnit& nal);
+    // H.265 specific parsing (no parameter-set state needed)
+    static bool parseH265NalUnit(const uint8_t* data, int size, TTNalUnit& nal);
+    static bool parseH265SliceHeader(const uint8_t* data, int size, TTNalUnit& nal);
 
     // Parameter set deduplication (only store unique SPS/PPS/VPS by content)
     void deduplicateList(QList<int>& list);
@@ -0,0 +1,171 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttstartcodescanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TT_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// ----------------------------------------------------------------------------
+// Scalar reference: the byte loop TTNaluParser::findNextStartCode() used
+// before the vector paths existed. Also finishes the tail of every vector
+// variant, so all of them share one definition of "a match".
+// ----------------------------------------------------------------------------
+static int64_t findPrefixScalar(const uint8_t* data, int64_t from, int64_t end)
+{
+    for (int64_t i = from; i < end; i++) {
+        // Fast skip: most bytes are not 0
+        if (data[i] != 0) continue;
+        if (data[i+1] == 0 && data[i+2] == 1)
+            return i;
+    }
+    return -1;
+}
+
+#ifdef TT_SCAN_X86
+
+// ----------------------------------------------------------------------------
+// SSE2 (baseline on x86-64): 2 x 16 candidate positions per iteration. For
+// each position p the three unaligned loads at p, p+1 and p+2 are compared
+// against 0, 0 and 1; the AND of the three masks has bit k set exactly when
+// a prefix starts at p+k, and the lowest set bit is the first match.
+// ----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+static int64_t findPrefixSSE2(const uint8_t* data, int64_t from, int64_t end)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one  = _mm_set1_epi8(1);
+
+    int64_t i = from;
+    for (; i + 32 <= end; i += 32) {
+        const uint8_t* p = data + i;
+
+        __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+        __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2));
+        __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 17));
+        __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 18));
+
+        __m128i m0 = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(a0, zero),
+                                                 _mm_cmpeq_epi8(b0, zero)),
+                                   _mm_cmpeq_epi8(c0, one));
+        __m128i m1 = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(a1, zero),
+                                                 _mm_cmpeq_epi8(b1, zero)),
+                                   _mm_cmpeq_epi8(c1, one));
+
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(m0))
+                      | (static_cast<uint32_t>(_mm_movemask_epi8(m1)) << 16);
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+
+    return findPrefixScalar(data, i, end);
+}
+
+// ----------------------------------------------------------------------------
+// AVX2: same scheme on 2 x 32 positions (64 per iteration). Only ever called
+// after __builtin_cpu_supports("avx2") said yes; the target attribute keeps
+// the rest of the build at the distribution's baseline ISA.
+// ----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+static int64_t findPrefixAVX2(const uint8_t* data, int64_t from, int64_t end)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one  = _mm256_set1_epi8(1);
+
+    int64_t i = from;
+    for (; i + 64 <= end; i += 64) {
+        const uint8_t* p = data + i;
+
+        __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+        __m256i c0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 2));
+        __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 33));
+        __m256i c1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 34));
+
+        __m256i m0 = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(a0, zero),
+                                                       _mm256_cmpeq_epi8(b0, zero)),
+                                      _mm256_cmpeq_epi8(c0, one));
+        __m256i m1 = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(a1, zero),
+                                                       _mm256_cmpeq_epi8(b1, zero)),
+                                      _mm256_cmpeq_epi8(c1, one));
+
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(m0))
+                      | (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(m1))) << 32);
+        if (mask)
+            return i + __builtin_ctzll(mask);
+    }
+
+    // Fewer than 64 positions left: let SSE2 take 32 of them before the
+    // scalar tail.
+    return findPrefixSSE2(data, i, end);
+}
+
+#endif // TT_SCAN_X86
+
+// ----------------------------------------------------------------------------
+// Runtime selection (resolved once, thread-safe static init)
+// ----------------------------------------------------------------------------
+TTStartCodeScanner::Impl TTStartCodeScanner::activeImpl()
+{
+    static const Impl impl = isSupported(ImplAVX2) ? ImplAVX2
+                           : isSupported(ImplSSE2) ? ImplSSE2
+                           : ImplScalar;
+    return impl;
+}
+
+bool TTStartCodeScanner::isSupported(Impl impl)
+{
+    switch (impl) {
+        case ImplScalar:
+            return true;
+#ifdef TT_SCAN_X86
+        case ImplSSE2:
+            return __builtin_cpu_supports("sse2");
+        case ImplAVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* TTStartCodeScanner::implName(Impl impl)
+{
+    switch (impl) {
+        case ImplSSE2: return "SSE2";
+        case ImplAVX2: return "AVX2";
+        default:       return "scalar";
+    }
+}
+
+int64_t TTStartCodeScanner::findPrefix(const uint8_t* data, int64_t from, int64_t end)
+{
+    return findPrefixWith(activeImpl(), data, from, end);
+}
+
+int64_t TTStartCodeScanner::findPrefixWith(Impl impl, const uint8_t* data, int64_t from, int64_t end)
+{
+    if (!data || from >= end) return -1;
+    if (from < 0) from = 0;
+
+#ifdef TT_SCAN_X86
+    if (impl == ImplAVX2 && isSupported(ImplAVX2))
+        return findPrefixAVX2(data, from, end);
+    if (impl == ImplSSE2 && isSupported(ImplSSE2))
+        return findPrefixSSE2(data, from, end);
+#else
+    (void)impl;
+#endif
+    return findPrefixScalar(data, from, end);
+}
@@ -0,0 +1,51 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTSTARTCODESCANNER
+// Vectorised search for the Annex-B / MPEG start-code prefix 00 00 01.
+// Opening a 20-40 GB UHD recording is dominated by this scan, so the hot loop
+// compares 32 (SSE2) or 64 (AVX2) candidate positions per iteration instead
+// of one byte at a time. The implementation is picked once at runtime from
+// the CPU's feature bits; every variant returns exactly the position the
+// scalar reference loop would, which bench_startcode_scan verifies on real
+// ES files.
+//
+// Deliberately Qt-free: the scanner works on raw spans (mmap or a read
+// buffer) and is shared by every start-code consumer.
+
+#ifndef TTSTARTCODESCANNER_H
+#define TTSTARTCODESCANNER_H
+
+#include <cstdint>
+
+class TTStartCodeScanner
+{
+public:
+    enum Impl {
+        ImplScalar = 0,
+        ImplSSE2,
+        ImplAVX2
+    };
+
+    // Position p of the first 00 00 01 prefix with from <= p < end, or -1.
+    // The caller guarantees data[p+2] is readable for every p < end, i.e.
+    // end <= (buffer size - 3) -- the same bound the original byte loop used,
+    // so a prefix in the last three bytes of a buffer is never reported.
+    static int64_t findPrefix(const uint8_t* data, int64_t from, int64_t end);
+
+    // Same search through an explicitly chosen implementation (benchmarks
+    // and cross-checks). An unsupported impl falls back to scalar.
+    static int64_t findPrefixWith(Impl impl, const uint8_t* data, int64_t from, int64_t end);
+
+    static Impl activeImpl();
+    static bool isSupported(Impl impl);
+    static const char* implName(Impl impl);
+};
+
+#endif // TTSTARTCODESCANNER_H
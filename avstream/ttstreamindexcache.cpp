@@ -0,0 +1,286 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttstreamindexcache.h"
+
+#include "../common/ttmessagelogger.h"
+#include "../common/ttsettings.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+// Bump whenever a section's record layout changes: an old sidecar is then
+// simply treated as missing and rewritten.
+static const uint32_t kFormatVersion = 1;
+static const char kMagic[8] = { 'T', 'T', 'C', 'U', 'T', 'I', 'D', 'X' };
+
+// Stream key sampling: 16 evenly spaced 4 KB blocks (64 KB read per open)
+static const int kSampleCount = 16;
+static const int kSampleSize  = 4096;
+
+struct TTIdxHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t sectionCount;
+    int64_t  streamSize;
+    int64_t  streamMtimeMs;
+    uint64_t sampleHash;
+};
+
+struct TTIdxDirEntry {
+    uint32_t tag;
+    uint32_t reserved;
+    int64_t  offset;
+    int64_t  size;
+};
+
+// Serialises save() so two producers finishing at the same time merge
+// instead of overwriting each other's sections.
+static QMutex sSaveMutex;
+
+static int64_t alignUp8(int64_t v) { return (v + 7) & ~int64_t(7); }
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+TTStreamIndexCache::TTStreamIndexCache(const QString& streamPath)
+    : mStreamPath(streamPath),
+      mMapped(nullptr),
+      mMappedSize(0),
+      mHaveKey(false)
+{
+}
+
+TTStreamIndexCache::~TTStreamIndexCache()
+{
+    unmap();
+}
+
+bool TTStreamIndexCache::isEnabled()
+{
+    return TTSettings::instance()->createStreamIndex();
+}
+
+QString TTStreamIndexCache::sidecarPath(const QString& streamPath)
+{
+    return streamPath + ".ttidx";
+}
+
+// ----------------------------------------------------------------------------
+// Identity of the stream: size, mtime and an FNV-1a hash over sampled blocks
+// ----------------------------------------------------------------------------
+bool TTStreamIndexCache::streamKey(StreamKey& key)
+{
+    if (mHaveKey) {
+        key = mKey;
+        return true;
+    }
+
+    QFileInfo info(mStreamPath);
+    QFile stream(mStreamPath);
+    if (!info.exists() || !stream.open(QIODevice::ReadOnly))
+        return false;
+
+    StreamKey k;
+    k.size    = info.size();
+    k.mtimeMs = info.lastModified().toMSecsSinceEpoch();
+
+    uint64_t hash = 14695981039346656037ULL;
+    const int64_t span = qMax<int64_t>(0, k.size - kSampleSize);
+    for (int i = 0; i < kSampleCount; i++) {
+        const int64_t pos = (kSampleCount > 1) ? span * i / (kSampleCount - 1) : 0;
+        if (!stream.seek(pos)) return false;
+        const QByteArray block = stream.read(kSampleSize);
+        for (char c : block) {
+            hash ^= uint8_t(c);
+            hash *= 1099511628211ULL;
+        }
+    }
+    k.sampleHash = hash;
+
+    mKey = k;
+    mHaveKey = true;
+    key = k;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Load: map the sidecar and validate header, key and directory
+// ----------------------------------------------------------------------------
+bool TTStreamIndexCache::load()
+{
+    unmap();
+    if (!isEnabled()) return false;
+
+    const QString path = sidecarPath(mStreamPath);
+    if (!QFileInfo::exists(path)) return false;
+
+    StreamKey key;
+    if (!streamKey(key)) return false;
+
+    mFile.setFileName(path);
+    if (!mFile.open(QIODevice::ReadOnly)) return false;
+
+    mMappedSize = mFile.size();
+    if (mMappedSize < int64_t(sizeof(TTIdxHeader))) {
+        unmap();
+        return false;
+    }
+    mMapped = mFile.map(0, mMappedSize);
+    if (!mMapped) {
+        unmap();
+        return false;
+    }
+
+    TTIdxHeader hdr;
+    memcpy(&hdr, mMapped, sizeof(hdr));
+    const bool current = memcmp(hdr.magic, kMagic, sizeof(kMagic)) == 0
+                      && hdr.version == kFormatVersion
+                      && hdr.streamSize == key.size
+                      && hdr.streamMtimeMs == key.mtimeMs
+                      && hdr.sampleHash == key.sampleHash;
+    const int64_t dirEnd = int64_t(sizeof(TTIdxHeader))
+                         + int64_t(hdr.sectionCount) * int64_t(sizeof(TTIdxDirEntry));
+    if (!current || dirEnd > mMappedSize) {
+        if (TTSettings::instance()->logAVStream())
+            qDebug() << "TTStreamIndexCache: stale index" << path << "- rescanning";
+        unmap();
+        return false;
+    }
+
+    for (uint32_t i = 0; i < hdr.sectionCount; i++) {
+        TTIdxDirEntry e;
+        memcpy(&e, mMapped + sizeof(TTIdxHeader) + i * sizeof(TTIdxDirEntry), sizeof(e));
+        if (e.offset < dirEnd || e.size < 0 || e.offset + e.size > mMappedSize) {
+            if (TTSettings::instance()->logAVStream())
+                qDebug() << "TTStreamIndexCache: damaged index" << path << "- rescanning";
+            unmap();
+            return false;
+        }
+        mSections.insert(e.tag, qMakePair(e.offset, e.size));
+    }
+
+    if (TTSettings::instance()->logAVStream())
+        qDebug() << "TTStreamIndexCache: using" << path << "(" << mSections.size() << "sections,"
+                 << (mMappedSize / 1024) << "KB)";
+    return true;
+}
+
+void TTStreamIndexCache::unmap()
+{
+    if (mMapped) {
+        mFile.unmap(mMapped);
+        mMapped = nullptr;
+    }
+    if (mFile.isOpen())
+        mFile.close();
+    mMappedSize = 0;
+    mSections.clear();
+}
+
+// ----------------------------------------------------------------------------
+// Sections
+// ----------------------------------------------------------------------------
+QByteArray TTStreamIndexCache::section(uint32_t tag) const
+{
+    auto it = mSections.constFind(tag);
+    if (it == mSections.constEnd() || !mMapped) return QByteArray();
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(mMapped + it->first),
+                                   it->second);
+}
+
+void TTStreamIndexCache::setSection(uint32_t tag, const QByteArray& payload)
+{
+    mPending.insert(tag, payload);
+}
+
+// ----------------------------------------------------------------------------
+// Save: merge with the sections of a still-valid sidecar, write atomically
+// ----------------------------------------------------------------------------
+bool TTStreamIndexCache::save()
+{
+    if (!isEnabled() || mPending.isEmpty()) return false;
+
+    StreamKey key;
+    if (!streamKey(key)) {
+        mLastError = QString("Cannot read stream %1").arg(mStreamPath);
+        return false;
+    }
+
+    QMutexLocker lock(&sSaveMutex);
+
+    // Sections another producer wrote since (or before) our load()
+    QMap<uint32_t, QByteArray> sections;
+    {
+        TTStreamIndexCache current(mStreamPath);
+        current.mKey = key;
+        current.mHaveKey = true;
+        if (current.load()) {
+            for (auto it = current.mSections.constBegin(); it != current.mSections.constEnd(); ++it) {
+                const QByteArray view = current.section(it.key());
+                sections.insert(it.key(), QByteArray(view.constData(), view.size()));
+            }
+        }
+    }
+    for (auto it = mPending.constBegin(); it != mPending.constEnd(); ++it)
+        sections.insert(it.key(), it.value());
+
+    TTIdxHeader hdr;
+    memcpy(hdr.magic, kMagic, sizeof(kMagic));
+    hdr.version       = kFormatVersion;
+    hdr.sectionCount  = uint32_t(sections.size());
+    hdr.streamSize    = key.size;
+    hdr.streamMtimeMs = key.mtimeMs;
+    hdr.sampleHash    = key.sampleHash;
+
+    QByteArray head(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    int64_t offset = alignUp8(int64_t(sizeof(TTIdxHeader))
+                            + int64_t(sections.size()) * int64_t(sizeof(TTIdxDirEntry)));
+    for (auto it = sections.constBegin(); it != sections.constEnd(); ++it) {
+        TTIdxDirEntry e;
+        e.tag      = it.key();
+        e.reserved = 0;
+        e.offset   = offset;
+        e.size     = it.value().size();
+        head.append(reinterpret_cast<const char*>(&e), sizeof(e));
+        offset = alignUp8(offset + e.size);
+    }
+
+    const QString path = sidecarPath(mStreamPath);
+    QSaveFile out(path);
+    bool ok = out.open(QIODevice::WriteOnly);
+    if (ok) {
+        head.append(QByteArray(alignUp8(head.size()) - head.size(), '\0'));
+        ok = out.write(head) == head.size();
+        for (auto it = sections.constBegin(); ok && it != sections.constEnd(); ++it) {
+            const QByteArray& payload = it.value();
+            ok = out.write(payload) == payload.size();
+            const int pad = int(alignUp8(payload.size()) - payload.size());
+            if (ok && pad > 0)
+                ok = out.write(QByteArray(pad, '\0')) == pad;
+        }
+    }
+    ok = ok && out.commit();
+    if (!ok) {
+        out.cancelWriting();
+        mLastError = QString("Cannot write stream index %1: %2").arg(path, out.errorString());
+        TTMessageLogger::getInstance()->infoMsg(__FILE__, __LINE__, mLastError);
+        return false;
+    }
+
+    mPending.clear();
+    if (TTSettings::instance()->logAVStream())
+        qDebug() << "TTStreamIndexCache: wrote" << path << "(" << sections.size() << "sections,"
+                 << (offset / 1024) << "KB)";
+    return true;
+}
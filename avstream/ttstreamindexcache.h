@@ -0,0 +1,127 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTSTREAMINDEXCACHE
+// Persistent index sidecar "<stream>.ttidx" next to an H.26x elementary
+// stream. Opening a stream indexes it up to three times (libav frame index in
+// TTFFmpegWrapper, NAL scan in TTNaluParser for every cut/preview, and the
+// standalone TTDisplayOrderMap pass); on a multi-hour recording each of these
+// takes tens of seconds and all of them are repeated on every project load.
+// Each producer stores its tables here as a tagged section and reads them
+// back on the next open instead of rescanning.
+//
+// File layout (native byte order, version-checked):
+//   header    magic, format version, section count, stream key
+//   directory one (tag, offset, size) entry per section
+//   payloads  8-byte aligned
+// The stream key is size + mtime + a hash over 16 samples of the stream, so a
+// re-recorded or edited stream invalidates the sidecar. load() maps the file;
+// section() returns views into that mapping.
+//
+// Writers merge: save() keeps the sections of a still-valid sidecar that
+// this object did not replace, so the wrapper and the parser can fill one
+// file independently.
+
+#ifndef TTSTREAMINDEXCACHE_H
+#define TTSTREAMINDEXCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QMap>
+#include <QPair>
+#include <QVector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+class TTStreamIndexCache
+{
+public:
+    // Four-character section tag, e.g. tag("NALO")
+    static constexpr uint32_t tag(const char (&s)[5])
+    {
+        return uint32_t(uint8_t(s[0])) | uint32_t(uint8_t(s[1])) << 8
+             | uint32_t(uint8_t(s[2])) << 16 | uint32_t(uint8_t(s[3])) << 24;
+    }
+
+    explicit TTStreamIndexCache(const QString& streamPath);
+    ~TTStreamIndexCache();
+
+    // TTSettings::createStreamIndex(); load()/save() are no-ops when off
+    static bool isEnabled();
+    static QString sidecarPath(const QString& streamPath);
+
+    // Map the sidecar; false if it is missing, of another format version or
+    // does not match the stream's current key.
+    bool load();
+    bool isLoaded() const { return mMapped != nullptr; }
+
+    // Payload of a section as a view into the mapping (no copy). Valid while
+    // this object lives; empty if the section is absent.
+    QByteArray section(uint32_t tag) const;
+    bool hasSection(uint32_t tag) const { return mSections.contains(tag); }
+
+    // Replace a section for the next save()
+    void setSection(uint32_t tag, const QByteArray& payload);
+
+    // Write the sidecar atomically. False (with a log line) if the directory
+    // is not writable; callers simply rescan next time.
+    bool save();
+
+    // Flat arrays of trivially copyable records
+    template <typename T>
+    bool readArray(uint32_t tag, QVector<T>& out) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "raw record array");
+        if (!hasSection(tag)) return false;
+        const QByteArray raw = section(tag);
+        if (raw.size() % sizeof(T) != 0) return false;
+        out.resize(raw.size() / sizeof(T));
+        if (!out.isEmpty())
+            memcpy(out.data(), raw.constData(), raw.size());
+        return true;
+    }
+
+    template <typename T>
+    void setArray(uint32_t tag, const QVector<T>& data)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "raw record array");
+        setSection(tag, QByteArray(reinterpret_cast<const char*>(data.constData()),
+                                   data.size() * sizeof(T)));
+    }
+
+    QString lastError() const { return mLastError; }
+
+    // Identity of the stream (size, mtime, sampled hash); other sidecars
+    // key themselves the same way (TTThumbnailAtlas)
+    struct StreamKey {
+        int64_t  size = -1;
+        int64_t  mtimeMs = 0;
+        uint64_t sampleHash = 0;
+    };
+    bool streamKey(StreamKey& key);
+
+private:
+    void unmap();
+
+    QString mStreamPath;
+    QFile mFile;
+    uchar* mMapped;
+    int64_t mMappedSize;
+    bool mHaveKey;
+    StreamKey mKey;
+
+    QMap<uint32_t, QPair<int64_t, int64_t>> mSections;   // tag -> (offset, size) in mapping
+    QMap<uint32_t, QByteArray> mPending;                 // set by setSection()
+
+    QString mLastError;
+};
+
+#endif // TTSTREAMINDEXCACHE_H
@@ -31,19 +31,121 @@
 #include "../common/ttexception.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 bool videoHeaderListCompareItems( TTAVHeader* head_1, TTAVHeader* head_2 );
 
+// 4 MB per arena block: about 70000 picture headers
+static const size_t arenaBlockSize = 4 * 1024 * 1024;
+
 /*! ////////////////////////////////////////////////////////////////////////////
  * Constructor
  */
 TTVideoHeaderList::TTVideoHeaderList(int size)
   :TTHeaderList( size )
 {
+  mArenaUsed    = arenaBlockSize;
 }
 
 TTVideoHeaderList::~TTVideoHeaderList()
 {
+  // Owners call deleteAll() first; the blocks go in any case
+  releaseArena();
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Add a header: it learns its list position and is entered in the position
+ * vector of its type
+ */
+void TTVideoHeaderList::add(TTAVHeader* header)
+{
+  TTHeaderList::add(header);
+  enterTypePositions(size()-1);
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Append the headers of part (one partition of a parallel header scan)
+ */
+void TTVideoHeaderList::takeHeaders(TTVideoHeaderList* part)
+{
+  const int first = size();
+  reserve(first + part->size());
+  for (int i = 0; i < part->size(); i++)
+    append(part->at(i));
+  enterTypePositions(first);
+
+  // The arena continues in part's last block
+  if (!part->mArenaBlocks.isEmpty()) {
+    mArenaBlocks += part->mArenaBlocks;
+    mArenaUsed    = part->mArenaUsed;
+  }
+
+  part->clear();
+  part->mArenaBlocks.clear();
+  part->mArenaUsed  = arenaBlockSize;
+  part->clearTypePositions();
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Delete all headers: arena headers are destroyed in place and their blocks
+ * freed, the others deleted
+ */
+void TTVideoHeaderList::deleteAll()
+{
+  for (int i = 0; i < size(); i++)
+  {
+    TTAVHeader* av_header = at(i);
+    if (av_header == NULL)
+      continue;
+    if (av_header->arenaOwned())
+      av_header->~TTAVHeader();
+    else
+      delete av_header;
+  }
+  clear();
+  releaseArena();
+  clearTypePositions();
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Bump allocation from the current block, a new block when it is full
+ */
+void* TTVideoHeaderList::allocate(size_t size, size_t align)
+{
+  size_t offset = (mArenaUsed + align - 1) & ~(align - 1);
+  if (offset + size > arenaBlockSize)
+  {
+    char* block = static_cast<char*>(malloc(arenaBlockSize));
+    if (block == NULL)
+      throw std::bad_alloc();
+    mArenaBlocks.append(block);
+    offset = 0;
+  }
+  mArenaUsed = offset + size;
+  return mArenaBlocks.last() + offset;
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Free the arena blocks. Headers still in the list are destroyed first.
+ */
+void TTVideoHeaderList::releaseArena()
+{
+  if (mArenaBlocks.isEmpty())
+    return;
+
+  for (int i = 0; i < size(); i++)
+  {
+    TTAVHeader* av_header = at(i);
+    if (av_header != NULL && av_header->arenaOwned())
+      av_header->~TTAVHeader();
+  }
+  if (size() > 0)
+    clear();
+
+  for (char* block : mArenaBlocks)
+    free(block);
+  mArenaBlocks.clear();
+  mArenaUsed  = arenaBlockSize;
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
@@ -74,10 +176,18 @@ TTVideoHeader* TTVideoHeaderList::getNextHeader(int startPos, TTMpeg2VideoHeader
   if (nextIndex < 0 || nextIndex >= count())
     return NULL;
 
-  if (nextIndex < count() && type == TTMpeg2VideoHeader::ndef) {
+  if (type == TTMpeg2VideoHeader::ndef) {
     return (TTVideoHeader*)at(nextIndex);
   }
 
+  QVector<int>* positions = typePositions(type);
+
+  if (positions != NULL) {
+    QVector<int>::const_iterator it =
+        std::lower_bound(positions->constBegin(), positions->constEnd(), nextIndex);
+    return (it != positions->constEnd()) ? (TTVideoHeader*)at(*it) : NULL;
+  }
+
   while (nextIndex < count())
   {
     if (at(nextIndex)->headerType() == type)
@@ -92,7 +202,48 @@ TTVideoHeader* TTVideoHeaderList::getNextHeader(int startPos, TTMpeg2VideoHeader
 TTVideoHeader* TTVideoHeaderList::getNextHeader(TTVideoHeader* current, TTMpeg2VideoHeader::mpeg2StartCodes type)
 {
   return (current != NULL)
-      ? getNextHeader(indexOf((TTAVHeader*)current), type)
+      ? getNextHeader(positionOf(current), type)
+      : NULL;
+}
+
+/*! //////////////////////////////////////////////////////////////////////////////////////
+ * Returns the header of type before startPos (the one just before if type is
+ * ndef), NULL if there is none
+ */
+TTVideoHeader* TTVideoHeaderList::getPrevHeader(int startPos, TTMpeg2VideoHeader::mpeg2StartCodes type)
+{
+  int prevIndex = startPos-1;
+
+  if (prevIndex < 0 || prevIndex >= count())
+    return NULL;
+
+  if (type == TTMpeg2VideoHeader::ndef) {
+    return (TTVideoHeader*)at(prevIndex);
+  }
+
+  QVector<int>* positions = typePositions(type);
+
+  if (positions != NULL) {
+    QVector<int>::const_iterator it =
+        std::upper_bound(positions->constBegin(), positions->constEnd(), prevIndex);
+    return (it != positions->constBegin()) ? (TTVideoHeader*)at(*(it-1)) : NULL;
+  }
+
+  while (prevIndex >= 0)
+  {
+    if (at(prevIndex)->headerType() == type)
+      return (TTVideoHeader*)at(prevIndex);
+
+    prevIndex--;
+  }
+
+  return NULL;
+}
+
+TTVideoHeader* TTVideoHeaderList::getPrevHeader(TTVideoHeader* current, TTMpeg2VideoHeader::mpeg2StartCodes type)
+{
+  return (current != NULL)
+      ? getPrevHeader(positionOf(current), type)
       : NULL;
 }
 
@@ -114,18 +265,12 @@ TTSequenceHeader* TTVideoHeaderList::firstSequenceHeader()
   if (size() == 0)
   	throw TTInvalidOperationException("Invalid");
 
-  // The bound is checked BEFORE at() reads: a list without any sequence
-  // header used to run index up to count() and trip the Q_ASSERT in
-  // QList::at, which aborts the process. Returning NULL is what the
-  // signature already allowed and what TTVideoStream::frameRate() and
-  // bitRate() expect - they fall back to 25.0 resp. 0.0.
-  for (int index = 0; index < count(); index++)
-  {
-    if (at(index)->headerType() == TTMpeg2VideoHeader::sequence_start_code)
-      return (TTSequenceHeader*)at(index);
-  }
-
-  return NULL;
+  // A list without any sequence header returns NULL: what the signature
+  // allows and what TTVideoStream::frameRate() and bitRate() expect - they
+  // fall back to 25.0 resp. 0.0.
+  return (!mSequencePos.isEmpty())
+      ? (TTSequenceHeader*)at(mSequencePos.first())
+      : NULL;
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
@@ -150,15 +295,79 @@ int TTVideoHeaderList::headerIndex( TTVideoHeader* current )
     throw TTInvalidOperationException(msg);
   }
 
+  return positionOf( current );
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * List position of current: the position it was told by add(), a search only
+ * if the list was rearranged behind the list's back
+ */
+int TTVideoHeaderList::positionOf( TTVideoHeader* current )
+{
+  if (current == NULL)
+    return -1;
+
+  int index = current->listIndex();
+  if (index >= 0 && index < size() && at(index) == current)
+    return index;
+
   return indexOf( (TTAVHeader*)current );
 }
 
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Position vector for the header type, NULL for types without one
+ */
+QVector<int>* TTVideoHeaderList::typePositions( quint8 type )
+{
+  switch (type)
+  {
+    case TTMpeg2VideoHeader::sequence_start_code: return &mSequencePos;
+    case TTMpeg2VideoHeader::group_start_code:    return &mGOPPos;
+    case TTMpeg2VideoHeader::picture_start_code:  return &mPicturePos;
+    case TTMpeg2VideoHeader::sequence_end_code:   return &mSequenceEndPos;
+    default:                                      return NULL;
+  }
+}
+
+/*! ////////////////////////////////////////////////////////////////////////////
+ * Enter the headers from list position first on: list position and type
+ * vector. Called by everything that changes the list (add(), takeHeaders(),
+ * sort()), so the lookups never rebuild anything.
+ */
+void TTVideoHeaderList::enterTypePositions(int first)
+{
+  for (int i = first; i < size(); i++)
+  {
+    TTVideoHeader* header = (TTVideoHeader*)at(i);
+    if (header == NULL)
+      continue;
+
+    header->setListIndex(i);
+
+    QVector<int>* positions = typePositions(header->headerType());
+    if (positions != NULL)
+      positions->append(i);
+  }
+}
+
+void TTVideoHeaderList::clearTypePositions()
+{
+  mSequencePos.clear();
+  mGOPPos.clear();
+  mPicturePos.clear();
+  mSequenceEndPos.clear();
+}
+
 /*! ///////////////////////////////////////////////////////////////////////////
  * Sort the header list by header offset
  */
 void TTVideoHeaderList::sort()
 {
   std::sort( begin(), end(), videoHeaderListCompareItems );
+
+  // Every position may have changed
+  clearTypePositions();
+  enterTypePositions(0);
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
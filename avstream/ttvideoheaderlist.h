@@ -32,12 +32,23 @@
 #include "ttheaderlist.h"
 #include "ttmpeg2videoheader.h"
 
+#include <new>
+
 class TTSequenceHeader;
 class TTPicturesHeader;
 class TTGOPHeader;
 
 /* /////////////////////////////////////////////////////////////////////////////   
  * TTVideoHeaderList: Pointer list MPEG2 header objects
+ * The headers the MPEG-2 parser creates come from the list's arena
+ * (create<T>()): large contiguous blocks instead of one heap allocation per
+ * header, released as a whole by deleteAll(). Each header knows whether it
+ * came from the arena (arenaOwned()); headers add()ed from the heap are still
+ * deleted one by one.
+ * Navigation does not search the list: add() tells every header its list
+ * position, and the positions of the sequence, GOP, picture and sequence end
+ * headers are kept in ascending per-type vectors, so the next/previous header
+ * of a type is a binary search. Headers must be add()ed, not append()ed.
  */
 class TTVideoHeaderList : public TTHeaderList
 {
@@ -45,6 +56,22 @@ class TTVideoHeaderList : public TTHeaderList
     TTVideoHeaderList(int size);
     virtual ~TTVideoHeaderList();
 
+    // New header in the arena, owned by the list: never delete it
+    template <class T>
+    T* create()
+    {
+      T* header = new (allocate(sizeof(T), alignof(T))) T();
+      header->setArenaOwned(true);
+      return header;
+    }
+
+    void add(TTAVHeader* header) override;
+    void deleteAll() override;
+
+    // Move all headers of part to the end of this list, together with the
+    // arena blocks holding them; part is empty afterwards
+    void takeHeaders(TTVideoHeaderList* part);
+
     quint8            headerTypeAt(int index);
     TTVideoHeader*    headerAt(int index);
     TTVideoHeader*    getPrevHeader(int startPos, TTMpeg2VideoHeader::mpeg2StartCodes type = TTMpeg2VideoHeader::ndef);
@@ -59,5 +86,24 @@ class TTVideoHeaderList : public TTHeaderList
 
   protected:
     virtual void sort();
+
+  private:
+    int           positionOf(TTVideoHeader* current);
+    QVector<int>* typePositions(quint8 type);
+    void          enterTypePositions(int first);
+    void          clearTypePositions();
+
+    void* allocate(size_t size, size_t align);
+    void  releaseArena();
+
+    QVector<char*> mArenaBlocks;
+    size_t         mArenaUsed;     // bytes used in the last block
+
+    // List positions per header type, ascending; kept current by add(),
+    // takeHeaders() and sort()
+    QVector<int>   mSequencePos;
+    QVector<int>   mGOPPos;
+    QVector<int>   mPicturePos;
+    QVector<int>   mSequenceEndPos;
 };
 #endif //TTVIDEOHEADERLIST_H
@@ -23,9 +23,9 @@ const char c_name[] = "TTVIDEOINDEX  : ";
 /*! ////////////////////////////////////////////////////////////////////////////
  * Compare function for sorting the video index list by display order
  */
-bool compareFunc( TTVideoIndex* index_1, TTVideoIndex* index_2 )
+bool compareFunc( const TTVideoIndex& index_1, const TTVideoIndex& index_2 )
 {
-  return (index_1->getDisplayOrder() < index_2->getDisplayOrder());
+  return (index_1.getDisplayOrder() < index_2.getDisplayOrder());
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
@@ -47,21 +47,31 @@ TTVideoIndexList::~TTVideoIndexList()
 /*! /////////////////////////////////////////////////////////////////////////////
  * Add index to video index list
  */
-void TTVideoIndexList::add(TTVideoIndex* index)
+void TTVideoIndexList::add(const TTVideoIndex& index)
 {
- append(index); 
+  mIndex.append(index);
 }
 
+void TTVideoIndexList::add(int displayOrder, int headerListIndex, int pictureCodingType)
+{
+  mIndex.append(TTVideoIndex(displayOrder, headerListIndex, pictureCodingType));
+}
+
+/*! /////////////////////////////////////////////////////////////////////////////
+ * Reserve space for size entries (the picture count is known in advance)
+ */
+void TTVideoIndexList::reserve(int size)
+{
+  mIndex.reserve(size);
+}
+
+/*! /////////////////////////////////////////////////////////////////////////////
+ * Remove all entries
+ */
 void TTVideoIndexList::deleteAll()
 {
-  for (int i = 0; i < size(); i++)
-  {
-    TTVideoIndex* v_index = at(i);
-    if (v_index != NULL) {
-      delete v_index;
-    }
-  }
-  clear();
+  mIndex.clear();
+  mIndex.squeeze();
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
@@ -70,7 +80,7 @@ void TTVideoIndexList::deleteAll()
 TTVideoIndex* TTVideoIndexList::videoIndexAt( int index )
 {
   checkIndexRange( index );
-  return (TTVideoIndex*)at( index );
+  return &mIndex[index];
 }
 
 /*! ////////////////////////////////////////////////////////////////////////////
@@ -112,7 +122,7 @@ int  TTVideoIndexList::pictureCodingType( int index )
  */
 void TTVideoIndexList::sort()
 {
-  std::sort( begin(), end(), compareFunc );
+  std::sort( mIndex.begin(), mIndex.end(), compareFunc );
 }
 
 /*! ///////////////////////////////////////////////////////////////////////////// 
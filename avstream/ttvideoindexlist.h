@@ -21,17 +21,26 @@
 #include "../common/ttmessagelogger.h"
 
 // -----------------------------------------------------------------------------
-// TTVideoIndexList: List of pointers to TTFrameIndex 
+// TTVideoIndexList: List of TTVideoIndex entries
 // -----------------------------------------------------------------------------
-class TTVideoIndexList : public QVector<TTVideoIndex*>
+// The entries are stored by value in one contiguous vector: twelve bytes per
+// picture instead of a heap object plus a pointer, and sorting moves the
+// entries themselves. Pointers from videoIndexAt() are valid until the next
+// add() or sort.
+class TTVideoIndexList
 {
  public:
   TTVideoIndexList();
   virtual ~TTVideoIndexList();
 
-  void add(TTVideoIndex* index);
+  void add(const TTVideoIndex& index);
+  void add(int displayOrder, int headerListIndex, int pictureCodingType);
+  void reserve(int size);
   void deleteAll();
 
+  int  count() const { return mIndex.size(); }
+  int  size() const  { return mIndex.size(); }
+
   TTVideoIndex* videoIndexAt(int index);
 
   void sortDisplayOrder();
@@ -49,8 +58,9 @@ class TTVideoIndexList : public QVector<TTVideoIndex*>
   void checkIndexRange(int index);
 
  protected:
-  TTMessageLogger* log;
-  int current_order;
+  TTMessageLogger*      log;
+  int                   current_order;
+  QVector<TTVideoIndex> mIndex;
 };
 #endif //TTVIDEOINDEXLIST_H
 
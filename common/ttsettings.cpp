@@ -87,6 +87,12 @@ void TTSettings::setSearchWorkerCount(int v)
   mSearchWorkerCount = v;
 }
 
+void TTSettings::setReencodeMemoryLimitMB(int v)
+{
+  if (mReencodeMemoryLimitMB == v) return;
+  mReencodeMemoryLimitMB = v;
+}
+
 // ---- Navigation Steps group setters (Task 5) -------------------------------
 // Each setter early-outs on no-op assignment.
 
@@ -130,6 +136,12 @@ void TTSettings::setStepMouseWheel(int v)
 // ---- Index Files & Logging group setters (Task 6) --------------------------
 // Each setter early-outs on no-op assignment.
 
+void TTSettings::setCreateStreamIndex(bool v)
+{
+  if (mCreateStreamIndex == v) return;
+  mCreateStreamIndex = v;
+}
+
 void TTSettings::setCreateLogFile(bool v)
 {
   if (mCreateLogFile == v) return;
@@ -178,6 +190,12 @@ void TTSettings::setLogMkvMux(bool v)
   mLogMkvMux = v;
 }
 
+void TTSettings::setLogPsMux(bool v)
+{
+  if (mLogPsMux == v) return;
+  mLogPsMux = v;
+}
+
 void TTSettings::setLogCutPipeline(bool v)
 {
   if (mLogCutPipeline == v) return;
@@ -535,6 +553,12 @@ void TTSettings::setMuxDeleteES(bool v)
   mMuxDeleteES = v;
 }
 
+void TTSettings::setMuxStreamDirect(bool v)
+{
+  if (mMuxStreamDirect == v) return;
+  mMuxStreamDirect = v;
+}
+
 void TTSettings::setMkvCreateChapters(bool v)
 {
   if (mMkvCreateChapters == v) return;
@@ -677,9 +701,14 @@ void TTSettings::load()
   mSearchWorkerCount = qBound(0, settings.value("WorkerCount/", 0).toInt(), 16);
   settings.endGroup();
 
+  settings.beginGroup("SmartCut");
+  mReencodeMemoryLimitMB = settings.value("ReencodeMemoryLimitMB/", mReencodeMemoryLimitMB).toInt();
+  settings.endGroup();
+
   // ----- Index Files group (Task 6) ------------------------------------
   settings.beginGroup("IndexFiles");
   mCreateD2V      = settings.value("CreateD2V/",      mCreateD2V).toBool();
+  mCreateStreamIndex = settings.value("CreateStreamIndex/", mCreateStreamIndex).toBool();
   settings.endGroup();
 
   // ----- Logging group (Task 6) ----------------------------------------
@@ -692,6 +721,7 @@ void TTSettings::load()
   mLogFFmpegDecoder = settings.value("LogFFmpegDecoder/", mLogFFmpegDecoder).toBool();
   mLogSmartCut = settings.value("LogSmartCut/", mLogSmartCut).toBool();
   mLogMkvMux = settings.value("LogMkvMux/", mLogMkvMux).toBool();
+  mLogPsMux = settings.value("LogPsMux/", mLogPsMux).toBool();
   mLogCutPipeline = settings.value("LogCutPipeline/", mLogCutPipeline).toBool();
   mLogAVStream = settings.value("LogAVStream/", mLogAVStream).toBool();
   mLogUI = settings.value("LogUI/", mLogUI).toBool();
@@ -762,6 +792,7 @@ void TTSettings::load()
   mMuxMode             = settings.value("MuxMode/",             mMuxMode).toInt();
   mMuxOutputPath       = settings.value("MuxOutputDir/",        mMuxOutputPath).toString();   // key is "MuxOutputDir/"
   mMuxDeleteES         = settings.value("MuxDeleteES/",         mMuxDeleteES).toBool();
+  mMuxStreamDirect     = settings.value("MuxStreamDirect/",     mMuxStreamDirect).toBool();
   mOutputContainer     = settings.value("OutputContainer/",     mOutputContainer).toInt();
   // Legacy migration: the MP4 option (value 2) was removed; remap any
   // stale persisted value of 2 to MKV (1). Mirrors the migration in former
@@ -919,9 +950,14 @@ void TTSettings::save()
   settings.setValue("WorkerCount/", mSearchWorkerCount);
   settings.endGroup();
 
+  settings.beginGroup("SmartCut");
+  settings.setValue("ReencodeMemoryLimitMB/", mReencodeMemoryLimitMB);
+  settings.endGroup();
+
   // ----- Index Files group (Task 6) ------------------------------------
   settings.beginGroup("IndexFiles");
   settings.setValue("CreateD2V/",      mCreateD2V);
+  settings.setValue("CreateStreamIndex/", mCreateStreamIndex);
   settings.endGroup();
 
   // ----- Logging group (Task 6) ----------------------------------------
@@ -934,6 +970,7 @@ void TTSettings::save()
   settings.setValue("LogFFmpegDecoder/", mLogFFmpegDecoder);
   settings.setValue("LogSmartCut/", mLogSmartCut);
   settings.setValue("LogMkvMux/", mLogMkvMux);
+  settings.setValue("LogPsMux/", mLogPsMux);
   settings.setValue("LogCutPipeline/", mLogCutPipeline);
   settings.setValue("LogAVStream/", mLogAVStream);
   settings.setValue("LogUI/", mLogUI);
@@ -972,6 +1009,7 @@ void TTSettings::save()
   settings.setValue("MuxMode/",             mMuxMode);
   settings.setValue("MuxOutputDir/",        mMuxOutputPath);   // key is "MuxOutputDir/"
   settings.setValue("MuxDeleteES/",         mMuxDeleteES);
+  settings.setValue("MuxStreamDirect/",     mMuxStreamDirect);
   settings.setValue("OutputContainer/",     mOutputContainer);
   settings.setValue("MkvCreateChapters/",   mMkvCreateChapters);
   settings.setValue("MkvChapterInterval/",  mMkvChapterInterval);
@@ -53,6 +53,12 @@ public:
   int     searchWorkerCount() const  { return mSearchWorkerCount; }
   void    setSearchWorkerCount(int v);
 
+  // Peak memory (MiB) for the decoded frames of the Smart Cut's boundary
+  // re-encodes; a run whose decode window would not fit streams instead
+  // (TTESSmartCut::setReencodeMemoryLimit). 0 = always stream, < 0 = no limit.
+  int     reencodeMemoryLimitMB() const { return mReencodeMemoryLimitMB; }
+  void    setReencodeMemoryLimitMB(int v);
+
 
   // ----- Navigation Steps group (Task 5) ----------------------------------
   int     stepSliderClick() const    { return mStepSliderClick; }
@@ -78,6 +84,12 @@ public:
   // ----- Index Files & Logging group (Task 6) -----------------------------
   bool    createD2V() const          { return mCreateD2V; }
 
+  // Persistent <es>.ttidx sidecar with the H.26x stream index (frame index,
+  // NAL/AU tables, display-order map), see TTStreamIndexCache. Also gates
+  // the QuickJump thumbnail atlas sidecars (TTThumbnailAtlas).
+  bool    createStreamIndex() const  { return mCreateStreamIndex; }
+  void    setCreateStreamIndex(bool v);
+
   bool    createLogFile() const      { return mCreateLogFile; }
   void    setCreateLogFile(bool v);
 
@@ -103,6 +115,9 @@ public:
   bool    logMkvMux() const          { return mLogMkvMux; }
   void    setLogMkvMux(bool v);
 
+  bool    logPsMux() const           { return mLogPsMux; }
+  void    setLogPsMux(bool v);
+
   bool    logCutPipeline() const     { return mLogCutPipeline; }
   void    setLogCutPipeline(bool v);
 
@@ -301,6 +316,12 @@ public:
   bool    muxDeleteES() const              { return mMuxDeleteES; }
   void    setMuxDeleteES(bool v);
 
+  // H.264/H.265 MKV output: when the ES would be deleted after muxing
+  // anyway, the smart cut feeds the matroska muxer directly and the cut
+  // video ES is never written (TTESPacketSink).
+  bool    muxStreamDirect() const          { return mMuxStreamDirect; }
+  void    setMuxStreamDirect(bool v);
+
 
   int     outputContainer() const          { return mOutputContainer; }
 
@@ -394,6 +415,7 @@ private:
   int     mCutPreviewSeconds = 25;
   int     mSearchLength      = 45;
   int     mSearchWorkerCount = 0;   // 0 = auto (qBound(1, idealThreadCount/2, 4))
+  int     mReencodeMemoryLimitMB = 1024;
 
   // ----- Navigation Steps group (Task 5) -----------------------------------
   // Defaults match common/ttcut.cpp lines 108-114 verbatim.
@@ -408,6 +430,7 @@ private:
   // ----- Index Files & Logging group (Task 6) ------------------------------
   // Defaults match common/ttcut.cpp lines 117-130 verbatim.
   bool    mCreateD2V         = false;
+  bool    mCreateStreamIndex = true;
   bool    mCreateLogFile     = true;
   QString mLogFilePath;           // empty = use TTMessageLogger default
   bool    mLogModeConsole    = false;
@@ -416,6 +439,7 @@ private:
   bool    mLogFFmpegDecoder = false;
   bool    mLogSmartCut = false;
   bool    mLogMkvMux = false;
+  bool    mLogPsMux = false;
   bool    mLogCutPipeline = false;
   bool    mLogAVStream = false;
   bool    mLogUI = false;
@@ -503,6 +527,7 @@ private:
   int     mMuxMode             = 0;
   QString mMuxOutputPath;          // initialised to QDir::homePath() in ctor
   bool    mMuxDeleteES         = false;
+  bool    mMuxStreamDirect     = true;
   int     mOutputContainer     = 1;   // 1=MKV (default for modern codecs)
   bool    mMkvCreateChapters   = true;
   int     mMkvChapterInterval  = 5;
@@ -33,7 +33,7 @@
 #include "../common/ttsettings.h"
 #include "../common/istatusreporter.h"
 
-#include "../extern/ttmplexprovider.h"
+#include "../extern/ttmpegpsmuxprovider.h"
 #include "../extern/ttmkvmergeprovider.h"
 #include "../extern/ttaudiorepair.h"
 #include "../avstream/ttesinfo.h"
@@ -1092,13 +1092,13 @@ void TTAVData::onUserAbortRequest()
   // mSyncPhaseAbort is what that phase polls instead.
   mSyncPhaseAbort.store(true, std::memory_order_relaxed);
 
-  // Same situation at the other end of the MPEG-2 cut: the mplex step of an
+  // Same situation at the other end of the MPEG-2 cut: the mux step of an
   // MPG-output cut runs synchronously on this thread inside onCutFinished(),
   // after the pool run is already over, so the pool call below has no task
-  // carrying it either. The provider polls its own flag in the loop it waits
-  // in and stops the external process (see TTMplexProvider::requestAbort).
-  if (mpMplexProvider != 0)
-    mpMplexProvider->requestAbort();
+  // carrying it either. The provider polls its own flag in its packet loop
+  // (see TTMpegPsMuxProvider::requestAbort).
+  if (mpPsMuxProvider != 0)
+    mpPsMuxProvider->requestAbort();
 
 	mpThreadTaskPool->onUserAbortRequest();
 }
@@ -1600,7 +1600,7 @@ void TTAVData::onDoCut(QString tgtFileName, TTCutList* cutList, bool audioOnly)
   mCutOperationActive = true;
 
   // Announce the planned stages for the progress estimator. MPEG-2 runs
-  // audio synchronously FIRST, then the pool video task, then mux (mplex or
+  // audio synchronously FIRST, then the pool video task, then mux (MPG or
   // MKV) inside onCutFinished.
   {
     TTAVItem* planItem = cutList->at(0).avDataItem();
@@ -1850,6 +1850,13 @@ void TTAVData::doH264Cut(QString tgtFileName, TTCutList* cutList)
   // branch of onDoCut().
   mCutOperationActive = true;
 
+  // Stream mux: the cut ES would be deleted right after muxing, so the Smart
+  // Cut feeds the muxer directly (TTH26xCutTask::runStreamCut). Audio is cut
+  // first then, and the mux has no stage of its own - also not when the run
+  // falls back to the ES path: that mux reports under the video stage.
+  const bool streamMux = TTSettings::instance()->muxStreamDirect()
+                      && TTSettings::instance()->workingMuxDeleteES();
+
   // Announce the planned stages + work amounts for the progress estimator.
   {
     double keptSecs = keepListSeconds(keepList);
@@ -1862,11 +1869,18 @@ void TTAVData::doH264Cut(QString tgtFileName, TTCutList* cutList)
     // start and the pre-stage totals.
     const QString videoCalibKey = (vStream->streamType() == TTAVTypes::h265_video)
         ? QStringLiteral("video/h265") : QStringLiteral("video/h264");
-    plan.append({ StatusReportArgs::StageVideo, videoCalibKey, keptSecs });
-    if (avItem->audioCount() > 0)
-      plan.append({ StatusReportArgs::StageAudio, audioCalibKey(avItem),
-                    keptSecs * avItem->audioCount() });
-    plan.append({ StatusReportArgs::StageMux, QStringLiteral("mux/h26xcut"), keptSecs });
+    if (streamMux) {
+      if (avItem->audioCount() > 0)
+        plan.append({ StatusReportArgs::StageAudio, audioCalibKey(avItem),
+                      keptSecs * avItem->audioCount() });
+      plan.append({ StatusReportArgs::StageVideo, videoCalibKey, keptSecs });
+    } else {
+      plan.append({ StatusReportArgs::StageVideo, videoCalibKey, keptSecs });
+      if (avItem->audioCount() > 0)
+        plan.append({ StatusReportArgs::StageAudio, audioCalibKey(avItem),
+                      keptSecs * avItem->audioCount() });
+      plan.append({ StatusReportArgs::StageMux, QStringLiteral("mux/h26xcut"), keptSecs });
+    }
     emit operationPlanReady(plan);
   }
 
@@ -1915,12 +1929,14 @@ void TTAVData::doH264Cut(QString tgtFileName, TTCutList* cutList)
   params.totalDurationMs     = mLastCutResultMs;
   params.cutFrames           = cutFrames;
   params.keepList            = keepList;
+  params.streamMux           = streamMux;
 
   // Frame-granularity display-order map from the open stream's wrapper.
   // Required for PAFF: TTESSmartCut's buildFromFile fallback is
   // field-granularity and would mismatch the parser's frame count.
   if (auto* h26x = dynamic_cast<TTH26xVideoStream*>(vStream)) {
     params.displayMap    = h26x->displayOrderMap();
+    params.naluIndex     = h26x->naluIndex();
     params.hasDisplayMap = true;
   }
 
@@ -2048,7 +2064,7 @@ void TTAVData::onCutFinished()
   }
 
   // Select muxer based on working container (transient, per-cut/per-project)
-  // 0 = MPG (mplex)
+  // 0 = MPG (libav program stream muxer; mplex for the mux script)
   // 1 = MKV (libav matroska muxer)
   // 3 = Elementary (no muxing; not reachable from UI, kept as defensive default)
 
@@ -2176,29 +2192,29 @@ void TTAVData::onCutFinished()
           qDebug() << "Elementary output selected, skipping muxing";
       break;
 
-    case 0: // TS - use mplex (default, existing behavior)
+    case 0: // MPG - in-process program stream muxer (default)
     default:
       {
-        TTMplexProvider* mplexProvider = new TTMplexProvider(mpMuxList);
+        TTMpegPsMuxProvider* muxProvider = new TTMpegPsMuxProvider(mpMuxList);
 
         // Apply A/V sync offset if present
         if (mAvSyncOffsetMs != 0) {
-          mplexProvider->setAudioSyncOffset(mAvSyncOffsetMs);
+          muxProvider->setAudioSyncOffset(mAvSyncOffsetMs);
         }
 
-        connect(mplexProvider, &TTMplexProvider::statusReport,
-                this,          &TTAVData::onStatusReport);
+        connect(muxProvider, &TTMpegPsMuxProvider::statusReport,
+                this,        &TTAVData::onStatusReport);
 
         if (TTSettings::instance()->workingMuxMode() == 1) {
-          mplexProvider->writeMuxScript();
+          muxProvider->writeMuxScript();
         }
         else {
-          // mplexPart() runs the external muxer synchronously on this thread
-          // and pumps the event loop while it waits, so the Cancel button's
+          // mplexPart() runs the muxer synchronously on this thread and pumps
+          // the event loop between packets, so the Cancel button's
           // onUserAbortRequest() executes re-entrantly inside it. Publishing
           // the provider is what gives that slot something to cancel; cleared
           // again the moment the call returns, well before the delete below.
-          mpMplexProvider = mplexProvider;
+          mpPsMuxProvider = muxProvider;
 
           // Seed the provider with a request that arrived BEFORE it existed.
           // There is a window between the video task's last abort poll and
@@ -2216,18 +2232,18 @@ void TTAVData::onCutFinished()
           // NOT honour the abort (had it done so, aborted() would have fired
           // and onCutAborted() would have disconnected this slot).
           if (mSyncPhaseAbort.load(std::memory_order_relaxed))
-            mplexProvider->requestAbort();
+            muxProvider->requestAbort();
 
-          mplexProvider->mplexPart(lastIdx);
-          mpMplexProvider = 0;
+          muxProvider->mplexPart(lastIdx);
+          mpPsMuxProvider = 0;
         }
 
-        const bool mplexAborted = mplexProvider->wasAborted();
-        if (!mplexProvider->succeeded())
-          mLastCutError = mplexProvider->lastError();
-        delete mplexProvider;
+        const bool muxAborted = muxProvider->wasAborted();
+        if (!muxProvider->succeeded())
+          mLastCutError = muxProvider->lastError();
+        delete muxProvider;
 
-        if (mplexAborted) {
+        if (muxAborted) {
           // Same situation as the synchronous audio phase in onDoCut(): the
           // pool run of this operation is already over (onThreadPoolExit()
           // ran before this slot), so none of the pool's abort machinery -
@@ -2247,10 +2263,10 @@ void TTAVData::onCutFinished()
           disconnect(mpThreadTaskPool, &TTThreadTaskPool::aborted, this, &TTAVData::onCutAborted);
 
           // The cut elementary streams that fed the mux. The partial .mpg is
-          // removed by TTMplexProvider itself (the only place that knows the
+          // removed by TTMpegPsMuxProvider itself (the only place that knows the
           // output path), so no file is deleted twice. Cancel-only by
           // construction: this branch is reached exclusively through
-          // wasAborted(), never through an mplex failure - a failed mux keeps
+          // wasAborted(), never through a mux failure - a failed mux keeps
           // its files for diagnosis.
           for (const QString& f : mCutProducedFiles) {
             if (f.isEmpty() || !QFile::exists(f)) continue;
@@ -2337,7 +2353,7 @@ void TTAVData::onMpeg2MuxFinished()
 
 //! Close the MPEG-2 cut operation - the single place that ends it.
 //!
-//! Called from the mplex/Elementary branches of onCutFinished() inline, and
+//! Called from the MPG/Elementary branches of onCutFinished() inline, and
 //! from onMpeg2MuxFinished() for the MKV branch (whose mux is a second pool
 //! run and therefore cannot finish inside onCutFinished()).
 //!
@@ -2602,9 +2618,9 @@ void TTAVData::onAudioOnlyCutFinished()
 }
 
 // This forwarder is reached from two kinds of caller: the one remaining
-// synchronous GUI-thread provider (mplex, run inline in onCutFinished for MPG
-// output), which needs the event loop pumped so the progress window repaints
-// while it blocks the GUI thread, and the cut tasks' worker threads
+// synchronous GUI-thread provider (the MPG muxer, run inline in
+// onCutFinished), which needs the event loop pumped so the progress window
+// repaints while it blocks the GUI thread, and the cut tasks' worker threads
 // (TTH26xCutTask, TTAudioOnlyCutTask, TTMuxTask), which must not. On a worker,
 // processEvents() would pump *that* thread's queue - it would not repaint
 // anything, but it would dispatch its deferred deletions at an arbitrary
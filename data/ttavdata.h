@@ -50,7 +50,7 @@ class TTCutVideoTask;
 class TTH26xCutTask;
 class TTAudioOnlyCutTask;
 class TTMuxTask;
-class TTMplexProvider;
+class TTMpegPsMuxProvider;
 class TTCutProjectData;
 class TTMuxListData;
 class TTMuxListDataItem;
@@ -225,7 +225,7 @@ class TTAVData : public QObject
                                            const QStringList& subtitleFilePaths = QStringList());
     //! Close the MPEG-2 cut operation: reset mCutOperationActive, emit the
     //! single final Exit bracket and cutFinished(). Called inline by
-    //! onCutFinished()'s mplex/Elementary branches and by onMpeg2MuxFinished()
+    //! onCutFinished()'s MPG/Elementary branches and by onMpeg2MuxFinished()
     //! for the MKV branch, whose mux is a second pool run.
     void           finishMpeg2Cut();
     void           doH264Cut(QString tgtFileName, TTCutList* cutList);
@@ -266,15 +266,15 @@ class TTAVData : public QObject
     //! Non-null only between onCutFinished() and onMpeg2MuxFinished()/
     //! onCutAborted().
     TTMuxTask*        mpMuxTask = nullptr;
-    //! mplex mux of an MPG-output MPEG-2 cut. Unlike every other cut engine
-    //! this one is NOT a pool task: it drives an external process
-    //! synchronously on the GUI thread inside onCutFinished(), so
-    //! mpThreadTaskPool->onUserAbortRequest() has nothing to deliver a cancel
-    //! to. Published here for exactly the duration of that mplexPart() call so
-    //! onUserAbortRequest() can reach it; null at every other moment. GUI
-    //! thread only - onUserAbortRequest() runs re-entrantly from mplexPart()'s
-    //! own qApp->processEvents(), never from another thread.
-    TTMplexProvider*  mpMplexProvider = nullptr;
+    //! Program-stream mux of an MPG-output MPEG-2 cut. Unlike every other cut
+    //! engine this one is NOT a pool task: it runs synchronously on the GUI
+    //! thread inside onCutFinished(), so mpThreadTaskPool->onUserAbortRequest()
+    //! has nothing to deliver a cancel to. Published here for exactly the
+    //! duration of that mplexPart() call so onUserAbortRequest() can reach it;
+    //! null at every other moment. GUI thread only - onUserAbortRequest() runs
+    //! re-entrantly from mplexPart()'s own qApp->processEvents(), never from
+    //! another thread.
+    TTMpegPsMuxProvider* mpPsMuxProvider = nullptr;
     TTCutProjectData* mpProjectData;
     int               mCurrentFramePosition;  // Track Current Frame widget position for frame search
 
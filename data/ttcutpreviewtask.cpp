@@ -208,6 +208,9 @@ void TTCutPreviewTask::operation()
 			QMutexLocker lock(&mSmartCutMutex);
 			mpActiveSmartCut = sharedSmartCut;
 		}
+		// Reuse the NAL index built at stream open instead of re-parsing the ES
+		if (auto* h26x = dynamic_cast<TTH26xVideoStream*>(vStream))
+			sharedSmartCut->setNaluIndex(h26x->naluIndex());
 		if (!sharedSmartCut->initialize(vStream->filePath(), frameRate)) {
 			// A cancel during the ES parse comes back through the same false
 			// return as a real parse failure — only the latter is a warning
@@ -564,6 +567,8 @@ void TTCutPreviewTask::createH264PreviewClip(TTCutList* cutList, const QString&
   TTESSmartCut* smartCut = sharedSmartCut;
   if (!smartCut) {
     localSmartCut.setPresetOverride(TTSettings::instance()->previewPreset());
+    if (auto* h26x = dynamic_cast<TTH26xVideoStream*>(vStream))
+      localSmartCut.setNaluIndex(h26x->naluIndex());
     if (!localSmartCut.initialize(sourceFile, frameRate)) {
       TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
           QString("Preview Smart Cut init failed: %1").arg(localSmartCut.lastError()));
@@ -101,6 +101,8 @@ void TTH26xCutTask::cleanUp()
  */
 void TTH26xCutTask::abortCleanup()
 {
+  // A stream mux session still holds the output open
+  mMkvProvider.abandonStreamMux();
   for (const QString& f : mCreatedFiles) {
     if (f.isEmpty() || !QFile::exists(f)) continue;
     if (!QFile::remove(f))
@@ -219,7 +221,14 @@ void TTH26xCutTask::runCut()
   connect(&mSmartCut, &TTESSmartCut::progressChanged, this,
       [this](int percent, const QString& msg) { reportStep(msg, percent); },
       Qt::DirectConnection);
+  // The muxer is also a member (see the header) so onUserAbort() can reach
+  // it. Connected here, once: a stream cut that falls back to the ES path
+  // configures it twice. Direct for the same reason as above.
+  connect(&mMkvProvider, &TTMkvMergeProvider::progressChanged, this,
+      [this](int percent, const QString& msg) { reportStep(msg, percent); },
+      Qt::DirectConnection);
 
+  mSmartCut.setNaluIndex(mParams.naluIndex);
   if (!mSmartCut.initialize(mParams.sourceFile, mParams.frameRate)) {
     // A cancel during the ES parse comes back through the same false return as
     // a real parse failure. wasAborted() is a plain bool owned by this thread,
@@ -267,39 +276,197 @@ void TTH26xCutTask::runCut()
   // The SPS boundary scan above can run for a while on a long cut list
   abortIfRequested();
 
+  // Stream mux: video straight into the MKV, no cut ES on disk. Returns
+  // false only when the muxer cannot take this stream frame by frame; the
+  // audio is cut by then.
+  if (mParams.streamMux && runStreamCut(vStream)) return;
+
   // Perform frame-accurate video cut
+  if (!cutVideo()) return;
+  reportSeamNotes();
+
+  // Cut audio and subtitle tracks against the video's actual output ranges
+  // (already done when a stream mux fell back with the same ranges)
+  const QList<QPair<double, double>> keepList =
+      adjustedKeepList(vStream, mSmartCut.actualOutputFrameRanges());
+  if (!mAudioCut || keepList != mAudioKeepList) {
+    if (!cutAudioAndSubtitles(keepList)) return;
+  }
+
+  // Mux video and audio into final MKV
+  log->infoMsg(__FILE__, __LINE__, QString("tempVideoFile: %1 (%2 bytes)")
+      .arg(mParams.tempVideoFile).arg(QFileInfo(mParams.tempVideoFile).size()));
+  for (int i = 0; i < mCutAudioFiles.size(); i++) {
+    log->infoMsg(__FILE__, __LINE__, QString("cutAudioFile[%1]: %2 (%3 bytes)")
+        .arg(i).arg(mCutAudioFiles[i]).arg(QFileInfo(mCutAudioFiles[i]).size()));
+  }
+  // A stream-mux run has no mux stage in its plan: after a fallback the
+  // mux reports under the running video stage
+  if (!mParams.streamMux)
+    reportStage(StatusReportArgs::StageMux);
+  reportStep(TTAVData::tr("Muxing video and audio..."), 0);
+  configureMuxer();
+  // Display-PTS: SmartCut-supplied output order (empty = legacy linear PTS)
+  mMkvProvider.setVideoDisplayOrder(mSmartCut.outputDisplayOrder());
+
+  mCreatedFiles.append(mParams.finalOutput);
+  bool success = mMkvProvider.mux(mParams.finalOutput, mParams.tempVideoFile,
+                                  mCutAudioFiles, mCutSubtitleFiles);
+
+  if (success) {
+    log->infoMsg(__FILE__, __LINE__, QString("Muxing complete: %1").arg(mParams.finalOutput));
+    // Delete cut elementary streams only if the option says so — same
+    // semantics as the MPEG-2 path (workingMuxDeleteES)
+    if (TTSettings::instance()->workingMuxDeleteES()) {
+      QFile::remove(mParams.tempVideoFile);
+      removeCutTracks();
+    }
+  } else {
+    // Same false return for a cancel as for a real mux failure.
+    if (mMkvProvider.wasAborted() || cancelRequested()) abortNow();
+    log->errorMsg(__FILE__, __LINE__, QString("Muxing failed: %1").arg(mMkvProvider.lastError()));
+    if (!mChapterFile.isEmpty()) QFile::remove(mChapterFile);
+    fail(TTAVData::tr("Muxing failed"),
+         TTAVData::tr("Muxing failed: %1").arg(mMkvProvider.lastError()));
+    return;
+  }
+
+  // Clean up chapter file
+  if (!mChapterFile.isEmpty()) QFile::remove(mChapterFile);
+
+  // No poll point after a SUCCESSFUL mux, deliberately: at this point the cut
+  // is complete and there is nothing left to cancel. A cancel that arrives in
+  // the microseconds between the mux returning and this line would otherwise
+  // delete a finished result - the run reports its regular Exit instead.
+  mExitMessage = TTAVData::tr("H.264/H.265 cutting complete");
+}
+
+/**
+ * Stream mux variant of the pipeline: audio and subtitles first, then the
+ * Smart Cut writes its frames straight into the muxer (TTESPacketSink) - the
+ * cut video ES is never written.
+ *
+ * The audio has to exist before the first video frame is muxed, i.e. before
+ * the video's actual output ranges are known. It is cut against the ranges of
+ * the Smart Cut's segment plan (plannedOutputFrameRanges), which carry the
+ * keepList adjustment of the ES path; the actual ranges are checked against
+ * them after the cut.
+ *
+ * Returns false - the caller takes the ES path, reusing the audio - only
+ * when the muxer cannot take this stream frame by frame. Returns true when
+ * the run is finished: successfully, or with a recorded failure.
+ */
+bool TTH26xCutTask::runStreamCut(TTVideoStream* vStream)
+{
+  const QList<QPair<double, double>> keepList =
+      adjustedKeepList(vStream, mSmartCut.plannedOutputFrameRanges(mParams.cutFrames));
+  if (!cutAudioAndSubtitles(keepList)) return true;
+
+  reportStage(StatusReportArgs::StageVideo);
+  reportStep(TTAVData::tr("Cutting video (Smart Cut)..."), 0);
+  configureMuxer();
+
+  auto streamMuxFailed = [&](const QString& error) {
+    mSmartCut.setPacketSink(nullptr);
+    mMkvProvider.abandonStreamMux();
+    log->errorMsg(__FILE__, __LINE__, QString("Stream mux failed: %1").arg(error));
+    fail(TTAVData::tr("Cutting failed"), TTAVData::tr("Cutting failed: %1").arg(error));
+    return true;
+  };
+
+  mCreatedFiles.append(mParams.finalOutput);
+  if (!mMkvProvider.beginStreamMux(mParams.finalOutput, mParams.sourceFile,
+                                   mCutAudioFiles, mCutSubtitleFiles)) {
+    if (!mMkvProvider.streamMuxUnsupported())
+      return streamMuxFailed(mMkvProvider.lastError());
+    log->warningMsg(__FILE__, __LINE__,
+        QString("Stream mux not possible (%1) - writing the video ES instead")
+            .arg(mMkvProvider.lastError()));
+    return false;
+  }
+
+  mSmartCut.setPacketSink(&mMkvProvider);
+  const bool cutOk = mSmartCut.smartCutFrames(mParams.tempVideoFile, mParams.cutFrames);
+  mSmartCut.setPacketSink(nullptr);
+  if (!cutOk) {
+    if (mSmartCut.wasAborted() || mMkvProvider.wasAborted() || cancelRequested()) abortNow();
+    return streamMuxFailed(mSmartCut.lastError());
+  }
+  abortIfRequested();
+
+  // The audio is muxed already: video that left the plan would drift
+  if (adjustedKeepList(vStream, mSmartCut.actualOutputFrameRanges()) != keepList)
+    return streamMuxFailed("video output ranges differ from the planned ones");
+
+  if (!mMkvProvider.finishStreamMux()) {
+    if (mMkvProvider.wasAborted() || cancelRequested()) abortNow();
+    return streamMuxFailed(mMkvProvider.lastError());
+  }
+
+  log->infoMsg(__FILE__, __LINE__, QString("Smart Cut complete: %1 frames re-encoded, %2 frames stream-copied")
+      .arg(mSmartCut.framesReencoded()).arg(mSmartCut.framesStreamCopied()));
+  reportSeamNotes();
+  log->infoMsg(__FILE__, __LINE__, QString("Muxing complete: %1 (stream mux)").arg(mParams.finalOutput));
+
+  // Stream mode implies workingMuxDeleteES
+  removeCutTracks();
+  if (!mChapterFile.isEmpty()) QFile::remove(mChapterFile);
+
+  // No poll point after a successful mux - see the end of runCut()
+  mExitMessage = TTAVData::tr("H.264/H.265 cutting complete");
+  return true;
+}
+
+/**
+ * Smart Cut of the video into the temporary ES. false = failure recorded.
+ */
+bool TTH26xCutTask::cutVideo()
+{
   reportStage(StatusReportArgs::StageVideo);
   reportStep(TTAVData::tr("Cutting video (Smart Cut)..."), 0);
   mCreatedFiles.append(mParams.tempVideoFile);
   if (!mSmartCut.smartCutFrames(mParams.tempVideoFile, mParams.cutFrames)) {
     // Same false return for a cancel as for a real failure - see the
-    // initialize() branch above.
+    // initialize() branch in runCut().
     if (mSmartCut.wasAborted() || cancelRequested()) abortNow();
     log->errorMsg(__FILE__, __LINE__, QString("TTESSmartCut failed: %1").arg(mSmartCut.lastError()));
     fail(TTAVData::tr("Cutting failed"),
          TTAVData::tr("Cutting failed: %1").arg(mSmartCut.lastError()));
-    return;
+    return false;
   }
   abortIfRequested();
 
   log->infoMsg(__FILE__, __LINE__, QString("Smart Cut complete: %1 frames re-encoded, %2 frames stream-copied")
       .arg(mSmartCut.framesReencoded()).arg(mSmartCut.framesStreamCopied()));
+  return true;
+}
 
-  // HEVC seam fallback notes (Defekt A / H.265): surface in the progress
-  // window and the log so affected seams are visible (spec decision 1).
+/**
+ * HEVC seam fallback notes (Defekt A / H.265): surface in the progress
+ * window and the log so affected seams are visible (spec decision 1).
+ */
+void TTH26xCutTask::reportSeamNotes()
+{
   mSeamNotes = mSmartCut.seamNotes();
   for (const QString& note : mSeamNotes) {
     log->warningMsg(__FILE__, __LINE__, note);
     reportStep(note, 0);
   }
+}
 
-  // Adjust audio keepList to match actual video output ranges.
-  // B-frame reorder delay can shift the display-order CutIn forward, causing
-  // the video Smart Cut to output fewer frames than the cut list specifies.
-  // Without adjustment, audio would be cut for the original (wider) range,
-  // resulting in cumulative A/V drift across segments.
+/**
+ * Audio keepList adjusted to match the video output ranges (actual, or
+ * planned before the cut).
+ *
+ * B-frame reorder delay can shift the display-order CutIn forward, causing
+ * the video Smart Cut to output fewer frames than the cut list specifies.
+ * Without adjustment, audio would be cut for the original (wider) range,
+ * resulting in cumulative A/V drift across segments.
+ */
+QList<QPair<double, double>> TTH26xCutTask::adjustedKeepList(TTVideoStream* vStream,
+                                                              const QList<QPair<int, int>>& actualRanges)
+{
   QList<QPair<double, double>> keepList = mParams.keepList;
-  QList<QPair<int, int>> actualRanges = mSmartCut.actualOutputFrameRanges();
   if (actualRanges.size() == keepList.size()) {
     for (int i = 0; i < keepList.size(); i++) {
       double origStart = keepList[i].first;
@@ -318,9 +485,18 @@ void TTH26xCutTask::runCut()
       }
     }
   }
+  return keepList;
+}
 
+/**
+ * Cut all audio and subtitle tracks against keepList. false = failure
+ * recorded (a missing audio track).
+ */
+bool TTH26xCutTask::cutAudioAndSubtitles(const QList<QPair<double, double>>& keepList)
+{
   // Cut audio tracks
-  QStringList cutAudioFiles;
+  mAudioCut = false;
+  mCutAudioFiles.clear();
   const bool normalizeAcmod = TTSettings::instance()->normalizeAcmod();
   // Cut all audio tracks against the (B-frame-adjusted) video keepList
   // (consolidated onto TTAVData::cutAudioTracks).
@@ -339,7 +515,7 @@ void TTH26xCutTask::runCut()
         // only, so this changes nothing for a real failure.
         mCreatedFiles.append(path);
         if (ok) {
-          cutAudioFiles.append(path);
+          mCutAudioFiles.append(path);
           log->infoMsg(__FILE__, __LINE__, QString("Audio track %1 cut: %2").arg(i+1).arg(path));
         }
       },
@@ -361,36 +537,36 @@ void TTH26xCutTask::runCut()
   // A missing track is a failure, not a footnote. cutAudioTracks() skips a
   // failed track silently (out-of-range index, missing stream, empty plan,
   // or cutAudioStream returning false) and reports that only through the ok
-  // flag of the callback above - which is also why cutAudioFiles counts
+  // flag of the callback above - which is also why mCutAudioFiles counts
   // exactly the successful tracks. Without this check the cut muxed an MKV
   // short of a track, reported success, and wrote a calibration factor on a
   // wrong work basis (measured: tools/diag/test_partial_track). Stopping
   // BEFORE the mux keeps the finished ES files - video and the successful
   // tracks - for a retry; a genuine error never cleans up (standing rule).
   // Per-track reasons are in the log as errorMsg entries.
-  if (cutAudioFiles.size() < mpAVItem->audioCount()) {
+  if (mCutAudioFiles.size() < mpAVItem->audioCount()) {
     // Per-track reasons in user wording, not just in the log (final review
     // M14) - see TTAVData::audioCutFailureReasons().
     QString detail = TTAVData::tr("Only %1 of %2 audio track(s) could be cut - "
                                   "the finished streams were kept.")
-                         .arg(cutAudioFiles.size()).arg(mpAVItem->audioCount());
+                         .arg(mCutAudioFiles.size()).arg(mpAVItem->audioCount());
     const QStringList reasons = mpAVData->audioCutFailureReasons();
     if (!reasons.isEmpty()) detail += "\n\n" + reasons.join("\n");
     else                    detail += "\n" + TTAVData::tr("See the log for the reason.");
     fail(TTAVData::tr("Cutting failed"), detail);
-    return;
+    return false;
   }
 
   // Collect audio languages from data model
-  QStringList cutAudioLanguages;
+  mCutAudioLanguages.clear();
   for (int i = 0; i < mpAVItem->audioCount(); i++) {
-    cutAudioLanguages.append(mpAVItem->audioListItemAt(i).getLanguage());
+    mCutAudioLanguages.append(mpAVItem->audioListItemAt(i).getLanguage());
   }
 
   // Cut subtitle tracks against the same (B-frame-adjusted) keepList as
   // the audio (consolidated onto TTAVData::cutSubtitleTracks)
-  QStringList cutSubtitleFiles;
-  QStringList cutSubtitleLanguages;
+  mCutSubtitleFiles.clear();
+  mCutSubtitleLanguages.clear();
   mpAVData->cutSubtitleTracks(mpAVItem, keepList,
       [&](int i) {
         return QFileInfo(QDir(TTSettings::instance()->cutDirPath()),
@@ -402,8 +578,8 @@ void TTH26xCutTask::runCut()
         // above (a partial .srt of an interrupted write must be cleaned up).
         mCreatedFiles.append(path);
         if (ok) {
-          cutSubtitleFiles.append(path);
-          cutSubtitleLanguages.append(lang);
+          mCutSubtitleFiles.append(path);
+          mCutSubtitleLanguages.append(lang);
           log->infoMsg(__FILE__, __LINE__,
               QString("Subtitle track %1 cut: %2").arg(i+1).arg(path));
         }
@@ -412,31 +588,22 @@ void TTH26xCutTask::runCut()
   // its own: it writes an in-memory header list to a text file and finishes in
   // milliseconds even for a full recording.
   abortIfRequested();
+  mAudioCut      = true;
+  mAudioKeepList = keepList;
+  return true;
+}
 
-  // Mux video and audio into final MKV
-  log->infoMsg(__FILE__, __LINE__, QString("tempVideoFile: %1 (%2 bytes)")
-      .arg(mParams.tempVideoFile).arg(QFileInfo(mParams.tempVideoFile).size()));
-  for (int i = 0; i < cutAudioFiles.size(); i++) {
-    log->infoMsg(__FILE__, __LINE__, QString("cutAudioFile[%1]: %2 (%3 bytes)")
-        .arg(i).arg(cutAudioFiles[i]).arg(QFileInfo(cutAudioFiles[i]).size()));
-  }
-  reportStage(StatusReportArgs::StageMux);
-  reportStep(TTAVData::tr("Muxing video and audio..."), 0);
-  // Also a member (see the header) so onUserAbort() can reach it.
-  // Direct connection for the same reason as the Smart Cut one above: keep the
-  // forwarding on this thread so the processEvents() guard actually bites.
-  connect(&mMkvProvider, &TTMkvMergeProvider::progressChanged, this,
-      [this](int percent, const QString& msg) { reportStep(msg, percent); },
-      Qt::DirectConnection);
-
+/**
+ * Muxer options shared by mux() and the stream mux session
+ */
+void TTH26xCutTask::configureMuxer()
+{
   // Calculate frame duration in nanoseconds (e.g., "0:20000000ns" for 50fps)
   int frameDurationNs = (int)(1000000000.0 / mParams.frameRate);
   mMkvProvider.setDefaultDuration("0", QString("%1ns").arg(frameDurationNs));
   mMkvProvider.setIsPAFF(mParams.isPAFF, mParams.paffLog2MaxFrameNum);
   AVCodecID codecId = mParams.isH265 ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264;
   mMkvProvider.setVideoCodecId(codecId);
-  // Display-PTS: SmartCut-supplied output order (empty = legacy linear PTS)
-  mMkvProvider.setVideoDisplayOrder(mSmartCut.outputDisplayOrder());
 
   // Apply A/V sync offset if present
   if (mParams.avOffsetMs != 0) {
@@ -447,11 +614,11 @@ void TTH26xCutTask::runCut()
   // file via audioKeepList above. Do NOT apply it again here via setAudioDelays()
   // — that would double-apply the delay.
 
-  mMkvProvider.setAudioLanguages(cutAudioLanguages);
-  mMkvProvider.setSubtitleLanguages(cutSubtitleLanguages);
+  mMkvProvider.setAudioLanguages(mCutAudioLanguages);
+  mMkvProvider.setSubtitleLanguages(mCutSubtitleLanguages);
 
   // Add chapters in first mux pass (no second container remux needed)
-  QString chapterFile;
+  mChapterFile.clear();
   if (TTSettings::instance()->workingMkvCreateChapters() && TTSettings::instance()->workingMkvChapterInterval() > 0 &&
       mParams.finalOutput.endsWith(".mkv", Qt::CaseInsensitive)) {
 
@@ -461,48 +628,25 @@ void TTH26xCutTask::runCut()
 
     if (totalDurationMs > 0) {
       mMkvProvider.setTotalDurationMs(totalDurationMs);
-      chapterFile = TTMkvMergeProvider::generateChapterFile(
+      mChapterFile = TTMkvMergeProvider::generateChapterFile(
           totalDurationMs, TTSettings::instance()->workingMkvChapterInterval(), TTSettings::instance()->cutDirPath());
-      if (!chapterFile.isEmpty()) {
-        mMkvProvider.setChapterFile(chapterFile);
-        mCreatedFiles.append(chapterFile);
+      if (!mChapterFile.isEmpty()) {
+        mMkvProvider.setChapterFile(mChapterFile);
+        mCreatedFiles.append(mChapterFile);
       }
     }
   }
+}
 
-  mCreatedFiles.append(mParams.finalOutput);
-  bool success = mMkvProvider.mux(mParams.finalOutput, mParams.tempVideoFile,
-                                  cutAudioFiles, cutSubtitleFiles);
-
-  if (success) {
-    log->infoMsg(__FILE__, __LINE__, QString("Muxing complete: %1").arg(mParams.finalOutput));
-    // Delete cut elementary streams only if the option says so — same
-    // semantics as the MPEG-2 path (workingMuxDeleteES)
-    if (TTSettings::instance()->workingMuxDeleteES()) {
-      QFile::remove(mParams.tempVideoFile);
-      for (const QString& f : cutAudioFiles) {
-        QFile::remove(f);
-      }
-      for (const QString& f : cutSubtitleFiles) {
-        QFile::remove(f);
-      }
-    }
-  } else {
-    // Same false return for a cancel as for a real mux failure.
-    if (mMkvProvider.wasAborted() || cancelRequested()) abortNow();
-    log->errorMsg(__FILE__, __LINE__, QString("Muxing failed: %1").arg(mMkvProvider.lastError()));
-    if (!chapterFile.isEmpty()) QFile::remove(chapterFile);
-    fail(TTAVData::tr("Muxing failed"),
-         TTAVData::tr("Muxing failed: %1").arg(mMkvProvider.lastError()));
-    return;
+/**
+ * Delete the cut audio and subtitle files once they are muxed
+ */
+void TTH26xCutTask::removeCutTracks()
+{
+  for (const QString& f : mCutAudioFiles) {
+    QFile::remove(f);
+  }
+  for (const QString& f : mCutSubtitleFiles) {
+    QFile::remove(f);
   }
-
-  // Clean up chapter file
-  if (!chapterFile.isEmpty()) QFile::remove(chapterFile);
-
-  // No poll point after a SUCCESSFUL mux, deliberately: at this point the cut
-  // is complete and there is nothing left to cancel. A cancel that arrives in
-  // the microseconds between the mux returning and this line would otherwise
-  // delete a finished result - the run reports its regular Exit instead.
-  mExitMessage = TTAVData::tr("H.264/H.265 cutting complete");
 }
@@ -29,6 +29,7 @@
 
 class TTAVData;
 class TTAVItem;
+class TTVideoStream;
 
 //! Value bundle for the H.26x final cut. Everything derived from the cut list
 //! is copied on the GUI thread before the task starts, so the worker never
@@ -47,7 +48,9 @@ struct TTH26xCutParams
   QList<QPair<int,int>>       cutFrames;  // display-order frame ranges
   QList<QPair<double,double>> keepList;   // seconds, extra-frame-corrected
   TTDisplayOrderMap           displayMap; // frame-granularity (PAFF-safe)
+  TTNaluIndex                 naluIndex;  // from stream open, may be empty
   bool    hasDisplayMap = false;
+  bool    streamMux     = false; // Smart Cut -> muxer without the video ES
 };
 
 //! Pool task running the whole H.26x final cut pipeline
@@ -80,6 +83,17 @@ class TTH26xCutTask : public TTThreadTask
   private:
     //! The pipeline itself; operation() only wraps it in the abort funnel.
     void runCut();
+    //! Stream mux pipeline (params.streamMux). false = the muxer cannot take
+    //! the stream frame by frame; take the ES path.
+    bool runStreamCut(TTVideoStream* vStream);
+    //! Pipeline steps; a false return means fail() was called.
+    bool cutVideo();
+    bool cutAudioAndSubtitles(const QList<QPair<double, double>>& keepList);
+    QList<QPair<double, double>> adjustedKeepList(TTVideoStream* vStream,
+                                                  const QList<QPair<int, int>>& actualRanges);
+    void reportSeamNotes();
+    void configureMuxer();
+    void removeCutTracks();
     void reportStep(const QString& msg, quint64 percent);
     void reportStage(int stage);
     void fail(const QString& exitMessage, const QString& errorText);
@@ -109,6 +123,15 @@ class TTH26xCutTask : public TTThreadTask
     QString          mError;
     QString          mExitMessage;
     QStringList      mSeamNotes;
+    //! Products of the audio/subtitle step, handed to the muxer
+    QStringList      mCutAudioFiles;
+    QStringList      mCutAudioLanguages;
+    QStringList      mCutSubtitleFiles;
+    QStringList      mCutSubtitleLanguages;
+    //! The keepList the tracks above were cut against (mAudioCut = done)
+    bool             mAudioCut = false;
+    QList<QPair<double, double>> mAudioKeepList;
+    QString          mChapterFile;
     //! Every file this run produced, in creation order — the cleanup list for
     //! an aborted cut.
     QStringList      mCreatedFiles;
@@ -233,6 +233,7 @@ bool TTSearchTask::setupWorkers()
     auto* w = new TTFFmpegWrapper();
     w->setAnalysisMode(true);
     w->setSearchMode(true);
+    w->setReducedDecode(mReducedDecode);
     if (!w->openFile(mFilePath)) {
       log->errorMsg(__FILE__, __LINE__,
                     QString("TTSearchTask::setupWorkers: openFile failed for %1 (worker %2)")
@@ -120,6 +120,9 @@ protected:
   // Batched-parallel state (lifetime = setupWorkers .. teardownWorkers).
   int                          mWorkerCount = 1;
   QVector<TTFFmpegWrapper*>    mSubWrappers;           // N entries (H.264/H.265)
+  // Set by subclasses that read I-frames only, through decodeKeyframeReduced():
+  // setupWorkers() then opens the sub-wrappers with the reduced decode profile
+  bool                         mReducedDecode = false;
 
 private:
   bool openDecoder();
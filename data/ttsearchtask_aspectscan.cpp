@@ -47,6 +47,9 @@ TTAspectScanTask::TTAspectScanTask(const QString& videoFilePath,
   // it only matters if either number changes in the future.
   const int hysteresisWindowFrames = qMax(1, qRound(kHysteresisWindowSeconds * mFrameRate));
   mSampleStride = qMin(mSampleStride, hysteresisWindowFrames);
+
+  // Samples are I-frames, classified on luma: decode intra pictures only
+  mReducedDecode = true;
 }
 
 QVector<int> TTAspectScanTask::collectSampleBatch(int& pos)
@@ -78,16 +81,18 @@ QVector<TTAspectSample> TTAspectScanTask::classifyBatch(const QVector<int>& batc
   QVector<TTAspectReason> why(batch.size(), TTAspectReason::Unusable);
 
   parallelMap(batch.size(), [&](int i) {
+    // H.26x: full-range luma straight from the decoder at kSampleWidth - the
+    // classifier's bar limits are fractions of the width, its thresholds
+    // image-domain values either way
     QImage frame = (i < mSubWrappers.size() && mSubWrappers[i])
-                     ? mSubWrappers[i]->decodeFrame(batch[i])
-                     : decodeFrameAt(batch[i]);
+                     ? mSubWrappers[i]->decodeKeyframeReduced(batch[i], QSize(kSampleWidth, 0), true)
+                     : decodeFrameAt(batch[i]).convertToFormat(QImage::Format_Grayscale8);
     if (frame.isNull()) {
       if (TTSettings::instance()->logFFmpegDecoder())
           qDebug() << "AspectScan: decode failure at frame" << batch[i];
       return;   // stays NoStatement / Unusable
     }
-    out[i] = classifyAspectSample(frame.convertToFormat(QImage::Format_Grayscale8),
-                                  mLuminanceThreshold, &why[i]);
+    out[i] = classifyAspectSample(frame, mLuminanceThreshold, &why[i]);
   });
 
   if (reasons) *reasons = why;
@@ -68,6 +68,10 @@ private:
   //! duration can never silently outrun the clamp (or vice versa).
   static constexpr float kHysteresisWindowSeconds = 10.0f;
 
+  //! Width the H.26x samples are decoded at (reduced profile, height keeps
+  //! the storage proportions). A 4:3 bar in 16:9 is w/8: 80 px here.
+  static constexpr int kSampleWidth = 640;
+
   float mFrameRate;
   int   mLuminanceThreshold;
   int   mSampleStride;      //!< frames between two samples
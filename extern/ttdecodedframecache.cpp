@@ -0,0 +1,135 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttdecodedframecache.h"
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+TTDecodedFrameCache::TTDecodedFrameCache(qint64 budgetBytes)
+    : mTick(0),
+      mBytes(0),
+      mBudget(qMax<qint64>(0, budgetBytes))
+{
+}
+
+TTDecodedFrameCache::~TTDecodedFrameCache()
+{
+    clear();
+}
+
+void TTDecodedFrameCache::setBudget(qint64 bytes)
+{
+    mBudget = qMax<qint64>(0, bytes);
+    if (mBudget == 0)
+        clear();
+    else
+        evict();
+}
+
+// ----------------------------------------------------------------------------
+// Entries
+// ----------------------------------------------------------------------------
+bool TTDecodedFrameCache::insert(int displayPos, const AVFrame* frame)
+{
+    if (mBudget <= 0 || frame == nullptr) return false;
+
+    AVFrame* ref = av_frame_clone(frame);
+    if (ref == nullptr) return false;
+
+    remove(displayPos);
+    const qint64 size = frameBytes(ref);
+    mEntries.insert(displayPos, { ref, QImage(), size, ++mTick });
+    mLru.insert(mTick, displayPos);
+    mBytes += size;
+    evict();
+    return true;
+}
+
+const AVFrame* TTDecodedFrameCache::frame(int displayPos)
+{
+    Entry* e = use(displayPos);
+    return e ? e->frame : nullptr;
+}
+
+QImage TTDecodedFrameCache::image(int displayPos)
+{
+    Entry* e = use(displayPos);
+    return e ? e->image : QImage();
+}
+
+void TTDecodedFrameCache::setImage(int displayPos, const QImage& image)
+{
+    Entry* e = use(displayPos);
+    if (e == nullptr) return;
+    const qint64 oldSize = e->image.sizeInBytes();
+    e->image = image;
+    e->bytes += image.sizeInBytes() - oldSize;
+    mBytes   += image.sizeInBytes() - oldSize;
+    evict();
+}
+
+void TTDecodedFrameCache::remove(int displayPos)
+{
+    auto it = mEntries.find(displayPos);
+    if (it != mEntries.end())
+        release(it);
+}
+
+void TTDecodedFrameCache::clear()
+{
+    for (Entry& e : mEntries)
+        av_frame_free(&e.frame);
+    mEntries.clear();
+    mLru.clear();
+    mBytes = 0;
+}
+
+// Look up and mark as most recently used
+TTDecodedFrameCache::Entry* TTDecodedFrameCache::use(int displayPos)
+{
+    auto it = mEntries.find(displayPos);
+    if (it == mEntries.end()) return nullptr;
+    mLru.remove(it->tick);
+    it->tick = ++mTick;
+    mLru.insert(mTick, displayPos);
+    return &it.value();
+}
+
+// Drop least recently used entries until the budget holds; the newest one
+// stays regardless
+void TTDecodedFrameCache::evict()
+{
+    while (mBytes > mBudget && mLru.size() > 1)
+        release(mEntries.find(mLru.first()));
+}
+
+void TTDecodedFrameCache::release(QHash<int, Entry>::iterator it)
+{
+    mBytes -= it->bytes;
+    mLru.remove(it->tick);
+    av_frame_free(&it->frame);
+    mEntries.erase(it);
+}
+
+// Bytes the reference keeps alive: the frame's pool buffers (planes,
+// padding included)
+qint64 TTDecodedFrameCache::frameBytes(const AVFrame* frame)
+{
+    qint64 size = 0;
+    for (int i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; ++i)
+        size += frame->buf[i]->size;
+    for (int i = 0; i < frame->nb_extended_buf; ++i)
+        size += frame->extended_buf[i]->size;
+    return size;
+}
@@ -0,0 +1,85 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTDECODEDFRAMECACHE
+// Decoded preview frames of TTFFmpegWrapper, keyed by display position.
+//
+// An entry holds a new reference to the decoder's frame (av_frame_clone, no
+// pixel copy) and, once somebody asked for it, the RGB image converted from
+// it. decodeFrame() puts every correctly decoded frame of its seek+skip run
+// here, so stepping through the GOP afterwards converts instead of decoding.
+//
+// Eviction is least-recently-used against a byte budget: the sizes of the
+// frame's buffers plus the RGB image. The newest entry is never evicted, so
+// a single frame larger than the budget still caches. Budget 0 disables the
+// cache (insert() refuses).
+
+#ifndef TTDECODEDFRAMECACHE_H
+#define TTDECODEDFRAMECACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMap>
+
+struct AVFrame;
+
+class TTDecodedFrameCache
+{
+public:
+    static constexpr qint64 kDefaultBudget = 512LL * 1024 * 1024;
+
+    explicit TTDecodedFrameCache(qint64 budgetBytes = kDefaultBudget);
+    ~TTDecodedFrameCache();
+    TTDecodedFrameCache(const TTDecodedFrameCache&) = delete;
+    TTDecodedFrameCache& operator=(const TTDecodedFrameCache&) = delete;
+
+    // Evicts down to the new budget at once
+    void   setBudget(qint64 bytes);
+    qint64 budget() const { return mBudget; }
+    qint64 bytes() const { return mBytes; }
+    int    count() const { return mEntries.size(); }
+
+    bool contains(int displayPos) const { return mEntries.contains(displayPos); }
+    QList<int> positions() const { return mEntries.keys(); }
+
+    // Keep a reference to frame under displayPos (replacing an older entry).
+    // false when the cache is disabled or the reference failed.
+    bool insert(int displayPos, const AVFrame* frame);
+
+    // The cached frame / its RGB image (null until setImage()); both count
+    // as a use. nullptr / null image when displayPos is not cached.
+    const AVFrame* frame(int displayPos);
+    QImage image(int displayPos);
+    void   setImage(int displayPos, const QImage& image);
+
+    void remove(int displayPos);
+    void clear();
+
+private:
+    struct Entry {
+        AVFrame* frame;
+        QImage   image;
+        qint64   bytes;
+        quint64  tick;
+    };
+
+    Entry* use(int displayPos);
+    void   evict();
+    void   release(QHash<int, Entry>::iterator it);
+    static qint64 frameBytes(const AVFrame* frame);
+
+    QHash<int, Entry>  mEntries;
+    QMap<quint64, int> mLru;      // use tick -> display position, oldest first
+    quint64 mTick;
+    qint64  mBytes;
+    qint64  mBudget;
+};
+
+#endif // TTDECODEDFRAMECACHE_H
@@ -0,0 +1,327 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttespacketsink.h"
+
+#include "../avstream/ttstartcodescanner.h"
+
+#include <QVarLengthArray>
+
+// Slice header bytes unescaped to reach field_pic_flag; first_mb_in_slice,
+// slice_type, pic_parameter_set_id and frame_num need at most 13.
+static const int kSliceHeaderBytes = 32;
+
+namespace {
+
+// Strip emulation prevention (00 00 03 -> 00 00) from the first maxOut RBSP
+// bytes of a NAL body
+template <typename Buffer>
+void unescapeNal(const uint8_t* nal, int64_t size, int64_t maxOut, Buffer& rbsp)
+{
+    int64_t i = 0;
+    while (i < size && rbsp.size() < maxOut) {
+        if (i + 2 < size && nal[i] == 0 && nal[i + 1] == 0 && nal[i + 2] == 3) {
+            rbsp.append(0);
+            rbsp.append(0);
+            i += 3;
+        } else {
+            rbsp.append(nal[i++]);
+        }
+    }
+}
+
+bool isH265PictureStart(int nut)
+{
+    // Non-VCL types libav's HEVC parser ends a packet at: VPS, SPS, PPS, AUD,
+    // EOS, EOB, prefix SEI and the reserved/unspecified prefix ranges
+    return (nut >= H265::NAL_VPS && nut <= 37) || nut == H265::NAL_PREFIX_SEI
+        || (nut >= 41 && nut <= 44) || (nut >= 48 && nut <= 55);
+}
+
+bool isH265Vcl(int nut)
+{
+    return nut <= 9 || (nut >= 16 && nut <= 21);
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+TTESPacketSinkDevice::TTESPacketSinkDevice(TTESPacketSink* sink, TTNaluCodecType codec,
+                                           bool isPAFF, int log2MaxFrameNum,
+                                           std::function<int(int)> rankOf,
+                                           QObject* parent)
+    : QIODevice(parent),
+      mSink(sink),
+      mCodec(codec),
+      mIsPAFF(isPAFF && codec == NALU_CODEC_H264),
+      mLog2MaxFrameNum(log2MaxFrameNum),
+      mFrameMbsOnly(false),
+      mRankOf(std::move(rankOf)),
+      mScanPos(0),
+      mNalStart(-1),
+      mPicStart(0),
+      mPicHasVcl(false),
+      mPicKeyframe(false),
+      mPicIsField(false),
+      mLastFirstMb(0),
+      mFirstFieldKeyframe(false),
+      mHaveFirstField(false),
+      mFramesEmitted(0),
+      mBytesReceived(0),
+      mFailed(false)
+{
+}
+
+qint64 TTESPacketSinkDevice::readData(char* /*data*/, qint64 /*maxSize*/)
+{
+    return -1;
+}
+
+// ----------------------------------------------------------------------------
+// Byte stream in: every NAL is classified once its successor's start code
+// has arrived (or at finish()). Consumed pictures are cut off the buffer at
+// the end of each write, so it only ever holds the picture in progress.
+// ----------------------------------------------------------------------------
+qint64 TTESPacketSinkDevice::writeData(const char* data, qint64 len)
+{
+    if (mFailed) return -1;
+
+    mBuffer.append(data, int(len));
+    mBytesReceived += len;
+
+    const uint8_t* d = reinterpret_cast<const uint8_t*>(mBuffer.constData());
+    const int64_t size = mBuffer.size();
+    while (mScanPos < size - 3) {
+        const int64_t sc = TTStartCodeScanner::findPrefix(d, mScanPos, size - 3);
+        if (sc < 0) {
+            mScanPos = size - 3;
+            break;
+        }
+        if (mNalStart >= 0)
+            consumeNal(mNalStart, sc);
+        mNalStart = sc;
+        mScanPos = sc + 3;
+    }
+
+    if (mPicStart > 0) {
+        mBuffer.remove(0, int(mPicStart));
+        mScanPos -= mPicStart;
+        if (mNalStart >= 0) mNalStart -= mPicStart;
+        mPicStart = 0;
+    }
+
+    if (!drainFrames()) return -1;
+    return len;
+}
+
+// ----------------------------------------------------------------------------
+// One complete NAL [nalStart, nalEnd) (nalStart = its 00 00 01). Decides
+// whether it opens a new picture - the rules of libav's h264/hevc parser
+// (find_frame_end) - and folds it into the current one.
+// ----------------------------------------------------------------------------
+void TTESPacketSinkDevice::consumeNal(int64_t nalStart, int64_t nalEnd)
+{
+    const uint8_t* d = reinterpret_cast<const uint8_t*>(mBuffer.constData());
+    const int64_t body = nalStart + 3;
+    int64_t bodyEnd = nalEnd;
+    while (bodyEnd > body && d[bodyEnd - 1] == 0)
+        --bodyEnd;
+    if (bodyEnd <= body) return;
+    const uint8_t* nal = d + body;
+    const int64_t nalSize = bodyEnd - body;
+
+    // A picture boundary takes the zero_byte of a 4-byte start code along
+    int64_t boundary = nalStart;
+    while (boundary > mPicStart && d[boundary - 1] == 0)
+        --boundary;
+
+    if (mCodec == NALU_CODEC_H265) {
+        const int nut = (nal[0] >> 1) & 0x3F;
+        if (isH265PictureStart(nut)) {
+            if (mPicHasVcl) completePicture(boundary);
+        } else if (isH265Vcl(nut) && nalSize > 2) {
+            const bool firstSliceInPic = (nal[2] & 0x80) != 0;
+            if (firstSliceInPic && mPicHasVcl) completePicture(boundary);
+            mPicHasVcl = true;
+            if (nut >= 16 && nut <= 21) mPicKeyframe = true;   // IRAP
+        }
+        return;
+    }
+
+    const int type = nal[0] & 0x1F;
+    switch (type) {
+    case H264::NAL_SLICE:
+    case H264::NAL_IDR_SLICE: {
+        QVarLengthArray<uint8_t, kSliceHeaderBytes> rbsp;
+        unescapeNal(nal, nalSize, kSliceHeaderBytes, rbsp);
+        int bit = 8;
+        const int firstMb = int(TTNaluParser::readExpGolombUE(rbsp.constData(), int(rbsp.size()), bit));
+        if (mPicHasVcl && firstMb <= mLastFirstMb)
+            completePicture(boundary);
+        if (!mPicHasVcl)
+            mPicIsField = mIsPAFF && sliceIsField(nal, nalSize);
+        mPicHasVcl = true;
+        mLastFirstMb = firstMb;
+        if (type == H264::NAL_IDR_SLICE) mPicKeyframe = true;
+        break;
+    }
+    case H264::NAL_SEI:
+    case H264::NAL_SPS:
+    case H264::NAL_PPS:
+    case H264::NAL_AUD:
+        if (mPicHasVcl) completePicture(boundary);
+        if (type == H264::NAL_SEI && hasRecoveryPointSei(nal, nalSize))
+            mPicKeyframe = true;
+        if (type == H264::NAL_SPS) {
+            // Smart-cut output carries encoder and source SPS with different
+            // frame_num widths; the latest one rules the following slices.
+            QByteArray rbsp;
+            TTSpsInfo info;
+            if (TTNaluParser::parseH264Sps(nal, int(nalSize), rbsp, info)) {
+                mLog2MaxFrameNum = info.log2MaxFrameNumMinus4 + 4;
+                mFrameMbsOnly = info.frameMbsOnlyFlag;
+            }
+        }
+        break;
+    default:
+        break;   // EOS, filler, ...: stay with the current picture
+    }
+}
+
+// field_pic_flag of the first slice of a picture
+bool TTESPacketSinkDevice::sliceIsField(const uint8_t* body, int64_t size) const
+{
+    if (mFrameMbsOnly || mLog2MaxFrameNum <= 0) return false;
+    QVarLengthArray<uint8_t, kSliceHeaderBytes> rbsp;
+    unescapeNal(body, size, kSliceHeaderBytes, rbsp);
+    const int n = int(rbsp.size());
+    int bit = 8;
+    TTNaluParser::readExpGolombUE(rbsp.constData(), n, bit);   // first_mb_in_slice
+    TTNaluParser::readExpGolombUE(rbsp.constData(), n, bit);   // slice_type
+    TTNaluParser::readExpGolombUE(rbsp.constData(), n, bit);   // pic_parameter_set_id
+    TTNaluParser::readBits(rbsp.constData(), n, bit, mLog2MaxFrameNum);   // frame_num
+    return TTNaluParser::readBits(rbsp.constData(), n, bit, 1) == 1;
+}
+
+// SEI message list containing a recovery point (payloadType 6)
+bool TTESPacketSinkDevice::hasRecoveryPointSei(const uint8_t* body, int64_t size)
+{
+    QByteArray rbsp;
+    unescapeNal(body, size, size, rbsp);
+    const uint8_t* r = reinterpret_cast<const uint8_t*>(rbsp.constData());
+    const int n = rbsp.size();
+
+    // more_rbsp_data(): a 0x80 where the next message would start is the
+    // rbsp_trailing_bits only if nothing but zero bytes follows it; anywhere
+    // else it is a payloadType of 128 or more
+    auto trailingBitsAt = [r, n](int at) {
+        if (r[at] != 0x80) return false;
+        for (int k = at + 1; k < n; ++k)
+            if (r[k] != 0) return false;
+        return true;
+    };
+
+    int pos = 1;
+    while (pos < n && !trailingBitsAt(pos)) {
+        int payloadType = 0;
+        while (pos < n && r[pos] == 0xFF) { payloadType += 255; ++pos; }
+        if (pos >= n) break;
+        payloadType += r[pos++];
+        int payloadSize = 0;
+        while (pos < n && r[pos] == 0xFF) { payloadSize += 255; ++pos; }
+        if (pos >= n) break;
+        payloadSize += r[pos++];
+        if (payloadType == 6) return true;
+        pos += payloadSize;
+    }
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+// Pictures -> frames. Same packets the MKV muxer's ES path writes: pictures
+// without a slice are dropped, a PAFF field picture takes the next picture
+// along as its second field.
+// ----------------------------------------------------------------------------
+void TTESPacketSinkDevice::completePicture(int64_t end)
+{
+    if (end > mPicStart && mPicHasVcl) {
+        const QByteArray picture = mBuffer.mid(int(mPicStart), int(end - mPicStart));
+        if (mHaveFirstField) {
+            mFirstField.append(picture);
+            queueFrame(mFirstField, mFirstFieldKeyframe);
+            mFirstField.clear();
+            mHaveFirstField = false;
+        } else if (mPicIsField) {
+            mFirstField = picture;
+            mFirstFieldKeyframe = mPicKeyframe;
+            mHaveFirstField = true;
+        } else {
+            queueFrame(picture, mPicKeyframe);
+        }
+    }
+    mPicStart = qMax(mPicStart, end);
+    mPicHasVcl = false;
+    mPicKeyframe = false;
+    mPicIsField = false;
+}
+
+void TTESPacketSinkDevice::queueFrame(const QByteArray& data, bool keyframe)
+{
+    mWaiting.append({ data, keyframe });
+}
+
+bool TTESPacketSinkDevice::drainFrames()
+{
+    while (!mWaiting.isEmpty()) {
+        const int rank = mRankOf(mFramesEmitted);
+        if (rank < 0) break;
+        const Frame& f = mWaiting.first();
+        if (!mSink->writeAccessUnit(f.data, rank, f.keyframe)) {
+            mFailed = true;
+            setErrorString(QString("packet sink rejected output frame %1").arg(mFramesEmitted));
+            return false;
+        }
+        mWaiting.removeFirst();
+        ++mFramesEmitted;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// End of stream
+// ----------------------------------------------------------------------------
+bool TTESPacketSinkDevice::finish()
+{
+    if (mFailed) return false;
+
+    if (mNalStart >= 0) {
+        consumeNal(mNalStart, mBuffer.size());
+        mNalStart = -1;
+    }
+    completePicture(mBuffer.size());
+    if (mHaveFirstField) {
+        // Unpaired last field: written alone, as the muxer does at EOF
+        queueFrame(mFirstField, mFirstFieldKeyframe);
+        mFirstField.clear();
+        mHaveFirstField = false;
+    }
+    mBuffer.clear();
+    mScanPos = mPicStart = 0;
+
+    if (!drainFrames()) return false;
+    if (!mWaiting.isEmpty()) {
+        mFailed = true;
+        setErrorString(QString("no display rank for output frame %1 (%2 frames waiting)")
+                           .arg(mFramesEmitted).arg(mWaiting.size()));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTESPACKETSINK
+// Access-unit output of TTESSmartCut without an elementary stream on disk.
+//
+// TTESPacketSink is the receiving end (TTMkvMergeProvider's in-process mux
+// session): one call per output frame, in write (= decode) order, with the
+// frame's output-local display rank.
+//
+// TTESPacketSinkDevice sits between the engine and the sink. The engine keeps
+// writing its Annex-B byte stream (parameter sets, EOS, copied and encoded
+// AUs) through a QIODevice; the device cuts that stream into frames exactly
+// the way the MKV muxer's ES path sees a written ES - libav parser packet
+// boundaries, PAFF field pairs merged, parameter-set-only packets dropped -
+// so frame k is the one the display-order list entry k describes.
+//
+// Bitstream-level only: no libav.
+
+#ifndef TTESPACKETSINK_H
+#define TTESPACKETSINK_H
+
+#include "../avstream/ttnaluparser.h"
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QList>
+#include <functional>
+
+class TTESPacketSink
+{
+public:
+    virtual ~TTESPacketSink() {}
+
+    // One output frame: its Annex-B bytes (PAFF: both fields) including the
+    // parameter sets and SEI in front of it, its display rank (0-based,
+    // output-local) and the keyframe flag libav's parser would set (H.264:
+    // IDR or recovery point SEI, H.265: IRAP). false = stop the cut.
+    virtual bool writeAccessUnit(const QByteArray& data, int displayRank,
+                                 bool keyframe) = 0;
+};
+
+class TTESPacketSinkDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    // rankOf(k) returns the display rank of output frame k, or -1 while the
+    // engine has not recorded it yet; frames wait until it has.
+    TTESPacketSinkDevice(TTESPacketSink* sink, TTNaluCodecType codec,
+                         bool isPAFF, int log2MaxFrameNum,
+                         std::function<int(int)> rankOf,
+                         QObject* parent = nullptr);
+
+    bool isSequential() const override { return true; }
+
+    // Hand over the last frame and every waiting one. false when the sink
+    // failed or a frame never got a rank (errorString() says which).
+    // close() without finish() drops what is still buffered.
+    bool finish();
+
+    bool   failed() const { return mFailed; }
+    int    framesEmitted() const { return mFramesEmitted; }
+    qint64 bytesReceived() const { return mBytesReceived; }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 len) override;
+
+private:
+    struct Frame {
+        QByteArray data;
+        bool keyframe;
+    };
+
+    void consumeNal(int64_t nalStart, int64_t nalEnd);
+    void completePicture(int64_t end);
+    void queueFrame(const QByteArray& data, bool keyframe);
+    bool drainFrames();
+    bool sliceIsField(const uint8_t* body, int64_t size) const;
+    static bool hasRecoveryPointSei(const uint8_t* body, int64_t size);
+
+    TTESPacketSink* mSink;
+    TTNaluCodecType mCodec;
+    bool mIsPAFF;
+    int  mLog2MaxFrameNum;
+    bool mFrameMbsOnly;
+    std::function<int(int)> mRankOf;
+
+    QByteArray mBuffer;       // bytes of the current picture and beyond
+    int64_t mScanPos;         // next start-code search position in mBuffer
+    int64_t mNalStart;        // start code of the NAL being collected, -1 = none
+
+    // Current picture (libav parser packet) = mBuffer[mPicStart, ...)
+    int64_t mPicStart;
+    bool mPicHasVcl;
+    bool mPicKeyframe;
+    bool mPicIsField;
+    int  mLastFirstMb;
+
+    // PAFF: first field waiting for its partner
+    QByteArray mFirstField;
+    bool mFirstFieldKeyframe;
+    bool mHaveFirstField;
+
+    QList<Frame> mWaiting;    // complete frames without a rank yet
+    int    mFramesEmitted;
+    qint64 mBytesReceived;
+    bool   mFailed;
+};
+
+#endif // TTESPACKETSINK_H
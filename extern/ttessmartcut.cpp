@@ -8,7 +8,10 @@
 /*----------------------------------------------------------------------------*/
 
 #include "ttessmartcut.h"
+#include "tth264copypatch.h"
+#include "ttespacketsink.h"
 #include "../avstream/ttesinfo.h"
+#include "../avstream/ttbyterangecopy.h"
 #include "../common/ttcut.h"
 #include "../common/ttsettings.h"
 #include "../common/ttmessagelogger.h"
@@ -17,9 +20,15 @@
 #include <QDebug>
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <QBuffer>
+#include <QDir>
 #include <QFileInfo>
 #include <QElapsedTimer>
 #include <QScopeGuard>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
 
 // Include libav headers
 extern "C" {
@@ -113,6 +122,11 @@ static QByteArray patchFrameNumInAU(const QByteArray& auData, int frameNumBitWid
 // bridgeable when it is not).
 static constexpr int kExpectedEncoderLog2PocLsb = 4;
 
+// Boundary re-encodes started ahead of the assembly per worker thread: one
+// rendering and one finished, waiting to be replayed. Bounds the rendered
+// packets held in memory on long cut lists.
+static constexpr int kBoundaryRunsPerWorker = 2;
+
 // True when some poc_lsb value representable in patchLog2PocLsb bits keeps
 // the decoder's PicOrderCntMsb continuous into srcPocLsb — the same linear
 // distance rule (|src - v| <= srcMax/2) that applyPocDomainFix's post-patch
@@ -132,14 +146,14 @@ static bool pocDomainBridgeable(int srcPocLsb, int patchLog2PocLsb, int srcLog2P
 // ReencodeContext: per-call state for reencodeFrames
 // ----------------------------------------------------------------------------
 struct TTESSmartCut::ReencodeContext {
-    ReencodeContext(QFile& f, int sf, int ef, int scsf, int* assc, int* asau, int sd,
+    ReencodeContext(QIODevice& f, int sf, int ef, int scsf, int* assc, int* asau, int sd,
                     int ed = -1, bool tm = false)
         : outFile(f), startFrame(sf), endFrame(ef), streamCopyStartFrame(scsf),
           startDisplay(sd), adjustedStreamCopyStart(assc), actualStartAU(asau),
           endDisplay(ed), tailMode(tm) {}
 
     // ---- Inputs (set by reencodeFrames before calling helpers) ----
-    QFile& outFile;
+    QIODevice& outFile;   // the cut's output file, or a helper engine's buffer
     int    startFrame;
     int    endFrame;
     int    streamCopyStartFrame;
@@ -156,6 +170,14 @@ struct TTESSmartCut::ReencodeContext {
     // ---- Decode phase ----
     QList<AVFrame*> allDecodedFrames;
     bool   encoderInitialized = false;
+    int    framesDecoded      = 0;
+
+    // ---- Streaming (decode window over the frame budget) ----
+    // Kept frames go to the encoder as they are decoded; the encoder
+    // packets wait here (compressed) for the POC anchor.
+    bool   streaming          = false;
+    bool   holdPackets        = false;   // until releaseHeldPackets
+    QList<QByteArray> heldPackets;
 
     // ---- Selection phase ----
     QList<AVFrame*> framesToEncode;
@@ -222,10 +244,15 @@ TTESSmartCut::TTESSmartCut()
     , mHevcSeamFix(false)
     , mHevcSeamRewriteFailed(false)
     , mOutputDisplayOrderValid(true)
+    , mPacketSink(nullptr)
+    , mSinkRankBase(0)
+    , mSinkDisplayBase(0)
     , mEncoderPts(0)
     , mFramesStreamCopied(0)
     , mFramesReencoded(0)
     , mBytesWritten(0)
+    , mBoundaryWorkerCount(0)
+    , mReencodeMemoryLimit(qint64(TTSettings::instance()->reencodeMemoryLimitMB()) * 1024 * 1024)
 {
 }
 
@@ -288,7 +315,9 @@ bool TTESSmartCut::initialize(const QString& esFile, double frameRate)
     // reuse), but the lambda must always target the current instance.
     mParser.setAbortCallback([this]() { return checkAbort(); });
 
-    if (!mParser.parseFile()) {
+    // An index injected from the video stream's indexing pass saves the scan
+    const bool adopted = !mNaluIndex.isEmpty() && mParser.adoptIndex(mNaluIndex);
+    if (!adopted && !mParser.parseFile()) {
         mParser.closeFile();
         // Not wasAborted(): mWasAborted is only cleared at smartCutFrames()
         // entry (see its declaration), so on a reused engine whose PRIOR
@@ -409,6 +438,7 @@ void TTESSmartCut::appendOutputDisplay(int mapDisplayIndex, int srcAuIndex)
         // display position -> whole list unusable for this run.
         mOutputDisplayOrderValid = false;
         mOutputDisplayOrder.clear();
+        mSinkRanks.clear();
         TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
             QString("output display-order tracking invalidated (negative "
                     "display index at source AU %1) - MKV muxer will use "
@@ -416,6 +446,8 @@ void TTESSmartCut::appendOutputDisplay(int mapDisplayIndex, int srcAuIndex)
         return;
     }
     mOutputDisplayOrder.append(mapDisplayIndex);
+    if (mPacketSink)
+        mSinkRanks.append(mSinkRankBase + (mapDisplayIndex - mSinkDisplayBase));
 }
 
 // Returns the display position (frame units, output-local, 0-based) of each
@@ -507,6 +539,7 @@ bool TTESSmartCut::smartCutFrames(const QString& outputFile,
     mActualOutputRanges.clear();
     mOutputDisplayOrder.clear();
     mOutputDisplayOrderValid = true;
+    mSinkRanks.clear();
     mSeamNotes.clear();
 
     // ---- Display -> AU conversion (single source of truth) ----
@@ -583,8 +616,16 @@ bool TTESSmartCut::smartCutFrames(const QString& outputFile,
         }
     }
 
-    // Open output file
-    QFile outFile(outputFile);
+    // Open output: the ES file, or the device that splits the byte stream
+    // into frames for the packet sink
+    QFile esFile(outputFile);
+    std::unique_ptr<TTESPacketSinkDevice> sinkDevice;
+    if (mPacketSink) {
+        sinkDevice.reset(new TTESPacketSinkDevice(
+            mPacketSink, mParser.codecType(), mParser.isPAFF(), mLog2MaxFrameNum,
+            [this](int frame) { return frame < mSinkRanks.size() ? mSinkRanks[frame] : -1; }));
+    }
+    QIODevice& outFile = sinkDevice ? static_cast<QIODevice&>(*sinkDevice) : esFile;
     if (!outFile.open(QIODevice::WriteOnly)) {
         setError(QString("Cannot create output file: %1").arg(outputFile));
         return false;
@@ -632,6 +673,50 @@ bool TTESSmartCut::smartCutFrames(const QString& outputFile,
     int cumulativeFrameNumDelta = 0;
     int maxFrameNum = (mLog2MaxFrameNum > 0) ? (1 << mLog2MaxFrameNum) : 0;
 
+    // Boundary re-encodes of all segments render ahead on helper engines;
+    // the loop below replays them in order (see renderBoundaryRun). The guard
+    // stops and drains the helpers on every return path.
+    QThreadPool boundaryPool;
+    mBoundaryCancel.store(false, std::memory_order_relaxed);
+    mBoundaryRuns.clear();
+    auto boundaryGuard = qScopeGuard([&] {
+        mBoundaryCancel.store(true, std::memory_order_relaxed);
+        boundaryPool.waitForDone();
+        mBoundaryRuns.clear();
+        mBoundaryDispatch = nullptr;
+    });
+    const int boundaryWorkers = boundaryWorkerCount();
+    if (boundaryWorkers > 1) {
+        const QVector<ReencodeJob> jobs = planBoundaryJobs(segments);
+        mBoundaryRuns.resize(jobs.size());
+        for (int j = 0; j < jobs.size(); ++j)
+            mBoundaryRuns[j].job = jobs[j];
+
+        // The helpers get the encoder POC probe by value: probed here, once,
+        // before any of them runs, so no run writes it while another reads it.
+        probeEncoderPocParams();
+        const TTNaluIndex index = mParser.index();
+        const TTDisplayOrderMap map = mDisplayMap;
+        const int reorderDelay = mReorderDelay;
+        const int probedLog2PocLsb = mProbedEncoderLog2PocLsb;
+        const int probedPocType = mProbedEncoderPocType;
+        boundaryPool.setMaxThreadCount(boundaryWorkers);
+        mBoundaryDispatch = [this, &boundaryPool, index, map, reorderDelay,
+                             probedLog2PocLsb, probedPocType](int j) {
+            boundaryPool.start(QRunnable::create([this, j, index, map, reorderDelay,
+                                                  probedLog2PocLsb, probedPocType]() {
+                renderBoundaryRun(j, index, map, reorderDelay, probedLog2PocLsb, probedPocType);
+            }));
+        };
+        mBoundaryWindow   = kBoundaryRunsPerWorker * boundaryWorkers;
+        mBoundaryNextRun  = 0;
+        mBoundaryConsumed = 0;
+        refillBoundaryWindow();
+        if (TTSettings::instance()->logSmartCut())
+            qDebug() << "  Boundary re-encodes:" << jobs.size() << "runs on"
+                     << boundaryWorkers << "workers, window" << mBoundaryWindow;
+    }
+
     mTotalSegments = segments.size();
     for (int i = 0; i < segments.size(); ++i) {
         if (checkAbort()) { outFile.close(); return false; }
@@ -655,8 +740,14 @@ bool TTESSmartCut::smartCutFrames(const QString& outputFile,
                      << "->" << seg.streamCopyEndFrame;
         }
 
+        mSinkRankBase = mOutputDisplayOrder.size();
+        mSinkDisplayBase = seg.startDisplay;
+
         int segActualStart = -1;
         if (!processSegment(outFile, seg, cumulativeFrameNumDelta, &segActualStart)) {
+            // A write the sink refused: say why, not just which frame
+            if (sinkDevice && sinkDevice->failed())
+                setError(QString("%1 (%2)").arg(mLastError, sinkDevice->errorString()));
             outFile.close();
             return false;
         }
@@ -723,8 +814,25 @@ bool TTESSmartCut::smartCutFrames(const QString& outputFile,
         // Progress is emitted granularly from streamCopyFrames/reencodeFrames
     }
 
-    outFile.close();
-    mBytesWritten = QFileInfo(outputFile).size();
+    if (sinkDevice) {
+        // Every frame must have gone out with the rank the muxer's sort of
+        // the finished display order would have given it
+        if (!sinkDevice->finish()) {
+            setError(QString("Packet sink output failed: %1").arg(sinkDevice->errorString()));
+            outFile.close();
+            return false;
+        }
+        if (mSinkRanks != outputDisplayOrder()) {
+            setError("Packet sink display ranks differ from the output display order");
+            outFile.close();
+            return false;
+        }
+        mBytesWritten = sinkDevice->bytesReceived();
+        outFile.close();
+    } else {
+        outFile.close();
+        mBytesWritten = QFileInfo(outputFile).size();
+    }
 
     // Persist the measured encode/copy cost ratio k for the next run's seed
     // (mSeedK, see weightedProgressPercent). This is a machine-relative
@@ -765,6 +873,25 @@ bool TTESSmartCut::smartCutFrames(const QString& outputFile,
     return true;
 }
 
+// ----------------------------------------------------------------------------
+// Output ranges of the segment plan - what smartCutFrames records in
+// mActualOutputRanges (the segment's start AU; reencodeFrames no longer
+// moves it)
+// ----------------------------------------------------------------------------
+QList<QPair<int, int>> TTESSmartCut::plannedOutputFrameRanges(
+    const QList<QPair<int, int>>& cutFrames)
+{
+    QList<QPair<int, int>> ranges;
+    if (!mDisplayMap.isValid())
+        mDisplayMap = TTDisplayOrderMap::buildFromFile(mInputFile);
+    if (!mDisplayMap.isValid() || mDisplayMap.count() != frameCount())
+        return ranges;
+
+    for (const TTCutSegmentInfo& seg : analyzeCutPoints(cutFrames))
+        ranges.append(qMakePair(seg.startFrame, seg.endFrame));
+    return ranges;
+}
+
 // ----------------------------------------------------------------------------
 // Analyze cut points
 // ----------------------------------------------------------------------------
@@ -951,15 +1078,14 @@ bool TTESSmartCut::hasSPSChangeAtBoundary(int frameIndex, bool isCutOut)
     if (frameB < 0 || frameB >= mParser.accessUnitCount()) return false;
 
     // Find which SPS NAL is closest before each frame
-    const auto& nalUnits = mParser.nalUnits();
     const auto& auA = mParser.accessUnitAt(frameA);
     const auto& auB = mParser.accessUnitAt(frameB);
 
     // Search backward from each AU's first NAL for the most recent SPS
     auto findActiveSPS = [&](const TTAccessUnit& au) -> int {
-        int firstNal = au.nalIndices.isEmpty() ? 0 : au.nalIndices.first();
+        int firstNal = au.nalCount > 0 ? au.firstNal : 0;
         for (int i = firstNal; i >= 0; i--) {
-            if (nalUnits[i].isSPS) return i;
+            if (mParser.nalUnitAt(i).isSPS) return i;
         }
         return -1;
     };
@@ -1024,7 +1150,7 @@ bool TTESSmartCut::planHevcSeamFix(const TTCutSegmentInfo& segment)
     if (au.isIDR || !au.isKeyframe)
         return false;                              // silent: nothing to fix
     int firstSliceType = -1;
-    for (int ni : au.nalIndices) {
+    for (int ni = au.firstNal; ni < au.firstNal + au.nalCount; ++ni) {
         TTNalUnit nu = mParser.nalUnitAt(ni);
         if (nu.isSlice) { firstSliceType = nu.type; break; }
     }
@@ -1037,7 +1163,7 @@ bool TTESSmartCut::planHevcSeamFix(const TTCutSegmentInfo& segment)
     for (int a = scStart + 1; a < mParser.accessUnitCount(); ++a) {
         int t = -1;
         const TTAccessUnit next = mParser.accessUnitAt(a);
-        for (int ni : next.nalIndices) {
+        for (int ni = next.firstNal; ni < next.firstNal + next.nalCount; ++ni) {
             TTNalUnit nu = mParser.nalUnitAt(ni);
             if (nu.isSlice) { t = nu.type; break; }
         }
@@ -1135,58 +1261,14 @@ bool TTESSmartCut::planHevcSeamFix(const TTCutSegmentInfo& segment)
     return true;
 }
 
-// Each section starts with its own SPS/PPS + IDR, allowing clean decoder reset
 // ----------------------------------------------------------------------------
-bool TTESSmartCut::processSegment(QFile& outFile, const TTCutSegmentInfo& segment,
-                                   int& frameNumDelta, int* actualStartAU)
+// Seam classification for a mixed H.264 segment: does the head re-encode need
+// SPS unification? Shared by processSegment and planBoundaryJobs so the
+// prerendered run is the one processSegment asks for.
+// ----------------------------------------------------------------------------
+bool TTESSmartCut::segmentNeedsSpsUnification(const TTCutSegmentInfo& segment,
+                                              int* pocAnchor, bool log)
 {
-    if (actualStartAU)
-        *actualStartAU = -1;  // -1 = no adjustment
-
-    // If only stream-copy (no re-encoding), write it, then fall through to the
-    // frame-accurate cut-OUT tail re-encode below (the cut-out may still need it).
-    if (segment.reencodeStartFrame < 0) {
-        if (TTSettings::instance()->logSmartCut())
-            qDebug() << "    Pure stream-copy segment";
-        if (!streamCopyFrames(outFile, segment.streamCopyStartFrame,
-                              segment.streamCopyEndFrame, mReorderDelay, frameNumDelta))
-            return false;
-        // fall through to the tail re-encode below (do NOT return)
-    } else if (segment.streamCopyStartFrame < 0) {
-        // Pure re-encode (short segment): selection already bounds display <=
-        // endDisplay, so the cut-out is frame-accurate without a separate tail.
-        if (TTSettings::instance()->logSmartCut())
-            qDebug() << "    Pure re-encode segment";
-        return reencodeFrames(outFile, segment.reencodeStartFrame, segment.reencodeEndFrame,
-                              -1, nullptr, actualStartAU, segment.startDisplay,
-                              segment.endDisplay /*, tailMode=false default */);
-    } else {
-    // Mixed segment: Re-encode partial GOP + stream-copy from keyframe
-    if (TTSettings::instance()->logSmartCut()) {
-        qDebug() << "    Smart Cut: Re-encode" << segment.reencodeStartFrame << "->" << segment.reencodeEndFrame
-                 << "then stream-copy" << segment.streamCopyStartFrame << "->" << segment.streamCopyEndFrame;
-    }
-
-    // PAFF H.264: SPS Unification — rewrite encoder output to match source SPS.
-    // This eliminates the MBAFF→PAFF mode switch at the transition, allowing
-    // seamless stream-copy without IDR/EOS DPB flush (which causes stutter).
-    // Strategy:
-    //   1. Write source SPS/PPS (id=0) before re-encode
-    //   2. Write encoder PPS with id=1 (extracted from first encoder packet)
-    //   3. Rewrite encoder slice NALs to use source SPS params + pps_id=1
-    //   4. At transition: no IDR, no EOS — just continue with stream-copy
-    //   5. Stream-copy frames use source PPS (id=0) naturally
-    // SPS Unification is required for PAFF (separated fields: the encoder's
-    // MBAFF output needs source-SPS signaling). For non-PAFF the encoder's
-    // slice FORMAT is compatible with the source — but its POC domain is not
-    // always: libx264 emits log2_max_poc_lsb=4 (16 values) while sources
-    // typically use 6 (64 values). When the stream-copy start POC lies
-    // outside the encoder-representable bridge window, applyPocDomainFix has
-    // no safe patch value ("no safe poc_lsb") and the decoder discards the
-    // first copied GOP as out-of-order after the EOS. For exactly those
-    // seams, unification (slices rewritten into the source POC domain) makes
-    // the bridge always possible; benign seams keep the unchanged fast path
-    // (byte-identical output).
     bool pocBridgeable = true;
     int unificationSrcPocLsb = -1;
     if (mParser.codecType() == NALU_CODEC_H264 && !mParser.isPAFF()
@@ -1230,7 +1312,7 @@ bool TTESSmartCut::processSegment(QFile& outFile, const TTCutSegmentInfo& segmen
             ? mProbedEncoderLog2PocLsb : kExpectedEncoderLog2PocLsb;
         pocBridgeable = pocDomainBridgeable(scPocLsb, encLog2PocLsb,
                                             mLog2MaxPocLsb);
-        if (!pocBridgeable && TTSettings::instance()->logSmartCut()) {
+        if (!pocBridgeable && log && TTSettings::instance()->logSmartCut()) {
             qDebug() << "    POC domain not bridgeable (copy-start poc_lsb" << scPocLsb
                      << ", first-display poc_lsb" << anchorPocLsb
                      << "at AU" << anchorAu
@@ -1253,225 +1335,308 @@ bool TTESSmartCut::processSegment(QFile& outFile, const TTCutSegmentInfo& segmen
             && kfHasLeadingPics(mParser, mDisplayMap,
                                 segment.streamCopyStartFrame, frameCount())) {
         seamNeedsUnification = true;
-        if (TTSettings::instance()->logSmartCut())
+        if (log && TTSettings::instance()->logSmartCut())
             qDebug() << "    Non-IDR copy-start with leading pics at AU"
                      << segment.streamCopyStartFrame
                      << "- enabling SPS unification for this segment";
     }
-    bool useSpsUnification = (mParser.codecType() == NALU_CODEC_H264)
+    if (pocAnchor)
+        *pocAnchor = unificationSrcPocLsb;
+    return (mParser.codecType() == NALU_CODEC_H264)
         && (mParser.isPAFF() || !pocBridgeable || seamNeedsUnification);
+}
 
-    // HEVC seam fix (Defekt A / H.265): preflighted RASL-preserving seam.
-    // On any later rewrite failure the segment output is rolled back and
-    // re-written on the standard path (never a half-written segment).
-    bool hevcSeamDone = false;
-    if (planHevcSeamFix(segment)) {
-        const qint64 segPos = outFile.pos();
-        const int dispCount = mOutputDisplayOrder.size();
-        const int rangeCount = mActualOutputRanges.size();
-        const int reencBefore = mFramesReencoded;
-        const int copiedBefore = mFramesStreamCopied;
-
-        bool ok = false;
-        mHevcSeamRewriteFailed = false;
-        mEncoderPacketsWritten = 0;
-        // 1. Source parameter sets rule the whole segment (prevents the
-        //    DPB flush from an SPS content switch at the seam). For H.265
-        //    writeParameterSets emits VPS/SPS/PPS verbatim (the reorder
-        //    patch argument only ever applies to H.264).
-        ok = writeParameterSets(outFile, 0);
-        int adjustedStart = -1;
-        if (ok)
-            ok = reencodeFrames(outFile, segment.reencodeStartFrame,
-                                segment.reencodeEndFrame,
-                                segment.streamCopyStartFrame, &adjustedStart,
-                                actualStartAU, segment.startDisplay);
-        if (ok && !mHevcSeamRewriteFailed) {
-            int scStart = (adjustedStart >= 0) ? adjustedStart
-                                               : segment.streamCopyStartFrame;
-            // 2. NO EOB, NO parameter-set re-write at the seam: the DPB must
-            //    survive so the RASL window resolves against the standins.
-            if (scStart <= segment.streamCopyEndFrame)
-                ok = streamCopyFrames(outFile, scStart,
-                                      segment.streamCopyEndFrame,
-                                      mReorderDelay, frameNumDelta);
-        }
-        mHevcSeamFix = false;
-        mHevcSeamX265Params.clear();
-
-        if (ok && !mHevcSeamRewriteFailed) {
-            hevcSeamDone = true;      // tail epilogue below is shared
-        } else if (!mHevcSeamRewriteFailed) {
-            return false;             // hard error (I/O, encoder) — abort
-        } else {
-            // P5 rollback: truncate segment output + restore counters, then
-            // run the standard path below.
-            const QString note =
-                tr("Seam at frame %1: RASL preservation aborted (%2) - "
-                   "using standard seam (short freeze)")
-                .arg(segment.streamCopyStartFrame).arg(mHevcSeamFailReason);
-            mSeamNotes.append(note);
-            TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__, note);
-            outFile.resize(segPos);
-            outFile.seek(segPos);
-            mOutputDisplayOrder.resize(dispCount);
-            while (mActualOutputRanges.size() > rangeCount)
-                mActualOutputRanges.removeLast();
-            mFramesReencoded = reencBefore;
-            mFramesStreamCopied = copiedBefore;
-            mHevcSeamRewriteFailed = false;
-        }
-    }
+// Each section starts with its own SPS/PPS + IDR, allowing clean decoder reset
+// ----------------------------------------------------------------------------
+bool TTESSmartCut::processSegment(QIODevice& outFile, const TTCutSegmentInfo& segment,
+                                   int& frameNumDelta, int* actualStartAU)
+{
+    if (actualStartAU)
+        *actualStartAU = -1;  // -1 = no adjustment
 
-    if (!hevcSeamDone) {
-    if (useSpsUnification) {
+    // If only stream-copy (no re-encoding), write it, then fall through to the
+    // frame-accurate cut-OUT tail re-encode below (the cut-out may still need it).
+    if (segment.reencodeStartFrame < 0) {
         if (TTSettings::instance()->logSmartCut())
-            qDebug() << "    PAFF SPS Unification: rewriting encoder output for source SPS";
-        if (TTSettings::instance()->logSmartCut()) {
-            qDebug() << "      Encoder: log2_fn=" << mEncoderLog2MaxFrameNum
-                     << "log2_poc=" << mEncoderLog2MaxPocLsb
-                     << "frame_mbs_only=" << mEncoderFrameMbsOnly;
-        }
-        if (TTSettings::instance()->logSmartCut()) {
-            qDebug() << "      Source:  log2_fn=" << mLog2MaxFrameNum
-                     << "log2_poc=" << mLog2MaxPocLsb
-                     << "frame_mbs_only=" << mFrameMbsOnly;
-        }
-
-        // 1. Write source SPS/PPS (id=0) first — these are the "active" params
-        writeParameterSets(outFile, mReorderDelay);
-
-        // 2. Re-encode with SPS unification
-        //    Encoder packets are rewritten on-the-fly in reencodeFrames.
-        //    The encoder PPS (id=1) is written after extraction from first packet.
-        mSpsUnification = true;
-        mSpsUnificationOutFile = &outFile;
-        // Non-PAFF POC seam: anchor the rewritten encoder POCs to the source
-        // value at the copy start so they join monotonically (PAFF keeps the
-        // legacy linear numbering: anchor stays -1).
-        mSpsUnificationPocAnchor = mParser.isPAFF() ? -1 : unificationSrcPocLsb;
-        mSpsUnificationPocBase = -1;
-        mEncoderPacketsWritten = 0;
-
-        int adjustedStart = -1;
-        if (!reencodeFrames(outFile, segment.reencodeStartFrame, segment.reencodeEndFrame,
-                            segment.streamCopyStartFrame, &adjustedStart, actualStartAU,
-                            segment.startDisplay)) {
-            mSpsUnification = false;
-            mSpsUnificationOutFile = nullptr;
-            mSpsUnificationPocAnchor = -1;
-            mSpsUnificationPocBase = -1;
+            qDebug() << "    Pure stream-copy segment";
+        if (!streamCopyFrames(outFile, segment.streamCopyStartFrame,
+                              segment.streamCopyEndFrame, mReorderDelay, frameNumDelta))
             return false;
+        // fall through to the tail re-encode below (do NOT return)
+    } else if (segment.streamCopyStartFrame < 0) {
+        // Pure re-encode (short segment): selection already bounds display <=
+        // endDisplay, so the cut-out is frame-accurate without a separate tail.
+        if (TTSettings::instance()->logSmartCut())
+            qDebug() << "    Pure re-encode segment";
+        return reencodeFrames(outFile, segment.reencodeStartFrame, segment.reencodeEndFrame,
+                              -1, nullptr, actualStartAU, segment.startDisplay,
+                              segment.endDisplay /*, tailMode=false default */);
+    } else {
+        // Mixed segment: Re-encode partial GOP + stream-copy from keyframe
+        if (TTSettings::instance()->logSmartCut()) {
+            qDebug() << "    Smart Cut: Re-encode" << segment.reencodeStartFrame << "->" << segment.reencodeEndFrame
+                     << "then stream-copy" << segment.streamCopyStartFrame << "->" << segment.streamCopyEndFrame;
+        }
+
+        // PAFF H.264: SPS Unification — rewrite encoder output to match source SPS.
+        // This eliminates the MBAFF→PAFF mode switch at the transition, allowing
+        // seamless stream-copy without IDR/EOS DPB flush (which causes stutter).
+        // Strategy:
+        //   1. Write source SPS/PPS (id=0) before re-encode
+        //   2. Write encoder PPS with id=1 (extracted from first encoder packet)
+        //   3. Rewrite encoder slice NALs to use source SPS params + pps_id=1
+        //   4. At transition: no IDR, no EOS — just continue with stream-copy
+        //   5. Stream-copy frames use source PPS (id=0) naturally
+        // SPS Unification is required for PAFF (separated fields: the encoder's
+        // MBAFF output needs source-SPS signaling). For non-PAFF the encoder's
+        // slice FORMAT is compatible with the source — but its POC domain is not
+        // always: libx264 emits log2_max_poc_lsb=4 (16 values) while sources
+        // typically use 6 (64 values). When the stream-copy start POC lies
+        // outside the encoder-representable bridge window, applyPocDomainFix has
+        // no safe patch value ("no safe poc_lsb") and the decoder discards the
+        // first copied GOP as out-of-order after the EOS. For exactly those
+        // seams, unification (slices rewritten into the source POC domain) makes
+        // the bridge always possible; benign seams keep the unchanged fast path
+        // (byte-identical output).
+        int unificationSrcPocLsb = -1;
+        bool useSpsUnification = segmentNeedsSpsUnification(segment, &unificationSrcPocLsb, true);
+
+        // HEVC seam fix (Defekt A / H.265): preflighted RASL-preserving seam.
+        // On any later rewrite failure the segment output is rolled back and
+        // re-written on the standard path (never a half-written segment).
+        bool hevcSeamDone = false;
+        if (planHevcSeamFix(segment)) {
+            // The rollback truncates a file. Any other device (packet sink) gets
+            // the attempt spooled to a temp file and copied in once it holds.
+            QFileDevice* outFileDev = qobject_cast<QFileDevice*>(&outFile);
+            QTemporaryFile spool(QDir(TTSettings::instance()->cutDirPath())
+                                     .filePath("ttcut_seam_XXXXXX.es"));
+            if (!outFileDev && !spool.open()) {
+                setError(QString("Cannot create seam spool file in %1")
+                             .arg(TTSettings::instance()->cutDirPath()));
+                return false;
+            }
+            QIODevice& seamOut = outFileDev ? outFile : static_cast<QIODevice&>(spool);
+            const qint64 segPos = outFileDev ? outFileDev->pos() : 0;
+            const int dispCount = mOutputDisplayOrder.size();
+            const int rangeCount = mActualOutputRanges.size();
+            const int reencBefore = mFramesReencoded;
+            const int copiedBefore = mFramesStreamCopied;
+
+            bool ok = false;
+            mHevcSeamRewriteFailed = false;
+            mEncoderPacketsWritten = 0;
+            // 1. Source parameter sets rule the whole segment (prevents the
+            //    DPB flush from an SPS content switch at the seam). For H.265
+            //    writeParameterSets emits VPS/SPS/PPS verbatim (the reorder
+            //    patch argument only ever applies to H.264).
+            ok = writeParameterSets(seamOut, 0);
+            int adjustedStart = -1;
+            if (ok)
+                ok = reencodeFrames(seamOut, segment.reencodeStartFrame,
+                                    segment.reencodeEndFrame,
+                                    segment.streamCopyStartFrame, &adjustedStart,
+                                    actualStartAU, segment.startDisplay);
+            if (ok && !mHevcSeamRewriteFailed) {
+                int scStart = (adjustedStart >= 0) ? adjustedStart
+                                                   : segment.streamCopyStartFrame;
+                // 2. NO EOB, NO parameter-set re-write at the seam: the DPB must
+                //    survive so the RASL window resolves against the standins.
+                if (scStart <= segment.streamCopyEndFrame)
+                    ok = streamCopyFrames(seamOut, scStart,
+                                          segment.streamCopyEndFrame,
+                                          mReorderDelay, frameNumDelta);
+            }
+            mHevcSeamFix = false;
+            mHevcSeamX265Params.clear();
+
+            if (ok && !mHevcSeamRewriteFailed && !outFileDev) {
+                ok = spool.seek(0);
+                while (ok && !spool.atEnd()) {
+                    const QByteArray chunk = spool.read(8 * 1024 * 1024);
+                    ok = !chunk.isEmpty() && outFile.write(chunk) == chunk.size();
+                }
+                if (!ok)
+                    setError(QString("Failed to copy the seam spool of frame %1: %2")
+                                 .arg(segment.streamCopyStartFrame).arg(outFile.errorString()));
+            }
+
+            if (ok && !mHevcSeamRewriteFailed) {
+                hevcSeamDone = true;      // tail epilogue below is shared
+            } else if (!mHevcSeamRewriteFailed) {
+                return false;             // hard error (I/O, encoder) — abort
+            } else {
+                // P5 rollback: truncate segment output + restore counters, then
+                // run the standard path below.
+                const QString note =
+                    tr("Seam at frame %1: RASL preservation aborted (%2) - "
+                       "using standard seam (short freeze)")
+                    .arg(segment.streamCopyStartFrame).arg(mHevcSeamFailReason);
+                mSeamNotes.append(note);
+                TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__, note);
+                if (outFileDev) {
+                    outFileDev->resize(segPos);
+                    outFileDev->seek(segPos);
+                }
+                mOutputDisplayOrder.resize(dispCount);
+                mSinkRanks.resize(qMin(mSinkRanks.size(), dispCount));
+                while (mActualOutputRanges.size() > rangeCount)
+                    mActualOutputRanges.removeLast();
+                mFramesReencoded = reencBefore;
+                mFramesStreamCopied = copiedBefore;
+                mHevcSeamRewriteFailed = false;
+            }
         }
-        mSpsUnification = false;
-        mSpsUnificationOutFile = nullptr;
-        mSpsUnificationPocAnchor = -1;
-        mSpsUnificationPocBase = -1;
 
-        int scStart = (adjustedStart >= 0) ? adjustedStart : segment.streamCopyStartFrame;
-        int scEnd = segment.streamCopyEndFrame;
+        if (!hevcSeamDone) {
+            if (useSpsUnification) {
+                if (TTSettings::instance()->logSmartCut())
+                    qDebug() << "    PAFF SPS Unification: rewriting encoder output for source SPS";
+                if (TTSettings::instance()->logSmartCut()) {
+                    qDebug() << "      Encoder: log2_fn=" << mEncoderLog2MaxFrameNum
+                             << "log2_poc=" << mEncoderLog2MaxPocLsb
+                             << "frame_mbs_only=" << mEncoderFrameMbsOnly;
+                }
+                if (TTSettings::instance()->logSmartCut()) {
+                    qDebug() << "      Source:  log2_fn=" << mLog2MaxFrameNum
+                             << "log2_poc=" << mLog2MaxPocLsb
+                             << "frame_mbs_only=" << mFrameMbsOnly;
+                }
 
-        if (scStart > scEnd) {
-            // Do NOT return: the boundary-crossing extension can consume the whole
-            // stream-copy range (scStart == tailStart) while a cut-out tail GOP is
-            // still pending. Fall through to the tail re-encode epilogue.
-            if (TTSettings::instance()->logSmartCut())
-                qDebug() << "    Re-encode consumed entire segment, no stream-copy needed";
-        } else {
+                // 1. Write source SPS/PPS (id=0) first — these are the "active" params
+                writeParameterSets(outFile, mReorderDelay);
+
+                // 2. Re-encode with SPS unification
+                //    Encoder packets are rewritten on-the-fly in reencodeFrames.
+                //    The encoder PPS (id=1) is written after extraction from first packet.
+                mSpsUnification = true;
+                mSpsUnificationOutFile = &outFile;
+                // Non-PAFF POC seam: anchor the rewritten encoder POCs to the source
+                // value at the copy start so they join monotonically (PAFF keeps the
+                // legacy linear numbering: anchor stays -1).
+                mSpsUnificationPocAnchor = mParser.isPAFF() ? -1 : unificationSrcPocLsb;
+                mSpsUnificationPocBase = -1;
+                mEncoderPacketsWritten = 0;
+
+                int adjustedStart = -1;
+                if (!reencodeFrames(outFile, segment.reencodeStartFrame, segment.reencodeEndFrame,
+                                    segment.streamCopyStartFrame, &adjustedStart, actualStartAU,
+                                    segment.startDisplay)) {
+                    mSpsUnification = false;
+                    mSpsUnificationOutFile = nullptr;
+                    mSpsUnificationPocAnchor = -1;
+                    mSpsUnificationPocBase = -1;
+                    return false;
+                }
+                mSpsUnification = false;
+                mSpsUnificationOutFile = nullptr;
+                mSpsUnificationPocAnchor = -1;
+                mSpsUnificationPocBase = -1;
+
+                int scStart = (adjustedStart >= 0) ? adjustedStart : segment.streamCopyStartFrame;
+                int scEnd = segment.streamCopyEndFrame;
+
+                if (scStart > scEnd) {
+                    // Do NOT return: the boundary-crossing extension can consume the whole
+                    // stream-copy range (scStart == tailStart) while a cut-out tail GOP is
+                    // still pending. Fall through to the tail re-encode epilogue.
+                    if (TTSettings::instance()->logSmartCut())
+                        qDebug() << "    Re-encode consumed entire segment, no stream-copy needed";
+                } else {
 
-        // 3. EOS to flush DPB before stream-copy.
-        // The re-encode produces MBAFF frames (x264 can't do PAFF). Without
-        // EOS, these stay in the DPB and corrupt PAFF B-frame references at
-        // stream-copy start (mmco failures, exceeds max, visual artifacts).
-        // EOS flushes all MBAFF references so stream-copy starts clean.
-        // The overlap extension (in reencodeFrames) ensures the re-encode
-        // covers all frames up to the next keyframe, so no Open-GOP B-frames
-        // need the flushed MBAFF references. (This branch is H.264-only, so
-        // writeEos emits the same H.264 EOS the open-coded write did.)
-        writeEos(outFile);
-        if (TTSettings::instance()->logSmartCut())
-            qDebug() << "    PAFF SPS Unification: EOS before stream-copy at" << scStart;
-
-        // Do NOT write SPS/PPS here — the first stream-copy keyframe AU has
-        // inline SPS/PPS which patchSpsNalsInAccessUnit will patch.
-        // Writing duplicate SPS/PPS causes the h264 parser to combine them
-        // with the first AU into one oversized packet → "Invalid NAL unit size".
-
-        // Bridge encoder frame_nums to the stream-copy start. The encoder
-        // slices were REWRITTEN into the SOURCE fn width by SPS unification
-        // (mSpsUnification is already reset back to false at this point, so
-        // do not consult it) — hence the encoder width here is
-        // mLog2MaxFrameNum.
-        frameNumDelta = bridgeFrameNum(scStart, mLog2MaxFrameNum);
-        if (TTSettings::instance()->logSmartCut())
-            qDebug() << "    frameNumDelta:" << frameNumDelta;
-
-        // MMCO neutralization: PAFF only. Its purpose is to stop source MMCOs
-        // from operating on the flushed MBAFF standins (mmco failures, visual
-        // artifacts); ~32 AUs cover the DPB refill. On frame-coded material
-        // blanket-emptying the ops is actively harmful: streams whose adaptive
-        // marking is load-bearing (measured: ONE-HD Petrocelli) end up with a
-        // sliding window that evicts different pictures than the source
-        // expected — display-order inversion and reference damage deep into
-        // the copy. Without neutralization the only residue there is the
-        // benign one-shot "mmco: unref short failure" chain reestablishment
-        // (the op's target is already gone), pixels bit-identical (2026-07-20).
-        int mmcoNeutralizeCount = mParser.isPAFF() ? 32 : 0;
-
-        if (!streamCopyFrames(outFile, scStart, scEnd,
-                              mReorderDelay, frameNumDelta, mmcoNeutralizeCount))
-            return false;
-        }   // end: stream-copy middle present (scStart <= scEnd)
+                    // 3. EOS to flush DPB before stream-copy.
+                    // The re-encode produces MBAFF frames (x264 can't do PAFF). Without
+                    // EOS, these stay in the DPB and corrupt PAFF B-frame references at
+                    // stream-copy start (mmco failures, exceeds max, visual artifacts).
+                    // EOS flushes all MBAFF references so stream-copy starts clean.
+                    // The overlap extension (in reencodeFrames) ensures the re-encode
+                    // covers all frames up to the next keyframe, so no Open-GOP B-frames
+                    // need the flushed MBAFF references. (This branch is H.264-only, so
+                    // writeEos emits the same H.264 EOS the open-coded write did.)
+                    writeEos(outFile);
+                    if (TTSettings::instance()->logSmartCut())
+                        qDebug() << "    PAFF SPS Unification: EOS before stream-copy at" << scStart;
+
+                    // Do NOT write SPS/PPS here — the first stream-copy keyframe AU has
+                    // inline SPS/PPS which patchSpsNalsInAccessUnit will patch.
+                    // Writing duplicate SPS/PPS causes the h264 parser to combine them
+                    // with the first AU into one oversized packet → "Invalid NAL unit size".
+
+                    // Bridge encoder frame_nums to the stream-copy start. The encoder
+                    // slices were REWRITTEN into the SOURCE fn width by SPS unification
+                    // (mSpsUnification is already reset back to false at this point, so
+                    // do not consult it) — hence the encoder width here is
+                    // mLog2MaxFrameNum.
+                    frameNumDelta = bridgeFrameNum(scStart, mLog2MaxFrameNum);
+                    if (TTSettings::instance()->logSmartCut())
+                        qDebug() << "    frameNumDelta:" << frameNumDelta;
+
+                    // MMCO neutralization: PAFF only. Its purpose is to stop source MMCOs
+                    // from operating on the flushed MBAFF standins (mmco failures, visual
+                    // artifacts); ~32 AUs cover the DPB refill. On frame-coded material
+                    // blanket-emptying the ops is actively harmful: streams whose adaptive
+                    // marking is load-bearing (measured: ONE-HD Petrocelli) end up with a
+                    // sliding window that evicts different pictures than the source
+                    // expected — display-order inversion and reference damage deep into
+                    // the copy. Without neutralization the only residue there is the
+                    // benign one-shot "mmco: unref short failure" chain reestablishment
+                    // (the op's target is already gone), pixels bit-identical (2026-07-20).
+                    int mmcoNeutralizeCount = mParser.isPAFF() ? 32 : 0;
+
+                    if (!streamCopyFrames(outFile, scStart, scEnd,
+                                          mReorderDelay, frameNumDelta, mmcoNeutralizeCount))
+                        return false;
+                }   // end: stream-copy middle present (scStart <= scEnd)
 
-    } else {
-        // Standard path: re-encode + EOS + stream-copy
-        mEncoderPacketsWritten = 0;
+            } else {
+                // Standard path: re-encode + EOS + stream-copy
+                mEncoderPacketsWritten = 0;
 
-        int adjustedStart = -1;
-        if (!reencodeFrames(outFile, segment.reencodeStartFrame, segment.reencodeEndFrame,
-                            segment.streamCopyStartFrame, &adjustedStart, actualStartAU,
-                            segment.startDisplay)) {
-            return false;
-        }
+                int adjustedStart = -1;
+                if (!reencodeFrames(outFile, segment.reencodeStartFrame, segment.reencodeEndFrame,
+                                    segment.streamCopyStartFrame, &adjustedStart, actualStartAU,
+                                    segment.startDisplay)) {
+                    return false;
+                }
 
-        int scStart = (adjustedStart >= 0) ? adjustedStart : segment.streamCopyStartFrame;
-        int scEnd = segment.streamCopyEndFrame;
+                int scStart = (adjustedStart >= 0) ? adjustedStart : segment.streamCopyStartFrame;
+                int scEnd = segment.streamCopyEndFrame;
 
-        if (scStart > scEnd) {
-            // Do NOT return: fall through to the tail re-encode epilogue (a pending
-            // cut-out tail GOP must still be written).
-            if (TTSettings::instance()->logSmartCut())
-                qDebug() << "    Re-encode consumed entire segment, no stream-copy needed";
-        } else {
-        // Non-PAFF: use EOS to flush decoder DPB
-        writeEos(outFile);
-        if (TTSettings::instance()->logSmartCut())
-            qDebug() << "    Inserted EOS NAL - flushing DPB at" << scStart;
-
-        // Write source parameter sets
-        writeParameterSets(outFile, mReorderDelay);
-
-        // Bridge encoder frame_nums to the stream-copy start. EOS flushes the
-        // DPB but does NOT reset PrevRefFrameNum (only IDR does); without the
-        // bridge a frame_num gap after PrevRefFrameNum overflows the DPB with
-        // dummy references ("co located POCs unavailable" -> first copied GOP
-        // dropped). This branch runs without SPS unification, so the encoder
-        // slices carry the ENCODER SPS fn width. No outer guard: bridgeFrameNum
-        // itself returns 0 for H.265/no-SPS, and frameNumDelta is only ever
-        // consumed on H.264 paths (streamCopyFrames and the inter-segment
-        // recompute are both H.264-gated).
-        frameNumDelta = bridgeFrameNum(scStart, mEncoderLog2MaxFrameNum);
-        if (TTSettings::instance()->logSmartCut())
-            qDebug() << "    frameNumDelta recalculated:" << frameNumDelta;
-
-        // Stream-copy from keyframe
-        if (!streamCopyFrames(outFile, scStart, scEnd,
-                              mReorderDelay, frameNumDelta)) {
-            return false;
-        }
-        }   // end: stream-copy middle present (scStart <= scEnd)
-    }
-    }   // end: standard/unification path (skipped when the HEVC seam fix ran)
+                if (scStart > scEnd) {
+                    // Do NOT return: fall through to the tail re-encode epilogue (a pending
+                    // cut-out tail GOP must still be written).
+                    if (TTSettings::instance()->logSmartCut())
+                        qDebug() << "    Re-encode consumed entire segment, no stream-copy needed";
+                } else {
+                    // Non-PAFF: use EOS to flush decoder DPB
+                    writeEos(outFile);
+                    if (TTSettings::instance()->logSmartCut())
+                        qDebug() << "    Inserted EOS NAL - flushing DPB at" << scStart;
+
+                    // Write source parameter sets
+                    writeParameterSets(outFile, mReorderDelay);
+
+                    // Bridge encoder frame_nums to the stream-copy start. EOS flushes the
+                    // DPB but does NOT reset PrevRefFrameNum (only IDR does); without the
+                    // bridge a frame_num gap after PrevRefFrameNum overflows the DPB with
+                    // dummy references ("co located POCs unavailable" -> first copied GOP
+                    // dropped). This branch runs without SPS unification, so the encoder
+                    // slices carry the ENCODER SPS fn width. No outer guard: bridgeFrameNum
+                    // itself returns 0 for H.265/no-SPS, and frameNumDelta is only ever
+                    // consumed on H.264 paths (streamCopyFrames and the inter-segment
+                    // recompute are both H.264-gated).
+                    frameNumDelta = bridgeFrameNum(scStart, mEncoderLog2MaxFrameNum);
+                    if (TTSettings::instance()->logSmartCut())
+                        qDebug() << "    frameNumDelta recalculated:" << frameNumDelta;
+
+                    // Stream-copy from keyframe
+                    if (!streamCopyFrames(outFile, scStart, scEnd,
+                                          mReorderDelay, frameNumDelta)) {
+                        return false;
+                    }
+                }   // end: stream-copy middle present (scStart <= scEnd)
+            }
+        }   // end: standard/unification path (skipped when the HEVC seam fix ran)
     }   // end mixed-segment else
 
     // ---- Frame-accurate cut-OUT: re-encode the tail GOP if needed ----
@@ -2444,7 +2609,7 @@ void TTESSmartCut::emitCutProgress(const QString& msg, int encodeInFlight)
 // If patchReorderFrames > 0, patches H.264 SPS NALs inline for correct
 // decoder reorder buffer signaling.
 // ----------------------------------------------------------------------------
-bool TTESSmartCut::streamCopyFrames(QFile& outFile, int startFrame, int endFrame,
+bool TTESSmartCut::streamCopyFrames(QIODevice& outFile, int startFrame, int endFrame,
                                      int patchReorderFrames, int frameNumDelta,
                                      int neutralizeMmcoFrames)
 {
@@ -2486,39 +2651,129 @@ bool TTESSmartCut::streamCopyFrames(QFile& outFile, int startFrame, int endFrame
                          << (totalSize / (1024*1024)) << "MB";
             }
 
-            // Chunked so a user abort takes effect within one chunk and the
-            // progress signal keeps flowing during multi-GB interior copies.
-            static const int64_t kChunk = 8LL * 1024 * 1024;
-            int64_t written = 0;
-            while (written < totalSize) {
-                if (checkAbort()) return false;
-                int64_t n = qMin(kChunk, totalSize - written);
-                if (outFile.write(reinterpret_cast<const char*>(startPtr) + written, n) != n) {
-                    setError(QString("Bulk write failed for frames %1-%2").arg(startFrame).arg(endFrame));
-                    return false;
-                }
-                written += n;
-                // Progress: proportional frame count for the weighting model.
-                int framesDone = int((endFrame - startFrame + 1) * (double(written) / totalSize));
-                if (mTotalFrames > 0) {
-                    int prev = mFramesStreamCopied;
-                    mFramesStreamCopied = copiedAtEntry + framesDone;
-                    if (mFramesStreamCopied != prev)
-                        emitCutProgress(
-                            tr("Processing segment %1/%2").arg(mCurrentSegment).arg(mTotalSegments), 0);
-                }
-            }
-
+            // Recorded up front: a packet sink hands each frame on as soon
+            // as its rank is known instead of holding the whole run.
             for (int au = startFrame; au <= endFrame && mOutputDisplayOrderValid; ++au)
                 appendOutputDisplay(mDisplayMap.decodeToDisplay(au), au);
 
+            // Into a file the bytes go file to file in the kernel
+            // (copy_file_range/sendfile), otherwise from the mapping. The
+            // callback runs per 8 MB chunk, so a user abort takes effect
+            // within one chunk and the progress signal keeps flowing during
+            // multi-GB interior copies.
+            bool aborted = false;
+            const int64_t copied = TTByteRangeCopy::copy(
+                mParser.file(), mParser.accessUnitOffset(startFrame), outFile, totalSize,
+                [&](qint64 written) {
+                    if (checkAbort()) {
+                        aborted = true;
+                        return false;
+                    }
+                    // Progress: proportional frame count for the weighting model.
+                    int framesDone = int((endFrame - startFrame + 1) * (double(written) / totalSize));
+                    if (mTotalFrames > 0) {
+                        int prev = mFramesStreamCopied;
+                        mFramesStreamCopied = copiedAtEntry + framesDone;
+                        if (mFramesStreamCopied != prev)
+                            emitCutProgress(
+                                tr("Processing segment %1/%2").arg(mCurrentSegment).arg(mTotalSegments), 0);
+                    }
+                    return true;
+                },
+                startPtr);
+            if (aborted) return false;
+            if (copied != totalSize) {
+                setError(QString("Bulk write failed for frames %1-%2: %3")
+                             .arg(startFrame).arg(endFrame).arg(TTByteRangeCopy::lastError()));
+                return false;
+            }
+            if (TTSettings::instance()->logSmartCut())
+                qDebug() << "    Bulk-write via" << TTByteRangeCopy::methodName(TTByteRangeCopy::lastMethod());
+
             mFramesStreamCopied = copiedAtEntry + (endFrame - startFrame + 1);
             return true;
         }
         // Fall through to per-frame path if accessUnitPtr failed
     }
 
-    // --- Per-frame path: patching required or mmap unavailable ---
+    // Copying patchers of the per-frame path. The mapped path below uses
+    // them only for the AUs it cannot patch in place (inline SPS, MMCO).
+    auto patchCopiedAU = [&](QByteArray& auData, int i) {
+        // Neutralize MMCO in first N frames after EOS (PAFF DPB refill)
+        if (neutralizeMmcoFrames > 0 && (i - startFrame) < neutralizeMmcoFrames &&
+            mParser.codecType() == NALU_CODEC_H264) {
+            H264PpsInfo ppsInfo = { true, false, true, false, false, 0, 0, 0, false };
+            if (mParser.ppsCount() > 0)
+                ppsInfo = parseH264PpsInfo(mParser.getPPS(0));
+            auData = neutralizeMmcoInAU(auData, mLog2MaxFrameNum,
+                mLog2MaxPocLsb, mFrameMbsOnly, ppsInfo);
+        }
+
+        // Patch H.264 SPS NALs inline if requested
+        if (patchReorderFrames > 0 && mParser.codecType() == NALU_CODEC_H264) {
+            auData = patchSpsNalsInAccessUnit(auData, patchReorderFrames, mParser.isPAFF());
+        }
+
+        // Patch H.264 frame_num for inter-segment continuity
+        if (frameNumDelta != 0 && mLog2MaxFrameNum > 0 &&
+            mParser.codecType() == NALU_CODEC_H264) {
+            auData = patchFrameNumInAU(auData, mLog2MaxFrameNum, frameNumDelta, maxFrameNum);
+        }
+    };
+
+    // --- Patched mmap path: H.264, scatter/gather ---
+    // frame_num is rewritten in the first bytes of each slice header only
+    // (TTH264CopyPatcher); the rest of every AU is written straight from the
+    // mapping with writev. AUs carrying an SPS (one per GOP) and the MMCO-
+    // neutralized frames after an EOS take the copying patchers.
+    if (needsPatching && mParser.isMapped() && mParser.codecType() == NALU_CODEC_H264) {
+        TTH264CopyPatcher patcher(mLog2MaxFrameNum, frameNumDelta);
+        for (int i = startFrame; i <= endFrame; ++i) {
+            if (checkAbort()) return false;
+
+            int64_t auSize;
+            const uchar* auPtr = mParser.accessUnitPtr(i, auSize);
+            if (!auPtr) {
+                setError(QString("Failed to read frame %1").arg(i));
+                return false;
+            }
+
+            bool copyPatch = neutralizeMmcoFrames > 0 && (i - startFrame) < neutralizeMmcoFrames;
+            if (!copyPatch && patchReorderFrames > 0) {
+                const TTAccessUnit au = mParser.accessUnitAt(i);
+                for (int n = au.firstNal; !copyPatch && n < au.firstNal + au.nalCount; ++n)
+                    copyPatch = mParser.nalUnitAt(n).isSPS;
+            }
+            if (copyPatch) {
+                QByteArray auData(reinterpret_cast<const char*>(auPtr), auSize);
+                patchCopiedAU(auData, i);
+                patcher.addBytes(auData);
+            } else {
+                patcher.addMapped(auPtr, auSize);
+            }
+
+            if ((patcher.needsFlush() || i == endFrame) && !patcher.flush(outFile)) {
+                setError(QString("Failed to write frames %1-%2: %3")
+                             .arg(startFrame).arg(i).arg(outFile.errorString()));
+                return false;
+            }
+
+            appendOutputDisplay(mDisplayMap.decodeToDisplay(i), i);
+            mFramesStreamCopied++;
+
+            if (mTotalFrames > 0 && (mFramesStreamCopied % 50 == 0 || i == endFrame)) {
+                emitCutProgress(
+                    tr("Processing segment %1/%2").arg(mCurrentSegment).arg(mTotalSegments), 0);
+            }
+        }
+
+        if (TTSettings::instance()->logSmartCut())
+            qDebug() << "    Patched copy:" << patcher.patchedSlices() << "slices patched,"
+                     << patcher.rewrittenNals() << "of them as whole NALs";
+        return true;
+    }
+
+    // --- Per-frame path: mmap unavailable (or patching outside H.264) ---
     for (int i = startFrame; i <= endFrame; ++i) {
         if (checkAbort()) return false;
 
@@ -2543,26 +2798,7 @@ bool TTESSmartCut::streamCopyFrames(QFile& outFile, int startFrame, int endFrame
             return false;
         }
 
-        // Neutralize MMCO in first N frames after EOS (PAFF DPB refill)
-        if (neutralizeMmcoFrames > 0 && (i - startFrame) < neutralizeMmcoFrames &&
-            mParser.codecType() == NALU_CODEC_H264) {
-            H264PpsInfo ppsInfo = { true, false, true, false, false, 0, 0, 0, false };
-            if (mParser.ppsCount() > 0)
-                ppsInfo = parseH264PpsInfo(mParser.getPPS(0));
-            auData = neutralizeMmcoInAU(auData, mLog2MaxFrameNum,
-                mLog2MaxPocLsb, mFrameMbsOnly, ppsInfo);
-        }
-
-        // Patch H.264 SPS NALs inline if requested
-        if (patchReorderFrames > 0 && mParser.codecType() == NALU_CODEC_H264) {
-            auData = patchSpsNalsInAccessUnit(auData, patchReorderFrames, mParser.isPAFF());
-        }
-
-        // Patch H.264 frame_num for inter-segment continuity
-        if (frameNumDelta != 0 && mLog2MaxFrameNum > 0 &&
-            mParser.codecType() == NALU_CODEC_H264) {
-            auData = patchFrameNumInAU(auData, mLog2MaxFrameNum, frameNumDelta, maxFrameNum);
-        }
+        patchCopiedAU(auData, i);
 
         // Write to output
         if (outFile.write(auData) != auData.size()) {
@@ -2587,7 +2823,7 @@ bool TTESSmartCut::streamCopyFrames(QFile& outFile, int startFrame, int endFrame
 // ----------------------------------------------------------------------------
 // Re-encode frames (for partial GOPs)
 // ----------------------------------------------------------------------------
-bool TTESSmartCut::reencodeFrames(QFile& outFile, int startFrame, int endFrame,
+bool TTESSmartCut::reencodeFrames(QIODevice& outFile, int startFrame, int endFrame,
                                   int streamCopyStartFrame, int* adjustedStreamCopyStart,
                                   int* actualStartAU, int startDisplay,
                                   int endDisplay, bool tailMode)
@@ -2603,77 +2839,74 @@ bool TTESSmartCut::reencodeFrames(QFile& outFile, int startFrame, int endFrame,
     ReencodeContext ctx(outFile, startFrame, endFrame, streamCopyStartFrame,
                         adjustedStreamCopyStart, actualStartAU, startDisplay,
                         endDisplay, tailMode);
+    bool replayed = false;
+    if (replayBoundaryRun(ctx, replayed)) return replayed;
+    return runReencode(ctx);
+}
+
+// ----------------------------------------------------------------------------
+// Re-encode proper for a prepared context. Self-contained: decoder and
+// encoder are recreated, so the bytes depend only on the context and the
+// per-segment mode flags (mSpsUnification*, mHevcSeam*, mReorderDelay).
+// ----------------------------------------------------------------------------
+bool TTESSmartCut::runReencode(ReencodeContext& ctx)
+{
+    const int startFrame = ctx.startFrame;
     if (!computeDecodeRange(ctx)) return false;
 
     if (!resetDecoderForSegment(ctx)) return false;
 
-    if (!decodeFramesIntoList(ctx)) return false;
-
     // ---- Display-order to AU-index mapping (unified PAFF + non-PAFF) ----
-    selectFramesByDisplayOrder(ctx);
+    computeSelectionBounds(ctx);
 
-    // Preserve the submitted AU order for display tracking (framesToEncode
-    // is consumed and cleared by runEncodePass; packets may arrive later).
-    ctx.encodeAuOrder.reserve(ctx.framesToEncode.size());
-    for (AVFrame* f : ctx.framesToEncode)
-        ctx.encodeAuOrder.append(static_cast<int>(f->pts));
+    // A streaming run encodes while it decodes: its encode time is the
+    // whole run.
+    QElapsedTimer runTimer; runTimer.start();
+    QElapsedTimer encTimer;
+    const int reencodedAtEntry = mFramesReencoded;
+    auto accountEncode = qScopeGuard([&] {
+        mEncodeMsAcc     += ctx.streaming ? runTimer.elapsed()
+                          : encTimer.isValid() ? encTimer.elapsed() : 0;
+        mEncodeFramesAcc += mFramesReencoded - reencodedAtEntry;
+    });
 
-    // POC anchoring (non-PAFF unification): number the rewritten encoder POCs
-    // so the LAST encoded frame lands directly below the copy-start POC —
-    // base = anchor - 2*N (mod srcMax). The decoder's output order then runs
-    // monotonically across the EOS into the stream-copy, instead of ending
-    // ABOVE the copy-start POC and getting the first copied AU discarded as
-    // out-of-order.
-    if (mSpsUnification && mSpsUnificationPocAnchor >= 0 && mLog2MaxPocLsb > 0) {
-        int srcMaxPocLsb = 1 << mLog2MaxPocLsb;
-        int n = ctx.framesToEncode.size();
-        int base = (mSpsUnificationPocAnchor - 2 * n) % srcMaxPocLsb;
-        if (base < 0) base += srcMaxPocLsb;
-        mSpsUnificationPocBase = base;
-        if (TTSettings::instance()->logSmartCut()) {
-            qDebug() << "      POC anchoring: copy-start poc_lsb" << mSpsUnificationPocAnchor
-                     << "- encoding" << n << "frames from poc_lsb base" << base;
-        }
-    }
+    if (!decodeFramesIntoList(ctx)) return false;
 
-    // HEVC seam fix: anchor encoder POCs so the standins end directly below
-    // the RASL window: base = craPoc - numRasl - N (source lsb domain).
-    if (mHevcSeamFix) {
-        const int n = ctx.framesToEncode.size();
-        const int base = mHevcSeamCtx.craPoc - mHevcSeamCtx.numRasl - n;
-        if (base < 0) {
-            // P4 exact check failed (lsb wrap) -> trigger rollback before
-            // any packet is written.
-            mHevcSeamRewriteFailed = true;
-            mHevcSeamFailReason = QStringLiteral("POC window wraps lsb cycle");
-            return false;
-        }
-        mHevcSeamCtx.pocBase = base;
-        if (TTSettings::instance()->logSmartCut())
-            qDebug() << "      HEVC seam POC base:" << base
-                     << "(" << n << "standins )";
-    }
+    if (!ctx.streaming) {
+        selectFramesByDisplayOrder(ctx);
 
-    if (TTSettings::instance()->logSmartCut()) {
-        qDebug() << "      Selected" << ctx.framesToEncode.size() << "frames for encoding"
-                 << "(AU range" << startFrame << "-" << (ctx.streamCopyLimit - 1) << ")";
-    }
+        // Preserve the submitted AU order for display tracking (framesToEncode
+        // is consumed and cleared by runEncodePass; packets may arrive later).
+        ctx.encodeAuOrder.reserve(ctx.framesToEncode.size());
+        for (AVFrame* f : ctx.framesToEncode)
+            ctx.encodeAuOrder.append(static_cast<int>(f->pts));
 
-    // Re-encode frames
-    // Buffer the last encoder packet so we can patch poc_lsb before writing it,
-    // preventing POC domain mismatch at the re-encode→stream-copy transition.
+        if (!anchorEncoderPocs(ctx.framesToEncode.size())) return false;
 
-    QElapsedTimer encTimer; encTimer.start();
-    const int reencodedAtEntry = mFramesReencoded;
-    auto accountEncode = qScopeGuard([&] {
-        mEncodeMsAcc     += encTimer.elapsed();
-        mEncodeFramesAcc += mFramesReencoded - reencodedAtEntry;
-    });
+        if (TTSettings::instance()->logSmartCut()) {
+            qDebug() << "      Selected" << ctx.framesToEncode.size() << "frames for encoding"
+                     << "(AU range" << startFrame << "-" << (ctx.streamCopyLimit - 1) << ")";
+        }
 
-    if (!runEncodePass(ctx)) return false;
+        // Re-encode frames
+        // Buffer the last encoder packet so we can patch poc_lsb before writing it,
+        // preventing POC domain mismatch at the re-encode→stream-copy transition.
+        encTimer.start();
+        if (!runEncodePass(ctx)) return false;
+    }
 
     if (!flushEncoder(ctx)) return false;
 
+    if (ctx.streaming) {
+        if (TTSettings::instance()->logSmartCut()) {
+            qDebug() << "      Streamed" << ctx.framesSent << "of" << ctx.framesDecoded
+                     << "decoded frames to the encoder"
+                     << "(AU range" << startFrame << "-" << (ctx.streamCopyLimit - 1) << ")";
+        }
+        if (!anchorEncoderPocs(ctx.framesSent)) return false;
+        if (!releaseHeldPackets(ctx)) return false;
+    }
+
     applyPocDomainFix(ctx);
 
     if (!writePendingPacket(ctx)) return false;
@@ -2697,7 +2930,7 @@ bool TTESSmartCut::reencodeFrames(QFile& outFile, int startFrame, int endFrame,
 // this needs none of the head->stream-copy machinery (frameNumDelta / MMCO /
 // SPS-unification). startDisplay is unused (tailMode bounds by au>=tailStart).
 // ----------------------------------------------------------------------------
-bool TTESSmartCut::reencodeTail(QFile& outFile, int tailStartFrame, int endDisplay)
+bool TTESSmartCut::reencodeTail(QIODevice& outFile, int tailStartFrame, int endDisplay)
 {
     int endAU = mDisplayMap.displayToDecode(endDisplay);
     if (TTSettings::instance()->logSmartCut())
@@ -2708,6 +2941,311 @@ bool TTESSmartCut::reencodeTail(QFile& outFile, int tailStartFrame, int endDispl
                           /*startDisplay*/ -1, endDisplay, /*tailMode*/ true);
 }
 
+// ----------------------------------------------------------------------------
+// Parallel boundary re-encodes
+// ----------------------------------------------------------------------------
+// smartCutFrames is a strict in-order walk, but the only work in it that is
+// expensive AND independent of the output written so far are the re-encodes:
+// each run recreates the encoder and resets the decoder
+// (resetDecoderForSegment) and reads nothing but the source and the
+// per-segment mode. planBoundaryJobs predicts
+// the runs processSegment will ask for; helper engines render them ahead
+// into memory - a sliding window of them, refilled as the assembly consumes
+// runs - while the assembly copies the stream, and reencodeFrames
+// replays a finished run (bytes + every side effect on this engine) instead
+// of encoding. Frame-num bridging, EOS and parameter-set insertion stay in the
+// serial assembly, so the output is byte-identical to inline rendering.
+
+int TTESSmartCut::boundaryWorkerCount() const
+{
+    if (mBoundaryWorkerCount > 0) return mBoundaryWorkerCount;
+    return qBound(1, QThread::idealThreadCount() / 2, 4);
+}
+
+// Mirrors the branch structure of processSegment. Runs it cannot predict
+// (the HEVC RASL seam with its rollback) are simply not planned and render
+// inline.
+QVector<TTESSmartCut::ReencodeJob> TTESSmartCut::planBoundaryJobs(
+        const QList<TTCutSegmentInfo>& segments)
+{
+    QVector<ReencodeJob> jobs;
+    for (const TTCutSegmentInfo& seg : segments) {
+        if (seg.reencodeStartFrame >= 0 && seg.streamCopyStartFrame < 0) {
+            // Pure re-encode: display-bounded at both ends, no tail
+            ReencodeJob job;
+            job.startFrame   = seg.reencodeStartFrame;
+            job.endFrame     = seg.reencodeEndFrame;
+            job.startDisplay = seg.startDisplay;
+            job.endDisplay   = seg.endDisplay;
+            jobs.append(job);
+            continue;
+        }
+
+        if (seg.reencodeStartFrame >= 0) {
+            const TTAccessUnit scAu = mParser.accessUnitAt(seg.streamCopyStartFrame);
+            const bool hevcSeamCandidate = mParser.codecType() == NALU_CODEC_H265
+                                        && scAu.isKeyframe && !scAu.isIDR;
+            if (!hevcSeamCandidate) {
+                ReencodeJob job;
+                job.startFrame           = seg.reencodeStartFrame;
+                job.endFrame             = seg.reencodeEndFrame;
+                job.streamCopyStartFrame = seg.streamCopyStartFrame;
+                job.startDisplay         = seg.startDisplay;
+                int anchor = -1;
+                job.spsUnification = segmentNeedsSpsUnification(seg, &anchor, false);
+                if (job.spsUnification)
+                    job.pocAnchor = mParser.isPAFF() ? -1 : anchor;
+                jobs.append(job);
+            }
+        }
+
+        if (seg.needsReencodeAtEnd && seg.tailStartFrame >= 0) {
+            ReencodeJob job;
+            job.startFrame = seg.tailStartFrame;
+            job.endFrame   = mDisplayMap.displayToDecode(seg.endDisplay);
+            job.endDisplay = seg.endDisplay;
+            job.tailMode   = true;
+            jobs.append(job);
+        }
+    }
+    return jobs;
+}
+
+// Pool thread: render one planned run on a private helper engine (own parser
+// mapping, decoder and encoder) into memory.
+void TTESSmartCut::renderBoundaryRun(int runIndex, const TTNaluIndex& index,
+                                     const TTDisplayOrderMap& map, int reorderDelay,
+                                     int probedLog2PocLsb, int probedPocType)
+{
+    ReencodeRun result;
+    {
+        QMutexLocker lock(&mBoundaryMutex);
+        ReencodeRun& slot = mBoundaryRuns[runIndex];
+        if (slot.state != ReencodeRun::Pending)
+            return;                     // the assembly got there first
+        slot.state = ReencodeRun::Running;
+        result.job = slot.job;
+    }
+    const ReencodeJob& job = result.job;
+    result.reorderDelayIn = reorderDelay;
+
+    if (!mBoundaryCancel.load(std::memory_order_relaxed)) {
+        TTESSmartCut helper;
+        helper.mBoundaryOwner = this;
+        helper.setNaluIndex(index);
+        helper.setDisplayOrderMap(map);
+        helper.setPresetOverride(mPresetOverride);
+        if (helper.initialize(mInputFile, mFrameRate)) {
+            helper.mReorderDelay            = reorderDelay;
+            helper.mPocProbeDone            = true;
+            helper.mProbedEncoderLog2PocLsb = probedLog2PocLsb;
+            helper.mProbedEncoderPocType    = probedPocType;
+            helper.mOutputDisplayOrderValid = false;   // replayed by this engine
+            helper.mTotalFrames = helper.mCurrentSegment = helper.mTotalSegments = 0;
+            helper.mSpsUnification          = job.spsUnification;
+            helper.mSpsUnificationPocAnchor = job.pocAnchor;
+
+            QBuffer buffer(&result.data);
+            buffer.open(QIODevice::WriteOnly);
+            int adjusted = -1;
+            int actualStart = -1;
+            ReencodeContext ctx(buffer, job.startFrame, job.endFrame,
+                                job.streamCopyStartFrame, &adjusted, &actualStart,
+                                job.startDisplay, job.endDisplay, job.tailMode);
+            result.ok = helper.runReencode(ctx);
+            buffer.close();
+
+            result.adjustedStreamCopyStart = adjusted;
+            result.encodeAuOrder           = ctx.encodeAuOrder;
+            result.packets                 = ctx.packetsReceived;
+            result.reorderDelayOut         = helper.mReorderDelay;
+            result.encoderSpsParsed        = ctx.encoderSpsParsed;
+            result.encoderLog2MaxFrameNum  = helper.mEncoderLog2MaxFrameNum;
+            result.encoderLog2MaxPocLsb    = helper.mEncoderLog2MaxPocLsb;
+            result.encoderPocType          = helper.mEncoderPocType;
+            result.encoderFrameMbsOnly     = helper.mEncoderFrameMbsOnly;
+            result.pocBase                 = helper.mSpsUnificationPocBase;
+            result.encodeMs                = helper.mEncodeMsAcc;
+        }
+    }
+
+    {
+        QMutexLocker lock(&mBoundaryMutex);
+        result.state = ReencodeRun::Done;
+        if (runIndex < mBoundaryConsumed) {
+            // The assembly has passed this run: nothing will replay it
+            result.state = ReencodeRun::Claimed;
+            result.data.clear();
+            result.encodeAuOrder.clear();
+        }
+        mBoundaryRuns[runIndex] = result;
+    }
+    mBoundaryDone.wakeAll();
+}
+
+void TTESSmartCut::refillBoundaryWindow()
+{
+    if (!mBoundaryDispatch) return;
+
+    QVector<int> start;
+    {
+        QMutexLocker lock(&mBoundaryMutex);
+        int inFlight = 0;
+        for (int j = mBoundaryConsumed; j < mBoundaryNextRun; ++j)
+            if (mBoundaryRuns[j].state != ReencodeRun::Claimed)
+                ++inFlight;
+        while (inFlight < mBoundaryWindow && mBoundaryNextRun < mBoundaryRuns.size()) {
+            if (mBoundaryRuns[mBoundaryNextRun].state == ReencodeRun::Pending) {
+                start.append(mBoundaryNextRun);
+                ++inFlight;
+            }
+            ++mBoundaryNextRun;
+        }
+    }
+    for (int j : start)
+        mBoundaryDispatch(j);
+}
+
+bool TTESSmartCut::replayBoundaryRun(ReencodeContext& ctx, bool& ok)
+{
+    ok = false;
+    if (mBoundaryRuns.isEmpty() || mHevcSeamFix) return false;
+
+    ReencodeJob job;
+    job.startFrame           = ctx.startFrame;
+    job.endFrame             = ctx.endFrame;
+    job.streamCopyStartFrame = ctx.streamCopyStartFrame;
+    job.startDisplay         = ctx.startDisplay;
+    job.endDisplay           = ctx.endDisplay;
+    job.tailMode             = ctx.tailMode;
+    job.spsUnification       = mSpsUnification;
+    job.pocAnchor            = mSpsUnification ? mSpsUnificationPocAnchor : -1;
+
+    ReencodeRun run;
+    {
+        QMutexLocker lock(&mBoundaryMutex);
+        int i = 0;
+        while (i < mBoundaryRuns.size()
+               && (mBoundaryRuns[i].state == ReencodeRun::Claimed || !(mBoundaryRuns[i].job == job)))
+            ++i;
+        if (i == mBoundaryRuns.size()) return false;
+
+        // The assembly asks for the runs in plan order: the ones before i
+        // were skipped (their segment took another branch) and are dropped.
+        for (int k = mBoundaryConsumed; k < i; ++k) {
+            ReencodeRun& skipped = mBoundaryRuns[k];
+            if (skipped.state == ReencodeRun::Pending || skipped.state == ReencodeRun::Done) {
+                skipped.state = ReencodeRun::Claimed;
+                skipped.data.clear();
+                skipped.encodeAuOrder.clear();
+            }
+        }
+        mBoundaryConsumed = qMax(mBoundaryConsumed, i + 1);
+
+        ReencodeRun& slot = mBoundaryRuns[i];
+        if (slot.state == ReencodeRun::Pending) {
+            slot.state = ReencodeRun::Claimed;   // not started yet: cheaper inline
+            lock.unlock();
+            refillBoundaryWindow();
+            return false;
+        }
+        while (slot.state == ReencodeRun::Running)
+            mBoundaryDone.wait(&mBoundaryMutex);
+        run = slot;
+        slot.state = ReencodeRun::Claimed;
+        slot.data.clear();
+        slot.encodeAuOrder.clear();
+    }
+    refillBoundaryWindow();
+
+    // The run started from this engine's state at plan time; the assembly
+    // may since have learned a reorder delay the helper did not know.
+    const bool h264 = mParser.codecType() == NALU_CODEC_H264;
+    if (!run.ok || run.reorderDelayIn != mReorderDelay || (h264 && !run.encoderSpsParsed)) {
+        if (TTSettings::instance()->logSmartCut())
+            qDebug() << "      Prerendered run" << job.startFrame << "->" << job.endFrame
+                     << "not usable - re-encoding inline";
+        return false;
+    }
+
+    if (ctx.outFile.write(run.data) != run.data.size()) {
+        setError("Failed to write encoded data");
+        return true;
+    }
+    if (ctx.adjustedStreamCopyStart)
+        *ctx.adjustedStreamCopyStart = run.adjustedStreamCopyStart;
+
+    mReorderDelay = run.reorderDelayOut;
+    if (run.encoderSpsParsed) {
+        mEncoderLog2MaxFrameNum = run.encoderLog2MaxFrameNum;
+        mEncoderLog2MaxPocLsb   = run.encoderLog2MaxPocLsb;
+        mEncoderPocType         = run.encoderPocType;
+        mEncoderFrameMbsOnly    = run.encoderFrameMbsOnly;
+    }
+    if (mSpsUnification)
+        mSpsUnificationPocBase = run.pocBase;
+    for (int k = 0; k < run.packets; ++k)
+        trackEncodedPacketDisplay(run.encodeAuOrder, k);
+    mEncoderPacketsWritten += run.packets;
+    mFramesReencoded       += run.packets;
+    mEncodeMsAcc           += run.encodeMs;
+    mEncodeFramesAcc       += run.packets;
+
+    if (TTSettings::instance()->logSmartCut())
+        qDebug() << "      Re-encode taken from parallel run:" << run.packets << "packets,"
+                 << run.data.size() << "bytes";
+    if (mTotalFrames > 0) {
+        emitCutProgress(
+            tr("Processing segment %1/%2").arg(mCurrentSegment).arg(mTotalSegments), 0);
+    }
+    ok = true;
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// POC anchoring for a run of frameCount encoded frames. Must run before the
+// first encoder packet is transformed.
+// ----------------------------------------------------------------------------
+bool TTESSmartCut::anchorEncoderPocs(int frameCount)
+{
+    // POC anchoring (non-PAFF unification): number the rewritten encoder POCs
+    // so the LAST encoded frame lands directly below the copy-start POC —
+    // base = anchor - 2*N (mod srcMax). The decoder's output order then runs
+    // monotonically across the EOS into the stream-copy, instead of ending
+    // ABOVE the copy-start POC and getting the first copied AU discarded as
+    // out-of-order.
+    if (mSpsUnification && mSpsUnificationPocAnchor >= 0 && mLog2MaxPocLsb > 0) {
+        int srcMaxPocLsb = 1 << mLog2MaxPocLsb;
+        int n = frameCount;
+        int base = (mSpsUnificationPocAnchor - 2 * n) % srcMaxPocLsb;
+        if (base < 0) base += srcMaxPocLsb;
+        mSpsUnificationPocBase = base;
+        if (TTSettings::instance()->logSmartCut()) {
+            qDebug() << "      POC anchoring: copy-start poc_lsb" << mSpsUnificationPocAnchor
+                     << "- encoding" << n << "frames from poc_lsb base" << base;
+        }
+    }
+
+    // HEVC seam fix: anchor encoder POCs so the standins end directly below
+    // the RASL window: base = craPoc - numRasl - N (source lsb domain).
+    if (mHevcSeamFix) {
+        const int n = frameCount;
+        const int base = mHevcSeamCtx.craPoc - mHevcSeamCtx.numRasl - n;
+        if (base < 0) {
+            // P4 exact check failed (lsb wrap) -> trigger rollback before
+            // any packet is written.
+            mHevcSeamRewriteFailed = true;
+            mHevcSeamFailReason = QStringLiteral("POC window wraps lsb cycle");
+            return false;
+        }
+        mHevcSeamCtx.pocBase = base;
+        if (TTSettings::instance()->logSmartCut())
+            qDebug() << "      HEVC seam POC base:" << base
+                     << "(" << n << "standins )";
+    }
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // Compute decode range: decodeStart (with runway extension if too close to
 // startFrame) and decodeEnd (with pre-extension to next keyframe after
@@ -2797,13 +3335,15 @@ bool TTESSmartCut::computeDecodeRange(ReencodeContext& ctx)
 }
 
 // ----------------------------------------------------------------------------
-// Reset decoder (flush after EOF state) and recreate encoder. Called once
-// per segment because libx264's lookahead thread can't be restarted after
-// a previous segment's flush.
+// Recreate decoder and encoder. Called once per re-encode run because
+// libx264's lookahead thread can't be restarted after a previous segment's
+// flush.
 // ----------------------------------------------------------------------------
 bool TTESSmartCut::resetDecoderForSegment(ReencodeContext& /*ctx*/)
 {
-    // Setup decoder if needed
+    // Helper engines render exactly one run and always start from a fresh
+    // decoder (see renderBoundaryRun); the assembly engine keeps its
+    // decoder across segments and only resets its state.
     if (!mDecoder) {
         if (!setupDecoder()) {
             return false;
@@ -2874,9 +3414,9 @@ bool TTESSmartCut::ensureEncoderInitialized(ReencodeContext& ctx, AVFrame* probe
 }
 
 // ----------------------------------------------------------------------------
-// Decode all frames in [ctx.decodeStart, ctx.decodeEnd] into
-// ctx.allDecodedFrames. Triggers one-shot encoder init on the first
-// received frame. Tracks mReorderDelay from decoder->has_b_frames.
+// Decode all frames in [ctx.decodeStart, ctx.decodeEnd] and hand each to
+// takeDecodedFrame (collected in ctx.allDecodedFrames, or streamed to the
+// encoder). Tracks mReorderDelay from decoder->has_b_frames.
 // Pre-condition: decoder is reset and ready (resetDecoderForSegment ran).
 // ----------------------------------------------------------------------------
 bool TTESSmartCut::decodeFramesIntoList(ReencodeContext& ctx)
@@ -2884,7 +3424,8 @@ bool TTESSmartCut::decodeFramesIntoList(ReencodeContext& ctx)
     // Decode ALL frames from keyframe to endFrame using correct FFmpeg API pattern.
     // The decoder outputs frames in DISPLAY ORDER (reordered by PTS),
     // but we feed AUs in DECODE ORDER (file order). With B-frames these differ.
-    // We collect ALL decoded frames first, then select by display position.
+    // Selection is by display position: over the collected window, or per
+    // frame as it arrives when the run streams.
     //
     // Important: avcodec_receive_frame() can return multiple frames per send_packet,
     // and decodeFrame() only retrieves one. So we call avcodec_receive_frame() in a
@@ -2901,12 +3442,7 @@ bool TTESSmartCut::decodeFramesIntoList(ReencodeContext& ctx)
                 break;  // EAGAIN (need more input) or EOF
             }
 
-            if (!ensureEncoderInitialized(ctx, frame)) {
-                av_frame_free(&frame);
-                return false;
-            }
-
-            ctx.allDecodedFrames.append(frame);
+            if (!takeDecodedFrame(ctx, frame)) return false;
 
             // Track B-frame reorder delay — the decoder updates has_b_frames
             // dynamically as it encounters B-frames. Source SPS may lack
@@ -2916,7 +3452,7 @@ bool TTESSmartCut::decodeFramesIntoList(ReencodeContext& ctx)
                 mReorderDelay = mDecoder->has_b_frames;
                 if (TTSettings::instance()->logSmartCut()) {
                     qDebug() << "      Decoder has_b_frames:" << mReorderDelay
-                             << "(detected after" << ctx.allDecodedFrames.size() << "frames)";
+                             << "(detected after" << ctx.framesDecoded << "frames)";
                 }
             }
         }
@@ -2987,18 +3523,13 @@ bool TTESSmartCut::decodeFramesIntoList(ReencodeContext& ctx)
             break;
         }
 
-        // Initialize encoder if needed (edge case: all frames come from flush)
-        if (!ensureEncoderInitialized(ctx, frame)) {
-            av_frame_free(&frame);
-            return false;
-        }
-
-        ctx.allDecodedFrames.append(frame);
+        // Encoder init may happen here (edge case: all frames come from flush)
+        if (!takeDecodedFrame(ctx, frame)) return false;
     }
 
-    int lostFrames = (ctx.decodeEnd - ctx.decodeStart + 1) - ctx.allDecodedFrames.size();
+    int lostFrames = (ctx.decodeEnd - ctx.decodeStart + 1) - ctx.framesDecoded;
     if (TTSettings::instance()->logSmartCut()) {
-        qDebug() << "      Decoded" << ctx.allDecodedFrames.size() << "frames from"
+        qDebug() << "      Decoded" << ctx.framesDecoded << "frames from"
                  << (ctx.decodeEnd - ctx.decodeStart + 1) << "input AUs"
                  << "(" << lostFrames << "lost to decoder delay)";
     }
@@ -3006,10 +3537,69 @@ bool TTESSmartCut::decodeFramesIntoList(ReencodeContext& ctx)
     return true;
 }
 
+// ----------------------------------------------------------------------------
+// One decoded frame. The first frame of a run fixes its mode: the decode
+// window (every AU of it decodes to one frame of this size) either fits the
+// frame budget and is collected for selectFramesByDisplayOrder, or it
+// streams - the frame is judged by keepFrameForEncode right here (the
+// decoder already delivers display order, the order the collected selection
+// submits in) and encoded or freed. Both modes send the same frames in the
+// same order, so the encoder output is the same.
+// ----------------------------------------------------------------------------
+bool TTESSmartCut::takeDecodedFrame(ReencodeContext& ctx, AVFrame* frame)
+{
+    if (!ensureEncoderInitialized(ctx, frame)) {
+        av_frame_free(&frame);
+        return false;
+    }
+
+    if (ctx.framesDecoded++ == 0) {
+        const qint64 budget = reencodeFrameBudget();
+        const int frameBytes = av_image_get_buffer_size(
+            static_cast<AVPixelFormat>(frame->format), frame->width, frame->height, 1);
+        const qint64 windowBytes = qint64(qMax(frameBytes, 0))
+                                 * (ctx.decodeEnd - ctx.decodeStart + 1);
+        ctx.streaming = budget >= 0 && windowBytes > budget;
+        ctx.holdPackets = ctx.streaming;
+        if (ctx.streaming && TTSettings::instance()->logSmartCut())
+            qDebug() << "      Streaming re-encode: window of"
+                     << (ctx.decodeEnd - ctx.decodeStart + 1) << "frames needs"
+                     << windowBytes / (1024 * 1024) << "MiB, budget"
+                     << budget / (1024 * 1024) << "MiB";
+    }
+
+    if (!ctx.streaming) {
+        ctx.allDecodedFrames.append(frame);
+        return true;
+    }
+
+    const int au = static_cast<int>(frame->pts);
+    bool ok = true;
+    if (keepFrameForEncode(ctx, au)) {
+        ctx.encodeAuOrder.append(au);
+        ok = encodeFrame(ctx, frame);
+    }
+    av_frame_free(&frame);
+    return ok;
+}
+
+// Share of mReencodeMemoryLimit for one run: the assembly and every
+// boundary worker can each be inside one. < 0 = no limit.
+qint64 TTESSmartCut::reencodeFrameBudget() const
+{
+    if (mBoundaryOwner)
+        return mBoundaryOwner->reencodeFrameBudget();
+    if (mReencodeMemoryLimit < 0) return -1;
+    const int workers = boundaryWorkerCount();
+    return mReencodeMemoryLimit / (workers > 1 ? workers + 1 : 1);
+}
+
 // ----------------------------------------------------------------------------
 // Frame selection for re-encode, display-order based (PAFF and non-PAFF).
 //
-// allDecodedFrames is display-ordered; each frame's ->pts carries its AU index.
+// Decoded frames arrive display-ordered; each frame's ->pts carries its AU
+// index. computeSelectionBounds fixes the stream-copy boundary before the
+// decode, keepFrameForEncode judges single frames (collected or streamed).
 // The kept set is defined in DISPLAY space (Direction A): every frame whose
 // display position >= ctx.startDisplay, up to the stream-copy AU boundary. The
 // display predicate is exact even where the kept set is NOT contiguous in AU
@@ -3017,7 +3607,7 @@ bool TTESSmartCut::decodeFramesIntoList(ReencodeContext& ctx)
 // 36385... ). Open-GOP B-frames before the cut-in are excluded automatically
 // (their display position < startDisplay).
 // ----------------------------------------------------------------------------
-void TTESSmartCut::selectFramesByDisplayOrder(ReencodeContext& ctx)
+void TTESSmartCut::computeSelectionBounds(ReencodeContext& ctx)
 {
     if (ctx.tailMode) {
         // Tail re-encode: start at the tail GOP keyframe (ctx.startFrame) and
@@ -3058,24 +3648,30 @@ void TTESSmartCut::selectFramesByDisplayOrder(ReencodeContext& ctx)
             }
         }
     }
+}
 
-    // Selection: mode-aware predicate (head / pure-re-encode / tail).
+// Mode-aware predicate (head / pure-re-encode / tail)
+bool TTESSmartCut::keepFrameForEncode(const ReencodeContext& ctx, int au) const
+{
+    const int disp = mDisplayMap.decodeToDisplay(au);
+    if (ctx.tailMode) {
+        // Tail: AU lower bound (tail GOP start), display upper bound.
+        return (au >= ctx.startFrame) && (disp <= ctx.endDisplay);
+    }
+    if (ctx.streamCopyStartFrame < 0 && ctx.endDisplay >= 0) {
+        // Pure re-encode (short segment): both display bounds.
+        return (disp >= ctx.startDisplay) && (disp <= ctx.endDisplay);
+    }
+    // Head re-encode (mixed): display lower bound + AU stream-copy bound.
+    return (disp >= ctx.startDisplay) && (au < ctx.streamCopyLimit);
+}
+
+void TTESSmartCut::selectFramesByDisplayOrder(ReencodeContext& ctx)
+{
     for (int i = 0; i < ctx.allDecodedFrames.size(); ++i) {
-        const int au   = static_cast<int>(ctx.allDecodedFrames[i]->pts);
-        const int disp = mDisplayMap.decodeToDisplay(au);
-        bool keep;
-        if (ctx.tailMode) {
-            // Tail: AU lower bound (tail GOP start), display upper bound.
-            keep = (au >= ctx.startFrame) && (disp <= ctx.endDisplay);
-        } else if (ctx.streamCopyStartFrame < 0 && ctx.endDisplay >= 0) {
-            // Pure re-encode (short segment): both display bounds.
-            keep = (disp >= ctx.startDisplay) && (disp <= ctx.endDisplay);
-        } else {
-            // Head re-encode (mixed): display lower bound + AU stream-copy bound.
-            keep = (disp >= ctx.startDisplay) && (au < ctx.streamCopyLimit);
-        }
-        if (keep) ctx.framesToEncode.append(ctx.allDecodedFrames[i]);
-        else      av_frame_free(&ctx.allDecodedFrames[i]);
+        const int au = static_cast<int>(ctx.allDecodedFrames[i]->pts);
+        if (keepFrameForEncode(ctx, au)) ctx.framesToEncode.append(ctx.allDecodedFrames[i]);
+        else                             av_frame_free(&ctx.allDecodedFrames[i]);
     }
     ctx.allDecodedFrames.clear();
 
@@ -3800,35 +4396,37 @@ bool TTESSmartCut::bufferAndWriteEncoderPacket(ReencodeContext& ctx,
     ctx.pendingPacket = transformedData;
 
     // Display-order tracking: with bf=0 the encoder emits packets 1:1 in
-    // submission order, so packet k belongs to ctx.framesToEncode[k] (whose
-    // AVFrame::pts carries the source AU index). The pending-packet buffer
+    // submission order, so packet k belongs to the k-th submitted frame,
+    // whose source AU is ctx.encodeAuOrder[k]. The pending-packet buffer
     // only delays writes by one packet - the write ORDER stays FIFO, so
     // recording at receive time matches write order.
-    if (mOutputDisplayOrderValid) {
-        if (ctx.packetsReceived < ctx.encodeAuOrder.size()) {
-            const int au = ctx.encodeAuOrder[ctx.packetsReceived];
-            appendOutputDisplay(mDisplayMap.decodeToDisplay(au), au);
-        } else {
-            // Encoder produced more packets than frames submitted - cannot map.
-            mOutputDisplayOrderValid = false;
-            mOutputDisplayOrder.clear();
-            TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-                "output display-order tracking invalidated (encoder packet "
-                "count exceeds submitted frames)");
-        }
-    }
+    trackEncodedPacketDisplay(ctx.encodeAuOrder, ctx.packetsReceived);
 
     ctx.packetsReceived++;
     mEncoderPacketsWritten++;
     return true;
 }
 
+void TTESSmartCut::trackEncodedPacketDisplay(const QVector<int>& auOrder, int packetIndex)
+{
+    if (!mOutputDisplayOrderValid) return;
+    if (packetIndex < auOrder.size()) {
+        const int au = auOrder[packetIndex];
+        appendOutputDisplay(mDisplayMap.decodeToDisplay(au), au);
+    } else {
+        // Encoder produced more packets than frames submitted - cannot map.
+        mOutputDisplayOrderValid = false;
+        mOutputDisplayOrder.clear();
+        mSinkRanks.clear();
+        TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+            "output display-order tracking invalidated (encoder packet "
+            "count exceeds submitted frames)");
+    }
+}
+
 // ----------------------------------------------------------------------------
-// Main encode pass: iterate ctx.framesToEncode, send to encoder, drain
-// output packets. Each output packet flows through parseEncoderSpsFromPacket
-// (one-shot) -> transformEncoderPacket -> bufferAndWriteEncoderPacket.
-// Frees each input frame after submission to encoder. Marks the first frame
-// as a keyframe.
+// Main encode pass: iterate ctx.framesToEncode, send each through
+// encodeFrame. Frees each input frame after submission to encoder.
 // ----------------------------------------------------------------------------
 bool TTESSmartCut::runEncodePass(ReencodeContext& ctx)
 {
@@ -3847,86 +4445,117 @@ bool TTESSmartCut::runEncodePass(ReencodeContext& ctx)
     for (int fi = 0; fi < ctx.framesToEncode.size(); ++fi) {
         AVFrame*& frame = ctx.framesToEncode[fi];
 
-        // Consistent with the other early returns in this loop below (none
-        // of which free `frame` either): leave ownership of the current and
-        // all not-yet-consumed entries to ~ReencodeContext. That is now safe
-        // for every entry, not just this one, because of the null-after-free
-        // pattern above.
-        if (checkAbort()) return false;
+        // encodeFrame never frees: on failure the current and all
+        // not-yet-consumed entries stay with ~ReencodeContext. That is safe
+        // for every entry because of the null-after-free pattern above.
+        if (!encodeFrame(ctx, frame)) return false;
+        av_frame_free(&frame);
+    }
+    ctx.framesToEncode.clear();
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Send one frame, drain the packets it releases. Marks the first frame of
+// the run as a keyframe.
+// ----------------------------------------------------------------------------
+bool TTESSmartCut::encodeFrame(ReencodeContext& ctx, AVFrame* frame)
+{
+    if (checkAbort()) return false;
 
-        if (ctx.firstFrame) {
-            frame->pict_type = AV_PICTURE_TYPE_I;
+    if (ctx.firstFrame) {
+        frame->pict_type = AV_PICTURE_TYPE_I;
 #if LIBAVUTIL_VERSION_INT < AV_VERSION_INT(58, 0, 0)
-            frame->key_frame = 1;
+        frame->key_frame = 1;
 #endif
-            ctx.firstFrame = false;
-        } else {
-            frame->pict_type = AV_PICTURE_TYPE_NONE;
-        }
+        ctx.firstFrame = false;
+    } else {
+        frame->pict_type = AV_PICTURE_TYPE_NONE;
+    }
 
-        frame->pts = ctx.framesSent;
+    frame->pts = ctx.framesSent;
 
-        int ret = avcodec_send_frame(mEncoder, frame);
-        if (ret < 0 && ret != AVERROR(EAGAIN)) {
-            QString errStr = avErrStr(ret);
+    int ret = avcodec_send_frame(mEncoder, frame);
+    if (ret < 0 && ret != AVERROR(EAGAIN)) {
+        QString errStr = avErrStr(ret);
+        TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+            QString("avcodec_send_frame failed: %1").arg(errStr));
+        setError(QString("Encoding failed: %1").arg(errStr));
+        return false;
+    }
+    ctx.framesSent++;
+
+    // Progress inside the encode pass: without this a whole-GOP encode
+    // is silent and the dialog looks frozen (observed stall 2026-08-09).
+    if (ctx.framesSent % 10 == 0) {
+        emitCutProgress(
+            tr("Encoding segment %1/%2...").arg(mCurrentSegment).arg(mTotalSegments),
+            ctx.framesSent);
+    }
+
+    AVPacket* packet = av_packet_alloc();
+    if (!packet) {
+        // Same reasoning as in decodeFramesIntoList: a break truncated
+        // the encode pass silently after part of the frame list was
+        // already processed, and the function still returned true.
+        setError(QString("av_packet_alloc failed"));
+        return false;
+    }
+    while (true) {
+        ret = avcodec_receive_packet(mEncoder, packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+            break;
+        if (ret < 0) {
             TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-                QString("avcodec_send_frame failed: %1").arg(errStr));
-            setError(QString("Encoding failed: %1").arg(errStr));
+                QString("avcodec_receive_packet failed: %1").arg(avErrStr(ret)));
+            av_packet_free(&packet);
             return false;
         }
-        ctx.framesSent++;
-
-        // Progress inside the encode pass: without this a whole-GOP encode
-        // is silent and the dialog looks frozen (observed stall 2026-08-09).
-        if (ctx.framesSent % 10 == 0) {
-            emitCutProgress(
-                tr("Encoding segment %1/%2...").arg(mCurrentSegment).arg(mTotalSegments),
-                ctx.framesSent);
-        }
-
-        AVPacket* packet = av_packet_alloc();
-        if (!packet) {
-            // Same reasoning as in decodeFramesIntoList: a break truncated
-            // the encode pass silently after part of the frame list was
-            // already processed, and the function still returned true.
-            setError(QString("av_packet_alloc failed"));
+        QByteArray rawData(reinterpret_cast<char*>(packet->data), packet->size);
+        if (!handleEncoderPacket(ctx, rawData)) {
+            av_packet_free(&packet);
             return false;
         }
-        while (true) {
-            ret = avcodec_receive_packet(mEncoder, packet);
-            if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
-                break;
-            if (ret < 0) {
-                TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-                    QString("avcodec_receive_packet failed: %1").arg(avErrStr(ret)));
-                av_packet_free(&packet);
-                return false;
-            }
-            QByteArray rawData(reinterpret_cast<char*>(packet->data), packet->size);
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    return true;
+}
 
-            parseEncoderSpsFromPacket(ctx, rawData);
-            QByteArray transformed = transformEncoderPacket(ctx, rawData);
-            if (transformed.isEmpty() && mHevcSeamRewriteFailed) {
-                av_packet_free(&packet);
-                return false;    // seam rewrite failed -> rollback in caller
-            }
-            if (!bufferAndWriteEncoderPacket(ctx, transformed)) {
-                av_packet_free(&packet);
-                return false;
-            }
-            av_packet_unref(packet);
-        }
-        av_packet_free(&packet);
-        av_frame_free(&frame);
+// ----------------------------------------------------------------------------
+// Encoder packet → output. Every packet flows through parseEncoderSpsFromPacket
+// (one-shot) -> transformEncoderPacket -> bufferAndWriteEncoderPacket, in
+// receive order. A streaming run holds the raw packets instead: the POC base
+// depends on the run's frame count, and the SPS reorder patch on the final
+// mReorderDelay, neither of which is known while frames are still decoding.
+// ----------------------------------------------------------------------------
+bool TTESSmartCut::handleEncoderPacket(ReencodeContext& ctx, const QByteArray& rawData)
+{
+    if (ctx.holdPackets) {
+        ctx.heldPackets.append(rawData);
+        return true;
+    }
+    parseEncoderSpsFromPacket(ctx, rawData);
+    QByteArray transformed = transformEncoderPacket(ctx, rawData);
+    if (transformed.isEmpty() && mHevcSeamRewriteFailed)
+        return false;    // seam rewrite failed -> rollback in caller
+    return bufferAndWriteEncoderPacket(ctx, transformed);
+}
+
+bool TTESSmartCut::releaseHeldPackets(ReencodeContext& ctx)
+{
+    ctx.holdPackets = false;
+    const QList<QByteArray> held = std::move(ctx.heldPackets);
+    ctx.heldPackets.clear();
+    for (const QByteArray& rawData : held) {
+        if (!handleEncoderPacket(ctx, rawData)) return false;
     }
-    ctx.framesToEncode.clear();
     return true;
 }
 
 // ----------------------------------------------------------------------------
-// Encoder flush: send NULL frame, drain remaining packets. Each packet
-// flows through the same parseEncoderSpsFromPacket → transformEncoderPacket
-// → bufferAndWriteEncoderPacket chain as runEncodePass.
+// Encoder flush: send NULL frame, drain remaining packets through
+// handleEncoderPacket like encodeFrame.
 // ----------------------------------------------------------------------------
 bool TTESSmartCut::flushEncoder(ReencodeContext& ctx)
 {
@@ -3945,14 +4574,7 @@ bool TTESSmartCut::flushEncoder(ReencodeContext& ctx)
             break;
         }
         QByteArray rawData(reinterpret_cast<char*>(packet->data), packet->size);
-
-        parseEncoderSpsFromPacket(ctx, rawData);
-        QByteArray transformed = transformEncoderPacket(ctx, rawData);
-        if (transformed.isEmpty() && mHevcSeamRewriteFailed) {
-            av_packet_free(&packet);
-            return false;    // seam rewrite failed -> rollback in caller
-        }
-        if (!bufferAndWriteEncoderPacket(ctx, transformed)) {
+        if (!handleEncoderPacket(ctx, rawData)) {
             av_packet_free(&packet);
             return false;
         }
@@ -5175,7 +5797,7 @@ int TTESSmartCut::bridgeFrameNum(int scStartAU, int encLog2Fn)
 // (H.264 type 11, H.265 type 37). Single home for the codec dispatch that
 // previously existed open-coded at four emit sites.
 // ----------------------------------------------------------------------------
-void TTESSmartCut::writeEos(QFile& outFile) const
+void TTESSmartCut::writeEos(QIODevice& outFile) const
 {
     if (mParser.codecType() == NALU_CODEC_H265)
         outFile.write(kEosNalH265, sizeof(kEosNalH265));
@@ -5188,7 +5810,7 @@ void TTESSmartCut::writeEos(QFile& outFile) const
 // If patchReorderFrames > 0, patches H.264 SPS to signal max_num_reorder_frames
 // to prevent backward timestamps at re-encode/stream-copy boundaries.
 // ----------------------------------------------------------------------------
-bool TTESSmartCut::writeParameterSets(QFile& outFile, int patchReorderFrames)
+bool TTESSmartCut::writeParameterSets(QIODevice& outFile, int patchReorderFrames)
 {
     // For H.265, write VPS first
     if (mParser.codecType() == NALU_CODEC_H265) {
@@ -5253,7 +5875,10 @@ void TTESSmartCut::setError(const QString& error)
 // ----------------------------------------------------------------------------
 bool TTESSmartCut::checkAbort()
 {
-    if (!mAbortRequested.load(std::memory_order_relaxed)) return false;
+    const bool ownerStop = mBoundaryOwner
+        && (mBoundaryOwner->mAbortRequested.load(std::memory_order_relaxed)
+            || mBoundaryOwner->mBoundaryCancel.load(std::memory_order_relaxed));
+    if (!ownerStop && !mAbortRequested.load(std::memory_order_relaxed)) return false;
     mWasAborted = true;
     // Deliberately not setError(): a user cancel is not a failure and must
     // not read as one in the log (setError() logs at ERROR level via
@@ -22,12 +22,19 @@
 #include <QPair>
 #include <QFile>
 #include <QObject>
+#include <QIODevice>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
 #include <atomic>
+#include <functional>
 
 #include "../avstream/ttnaluparser.h"
 #include "../avstream/ttdisplayordermap.h"
 #include "tthevcseam.h"
 
+class TTESPacketSink;
+
 // Forward declarations for libav types
 struct AVFormatContext;
 struct AVCodecContext;
@@ -80,6 +87,32 @@ public:
     // smartCutFrames uses it instead of building its own from the input file.
     void setDisplayOrderMap(const TTDisplayOrderMap& map) { mDisplayMap = map; }
 
+    // Inject the NAL/AU index the video stream built while indexing
+    // (TTFFmpegWrapper::naluIndex). When it matches the file, initialize()
+    // adopts it instead of parsing the ES again.
+    void setNaluIndex(const TTNaluIndex& index) { mNaluIndex = index; }
+
+    // Worker count for the boundary re-encodes of smartCutFrames (head and
+    // tail GOPs of every segment run concurrently on helper engines and are
+    // spliced in segment order). 0 = auto (qBound(1, idealThreadCount/2, 4)),
+    // 1 = render every boundary inline. The output is byte-identical for
+    // any value.
+    void setBoundaryWorkerCount(int count) { mBoundaryWorkerCount = count; }
+
+    // Peak memory for the decoded frames of the boundary re-encodes, split
+    // evenly between the runs that can be in flight at once. A run whose
+    // decode window would not fit streams: each decoded frame is selected,
+    // encoded and released on the spot instead of the whole window being
+    // collected first. Output bytes are the same either way. 0 = always
+    // stream, < 0 = never. Defaults to TTSettings::reencodeMemoryLimitMB().
+    void setReencodeMemoryLimit(qint64 bytes) { mReencodeMemoryLimit = bytes; }
+
+    // Hand the output to a packet sink instead of a file: smartCutFrames
+    // then writes no ES (outputFile only names the cut in the log) and
+    // passes every output frame with its display rank to sink, in write
+    // order. nullptr = write the ES file. Not owned.
+    void setPacketSink(TTESPacketSink* sink) { mPacketSink = sink; }
+
     // Initialize with ES file
     bool initialize(const QString& esFile, double frameRate = -1);
     void cleanup();
@@ -115,6 +148,12 @@ public:
     // so actual start frames can differ from the requested cut-in frames.
     QList<QPair<int, int>> actualOutputFrameRanges() const { return mActualOutputRanges; }
 
+    // The output frame ranges smartCutFrames(cutFrames) will record, known
+    // before the cut (the segment plan); empty when the display-order map
+    // is unavailable. For work that must be done before the video, such as
+    // the audio of a stream mux.
+    QList<QPair<int, int>> plannedOutputFrameRanges(const QList<QPair<int, int>>& cutFrames);
+
     // Display position (frame units, output-local) of each mux packet in the
     // written ES, in write order. Empty when tracking was invalidated (any
     // anomaly) — callers then keep the muxer's legacy linear PTS behavior.
@@ -140,6 +179,50 @@ signals:
 private:
     struct ReencodeContext;  // forward; defined in ttessmartcut.cpp
 
+    // One boundary re-encode (head, pure or tail) as reencodeFrames sees it.
+    // Two jobs with equal fields produce the same bytes: every run starts
+    // from a fresh encoder and a fresh (helper) or flushed (assembly)
+    // decoder.
+    struct ReencodeJob {
+        int  startFrame = -1;
+        int  endFrame = -1;
+        int  streamCopyStartFrame = -1;
+        int  startDisplay = -1;
+        int  endDisplay = -1;
+        bool tailMode = false;
+        bool spsUnification = false;
+        int  pocAnchor = -1;     // mSpsUnificationPocAnchor, -1 without unification
+
+        bool operator==(const ReencodeJob& o) const {
+            return startFrame == o.startFrame && endFrame == o.endFrame
+                && streamCopyStartFrame == o.streamCopyStartFrame
+                && startDisplay == o.startDisplay && endDisplay == o.endDisplay
+                && tailMode == o.tailMode && spsUnification == o.spsUnification
+                && pocAnchor == o.pocAnchor;
+        }
+    };
+
+    // Result of a job rendered on a helper engine, replayed by reencodeFrames
+    struct ReencodeRun {
+        enum State { Pending, Running, Done, Claimed };
+        ReencodeJob job;
+        State  state = Pending;
+        bool   ok = false;
+        QByteArray data;                  // bytes reencodeFrames would have written
+        int    adjustedStreamCopyStart = -1;
+        QVector<int> encodeAuOrder;       // ctx.encodeAuOrder
+        int    packets = 0;               // ctx.packetsReceived
+        int    reorderDelayIn = 0;        // mReorderDelay before / after the run
+        int    reorderDelayOut = 0;
+        bool   encoderSpsParsed = false;
+        int    encoderLog2MaxFrameNum = 0;
+        int    encoderLog2MaxPocLsb = 0;
+        int    encoderPocType = -1;
+        bool   encoderFrameMbsOnly = true;
+        int    pocBase = -1;              // mSpsUnificationPocBase
+        qint64 encodeMs = 0;
+    };
+
     // State
     bool mIsInitialized;
     int mPresetOverride;     // -1 = use TTCut settings, 0-8 = override preset
@@ -148,6 +231,7 @@ private:
 
     // NAL parser
     TTNaluParser mParser;
+    TTNaluIndex mNaluIndex;   // injected via setNaluIndex, may be empty
 
     // Display-order <-> decode-order (AU) map. Injected via setDisplayOrderMap
     // (Task 6) or built standalone from mInputFile in smartCutFrames.
@@ -192,7 +276,7 @@ private:
     // SPS Unification mode: rewrite encoder output to match source SPS
     // Set by processSegment() for PAFF H.264, checked in reencodeFrames()
     bool mSpsUnification;
-    QFile* mSpsUnificationOutFile;  // output file for encoder PPS injection
+    QIODevice* mSpsUnificationOutFile;  // output device for encoder PPS injection
     // poc_lsb of the stream-copy start AU when unification runs for a
     // non-bridgeable POC seam; -1 otherwise (PAFF keeps the legacy linear
     // POC numbering for byte-identical output).
@@ -226,6 +310,16 @@ private:
     bool mOutputDisplayOrderValid;
     void appendOutputDisplay(int mapDisplayIndex, int srcAuIndex);
 
+    // Packet-sink output: ranks are needed while writing, before the global
+    // sort of outputDisplayOrder() can run. Each entry is the rank the frame
+    // takes if its segment's output is gap-free from the segment's cut-in
+    // (mSinkRankBase = frames before the segment, mSinkDisplayBase = its
+    // startDisplay); smartCutFrames fails unless they match at the end.
+    TTESPacketSink* mPacketSink;
+    QVector<int> mSinkRanks;
+    int mSinkRankBase;
+    int mSinkDisplayBase;
+
     // Encoder PTS counter (reset per segment in setupEncoder)
     int64_t mEncoderPts;
 
@@ -272,6 +366,25 @@ private:
     std::atomic<bool> mAbortRequested { false };
     bool mWasAborted = false;   // output, not input; cleared at smartCutFrames() entry
 
+    // --- Parallel boundary re-encodes (see setBoundaryWorkerCount) ---
+    int mBoundaryWorkerCount;
+    qint64 mReencodeMemoryLimit;
+    QVector<ReencodeRun> mBoundaryRuns;       // planned jobs of the current cut
+    QMutex mBoundaryMutex;                    // guards ReencodeRun::state/results
+    // Sliding window over mBoundaryRuns: at most mBoundaryWindow runs are
+    // started and not yet claimed by the assembly, so the rendered packets
+    // held in memory stay bounded however long the cut list is. Runs below
+    // mBoundaryConsumed were passed by the assembly and are dropped.
+    std::function<void(int)> mBoundaryDispatch;   // starts run j on the cut's pool
+    int mBoundaryWindow = 0;
+    int mBoundaryNextRun = 0;
+    int mBoundaryConsumed = 0;
+    QWaitCondition mBoundaryDone;
+    std::atomic<bool> mBoundaryCancel { false };
+    // Set on helper engines: their checkAbort() also honours the owning
+    // engine's abort request and its end-of-cut cancel.
+    const TTESSmartCut* mBoundaryOwner = nullptr;
+
     // Actual output frame ranges (start AU may differ from requested due to B-frame reorder)
     QList<QPair<int, int>> mActualOutputRanges;
 
@@ -294,13 +407,32 @@ private:
     // Process a single segment
     // frameNumDelta: H.264 frame_num offset for inter-segment continuity
     // actualStartAU: output — actual first AU written (may differ from segment.startFrame)
-    bool processSegment(QFile& outFile, const TTCutSegmentInfo& segment,
+    bool processSegment(QIODevice& outFile, const TTCutSegmentInfo& segment,
                         int& frameNumDelta, int* actualStartAU = nullptr);
 
+    // H.264 seam classification of a mixed segment (PAFF, POC domain not
+    // bridgeable, non-IDR copy-start with leading pictures). *pocAnchor gets
+    // the source poc_lsb the rewritten encoder POCs are anchored to.
+    bool segmentNeedsSpsUnification(const TTCutSegmentInfo& segment, int* pocAnchor,
+                                    bool log);
+
+    // Parallel boundary re-encodes: plan the jobs processSegment will issue,
+    // render them on helper engines, and hand results to reencodeFrames.
+    QVector<ReencodeJob> planBoundaryJobs(const QList<TTCutSegmentInfo>& segments);
+    int  boundaryWorkerCount() const;
+    void renderBoundaryRun(int runIndex, const TTNaluIndex& index,
+                           const TTDisplayOrderMap& map, int reorderDelay,
+                           int probedLog2PocLsb, int probedPocType);
+    // Start runs until the window is full (assembly thread only)
+    void refillBoundaryWindow();
+    // True when a rendered run for ctx was consumed (ok = its bytes were
+    // written); false = no usable run, re-encode inline.
+    bool replayBoundaryRun(ReencodeContext& ctx, bool& ok);
+
     // Stream-copy NAL units (no re-encoding)
     // patchReorderFrames > 0: patch inline H.264 SPS NALs with max_num_reorder_frames
     // frameNumDelta != 0: patch H.264 slice frame_num for inter-segment continuity
-    bool streamCopyFrames(QFile& outFile, int startFrame, int endFrame,
+    bool streamCopyFrames(QIODevice& outFile, int startFrame, int endFrame,
                           int patchReorderFrames = 0, int frameNumDelta = 0,
                           int neutralizeMmcoFrames = 0);
 
@@ -310,20 +442,23 @@ private:
     //   this is set to the new stream-copy start (next keyframe). -1 if unchanged.
     // actualStartAU: output — the actual first AU that was encoded (may differ from startFrame
     //   due to B-frame display-order mapping). -1 if unchanged.
-    bool reencodeFrames(QFile& outFile, int startFrame, int endFrame,
+    bool reencodeFrames(QIODevice& outFile, int startFrame, int endFrame,
                         int streamCopyStartFrame, int* adjustedStreamCopyStart = nullptr,
                         int* actualStartAU = nullptr, int startDisplay = -1,
                         int endDisplay = -1, bool tailMode = false);
 
     // Re-encode the tail GOP [tailStartFrame ..] keeping only frames displaying
     // <= endDisplay; forced-IDR closed sub-segment (frame-accurate cut-out).
-    bool reencodeTail(QFile& outFile, int tailStartFrame, int endDisplay);
+    bool reencodeTail(QIODevice& outFile, int tailStartFrame, int endDisplay);
+
+    // The re-encode proper (decode, select, encode, flush) for a prepared ctx
+    bool runReencode(ReencodeContext& ctx);
 
     // Compute decode range for re-encoding: decodeStart with runway extension,
     // decodeEnd with pre-extension to next keyframe after streamCopyStartFrame.
     bool computeDecodeRange(ReencodeContext& ctx);
 
-    // Reset decoder (flush) and recreate encoder for a new segment.
+    // Recreate decoder and encoder for a new re-encode run.
     // libx264's lookahead can't be restarted after flush, hence the recreate.
     bool resetDecoderForSegment(ReencodeContext& ctx);
 
@@ -332,22 +467,41 @@ private:
     bool ensureEncoderInitialized(ReencodeContext& ctx, AVFrame* probeFrame);
 
     // Decode all frames in [ctx.decodeStart, ctx.decodeEnd] plus drain on EOF,
-    // appending each decoded AVFrame* to ctx.allDecodedFrames. Calls
-    // ensureEncoderInitialized on the first received frame. Tracks
+    // handing each decoded AVFrame* to takeDecodedFrame. Tracks
     // mReorderDelay from decoder->has_b_frames.
     bool decodeFramesIntoList(ReencodeContext& ctx);
 
+    // One decoded frame from decodeFramesIntoList (takes ownership). The
+    // first one decides between collecting the window and streaming it
+    // (setReencodeMemoryLimit); streaming sends kept frames straight to the
+    // encoder and frees the others.
+    bool takeDecodedFrame(ReencodeContext& ctx, AVFrame* frame);
+    qint64 reencodeFrameBudget() const;
+
+    // Stream-copy boundary of the run (ctx.streamCopyLimit, cut-in boundary
+    // crossing, *ctx.adjustedStreamCopyStart). Needs no decoded frame, so it
+    // runs before the decode.
+    void computeSelectionBounds(ReencodeContext& ctx);
+
+    // Selection predicate for the frame of source AU au (see below)
+    bool keepFrameForEncode(const ReencodeContext& ctx, int au) const;
+
     // Display-order based frame selection (PAFF and non-PAFF, unified), with
     // three modes:
     //   head/mixed: DISPLAY >= ctx.startDisplay && AU < stream-copy boundary
     //   pure re-encode (streamCopyStartFrame<0, endDisplay>=0):
     //               ctx.startDisplay <= DISPLAY <= ctx.endDisplay
     //   tail (ctx.tailMode): AU >= ctx.startFrame && DISPLAY <= ctx.endDisplay
-    // Sets ctx.framesToEncode, ctx.streamCopyLimit,
-    // *ctx.adjustedStreamCopyStart. The cut-in boundary-crossing extension
-    // applies only to head/mixed mode.
+    // Moves the kept frames of ctx.allDecodedFrames to ctx.framesToEncode
+    // (collecting mode; computeSelectionBounds ran before the decode). The
+    // cut-in boundary-crossing extension applies only to head/mixed mode.
     void selectFramesByDisplayOrder(ReencodeContext& ctx);
 
+    // POC anchoring of the rewritten encoder POCs for a run of frameCount
+    // encoded frames (SPS unification base, HEVC seam base). false = the
+    // HEVC seam window wraps (rollback).
+    bool anchorEncoderPocs(int frameCount);
+
     // One-shot parse of encoder's H.264 SPS from the first encoder packet.
     // Idempotent: returns immediately if ctx.encoderSpsParsed. No-op for HEVC.
     void parseEncoderSpsFromPacket(ReencodeContext& ctx, const QByteArray& rawData);
@@ -361,13 +515,25 @@ private:
     // new pending packet. Increments ctx.packetsReceived and mEncoderPacketsWritten.
     bool bufferAndWriteEncoderPacket(ReencodeContext& ctx, const QByteArray& transformedData);
 
-    // Iterate ctx.framesToEncode, send each to encoder, drain output packets.
-    // Calls parseEncoderSpsFromPacket + transformEncoderPacket +
-    // bufferAndWriteEncoderPacket per output packet.
+    // Output display-order entry for encoder packet packetIndex of a run
+    // whose submitted source AUs are auOrder.
+    void trackEncodedPacketDisplay(const QVector<int>& auOrder, int packetIndex);
+
+    // Iterate ctx.framesToEncode (collecting mode), encodeFrame each.
     bool runEncodePass(ReencodeContext& ctx);
 
-    // Send NULL frame to encoder, drain remaining packets via the same
-    // parse → transform → buffer-and-write chain as runEncodePass.
+    // Send one frame to the encoder (the first one forced to I) and drain
+    // its packets through handleEncoderPacket. Does not free frame.
+    bool encodeFrame(ReencodeContext& ctx, AVFrame* frame);
+
+    // One encoder packet: parse → transform → buffer-and-write, or - when
+    // streaming - held until the run's frame count fixes the POC anchor
+    // and mReorderDelay is final (releaseHeldPackets).
+    bool handleEncoderPacket(ReencodeContext& ctx, const QByteArray& rawData);
+    bool releaseHeldPackets(ReencodeContext& ctx);
+
+    // Send NULL frame to encoder, drain remaining packets through
+    // handleEncoderPacket.
     bool flushEncoder(ReencodeContext& ctx);
 
     // POC domain mismatch fix: patch poc_lsb in ctx.pendingPacket to prevent
@@ -383,10 +549,10 @@ private:
     // Helper: write parameter sets (SPS/PPS/VPS)
     // patchReorderFrames > 0: patch H.264 SPS to add bitstream_restriction
     // with max_num_reorder_frames = patchReorderFrames
-    bool writeParameterSets(QFile& outFile, int patchReorderFrames = 0);
+    bool writeParameterSets(QIODevice& outFile, int patchReorderFrames = 0);
 
     // Write the codec's EOS NAL to flush the decoder DPB at a splice point.
-    void writeEos(QFile& outFile) const;
+    void writeEos(QIODevice& outFile) const;
 
     // Bridge the encoder AUs' frame_num sequence to the stream-copy start.
     // Returns the delta to add to every copied AU's frame_num (0 = don't
@@ -17,6 +17,7 @@
 #include "../avstream/ttdisplayordermap.h"
 #include "../avstream/ttesinfo.h"
 #include "../avstream/ttnaluparser.h"
+#include "../avstream/ttstreamindexcache.h"
 #include "../common/ttcut.h"
 #include "../common/ttmessagelogger.h"
 #include "../common/ttsettings.h"
@@ -31,6 +32,7 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
+#include <QThreadPool>
 #include <QRegularExpression>
 
 // Include libav headers (C libraries)
@@ -84,7 +86,6 @@ TTFFmpegWrapper::TTFFmpegWrapper()
     , mH264Log2MaxFrameNum(4)
     , mH264FrameMbsOnlyFlag(true)
     , mRawPacketCount(0)
-    , mFrameCacheMaxSize(30)
 {
     initializeFFmpeg();
 }
@@ -179,10 +180,32 @@ bool TTFFmpegWrapper::openFile(const QString& filePath)
                     avcodec_free_context(&mVideoCodecCtx);
                     mVideoCodecCtx = nullptr;
                 } else {
-                    if (mAnalysisMode) {
+                    if (mReducedDecode) {
+                        // NONINTRA, not NONKEY: libav's H.264 decoder counts
+                        // only IDR / recovery-point pictures as key, which
+                        // would drop the non-IDR I pictures broadcast GOPs
+                        // start with. skip_idct only reaches the MPEG-1/2/4
+                        // decoders; H.264/H.265 ignore it. SHOW_ALL: after a
+                        // seek straight to such a picture the H.264 decoder
+                        // would hold it back until the next key picture.
+                        mVideoCodecCtx->thread_count = 0;
+                        mVideoCodecCtx->thread_type = FF_THREAD_SLICE;
+                        mVideoCodecCtx->skip_frame = AVDISCARD_NONINTRA;
+                        mVideoCodecCtx->skip_idct = AVDISCARD_NONINTRA;
+                        mVideoCodecCtx->skip_loop_filter = AVDISCARD_ALL;
+                        mVideoCodecCtx->flags2 |= AV_CODEC_FLAG2_SHOW_ALL;
+                    } else if (mAnalysisMode) {
                         mVideoCodecCtx->thread_count = 0;  // auto-detect (all cores)
                         mVideoCodecCtx->thread_type = FF_THREAD_SLICE;
                         mVideoCodecCtx->skip_loop_filter = AVDISCARD_ALL;  // skip deblocking (safe for analysis)
+                    } else if (mDecodeThreads != 1) {
+                        // Interactive preview with frame threads: decode-order
+                        // tags ride in packet pts, which libav carries to the
+                        // frame decoded from that packet on any thread; the
+                        // extra output delay is absorbed by skipCurrentFrame()
+                        // (receive first, pending packet on send-EAGAIN).
+                        mVideoCodecCtx->thread_count = qMax(0, mDecodeThreads);
+                        mVideoCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
                     } else {
                         mVideoCodecCtx->thread_count = 1;
                         mVideoCodecCtx->thread_type = FF_THREAD_SLICE;
@@ -216,6 +239,12 @@ bool TTFFmpegWrapper::openFile(const QString& filePath)
 // ----------------------------------------------------------------------------
 void TTFFmpegWrapper::closeFile()
 {
+    cancelBackwardPrefetch();
+    delete mPrefetchPool;
+    mPrefetchPool = nullptr;
+    delete mPrefetchWrapper;   // closes its file
+    mPrefetchWrapper = nullptr;
+
     mFrameIndex.clear();
     mGOPIndex.clear();
 
@@ -236,6 +265,10 @@ void TTFFmpegWrapper::closeFile()
         sws_freeContext(mSwsCtx);
         mSwsCtx = nullptr;
     }
+    if (mSwsCtxReduced) {
+        sws_freeContext(mSwsCtxReduced);
+        mSwsCtxReduced = nullptr;
+    }
 
     if (mVideoCodecCtx) {
         avcodec_free_context(&mVideoCodecCtx);
@@ -270,6 +303,8 @@ void TTFFmpegWrapper::closeFile()
     mIsPAFF = false;
     mH264Log2MaxFrameNum = 4;
     mH264FrameMbsOnlyFlag = true;
+    mNaluIndex = TTNaluIndex();
+    mPreviewRunTag = -1;
     clearFrameCache();
 }
 
@@ -540,19 +575,56 @@ TTFFmpegWrapper::TTFieldInfo TTFFmpegWrapper::parseH264FieldInfoFromPacket(const
 }
 
 // ----------------------------------------------------------------------------
-// Build frame index by scanning all packets
+// Build frame index by scanning all packets.
+// With withNaluIndex, an H.26x elementary stream is indexed once for the
+// cutter too: the NAL/AU index (TTNaluParser, for TTESSmartCut) is built on a
+// worker from the same file while the codec parser walks it for the frame
+// index, POC, IDR/RASL classification and the PAFF merge. Preview, search and
+// thumbnail wrappers never read it and skip that second pass.
 // ----------------------------------------------------------------------------
-bool TTFFmpegWrapper::buildFrameIndex(int videoStreamIndex)
+bool TTFFmpegWrapper::buildFrameIndex(int videoStreamIndex, bool withNaluIndex)
 {
     if (!setupIndexingPass(videoStreamIndex)) return false;
     if (videoStreamIndex < 0) videoStreamIndex = mVideoStreamIndex;
 
-    scanPacketsIntoRawIndex(videoStreamIndex);
-    mergePAFFFieldsInIndex();
-    finalizeFrameIndex();
-    buildDisplayOrderMap();
+    mNaluIndex = TTNaluIndex();
+    const AVCodecID codecId = mFormatCtx->streams[videoStreamIndex]->codecpar->codec_id;
+    const bool buildNalu = withNaluIndex && mIsElementaryStream &&
+                           (codecId == AV_CODEC_ID_H264 || codecId == AV_CODEC_ID_HEVC);
+    TTNaluParser naluParser;
+    bool naluParsed = false;
+    QThreadPool naluPool;
+    if (buildNalu) {
+        const QString path = QString::fromUtf8(mFormatCtx->url);
+        if (mIndexAbortCallback)
+            naluParser.setAbortCallback(mIndexAbortCallback);
+        naluPool.setMaxThreadCount(1);
+        naluPool.start(QRunnable::create([&naluParser, &naluParsed, path]() {
+            naluParsed = naluParser.openFile(path) && naluParser.parseFile();
+        }));
+    }
+
+    if (!loadFrameIndexCache(videoStreamIndex)) {
+        if (!mMappedIndexScan || !scanMappedStreamIntoRawIndex(videoStreamIndex))
+            scanPacketsIntoRawIndex(videoStreamIndex);
+        mergePAFFFieldsInIndex();
+        finalizeFrameIndex();
+        buildDisplayOrderMap();
+        storeFrameIndexCache(videoStreamIndex);
+    }
     rewindContext(videoStreamIndex);
 
+    if (buildNalu) {
+        naluPool.waitForDone();
+        if (naluParsed) {
+            mNaluIndex = naluParser.index();
+        } else if (!(mIndexAbortCallback && mIndexAbortCallback())) {
+            TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+                QString("NAL index not built (%1) - the cutter will parse the stream itself")
+                    .arg(naluParser.lastError()));
+        }
+    }
+
     if (!mFrameIndex.isEmpty() && mFrameIndex[0].pts == AV_NOPTS_VALUE) {
         assignPtsFromFrameRate(videoStreamIndex);
     }
@@ -701,6 +773,14 @@ bool TTFFmpegWrapper::seekToFrame(int frameIndex)
         }
     }
 
+    return seekToAU(seekKeyframe, keyframeIndex, AVSEEK_FLAG_BACKWARD);
+}
+
+// Position the demuxer on decode-order AU seekKeyframe and flush the decoder.
+// keyframeIndex only labels the log line; seekFlags go to av_seek_frame()
+// for containers (AVSEEK_FLAG_ANY lands on a non-keyframe AU).
+bool TTFFmpegWrapper::seekToAU(int seekKeyframe, int keyframeIndex, int seekFlags)
+{
     int64_t ret;
     if (mIsElementaryStream && mFormatCtx->pb) {
         // For ES files, use byte-based seeking
@@ -740,7 +820,7 @@ bool TTFFmpegWrapper::seekToFrame(int frameIndex)
         int64_t seekPts = mFrameIndex[seekKeyframe].pts;
         if (TTSettings::instance()->logFFmpegDecoder())
             qDebug() << "Container seek to PTS" << seekPts << "seekKeyframe:" << seekKeyframe << "targetKeyframe:" << keyframeIndex;
-        ret = av_seek_frame(mFormatCtx, mVideoStreamIndex, seekPts, AVSEEK_FLAG_BACKWARD);
+        ret = av_seek_frame(mFormatCtx, mVideoStreamIndex, seekPts, seekFlags);
     }
 
     if (ret < 0) {
@@ -758,6 +838,7 @@ bool TTFFmpegWrapper::seekToFrame(int frameIndex)
     if (mPendingPacket)
         av_packet_free(&mPendingPacket);
     mDecoderDrained = false;
+    mPreviewRunTag = -1;
 
     mCurrentFrameIndex = seekKeyframe;
     mDecoderFrameIndex = seekKeyframe;
@@ -777,6 +858,23 @@ bool TTFFmpegWrapper::seekToFrame(int frameIndex)
 // Decode frame at specific index and return as QImage
 // ----------------------------------------------------------------------------
 QImage TTFFmpegWrapper::decodeFrame(int frameIndex)
+{
+    QImage image;
+    return decodePreviewFrame(frameIndex, &image) ? image : QImage();
+}
+
+// The same frame as 8-bit YUV 4:2:0 planes (see decodeFrameYUV() for the
+// buffers) - no RGB conversion, for a display that converts on the GPU
+bool TTFFmpegWrapper::decodePreviewFrameYUV(int displayPos, TFrameInfo& outInfo)
+{
+    const AVFrame* frame = decodePreviewFrame(displayPos, nullptr);
+    return frame != nullptr && packFrameYUV(frame, outInfo);
+}
+
+// decodeFrame()'s work: returns the decoded frame (cached or mDecodedFrame,
+// valid until the next decode) and, when image is given, its RGB image -
+// converted once and kept with the cached frame. nullptr on failure.
+const AVFrame* TTFFmpegWrapper::decodePreviewFrame(int frameIndex, QImage* image)
 {
     // Bounds check — frameIndex is a DISPLAY position. When the display-order
     // map is valid the visible range is [0, displayCount()) (= n minus dropped
@@ -796,18 +894,10 @@ QImage TTFFmpegWrapper::decodeFrame(int frameIndex)
             if (TTSettings::instance()->logFFmpegDecoder())
                 qDebug() << "decodeFrame: clamped to last valid frame" << frameIndex;
         } else {
-            return QImage();
+            return nullptr;
         }
     }
 
-    // Check LRU cache first
-    if (mFrameCache.contains(frameIndex)) {
-        // Move to back of LRU list (most recently used)
-        mFrameCacheLRU.removeOne(frameIndex);
-        mFrameCacheLRU.append(frameIndex);
-        return mFrameCache[frameIndex];
-    }
-
     // Map the DISPLAY position to the decode-order AU to deliver. This is the
     // SAME map the smart cut uses (displayOrderMap), so the still-image shows
     // exactly the frame the cut starts with for cut-in N (WYSIWYG). The old code
@@ -817,42 +907,54 @@ QImage TTFFmpegWrapper::decodeFrame(int frameIndex)
     if (mDisplayOrderMap.isValid() && frameIndex >= 0 && frameIndex < mDisplayOrderMap.displayCount())
         targetAU = mDisplayOrderMap.displayToDecode(frameIndex);
 
+    if (mDecodeAbort.load())
+        return nullptr;
+
+    // Frames of earlier runs are cached as decoded YUV: a hit costs at most
+    // the RGB conversion, and only the first time. A finished backward
+    // prefetch adds its frames first.
+    collectBackwardPrefetch(frameIndex);
+    if (mFrameCache.contains(frameIndex)) {
+        const QImage cached = image ? cachedFrameImage(frameIndex) : QImage();
+        if (image == nullptr || !cached.isNull()) {
+            if (image) *image = cached;
+            if (frameIndex < mFrameIndex.size())
+                mFrameIndex[frameIndex].deliveredDecodeIndex = targetAU;
+            return mFrameCache.frame(frameIndex);
+        }
+    }
+
     if (TTSettings::instance()->logFFmpegDecoder())
         qDebug() << "decodeFrame: display" << frameIndex << "-> targetAU" << targetAU
                  << "total_frames=" << mFrameIndex.size();
 
-    // Always seek (consistent DPB state across decoder instances; the LRU cache
-    // mitigates the cost). Decoder emits frames in DISPLAY order, each tagged
-    // with its decode-order AU in pts; decode until the output whose pts ==
-    // targetAU, then convert THAT frame. Same decode work as the old skip; only
-    // the stop condition changed (deliver the mapped AU, not the Nth output).
-    QImage result;
-    for (int attempt = 0; attempt < 2 && result.isNull(); ++attempt) {
+    // A step forward from the last decoded frame continues the run: the
+    // decoder still holds its reference chain, so reading on is exact and
+    // saves the seek back up to two GOPs.
+    bool reached = false;
+    if (canContinuePreviewRun(targetAU, frameIndex)) {
+        reached = decodePreviewRunTo(targetAU, frameIndex);
+        if (!reached && TTSettings::instance()->logFFmpegDecoder())
+            qDebug() << "  continued run missed target" << targetAU << "- seeking";
+    }
+
+    // Otherwise seek (consistent DPB state across decoder instances).
+    // Decoder emits frames in DISPLAY order, each tagged with its decode-order
+    // AU in pts; decode until the output whose pts == targetAU, then convert
+    // THAT frame. Same decode work as the old skip; only the stop condition
+    // changed (deliver the mapped AU, not the Nth output).
+    for (int attempt = 0; attempt < 2 && !reached; ++attempt) {
         if (!seekToFrame(targetAU)) {
             TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
                 QString("decodeFrame: seekToFrame failed for AU %1 (display %2)")
                     .arg(targetAU).arg(frameIndex));
             break;
         }
-        mDecoderFrameIndex = mCurrentFrameIndex;
-        mDecodeOrderTag    = mCurrentFrameIndex;
-
-        int guard = 0;
-        const int guardMax = mFrameIndex.size() > 0 ? mFrameIndex.size() : 100000;
-        const bool logTags = TTSettings::instance()->logFFmpegDecoder();
-        while (guard++ < guardMax) {
-            if (!skipCurrentFrame()) break;   // decodes one output into mDecodedFrame
-            if (logTags && (guard <= 5 || static_cast<int>(mDecodedFrame->pts) >= targetAU - 2))
-                qDebug() << "  skip-loop output" << guard << "pts-tag" << mDecodedFrame->pts
-                         << "(target" << targetAU << ")";
-            if (static_cast<int>(mDecodedFrame->pts) == targetAU) {
-                result = convertDecodedFrameToImage();
-                break;
-            }
-        }
-        if (logTags && result.isNull())
-            qDebug() << "  skip-loop ended after" << guard << "outputs without hitting target" << targetAU;
-        if (result.isNull() && attempt == 0) {
+        startPreviewRun(targetAU);
+        reached = decodePreviewRunTo(targetAU, INT_MAX);
+        if (!reached && mDecodeAbort.load())
+            break;
+        if (!reached && attempt == 0) {
             TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
                 QString("decodeFrame: targetAU %1 (display %2) not delivered — retrying with fresh seek")
                     .arg(targetAU).arg(frameIndex));
@@ -860,35 +962,40 @@ QImage TTFFmpegWrapper::decodeFrame(int frameIndex)
         }
     }
 
+    const AVFrame* frame = nullptr;
+    if (reached) {
+        frame = mDecodedFrame;
+        if (image) {
+            *image = convertDecodedFrameToImage();
+            mFrameCache.setImage(frameIndex, *image);
+            if (image->isNull()) frame = nullptr;
+        }
+    }
+
     // deliveredDecodeIndex is now exact: the delivered frame's decode AU == targetAU.
     // Used by the playback seek path (onPlayVideo) to land mpv on the shown frame.
-    if (!result.isNull() && frameIndex >= 0 && frameIndex < mFrameIndex.size())
+    if (frame && frameIndex >= 0 && frameIndex < mFrameIndex.size())
         mFrameIndex[frameIndex].deliveredDecodeIndex = targetAU;
 
+    if (!frame && mDecodeAbort.load())
+        return nullptr;
+
     // Fallback: try one frame earlier if target frame cannot be decoded
-    if (result.isNull() && frameIndex > 0) {
+    if (!frame && frameIndex > 0) {
         TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
             QString("decodeFrame: retry failed — trying frame %1").arg(frameIndex - 1));
         // Recursive call with frameIndex-1 (will seek fresh)
         mDecoderDrained = true;  // Force seek in recursive call
-        result = decodeFrame(frameIndex - 1);
-        if (!result.isNull()) {
+        frame = decodePreviewFrame(frameIndex - 1, image);
+        if (frame) {
             // Return the nearby frame but don't cache it under the wrong index
-            return result;
+            return frame;
         }
     }
 
-    if (!result.isNull()) {
+    if (frame) {
         mDecoderFrameIndex = frameIndex;
         mCurrentFrameIndex = frameIndex;
-
-        // Store in LRU cache
-        mFrameCache[frameIndex] = result;
-        mFrameCacheLRU.append(frameIndex);
-        while (mFrameCacheLRU.size() > mFrameCacheMaxSize) {
-            int evict = mFrameCacheLRU.takeFirst();
-            mFrameCache.remove(evict);
-        }
     } else {
         if (mSearchMode && TTSettings::instance()->logFFmpegDecoder()) {
             qDebug() << "Search-mode decodeFrame: failure at frame" << frameIndex
@@ -898,7 +1005,217 @@ QImage TTFFmpegWrapper::decodeFrame(int frameIndex)
             QString("decodeFrame: FAILED to decode frame %1 and fallback (total_frames=%2)")
                 .arg(frameIndex).arg(mFrameIndex.size()));
     }
-    return result;
+    return frame;
+}
+
+// ----------------------------------------------------------------------------
+// decodeFrame()'s seek+skip run
+// ----------------------------------------------------------------------------
+// Right after seekToFrame(targetAU): decide which outputs of the run come
+// from a complete reference chain. With the previous-GOP prefill that is
+// the target GOP including its leading pictures - and, when the prefill
+// keyframe is an IDR, the prefill GOP as well (nothing before an IDR is
+// referenced, nothing after it displays before it). Without prefill
+// (search mode) an open-GOP keyframe's leading pictures are broken; they are
+// the outputs displayed before it.
+void TTFFmpegWrapper::startPreviewRun(int targetAU)
+{
+    int keyAU = targetAU;
+    while (keyAU > 0 && !mFrameIndex[keyAU].isKeyframe)
+        keyAU--;
+    const int seekAU = mCurrentFrameIndex;
+
+    mDecoderFrameIndex = seekAU;
+    mDecodeOrderTag    = seekAU;
+
+    mPreviewRunFloorDisplay = INT_MIN;
+    if (mFrameIndex[seekAU].isIDR) {
+        mPreviewRunFloorTag = seekAU;
+    } else {
+        mPreviewRunFloorTag = keyAU;
+        if (seekAU == keyAU)
+            mPreviewRunFloorDisplay = mDisplayOrderMap.decodeToDisplay(keyAU);
+    }
+}
+
+// The decoder emits in display order, so a target displayed after the run's
+// last output is still ahead of it (needs the display-order map; without it
+// tags and display positions are not comparable). Bounded to the next GOP:
+// further away a fresh seek decodes less than reading on.
+bool TTFFmpegWrapper::canContinuePreviewRun(int targetAU, int displayPos) const
+{
+    if (mPreviewRunTag < 0 || mDecoderDrained || !mDisplayOrderMap.isValid()) return false;
+    if (targetAU < 0 || targetAU >= mFrameIndex.size()
+        || mPreviewRunTag >= mFrameIndex.size()) return false;
+    if (displayPos <= mDisplayOrderMap.decodeToDisplay(mPreviewRunTag)) return false;
+    return mFrameIndex[targetAU].gopIndex <= mFrameIndex[mPreviewRunTag].gopIndex + 1;
+}
+
+// Decode outputs up to the one tagged targetAU (left in mDecodedFrame),
+// caching every exact one on the way. false at EOF, on a decoder error, or
+// when the outputs pass stopAfterDisplay without the target showing up (a
+// continued run whose target was already behind it).
+bool TTFFmpegWrapper::decodePreviewRunTo(int targetAU, int stopAfterDisplay)
+{
+    const int guardMax = mFrameIndex.size() > 0 ? mFrameIndex.size() : 100000;
+    const bool logTags = TTSettings::instance()->logFFmpegDecoder();
+    int guard = 0;
+    while (guard++ < guardMax && !mDecodeAbort.load()) {
+        if (!skipCurrentFrame()) break;   // decodes one output into mDecodedFrame
+        const int tag = static_cast<int>(mDecodedFrame->pts);
+        const int display = mDisplayOrderMap.decodeToDisplay(tag);
+        mPreviewRunTag = tag;
+        if (logTags && (guard <= 5 || tag >= targetAU - 2))
+            qDebug() << "  skip-loop output" << guard << "pts-tag" << tag
+                     << "(target" << targetAU << ")";
+
+        const bool exact = tag >= mPreviewRunFloorTag && display >= 0
+                        && display >= mPreviewRunFloorDisplay
+                        && mDecodedFrame->decode_error_flags == 0
+                        && !(mDecodedFrame->flags & AV_FRAME_FLAG_CORRUPT);
+        if (exact)
+            mFrameCache.insert(display, mDecodedFrame);
+
+        if (tag == targetAU)
+            return true;
+        if (display > stopAfterDisplay)
+            break;
+    }
+    if (logTags)
+        qDebug() << "  skip-loop ended after" << guard << "outputs without hitting target" << targetAU;
+    mPreviewRunTag = -1;
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+// Backward prefetch
+// ----------------------------------------------------------------------------
+void TTFFmpegWrapper::startBackwardPrefetch(int displayPos)
+{
+    if (!mFormatCtx || mFrameIndex.isEmpty() || mFrameCache.budget() <= 0) return;
+    if (mPrefetchRunning.load() || mPrefetchReady) return;
+
+    // The frame right below the cached run around displayPos
+    int target = displayPos;
+    while (target >= 0 && mFrameCache.contains(target))
+        target--;
+    if (target < 0 || target == displayPos) return;
+
+    const int targetAU = mDisplayOrderMap.displayToDecode(target);
+    const int posAU    = mDisplayOrderMap.displayToDecode(displayPos);
+    if (targetAU < 0 || targetAU >= mFrameIndex.size()
+        || posAU < 0 || posAU >= mFrameIndex.size()) return;
+    if (mFrameIndex[posAU].gopIndex - mFrameIndex[targetAU].gopIndex > 1) return;
+
+    // decodeFrame(target) caches from the target's keyframe on; the lowest
+    // display position among those frames is the job's lower end
+    int keyAU = targetAU;
+    while (keyAU > 0 && !mFrameIndex[keyAU].isKeyframe)
+        keyAU--;
+    int first = target;
+    for (int au = keyAU; au <= targetAU; ++au) {
+        const int display = mDisplayOrderMap.decodeToDisplay(au);
+        if (display >= 0) first = qMin(first, display);
+    }
+
+    if (mPrefetchPool == nullptr) {
+        mPrefetchWrapper = new TTFFmpegWrapper();
+        mPrefetchWrapper->setDecodeThreads(mDecodeThreads);
+        mPrefetchPool = new QThreadPool();
+        mPrefetchPool->setMaxThreadCount(1);
+    }
+    mPrefetchWrapper->setFrameCacheBudget(mFrameCache.budget());
+    mPrefetchFirst  = first;
+    mPrefetchTarget = target;
+    mPrefetchRunning = true;
+
+    if (TTSettings::instance()->logFFmpegDecoder())
+        qDebug() << "Backward prefetch: display" << first << "-" << target
+                 << "(stepping at" << displayPos << ")";
+
+    // The first job opens the file (probing an ES takes a while) and adopts
+    // this wrapper's index, off the GUI thread
+    TTFFmpegWrapper* w = mPrefetchWrapper;
+    const QString filePath = mPrefetchWrapper->isOpen() ? QString()
+                                                        : QString::fromUtf8(mFormatCtx->url);
+    const QList<TTFrameInfo> index = filePath.isEmpty() ? QList<TTFrameInfo>() : mFrameIndex;
+    const bool isPAFF = mIsPAFF, frameMbsOnly = mH264FrameMbsOnlyFlag;
+    const int log2MaxFrameNum = mH264Log2MaxFrameNum;
+    mPrefetchPool->start([this, w, target, filePath, index, isPAFF, frameMbsOnly, log2MaxFrameNum]() {
+        bool ok = w->isOpen();
+        if (!ok && w->openFile(filePath)) {
+            w->setFrameIndex(index);
+            w->adoptStreamMetadata(isPAFF, frameMbsOnly, log2MaxFrameNum);
+            ok = true;
+        }
+        ok = ok && !w->decodeFrame(target).isNull();
+        if (ok) {
+            for (int pos : w->mFrameCache.positions())
+                w->cachedFrameImage(pos);
+        }
+        mPrefetchReady = ok;
+        mPrefetchRunning = false;
+    });
+}
+
+// Move a finished job's frames into the cache - in ascending display order,
+// so the ones the next backward steps need are the most recently used
+void TTFFmpegWrapper::collectBackwardPrefetch(int displayPos)
+{
+    if (mPrefetchPool == nullptr) return;
+    if (mPrefetchRunning.load()) {
+        if (displayPos < mPrefetchFirst || displayPos > mPrefetchTarget) return;
+        mPrefetchPool->waitForDone();   // the job is decoding this very frame
+    }
+    if (!mPrefetchReady) return;
+    mPrefetchReady = false;
+
+    TTDecodedFrameCache& from = mPrefetchWrapper->mFrameCache;
+    QList<int> positions = from.positions();
+    std::sort(positions.begin(), positions.end());
+    for (int pos : positions) {
+        if (mFrameCache.contains(pos)) continue;
+        const QImage image = from.image(pos);
+        if (mFrameCache.insert(pos, from.frame(pos)) && !image.isNull())
+            mFrameCache.setImage(pos, image);
+    }
+    from.clear();
+}
+
+void TTFFmpegWrapper::cancelBackwardPrefetch()
+{
+    if (mPrefetchPool == nullptr) return;
+    mPrefetchWrapper->mDecodeAbort = true;
+    mPrefetchPool->waitForDone();
+    mPrefetchWrapper->mDecodeAbort = false;
+    mPrefetchWrapper->clearFrameCache();
+    mPrefetchReady = false;
+}
+
+bool TTFFmpegWrapper::decodesWithoutSeek(int displayPos)
+{
+    const int displayCount = mDisplayOrderMap.isValid()
+                           ? mDisplayOrderMap.displayCount() : mFrameIndex.size();
+    if (displayPos < 0 || displayPos >= displayCount) return false;
+
+    collectBackwardPrefetch(displayPos);
+    if (mFrameCache.contains(displayPos)) return true;
+
+    const int targetAU = mDisplayOrderMap.isValid()
+                       ? mDisplayOrderMap.displayToDecode(displayPos) : displayPos;
+    return canContinuePreviewRun(targetAU, displayPos);
+}
+
+QImage TTFFmpegWrapper::cachedFrameImage(int displayPos)
+{
+    QImage image = mFrameCache.image(displayPos);
+    if (image.isNull()) {
+        const AVFrame* frame = mFrameCache.frame(displayPos);
+        if (frame == nullptr) return QImage();
+        image = convertFrameToImage(frame);
+        mFrameCache.setImage(displayPos, image);
+    }
+    return image;
 }
 
 // ----------------------------------------------------------------------------
@@ -944,6 +1261,8 @@ bool TTFFmpegWrapper::decodeFrameYUV(int frameIndex, TFrameInfo& outInfo)
         }
     }
 
+    mPreviewRunTag = -1;   // moves the decoder away from decodeFrame()'s run
+
     // Sequential-decode path: previous call delivered the immediately preceding display
     // position; the decoder is still positioned to emit the next output.
     bool sequentialPath = (mDecoderFrameIndex == frameIndex - 1
@@ -984,34 +1303,9 @@ bool TTFFmpegWrapper::decodeFrameYUV(int frameIndex, TFrameInfo& outInfo)
     bool gotFrame = !sequentialPath;
 
     if (sequentialPath) {
-        AVPacket* packet = av_packet_alloc();
-        if (!packet) {
-            TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-                QString("decodeFrameYUV: could not allocate packet"));
-            return false;
-        }
-        while (!gotFrame && av_read_frame(mFormatCtx, packet) >= 0) {
-            if (packet->stream_index == mVideoStreamIndex) {
-                int ret = avcodec_send_packet(mVideoCodecCtx, packet);
-                if (ret < 0) {
-                    av_packet_unref(packet);
-                    continue;
-                }
-                ret = avcodec_receive_frame(mVideoCodecCtx, mDecodedFrame);
-                if (ret == 0)
-                    gotFrame = true;
-            }
-            av_packet_unref(packet);
-        }
-        // EOF drain if no frame yet
-        if (!gotFrame) {
-            avcodec_send_packet(mVideoCodecCtx, nullptr);
-            if (avcodec_receive_frame(mVideoCodecCtx, mDecodedFrame) == 0) {
-                gotFrame = true;
-                mDecoderDrained = true;
-            }
-        }
-        av_packet_free(&packet);
+        // Receive-first, EAGAIN-safe and draining at EOF (frame threads
+        // hold several frames and refuse packets while one is waiting)
+        gotFrame = skipCurrentFrame();
         if (!gotFrame) {
             TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
                 QString("decodeFrameYUV: no frame decoded for display %1").arg(frameIndex));
@@ -1020,9 +1314,16 @@ bool TTFFmpegWrapper::decodeFrameYUV(int frameIndex, TFrameInfo& outInfo)
         mDecoderFrameIndex = frameIndex;
     }
 
-    int srcFmt = mDecodedFrame->format;
-    int w = mDecodedFrame->width;
-    int h = mDecodedFrame->height;
+    return packFrameYUV(mDecodedFrame, outInfo);
+}
+
+// Tight-pack frame's planes into mY/U/VBuffer as 8-bit 4:2:0 (swscale for
+// any other format) and point outInfo at them
+bool TTFFmpegWrapper::packFrameYUV(const AVFrame* frame, TFrameInfo& outInfo)
+{
+    int srcFmt = frame->format;
+    int w = frame->width;
+    int h = frame->height;
     int cw = w / 2;
     int ch = h / 2;
 
@@ -1042,15 +1343,15 @@ bool TTFFmpegWrapper::decodeFrameYUV(int frameIndex, TFrameInfo& outInfo)
         // Fast path: tight-pack memcpy from libav's strided 8-bit planes
         for (int row = 0; row < h; row++) {
             memcpy(mYBuffer + row * w,
-                   mDecodedFrame->data[0] + row * mDecodedFrame->linesize[0],
+                   frame->data[0] + row * frame->linesize[0],
                    w);
         }
         for (int row = 0; row < ch; row++) {
             memcpy(mUBuffer + row * cw,
-                   mDecodedFrame->data[1] + row * mDecodedFrame->linesize[1],
+                   frame->data[1] + row * frame->linesize[1],
                    cw);
             memcpy(mVBuffer + row * cw,
-                   mDecodedFrame->data[2] + row * mDecodedFrame->linesize[2],
+                   frame->data[2] + row * frame->linesize[2],
                    cw);
         }
     } else {
@@ -1080,7 +1381,7 @@ bool TTFFmpegWrapper::decodeFrameYUV(int frameIndex, TFrameInfo& outInfo)
         uint8_t* dst[4]    = { mYBuffer, mUBuffer, mVBuffer, nullptr };
         int      dstStride[4] = { w, cw, cw, 0 };
         int swsRet = sws_scale(mSwsCtxYUV,
-                               mDecodedFrame->data, mDecodedFrame->linesize,
+                               frame->data, frame->linesize,
                                0, h, dst, dstStride);
         if (swsRet <= 0) {
             TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
@@ -1101,7 +1402,7 @@ bool TTFFmpegWrapper::decodeFrameYUV(int frameIndex, TFrameInfo& outInfo)
     outInfo.chroma_height = ch;
     outInfo.chroma_size = cw * ch;
     // Map libav pict_type to MPEG-2 type (I=1, P=2, B=3); unknown→0
-    switch (mDecodedFrame->pict_type) {
+    switch (frame->pict_type) {
         case AV_PICTURE_TYPE_I: outInfo.type = 1; break;
         case AV_PICTURE_TYPE_P: outInfo.type = 2; break;
         case AV_PICTURE_TYPE_B: outInfo.type = 3; break;
@@ -1119,7 +1420,13 @@ bool TTFFmpegWrapper::decodeFrameYUV(int frameIndex, TFrameInfo& outInfo)
 // mDecodedFrame. Shared by decodeCurrentFrame() and decodeFrame().
 QImage TTFFmpegWrapper::convertDecodedFrameToImage()
 {
-    if (!mVideoCodecCtx || !mDecodedFrame) return QImage();
+    return convertFrameToImage(mDecodedFrame);
+}
+
+// Same for any frame of this decoder (a cached one in mFrameCache)
+QImage TTFFmpegWrapper::convertFrameToImage(const AVFrame* frame)
+{
+    if (!mVideoCodecCtx || !frame) return QImage();
 
     if (!mRgbFrame) {
         mRgbFrame = av_frame_alloc();
@@ -1141,7 +1448,7 @@ QImage TTFFmpegWrapper::convertDecodedFrameToImage()
             SWS_BILINEAR, nullptr, nullptr, nullptr);
         if (!mSwsCtx) { setError("Could not create scaler context"); return QImage(); }
     }
-    sws_scale(mSwsCtx, mDecodedFrame->data, mDecodedFrame->linesize,
+    sws_scale(mSwsCtx, frame->data, frame->linesize,
               0, mVideoCodecCtx->height, mRgbFrame->data, mRgbFrame->linesize);
     return QImage(mRgbFrame->data[0],
                   mVideoCodecCtx->width, mVideoCodecCtx->height,
@@ -1157,6 +1464,7 @@ bool TTFFmpegWrapper::isFrameBlack(int frameIndex, int pixelThreshold, float rat
 {
     if (frameIndex < 0 || frameIndex >= mFrameIndex.size()) return false;
     if (!mFormatCtx || !mVideoCodecCtx) return false;
+    mPreviewRunTag = -1;   // moves the decoder away from decodeFrame()'s run
 
     // Seek to keyframe for this frame
     int keyframeIndex = frameIndex;
@@ -1186,33 +1494,9 @@ bool TTFFmpegWrapper::isFrameBlack(int frameIndex, int pixelThreshold, float rat
         if (!mDecodedFrame) return false;
     }
 
-    AVPacket* packet = av_packet_alloc();
-    if (!packet) return false;
-
-    bool decoded = false;
-    while (av_read_frame(mFormatCtx, packet) >= 0) {
-        if (packet->stream_index == mVideoStreamIndex) {
-            if (avcodec_send_packet(mVideoCodecCtx, packet) >= 0) {
-                if (avcodec_receive_frame(mVideoCodecCtx, mDecodedFrame) == 0) {
-                    decoded = true;
-                    av_packet_unref(packet);
-                    break;
-                }
-            }
-        }
-        av_packet_unref(packet);
-    }
-
-    // EOF drain if needed
-    if (!decoded) {
-        avcodec_send_packet(mVideoCodecCtx, nullptr);
-        if (avcodec_receive_frame(mVideoCodecCtx, mDecodedFrame) == 0) {
-            decoded = true;
-            mDecoderDrained = true;
-        }
-    }
-
-    av_packet_free(&packet);
+    // skipCurrentFrame() takes a frame the decoder already holds first and
+    // keeps a packet the decoder refused - both happen with frame threads
+    const bool decoded = skipCurrentFrame();
     if (!decoded) {
         if (mSearchMode && TTSettings::instance()->logFFmpegDecoder()) {
             qDebug() << "Search-mode isFrameBlack: decode failure at frame" << frameIndex
@@ -1297,34 +1581,8 @@ bool TTFFmpegWrapper::buildHistogram(int frameIndex, int hist[256], int& totalPi
         if (!mDecodedFrame) return false;
     }
 
-    AVPacket* packet = av_packet_alloc();
-    if (!packet) return false;
-
-    // Read packets until decoder produces a frame
     // In analysis mode (AVDISCARD_NONKEY), only keyframes produce output
-    bool decoded = false;
-    while (av_read_frame(mFormatCtx, packet) >= 0) {
-        if (packet->stream_index == mVideoStreamIndex) {
-            if (avcodec_send_packet(mVideoCodecCtx, packet) >= 0) {
-                if (avcodec_receive_frame(mVideoCodecCtx, mDecodedFrame) == 0) {
-                    decoded = true;
-                    av_packet_unref(packet);
-                    break;
-                }
-            }
-        }
-        av_packet_unref(packet);
-    }
-
-    if (!decoded) {
-        avcodec_send_packet(mVideoCodecCtx, nullptr);
-        if (avcodec_receive_frame(mVideoCodecCtx, mDecodedFrame) == 0) {
-            decoded = true;
-            mDecoderDrained = true;
-        }
-    }
-
-    av_packet_free(&packet);
+    const bool decoded = skipCurrentFrame();
     if (!decoded) {
         if (mSearchMode && TTSettings::instance()->logFFmpegDecoder()) {
             qDebug() << "Search-mode buildHistogram: decode failure at frame" << frameIndex
@@ -1399,40 +1657,66 @@ int64_t TTFFmpegWrapper::decodeOrderTagForPacket(const AVPacket* packet)
     return tag;
 }
 
-QImage TTFFmpegWrapper::decodeNearestKeyframe(int displayPos, int* shownDisplayPos)
+// Display position -> decode-order AU, then walk back to the keyframe.
+// intraStart: an intra AU (I slices) is its own start picture. libav's key
+// flag only marks IDR / recovery-point / IRAP pictures, while the index list
+// and its callers count every I picture as type 1 - walking back from a
+// non-IDR I would deliver an earlier picture under the requested number.
+void TTFFmpegWrapper::keyframeBefore(int displayPos, int& keyAU, int& keyDisplay,
+                                     bool intraStart) const
 {
-    if (shownDisplayPos) *shownDisplayPos = -1;
-    if (mFrameIndex.isEmpty()) return QImage();
-
-    // Display position -> decode-order AU, then walk back to the keyframe.
     int targetAU = qBound(0, displayPos, int(mFrameIndex.size()) - 1);
     if (mDisplayOrderMap.isValid() && displayPos >= 0
         && displayPos < mDisplayOrderMap.displayCount())
         targetAU = mDisplayOrderMap.displayToDecode(displayPos);
-    int keyAU = qBound(0, targetAU, int(mFrameIndex.size()) - 1);
-    while (keyAU > 0 && !mFrameIndex[keyAU].isKeyframe)
-        keyAU--;
+    keyAU = qBound(0, targetAU, int(mFrameIndex.size()) - 1);
+    if (!(intraStart && mFrameIndex[keyAU].frameType == AV_PICTURE_TYPE_I)) {
+        while (keyAU > 0 && !mFrameIndex[keyAU].isKeyframe)
+            keyAU--;
+    }
+
+    keyDisplay = mDisplayOrderMap.isValid()
+                     ? mDisplayOrderMap.decodeToDisplay(keyAU)
+                     : keyAU;
+}
+
+QImage TTFFmpegWrapper::decodeNearestKeyframe(int displayPos, int* shownDisplayPos)
+{
+    if (shownDisplayPos) *shownDisplayPos = -1;
+    if (mFrameIndex.isEmpty()) return QImage();
 
-    const int keyDisplay = mDisplayOrderMap.isValid()
-                               ? mDisplayOrderMap.decodeToDisplay(keyAU)
-                               : keyAU;
+    int keyAU, keyDisplay;
+    keyframeBefore(displayPos, keyAU, keyDisplay);
     if (shownDisplayPos) *shownDisplayPos = keyDisplay;
 
-    // The LRU cache is shared with decodeFrame() and keyed by display
+    // The frame cache is shared with decodeFrame() and keyed by display
     // position - dragging back and forth over the same GOP is then free.
-    if (keyDisplay >= 0 && mFrameCache.contains(keyDisplay)) {
-        mFrameCacheLRU.removeOne(keyDisplay);
-        mFrameCacheLRU.append(keyDisplay);
-        return mFrameCache[keyDisplay];
+    if (keyDisplay >= 0) {
+        const QImage cached = cachedFrameImage(keyDisplay);
+        if (!cached.isNull()) return cached;
     }
 
-    // Borrow the search path's no-prefill seek: mSearchMode is only read by
-    // seekToFrame() to decide whether to prefill from the previous keyframe.
-    const bool savedSearchMode = mSearchMode;
-    mSearchMode = true;
-    const bool seekOk = seekToFrame(keyAU);
-    mSearchMode = savedSearchMode;
-    if (!seekOk) return QImage();
+    QImage result;
+    if (decodeKeyframeAU(keyAU))
+        result = convertDecodedFrameToImage();
+
+    if (!result.isNull() && keyDisplay >= 0) {
+        if (mDecodedFrame->decode_error_flags == 0
+            && !(mDecodedFrame->flags & AV_FRAME_FLAG_CORRUPT)
+            && mFrameCache.insert(keyDisplay, mDecodedFrame))
+            mFrameCache.setImage(keyDisplay, result);
+        mCurrentFrameIndex = keyDisplay;
+        mDecoderFrameIndex = keyDisplay;
+    }
+    return result;
+}
+
+// Seek straight to keyAU - a keyframe or an intra AU, no previous-GOP
+// prefill - and decode it into mDecodedFrame
+bool TTFFmpegWrapper::decodeKeyframeAU(int keyAU)
+{
+    if (!seekToAU(keyAU, keyAU, AVSEEK_FLAG_BACKWARD | AVSEEK_FLAG_ANY))
+        return false;
 
     mDecoderFrameIndex = mCurrentFrameIndex;
     mDecodeOrderTag    = mCurrentFrameIndex;
@@ -1442,27 +1726,94 @@ QImage TTFFmpegWrapper::decodeNearestKeyframe(int displayPos, int* shownDisplayP
     // display order, so the keyframe (lowest POC of its GOP) comes out first
     // or nearly so - a small guard suffices and keeps a broken stream from
     // turning the preview into the very drain this is meant to avoid.
-    QImage result;
     int guard = 0;
     while (guard++ < 64) {
         if (!skipCurrentFrame()) break;
-        if (static_cast<int>(mDecodedFrame->pts) == keyAU) {
-            result = convertDecodedFrameToImage();
-            break;
-        }
+        if (static_cast<int>(mDecodedFrame->pts) == keyAU)
+            return true;
     }
+    return false;
+}
 
-    if (!result.isNull() && keyDisplay >= 0) {
-        mFrameCache[keyDisplay] = result;
-        mFrameCacheLRU.append(keyDisplay);
-        while (mFrameCacheLRU.size() > mFrameCacheMaxSize) {
-            int evict = mFrameCacheLRU.takeFirst();
-            mFrameCache.remove(evict);
-        }
+QImage TTFFmpegWrapper::decodeKeyframeReduced(int displayPos, const QSize& size, bool grayscale,
+                                              int* shownDisplayPos)
+{
+    if (shownDisplayPos) *shownDisplayPos = -1;
+    if (mFrameIndex.isEmpty()) return QImage();
+    mPreviewRunTag = -1;   // moves the decoder away from decodeFrame()'s run
+
+    int keyAU, keyDisplay;
+    keyframeBefore(displayPos, keyAU, keyDisplay, true);
+    if (shownDisplayPos) *shownDisplayPos = keyDisplay;
+
+    // No cache insert: thumbnail and scan wrappers do not come back
+    const AVFrame* frame = (keyDisplay >= 0 && mFrameCache.contains(keyDisplay))
+                               ? mFrameCache.frame(keyDisplay) : nullptr;
+    if (frame == nullptr) {
+        // A non-key intra start on a full-profile wrapper: decode it the way
+        // a reduced wrapper does (see openFile()) for this one picture
+        const bool intraStart = !mFrameIndex[keyAU].isKeyframe && !mReducedDecode
+                                && mVideoCodecCtx;
+        AVDiscard savedSkip   = AVDISCARD_DEFAULT;
+        int       savedFlags2 = 0;
+        if (intraStart) {
+            savedSkip   = mVideoCodecCtx->skip_frame;
+            savedFlags2 = mVideoCodecCtx->flags2;
+            mVideoCodecCtx->skip_frame = AVDISCARD_NONINTRA;
+            mVideoCodecCtx->flags2    |= AV_CODEC_FLAG2_SHOW_ALL;
+        }
+        const bool decoded = decodeKeyframeAU(keyAU);
+        if (intraStart) {
+            mVideoCodecCtx->skip_frame = savedSkip;
+            mVideoCodecCtx->flags2     = savedFlags2;
+        }
+        if (!decoded) return QImage();
+        frame = mDecodedFrame;
         mCurrentFrameIndex = keyDisplay;
         mDecoderFrameIndex = keyDisplay;
     }
-    return result;
+    return scaleFrameToImage(frame, size, grayscale);
+}
+
+// One swscale pass from the decoder's planes to the output image. SWS_AREA:
+// thumbnails shrink by 5-10x, where bilinear would alias.
+QImage TTFFmpegWrapper::scaleFrameToImage(const AVFrame* frame, const QSize& size, bool grayscale)
+{
+    if (!frame || frame->width <= 0 || frame->height <= 0) return QImage();
+
+    int outW = size.width()  > 0 ? size.width()  : frame->width;
+    int outH = size.height() > 0 ? size.height() : frame->height;
+    if (size.width() > 0 && size.height() <= 0)
+        outH = qMax(1, qRound(double(frame->height) * outW / frame->width));
+
+    QImage image(outW, outH, grayscale ? QImage::Format_Grayscale8 : QImage::Format_RGB32);
+    if (image.isNull()) return QImage();
+
+    // AV_PIX_FMT_RGB32 is native-endian 0xAARRGGBB - QImage::Format_RGB32
+    const AVPixelFormat dstFmt = grayscale ? AV_PIX_FMT_GRAY8 : AV_PIX_FMT_RGB32;
+    mSwsCtxReduced = sws_getCachedContext(mSwsCtxReduced,
+        frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+        outW, outH, dstFmt, SWS_AREA, nullptr, nullptr, nullptr);
+    if (!mSwsCtxReduced) {
+        setError("Could not create scaler context");
+        return QImage();
+    }
+
+    if (grayscale) {
+        // Luma is stretched to full range like the RGB path's output, so
+        // thresholds written against swscale RGB (black == 0) still hold
+        const int srcRange = (frame->color_range == AVCOL_RANGE_JPEG) ? 1 : 0;
+        const int* coeffs = sws_getCoefficients(SWS_CS_DEFAULT);
+        sws_setColorspaceDetails(mSwsCtxReduced, coeffs, srcRange, coeffs, 1,
+                                 0, 1 << 16, 1 << 16);
+    }
+
+    uint8_t* dst[4]       = { image.bits(), nullptr, nullptr, nullptr };
+    int      dstStride[4] = { int(image.bytesPerLine()), 0, 0, 0 };
+    if (sws_scale(mSwsCtxReduced, frame->data, frame->linesize, 0, frame->height,
+                  dst, dstStride) <= 0)
+        return QImage();
+    return image;
 }
 
 // ----------------------------------------------------------------------------
@@ -1593,7 +1944,6 @@ bool TTFFmpegWrapper::skipCurrentFrame()
 void TTFFmpegWrapper::clearFrameCache()
 {
     mFrameCache.clear();
-    mFrameCacheLRU.clear();
 }
 
 // ----------------------------------------------------------------------------
@@ -2592,6 +2942,7 @@ bool TTFFmpegWrapper::setupIndexingPass(int videoStreamIndex)
     mIsPAFF = false;
     mRawPacketCount = 0;
     mRawToMerged.clear();
+    mPreviewRunTag = -1;
 
     // For raw ES files, seek to byte 0 instead of using av_seek_frame.
     // av_seek_frame doesn't work well with raw h264/hevc demuxers.
@@ -2627,6 +2978,7 @@ bool TTFFmpegWrapper::setupIndexingPass(int videoStreamIndex)
 // ----------------------------------------------------------------------------
 void TTFFmpegWrapper::rewindContext(int videoStreamIndex)
 {
+    mPreviewRunTag = -1;
     QString suffix = QFileInfo(QString::fromUtf8(mFormatCtx->url)).suffix().toLower();
     bool isES = (suffix == "264" || suffix == "h264" ||
                  suffix == "265" || suffix == "h265" || suffix == "hevc" ||
@@ -2698,49 +3050,16 @@ void TTFFmpegWrapper::scanPacketsIntoRawIndex(int videoStreamIndex)
 
     while (av_read_frame(mFormatCtx, packet) >= 0) {
         if (packet->stream_index == videoStreamIndex) {
-            TTFrameInfo info;
+            TTFrameInfo info = rawFrameInfo(packet->data, packet->size,
+                                            (packet->flags & AV_PKT_FLAG_KEY) != 0,
+                                            codecId, leadingClassifier);
             info.pts        = packet->pts;
             info.dts        = packet->dts;
             info.fileOffset = packet->pos;
             info.packetSize = packet->size;
-            info.isKeyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
-            info.frameIndex = -1;       // filled by finalizeFrameIndex
-            info.gopIndex   = -1;       // filled by finalizeFrameIndex
-            info.isFieldCoded = false;  // may be set true below
-
-            if (collectPoc) {
-                info.isIDR = TTPocCollector::packetIsIDR(packet->data, packet->size, codecId);
-                info.isDroppedLeading = leadingClassifier.classifyPacket(packet->data, packet->size);
-                pocCollector.feedPacket(packet->data, packet->size);
-            }
-
-            // Field detection (H.264 PAFF only)
-            if (codecId == AV_CODEC_ID_H264 && !mH264FrameMbsOnlyFlag) {
-                TTFieldInfo fi = parseH264FieldInfoFromPacket(packet->data, packet->size);
-                if (fi.isField) {
-                    mIsPAFF = true;
-                    info.isFieldCoded  = true;
-                    info.isBottomField = fi.isBottomField;
-                    info.paffFrameNum  = fi.frameNum;
-                }
-            }
 
-            // Frame type
-            if (info.isKeyframe) {
-                info.frameType = AV_PICTURE_TYPE_I;
-            } else if (codecId == AV_CODEC_ID_H264) {
-                int slice = TTNaluParser::parseH264SliceTypeFromPacket(packet->data, packet->size);
-                info.frameType = (slice == H264::SLICE_B) ? AV_PICTURE_TYPE_B
-                               : (slice == H264::SLICE_I) ? AV_PICTURE_TYPE_I
-                                                          : AV_PICTURE_TYPE_P;
-            } else if (codecId == AV_CODEC_ID_HEVC) {
-                int slice = TTNaluParser::parseH265SliceTypeFromPacket(packet->data, packet->size);
-                info.frameType = (slice == H265::SLICE_B) ? AV_PICTURE_TYPE_B
-                               : (slice == H265::SLICE_I) ? AV_PICTURE_TYPE_I
-                                                          : AV_PICTURE_TYPE_P;
-            } else {
-                info.frameType = AV_PICTURE_TYPE_P;
-            }
+            if (collectPoc)
+                pocCollector.feedPacket(packet->data, packet->size);
 
             mFrameIndex.append(info);
             rawCount++;
@@ -2787,6 +3106,163 @@ void TTFFmpegWrapper::scanPacketsIntoRawIndex(int videoStreamIndex)
     av_packet_free(&packet);
 }
 
+// ----------------------------------------------------------------------------
+// Per-packet classification shared by both scans
+// ----------------------------------------------------------------------------
+TTFrameInfo TTFFmpegWrapper::rawFrameInfo(const uint8_t* data, int size, bool isKeyframe,
+                                          int codecId, TTLeadingPicClassifier& leading)
+{
+    TTFrameInfo info;
+    info.isKeyframe   = isKeyframe;
+    info.frameIndex   = -1;       // filled by finalizeFrameIndex
+    info.gopIndex     = -1;       // filled by finalizeFrameIndex
+    info.isFieldCoded = false;    // may be set true below
+
+    if (codecId == AV_CODEC_ID_H264 || codecId == AV_CODEC_ID_HEVC) {
+        info.isIDR = TTPocCollector::packetIsIDR(data, size, codecId);
+        info.isDroppedLeading = leading.classifyPacket(data, size);
+    }
+
+    // Field detection (H.264 PAFF only)
+    if (codecId == AV_CODEC_ID_H264 && !mH264FrameMbsOnlyFlag) {
+        TTFieldInfo fi = parseH264FieldInfoFromPacket(data, size);
+        if (fi.isField) {
+            mIsPAFF = true;
+            info.isFieldCoded  = true;
+            info.isBottomField = fi.isBottomField;
+            info.paffFrameNum  = fi.frameNum;
+        }
+    }
+
+    // Frame type
+    if (info.isKeyframe) {
+        info.frameType = AV_PICTURE_TYPE_I;
+    } else if (codecId == AV_CODEC_ID_H264) {
+        int slice = TTNaluParser::parseH264SliceTypeFromPacket(data, size);
+        info.frameType = (slice == H264::SLICE_B) ? AV_PICTURE_TYPE_B
+                       : (slice == H264::SLICE_I) ? AV_PICTURE_TYPE_I
+                                                  : AV_PICTURE_TYPE_P;
+    } else if (codecId == AV_CODEC_ID_HEVC) {
+        int slice = TTNaluParser::parseH265SliceTypeFromPacket(data, size);
+        info.frameType = (slice == H265::SLICE_B) ? AV_PICTURE_TYPE_B
+                       : (slice == H265::SLICE_I) ? AV_PICTURE_TYPE_I
+                                                  : AV_PICTURE_TYPE_P;
+    } else {
+        info.frameType = AV_PICTURE_TYPE_P;
+    }
+
+    return info;
+}
+
+// ----------------------------------------------------------------------------
+// Mapped scan (H.26x ES): libav's codec parser over the mapping
+// ----------------------------------------------------------------------------
+bool TTFFmpegWrapper::scanMappedStreamIntoRawIndex(int videoStreamIndex)
+{
+    const AVCodecID codecId = mFormatCtx->streams[videoStreamIndex]->codecpar->codec_id;
+    if (!mIsElementaryStream || (codecId != AV_CODEC_ID_H264 && codecId != AV_CODEC_ID_HEVC))
+        return false;
+
+    QFile file(QString::fromUtf8(mFormatCtx->url));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const int64_t fileSize = file.size();
+    const uchar* data = (fileSize > 0) ? file.map(0, fileSize) : nullptr;
+    if (!data) return false;
+
+    // The raw demuxer feeds this very parser; its emissions are the packets
+    // av_read_frame would return (same split, same key flag, same POC).
+    const AVCodec* codec = avcodec_find_decoder(codecId);
+    AVCodecContext* ctx = codec ? avcodec_alloc_context3(codec) : nullptr;
+    AVCodecParserContext* parser = ctx ? av_parser_init(codecId) : nullptr;
+    if (!parser) {
+        if (ctx) avcodec_free_context(&ctx);
+        file.unmap(const_cast<uchar*>(data));
+        return false;
+    }
+
+    if (TTSettings::instance()->logFFmpegDecoder())
+        qDebug() << "Building frame index for stream" << videoStreamIndex
+                 << "from the mapped file (" << fileSize << "bytes)";
+
+    TTLeadingPicClassifier leadingClassifier(codecId);
+
+    // av_parser_parse2() may read AV_INPUT_BUFFER_PADDING_SIZE bytes past
+    // the input: interior chunks have the following file bytes there, the
+    // last one is copied into a zero-padded buffer.
+    const int64_t chunkSize = 1 << 20;
+    QByteArray tail;
+    int64_t pos = 0;
+    int64_t lastProgress = -1;
+    bool ok = true;
+
+    auto takeEmission = [&](const uint8_t* out, int outSize) {
+        const bool key = parser->key_frame == 1 ||
+                         (parser->key_frame == -1 && parser->pict_type == AV_PICTURE_TYPE_I);
+        TTFrameInfo info = rawFrameInfo(out, outSize, key, codecId, leadingClassifier);
+        info.pts        = AV_NOPTS_VALUE;   // raw ES: assignPtsFromFrameRate()
+        info.dts        = AV_NOPTS_VALUE;
+        info.fileOffset = parser->frame_offset;
+        info.packetSize = outSize;
+        info.poc        = parser->output_picture_number;
+        mFrameIndex.append(info);
+    };
+
+    while (pos < fileSize) {
+        const int bufSize = static_cast<int>(qMin<int64_t>(chunkSize, fileSize - pos));
+        const uint8_t* buf = data + pos;
+        if (pos + bufSize + AV_INPUT_BUFFER_PADDING_SIZE > fileSize) {
+            tail = QByteArray(reinterpret_cast<const char*>(buf), bufSize);
+            tail.append(QByteArray(AV_INPUT_BUFFER_PADDING_SIZE, '\0'));
+            buf = reinterpret_cast<const uint8_t*>(tail.constData());
+        }
+
+        int offset = 0;
+        while (offset < bufSize) {
+            uint8_t* out = nullptr;
+            int outSize = 0;
+            const int used = av_parser_parse2(parser, ctx, &out, &outSize,
+                                              buf + offset, bufSize - offset,
+                                              AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
+            if (outSize > 0) takeEmission(out, outSize);
+            if (used < 0 || (used == 0 && outSize == 0)) { ok = false; break; }
+            offset += used;
+        }
+        if (!ok) break;
+        pos += bufSize;
+
+        const int64_t progress = (pos * 100) / fileSize;
+        if (progress != lastProgress) {
+            emit progressChanged(static_cast<int>(progress),
+                tr("Indexing frame %1...").arg(mFrameIndex.size()));
+            lastProgress = progress;
+        }
+    }
+
+    // Flush: the parser holds the last access unit until EOF
+    while (ok) {
+        uint8_t* out = nullptr;
+        int outSize = 0;
+        av_parser_parse2(parser, ctx, &out, &outSize, nullptr, 0,
+                         AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
+        if (outSize <= 0) break;
+        takeEmission(out, outSize);
+    }
+
+    av_parser_close(parser);
+    avcodec_free_context(&ctx);
+    file.unmap(const_cast<uchar*>(data));
+
+    if (!ok) {
+        // Parser stalled: discard and let the demuxer scan do the work
+        TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+            QString("Mapped index scan stalled at byte %1 - falling back to packet scan").arg(pos));
+        mFrameIndex.clear();
+        mIsPAFF = false;
+        return false;
+    }
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // PAFF post-processing: collapse adjacent top+bottom field pairs in-place
 // ----------------------------------------------------------------------------
@@ -2881,6 +3357,68 @@ void TTFFmpegWrapper::buildDisplayOrderMap()
     if (!mDisplayOrderMap.isValid()) identity("rank validation failed");
 }
 
+// ----------------------------------------------------------------------------
+// Index sidecar (elementary streams only)
+// ----------------------------------------------------------------------------
+static const uint32_t kFrameIndexTag  = TTStreamIndexCache::tag("FRMI");
+static const uint32_t kFrameMetaTag   = TTStreamIndexCache::tag("FMET");
+static const uint32_t kRawToMergedTag = TTStreamIndexCache::tag("FRAW");
+static const uint32_t kFrameRanksTag  = TTStreamIndexCache::tag("FDOR");
+
+// FMET layout: record size guards against a TTFrameInfo layout change
+// without a sidecar format bump.
+enum { kMetaRecordSize, kMetaStreamIndex, kMetaRawCount, kMetaIsPAFF, kMetaCount };
+
+bool TTFFmpegWrapper::loadFrameIndexCache(int videoStreamIndex)
+{
+    if (!mIsElementaryStream) return false;
+
+    TTStreamIndexCache cache(QString::fromUtf8(mFormatCtx->url));
+    if (!cache.load()) return false;
+
+    QVector<int32_t> meta;
+    QList<TTFrameInfo> frames;
+    QVector<int> rawToMerged;
+    QVector<int> ranks;
+    if (!cache.readArray(kFrameMetaTag, meta) || meta.size() != kMetaCount
+        || meta[kMetaRecordSize] != int32_t(sizeof(TTFrameInfo))
+        || meta[kMetaStreamIndex] != videoStreamIndex
+        || !cache.readArray(kFrameIndexTag, frames)
+        || !cache.readArray(kRawToMergedTag, rawToMerged)
+        || !cache.readArray(kFrameRanksTag, ranks)
+        || frames.isEmpty())
+        return false;
+
+    mFrameIndex     = frames;
+    mIsPAFF         = meta[kMetaIsPAFF] != 0;
+    mRawPacketCount = meta[kMetaRawCount];
+    mRawToMerged    = rawToMerged;
+    mDisplayOrderMap.buildFromRanks(ranks);
+
+    if (TTSettings::instance()->logFFmpegDecoder())
+        qDebug() << "Frame index loaded from index sidecar:" << mFrameIndex.size() << "frames";
+    return true;
+}
+
+void TTFFmpegWrapper::storeFrameIndexCache(int videoStreamIndex)
+{
+    if (!mIsElementaryStream || mFrameIndex.isEmpty() || !TTStreamIndexCache::isEnabled())
+        return;
+
+    QVector<int32_t> meta(kMetaCount);
+    meta[kMetaRecordSize]  = int32_t(sizeof(TTFrameInfo));
+    meta[kMetaStreamIndex] = videoStreamIndex;
+    meta[kMetaRawCount]    = mRawPacketCount;
+    meta[kMetaIsPAFF]      = mIsPAFF ? 1 : 0;
+
+    TTStreamIndexCache cache(QString::fromUtf8(mFormatCtx->url));
+    cache.setArray(kFrameMetaTag, meta);
+    cache.setArray(kFrameIndexTag, mFrameIndex);
+    cache.setArray(kRawToMergedTag, mRawToMerged);
+    cache.setArray(kFrameRanksTag, mDisplayOrderMap.decodeToDisplayRanks());
+    cache.save();
+}
+
 void TTFFmpegWrapper::setFrameIndex(const QList<TTFrameInfo>& index)
 {
     mFrameIndex = index;
@@ -16,6 +16,7 @@
 #ifndef TTFFMPEGWRAPPER_H
 #define TTFFMPEGWRAPPER_H
 
+#include <atomic>
 #include <climits>
 #include <functional>
 #include <QString>
@@ -26,7 +27,9 @@
 #include <QImage>
 
 #include "../avstream/ttdisplayordermap.h"
+#include "../avstream/ttnaluparser.h"
 #include "ttaudiorepair.h"
+#include "ttdecodedframecache.h"
 
 #include "../mpeg2decoder/ttmpeg2decoder.h"
 
@@ -38,6 +41,7 @@ struct AVPacket;
 struct AVFrame;
 struct AVInputFormat;
 struct SwsContext;
+class QThreadPool;
 
 // ----------------------------------------------------------------------------
 // Stream information structure
@@ -157,6 +161,20 @@ public:
     // Open/close media file
     void setAnalysisMode(bool enabled) { mAnalysisMode = enabled; }
     void setSearchMode(bool enabled) { mSearchMode = enabled; }
+    // Decoder threads outside analysis mode, applied by openFile(): 1 =
+    // single-threaded (default), 0 = one per core, n = n. Anything but 1
+    // enables frame threading - for the interactive preview, where a seek
+    // with prefill decodes up to two GOPs per request.
+    void setDecodeThreads(int count) { mDecodeThreads = count; }
+    // Reduced decode profile, applied by openFile(), for thumbnails and
+    // keyframe scans through decodeKeyframeReduced(): intra pictures only
+    // (P/B packets are discarded unparsed), no deblocking, slice threads.
+    // Exact frame access (decodeFrame & co.) is meaningless on such a wrapper.
+    void setReducedDecode(bool enabled) { mReducedDecode = enabled; }
+    // H.26x ES: index from the mapped parser scan (default) or, when off,
+    // through the demuxer scan that stays the fallback. Diagnostics: builds
+    // both indexes of one stream for comparison.
+    void setMappedIndexScan(bool enabled) { mMappedIndexScan = enabled; }
     bool openFile(const QString& filePath);
     void closeFile();
     bool isOpen() const { return mFormatCtx != nullptr; }
@@ -172,8 +190,12 @@ public:
 
     // Detect container type (used by Smart Cut)
 
-    // Build frame index (for H.264/H.265)
-    bool buildFrameIndex(int videoStreamIndex = -1);
+    // Build frame index (for H.264/H.265). withNaluIndex: an H.26x ES also
+    // gets its NAL/AU index (naluIndex(), for TTESSmartCut) from a parse on
+    // a worker alongside - only the cut path's stream open asks for it.
+    bool buildFrameIndex(int videoStreamIndex = -1, bool withNaluIndex = false);
+    // Polled by that NAL parse; true stops it (naluIndex() stays empty)
+    void setIndexAbortCallback(std::function<bool()> cb) { mIndexAbortCallback = std::move(cb); }
     const QList<TTFrameInfo>& frameIndex() const { return mFrameIndex; }
     void setFrameIndex(const QList<TTFrameInfo>& index);   // rebuilds display map
     const TTDisplayOrderMap& displayOrderMap() const { return mDisplayOrderMap; }
@@ -182,6 +204,12 @@ public:
     int h264Log2MaxFrameNum() const { return mH264Log2MaxFrameNum; }
     bool h264FrameMbsOnlyFlag() const { return mH264FrameMbsOnlyFlag; }
 
+    // NAL/AU/GOP index of an H.26x elementary stream, built by
+    // buildFrameIndex() from the same mapping as the frame index. Handed to
+    // TTESSmartCut::setNaluIndex() so the cutter does not rescan the file.
+    // Empty for containers, MPEG-2 and wrappers that adopted an index.
+    const TTNaluIndex& naluIndex() const { return mNaluIndex; }
+
     // Sample aspect ratio (SAR) of the video stream as width/height factor.
     // Codec context first (populated once a frame was decoded), stream
     // codecpar as fallback; 1.0 when unset/invalid.
@@ -250,6 +278,16 @@ public:
     // position of the frame actually delivered.
     QImage decodeNearestKeyframe(int displayPos, int* shownDisplayPos);
 
+    // The picture at displayPos if it is an intra picture (any I, as the
+    // index list counts them), else the keyframe before it, scaled from its
+    // YUV planes straight to the output size in one swscale pass - no
+    // full-size RGB image, no QImage::scaled(). RGB32, or Grayscale8 (full-range luma, black == 0 as
+    // in the RGB path) when grayscale is set. size: a zero height keeps the
+    // frame's storage proportions, an empty size the frame's size. Meant for
+    // a setReducedDecode() wrapper, works on any.
+    QImage decodeKeyframeReduced(int displayPos, const QSize& size, bool grayscale,
+                                 int* shownDisplayPos = nullptr);
+
     /**
      * Decode a frame and expose its YUV420P planes via TFrameInfo.
      *
@@ -268,9 +306,16 @@ public:
      */
     bool decodeFrameYUV(int frameIndex, TFrameInfo& outInfo);
 
+    // decodeFrame() without the RGB conversion: the preview frame (cache,
+    // run continuation, prefetch, deliveredDecodeIndex - all as there) as
+    // tight-packed 8-bit YUV420P in decodeFrameYUV()'s buffers. For a
+    // display that converts and scales on the GPU (TTYuvVideoWidget).
+    bool decodePreviewFrameYUV(int displayPos, TFrameInfo& outInfo);
+
     // Convert the already-decoded mDecodedFrame to a QImage (lazy-inits
     // mRgbFrame/mSwsCtx + sws_scale). Does NOT read or decode a packet.
     QImage convertDecodedFrameToImage();
+    QImage convertFrameToImage(const AVFrame* frame);
     bool skipCurrentFrame();
 
     // Lightweight black frame check (no RGB conversion, no QImage)
@@ -281,8 +326,30 @@ public:
     // Build luma histogram for a single frame (for cached scene change search)
     bool buildHistogram(int frameIndex, int hist[256], int& totalPixels);
 
-    // Frame cache management
+    // Frame cache management. decodeFrame() keeps every frame of its
+    // seek+skip run as decoded YUV (see TTDecodedFrameCache); the budget
+    // bounds frames plus their converted images. 0 disables the cache.
     void clearFrameCache();
+    void setFrameCacheBudget(qint64 bytes) { mFrameCache.setBudget(bytes); }
+    const TTDecodedFrameCache& frameCache() const { return mFrameCache; }
+
+    // Backward stepping / reverse playback. After a step back to displayPos,
+    // startBackwardPrefetch() decodes the frames displayed just before the
+    // cached run around it - the preceding GOP - on a second decoder
+    // instance in the background, RGB conversion included. decodeFrame()
+    // moves finished frames into the cache, and waits for a job that is
+    // still decoding the requested frame instead of decoding it twice.
+    // No-op while a job runs or when the gap is more than a GOP away.
+    void startBackwardPrefetch(int displayPos);
+    void cancelBackwardPrefetch();
+
+    // Asynchronous preview (TTFrameDecodeThread). decodesWithoutSeek() says
+    // decodeFrame(displayPos) will be quick: the frame is cached, a finished
+    // prefetch holds it, or it continues the current run. While the decode
+    // abort is set, a decodeFrame() running on another thread returns a null
+    // image at its next output - the caller clears it before the next call.
+    bool decodesWithoutSeek(int displayPos);
+    void setDecodeAbort(bool abort) { mDecodeAbort = abort; }
 
     // Audio ES cutting - time-based stream-copy (ms-accurate)
     // If normalizeAcmod is true and targetAcmods is provided, frames with wrong acmod
@@ -365,6 +432,10 @@ private:
     bool mIsElementaryStream;   // Cached: true if file is raw ES (byte-seeking)
     bool mAnalysisMode;         // True: use multi-threaded decoding for analysis
     bool mSearchMode;           // True: skip DPB prefill in seekToFrame (I-frame-only access)
+    int  mDecodeThreads = 1;    // see setDecodeThreads()
+    bool mReducedDecode = false;  // see setReducedDecode()
+    bool mMappedIndexScan = true; // see setMappedIndexScan()
+    SwsContext* mSwsCtxReduced = nullptr;  // decodeKeyframeReduced(), cached per geometry
 
     // YUV-plane tight-packed buffers for decodeFrameYUV()
     quint8* mYBuffer = nullptr;       // size = mYUVBufferWidth * mYUVBufferHeight
@@ -419,6 +490,19 @@ private:
     // Emits progressChanged.
     void scanPacketsIntoRawIndex(int videoStreamIndex);
 
+    // One raw index entry from a packet's payload: IDR / dropped-leading
+    // classification, PAFF field info and frame type. pts/dts, offset and
+    // size are the caller's. Shared by both scans below.
+    TTFrameInfo rawFrameInfo(const uint8_t* data, int size, bool isKeyframe,
+                             int codecId, TTLeadingPicClassifier& leading);
+
+    // H.26x elementary streams: the same per-packet work on the mapped file.
+    // libav's codec parser splits the mapping into exactly the packets the
+    // raw demuxer would return (offset, size, key flag, POC), without the
+    // demuxer's read + copy per packet. False (nothing appended) if the
+    // stream is not an H.26x ES or cannot be mapped -> use the packet scan.
+    bool scanMappedStreamIntoRawIndex(int videoStreamIndex);
+
     // PAFF post-processing: walk mFrameIndex, collapse adjacent
     // top+bottom field pairs (matching paffFrameNum) into a single entry
     // (top's fields + summed packetSize). No-op if !mIsPAFF. In-place.
@@ -428,8 +512,17 @@ private:
     // and frameIndex (= position) to every entry.
     void finalizeFrameIndex();
 
+    // Elementary streams: adopt / store the finished index (frame list,
+    // raw->merged map, display ranks) in the stream's .ttidx sidecar
+    // (TTStreamIndexCache). The stored index predates assignPtsFromFrameRate,
+    // so a changed .info frame rate still applies on the next open.
+    bool loadFrameIndexCache(int videoStreamIndex);
+    void storeFrameIndexCache(int videoStreamIndex);
+
     // Frame and GOP indices
     QList<TTFrameInfo> mFrameIndex;
+    TTNaluIndex mNaluIndex;
+    std::function<bool()> mIndexAbortCallback;
     QList<TTGOPInfo> mGOPIndex;
     TTDisplayOrderMap mDisplayOrderMap;
 
@@ -438,10 +531,46 @@ private:
     // missing or degenerate — identical to pre-map behavior.
     void buildDisplayOrderMap();
 
-    // LRU frame cache
-    QMap<int, QImage> mFrameCache;
-    QList<int> mFrameCacheLRU;  // Most recently used at back
-    int mFrameCacheMaxSize;
+    // Decoded preview frames by display position
+    TTDecodedFrameCache mFrameCache;
+    QImage cachedFrameImage(int displayPos);
+    const AVFrame* decodePreviewFrame(int frameIndex, QImage* image);
+    // decodeNearestKeyframe()/decodeKeyframeReduced(): locate the keyframe
+    // at/before a display position (the position itself if it is an intra
+    // AU and intraStart is set), and decode it into mDecodedFrame
+    void keyframeBefore(int displayPos, int& keyAU, int& keyDisplay,
+                        bool intraStart = false) const;
+    bool decodeKeyframeAU(int keyAU);
+    bool seekToAU(int seekKeyframe, int keyframeIndex, int seekFlags);
+    QImage scaleFrameToImage(const AVFrame* frame, const QSize& size, bool grayscale);
+    bool packFrameYUV(const AVFrame* frame, TFrameInfo& outInfo);
+
+    // decodeFrame()'s seek+skip run. Outputs with a decode-order tag >=
+    // mPreviewRunFloorTag and a display position >= mPreviewRunFloorDisplay
+    // decoded from a complete reference chain and go into mFrameCache.
+    // mPreviewRunTag is the tag of the run's last output while the decoder
+    // still holds the run (-1 once anything else seeks or reads packets), so
+    // a step forward continues the run instead of seeking.
+    int mPreviewRunTag = -1;
+    int mPreviewRunFloorTag = 0;
+    int mPreviewRunFloorDisplay = 0;
+    void startPreviewRun(int targetAU);
+    bool canContinuePreviewRun(int targetAU, int displayPos) const;
+    bool decodePreviewRunTo(int targetAU, int stopAfterDisplay);
+
+    // Backward prefetch: a second wrapper on the same file and index, run
+    // by a one-thread pool. The job decodes display positions
+    // [mPrefetchFirst, mPrefetchTarget]; mPrefetchReady (written by the job
+    // before it clears mPrefetchRunning) says its cache holds them.
+    // mDecodeAbort stops a decodeFrame() of that wrapper early.
+    TTFFmpegWrapper*  mPrefetchWrapper = nullptr;
+    QThreadPool*      mPrefetchPool    = nullptr;
+    std::atomic<bool> mPrefetchRunning{false};
+    bool              mPrefetchReady   = false;
+    int               mPrefetchFirst   = -1;
+    int               mPrefetchTarget  = -1;
+    std::atomic<bool> mDecodeAbort{false};
+    void collectBackwardPrefetch(int displayPos);
 
     // Error handling
     QString mLastError;
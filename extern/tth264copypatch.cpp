@@ -0,0 +1,313 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "tth264copypatch.h"
+
+#include "../avstream/ttstartcodescanner.h"
+
+#include <QFileDevice>
+#include <QVarLengthArray>
+
+#include <cerrno>
+#include <sys/uio.h>
+
+// Queue limits: one writev() takes at most 1024 vectors (UIO_MAXIOV), and
+// the volume bound keeps abort/progress granularity at the bulk path's 8 MB.
+static const int     kMaxSpans        = 1024;
+static const int64_t kMaxScratchBytes = 1LL * 1024 * 1024;
+static const int64_t kMaxPendingBytes = 8LL * 1024 * 1024;
+
+// RBSP bytes unescaped per slice before falling back to the whole NAL;
+// first_mb_in_slice, slice_type, pic_parameter_set_id and frame_num need
+// at most 13 of them.
+static const int kHeaderRbspBytes = 32;
+
+namespace {
+
+class TTSliceBits
+{
+public:
+    TTSliceBits(uint8_t* data, int size) : mData(data), mSizeBits(size * 8), mPos(0), mError(false) {}
+
+    bool error() const { return mError; }
+    int  pos() const { return mPos; }
+    void setPos(int pos) { mPos = pos; }
+
+    uint32_t bits(int n)
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < n; ++i) {
+            if (mPos >= mSizeBits) { mError = true; return 0; }
+            v = (v << 1) | ((mData[mPos >> 3] >> (7 - (mPos & 7))) & 1);
+            ++mPos;
+        }
+        return v;
+    }
+
+    uint32_t ue()
+    {
+        int zeros = 0;
+        while (!mError && bits(1) == 0)
+            if (++zeros > 31) { mError = true; return 0; }
+        if (mError) return 0;
+        return ((1u << zeros) - 1) + bits(zeros);
+    }
+
+    void put(uint32_t value, int n)
+    {
+        for (int i = n - 1; i >= 0; --i) {
+            const int byte = mPos >> 3;
+            const uint8_t mask = uint8_t(1 << (7 - (mPos & 7)));
+            if (value & (1u << i)) mData[byte] |= mask;
+            else                   mData[byte] &= uint8_t(~mask);
+            ++mPos;
+        }
+    }
+
+private:
+    uint8_t* mData;
+    int  mSizeBits;
+    int  mPos;
+    bool mError;
+};
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+TTH264CopyPatcher::TTH264CopyPatcher(int frameNumBitWidth, int frameNumDelta)
+    : mFrameNumBitWidth(frameNumBitWidth),
+      mFrameNumDelta(frameNumBitWidth > 0 ? frameNumDelta : 0),
+      mPendingBytes(0),
+      mPatchedSlices(0),
+      mRewrittenNals(0)
+{
+    mSpans.reserve(kMaxSpans);
+}
+
+// ----------------------------------------------------------------------------
+// Queue
+// ----------------------------------------------------------------------------
+void TTH264CopyPatcher::queueMapped(const uchar* data, int64_t size)
+{
+    if (size <= 0) return;
+    const char* p = reinterpret_cast<const char*>(data);
+    // Consecutive mapped spans coalesce: an unpatched run of AUs is one vector
+    if (!mSpans.isEmpty() && mSpans.last().mapped
+            && mSpans.last().mapped + mSpans.last().size == p) {
+        mSpans.last().size += size;
+    } else {
+        mSpans.append({ p, 0, size });
+    }
+    mPendingBytes += size;
+}
+
+void TTH264CopyPatcher::queueScratch(int64_t offset, int64_t size)
+{
+    if (size <= 0) return;
+    if (!mSpans.isEmpty() && !mSpans.last().mapped
+            && mSpans.last().scratchOffset + mSpans.last().size == offset) {
+        mSpans.last().size += size;
+    } else {
+        mSpans.append({ nullptr, offset, size });
+    }
+    mPendingBytes += size;
+}
+
+void TTH264CopyPatcher::addBytes(const QByteArray& data)
+{
+    const int64_t offset = mScratch.size();
+    mScratch.append(data);
+    queueScratch(offset, data.size());
+}
+
+void TTH264CopyPatcher::addMapped(const uchar* au, int64_t size)
+{
+    if (mFrameNumDelta == 0 || size < 4) {
+        queueMapped(au, size);
+        return;
+    }
+
+    int64_t queued = 0;   // bytes of au already queued
+    int64_t sc = TTStartCodeScanner::findPrefix(au, 0, size - 3);
+    while (sc >= 0) {
+        const int64_t body = sc + 3;
+        const int64_t next = (body < size - 3)
+            ? TTStartCodeScanner::findPrefix(au, body, size - 3) : -1;
+        int64_t bodyEnd = (next >= 0) ? next : size;
+        while (bodyEnd > body && au[bodyEnd - 1] == 0)
+            --bodyEnd;
+
+        const int nalType = (body < size) ? (au[body] & 0x1F) : -1;
+        if ((nalType == 1 || nalType == 5) && bodyEnd - body >= 3) {
+            const int64_t scratchAt = mScratch.size();
+            const int64_t replaced = patchSliceHeader(au + body, bodyEnd - body);
+            if (replaced > 0) {
+                queueMapped(au + queued, body - queued);
+                queueScratch(scratchAt, mScratch.size() - scratchAt);
+                queued = body + replaced;
+            }
+        }
+        sc = next;
+    }
+    queueMapped(au + queued, size - queued);
+}
+
+bool TTH264CopyPatcher::needsFlush() const
+{
+    return mSpans.size() >= kMaxSpans - 2
+        || mScratch.size() >= kMaxScratchBytes
+        || mPendingBytes >= kMaxPendingBytes;
+}
+
+// ----------------------------------------------------------------------------
+// Slice header: unescape a prefix, rewrite frame_num, re-escape the prefix up
+// to the first non-zero RBSP byte behind the field. Emulation prevention only
+// looks at runs of zero bytes, so the escaped tail after that byte is the
+// source's own. Appends the new prefix to mScratch and returns the number of
+// source bytes it replaces (0 = slice left untouched).
+// ----------------------------------------------------------------------------
+int64_t TTH264CopyPatcher::patchSliceHeader(const uchar* nal, int64_t size)
+{
+    for (int pass = 0; pass < 2; ++pass) {
+        const int64_t limit = (pass == 0) ? kHeaderRbspBytes : size;
+
+        // Unescape (00 00 03 -> 00 00); rawEnd[k] = source bytes behind rbsp[k].
+        // The header pass stays on the stack.
+        QVarLengthArray<uint8_t, kHeaderRbspBytes + 1> rbsp;
+        QVarLengthArray<int64_t, kHeaderRbspBytes + 1> rawEnd;
+        int64_t i = 0;
+        while (i < size && rbsp.size() < limit) {
+            if (i + 2 < size && nal[i] == 0 && nal[i + 1] == 0 && nal[i + 2] == 3) {
+                rbsp.append(0); rawEnd.append(i + 1);
+                rbsp.append(0); rawEnd.append(i + 3);
+                i += 3;
+            } else {
+                rbsp.append(nal[i]); rawEnd.append(i + 1);
+                ++i;
+            }
+        }
+        const bool wholeNal = (i >= size);
+
+        TTSliceBits bits(rbsp.data(), int(rbsp.size()));
+        bits.setPos(8);       // NAL header byte
+        bits.ue();            // first_mb_in_slice
+        bits.ue();            // slice_type
+        bits.ue();            // pic_parameter_set_id
+        const int frameNumPos = bits.pos();
+        const uint32_t frameNum = bits.bits(mFrameNumBitWidth);
+        if (bits.error()) {
+            if (wholeNal) return 0;   // truncated slice: leave it alone
+            continue;
+        }
+
+        const int maxFrameNum = 1 << mFrameNumBitWidth;
+        int newFrameNum = (int(frameNum) + mFrameNumDelta) % maxFrameNum;
+        if (newFrameNum < 0) newFrameNum += maxFrameNum;
+        if (uint32_t(newFrameNum) == frameNum) return 0;
+
+        // Split behind the first byte at or after frame_num's end that is
+        // non-zero both before and after the patch (the last frame_num byte
+        // is the only one that changes).
+        const int fieldEnd = (bits.pos() + 7) / 8;
+        const uint8_t lastBefore = rbsp[fieldEnd - 1];
+        bits.setPos(frameNumPos);
+        bits.put(uint32_t(newFrameNum), mFrameNumBitWidth);
+
+        int split = fieldEnd;
+        while (split <= rbsp.size()
+               && (rbsp[split - 1] == 0 || (split == fieldEnd && lastBefore == 0)))
+            ++split;
+        if (split > rbsp.size()) {
+            if (!wholeNal) continue;
+            split = int(rbsp.size());
+        }
+
+        // Re-escape rbsp[0, split)
+        const uint8_t* r = rbsp.constData();
+        for (int k = 0; k < split; ++k) {
+            if (k + 2 < split && r[k] == 0 && r[k + 1] == 0 && r[k + 2] <= 3) {
+                mScratch.append('\0');
+                mScratch.append('\0');
+                mScratch.append('\3');
+                ++k;
+            } else {
+                mScratch.append(char(r[k]));
+            }
+        }
+
+        ++mPatchedSlices;
+        if (pass == 1) ++mRewrittenNals;
+        return rawEnd[split - 1];
+    }
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Write the queue
+// ----------------------------------------------------------------------------
+bool TTH264CopyPatcher::flush(QIODevice& out)
+{
+    bool ok = true;
+    QFileDevice* file = qobject_cast<QFileDevice*>(&out);
+    const int fd = file ? file->handle() : -1;
+
+    if (!mSpans.isEmpty() && fd >= 0 && !file->flush()) {
+        // Qt's write buffer could not be emptied: the queue behind it would
+        // leave a hole, and writing it buffered would only defer the error
+        ok = false;
+    } else if (!mSpans.isEmpty() && fd >= 0) {
+        // The descriptor's offset is the device position once Qt's write
+        // buffer is empty; seek() afterwards re-syncs QFileDevice::pos().
+        const qint64 start = out.pos();
+        QVector<struct iovec> iov(mSpans.size());
+        for (int k = 0; k < mSpans.size(); ++k) {
+            const Span& s = mSpans[k];
+            iov[k].iov_base = const_cast<char*>(s.mapped ? s.mapped
+                                                         : mScratch.constData() + s.scratchOffset);
+            iov[k].iov_len  = size_t(s.size);
+        }
+
+        int first = 0;
+        qint64 written = 0;
+        while (first < iov.size()) {
+            const ssize_t n = ::writev(fd, iov.constData() + first,
+                                       qMin(int(iov.size()) - first, kMaxSpans));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                ok = false;
+                break;
+            }
+            // Partial write: skip the vectors written, trim the next one
+            written += n;
+            size_t left = size_t(n);
+            while (first < iov.size() && left >= iov[first].iov_len)
+                left -= iov[first++].iov_len;
+            if (left > 0) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                iov[first].iov_len -= left;
+            }
+        }
+        ok = out.seek(start + written) && ok;
+    } else {
+        for (const Span& s : mSpans) {
+            const char* p = s.mapped ? s.mapped : mScratch.constData() + s.scratchOffset;
+            if (out.write(p, s.size) != s.size) {
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    mSpans.clear();
+    mScratch.truncate(0);   // keeps the allocation for the next batch
+    mPendingBytes = 0;
+    return ok;
+}
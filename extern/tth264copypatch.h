@@ -0,0 +1,81 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTH264COPYPATCH
+// Stream-copy of mapped H.264 access units with frame_num rewritten in place.
+// Every smart-cut segment after the first carries a frame_num delta, so its
+// interior copy cannot use the bulk mmap write. Instead of copying each AU
+// into a buffer and re-escaping every slice NAL, the patcher re-encodes only
+// the first bytes of each slice header (up to the first non-zero RBSP byte
+// behind frame_num, where emulation prevention restarts) into a small scratch
+// buffer. The output of a run of AUs is then a list of spans - mapped source
+// bytes and scratch bytes - written with writev().
+//
+// For a stream with canonical emulation prevention the bytes are identical to
+// unescaping, patching and re-escaping the whole NAL.
+//
+// Bitstream-level only: no libav, no parser dependency. The caller keeps the
+// mapping alive until flush().
+
+#ifndef TTH264COPYPATCH_H
+#define TTH264COPYPATCH_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QVector>
+#include <cstdint>
+
+class TTH264CopyPatcher
+{
+public:
+    // frameNumBitWidth = log2_max_frame_num; frameNumDelta is added to every
+    // slice's frame_num modulo 2^frameNumBitWidth (0 = copy unchanged).
+    TTH264CopyPatcher(int frameNumBitWidth, int frameNumDelta);
+
+    // Queue one mapped access unit [au, au + size), slice headers patched
+    void addMapped(const uchar* au, int64_t size);
+    // Queue bytes patched elsewhere (copied into the scratch buffer)
+    void addBytes(const QByteArray& data);
+
+    // True once the queue should be written (span count, scratch or byte
+    // volume limit); the caller flushes then, and at the end of its run.
+    bool needsFlush() const;
+    int64_t pendingBytes() const { return mPendingBytes; }
+
+    // Write the queue to out and clear it. Uses writev() on a file's
+    // descriptor and re-syncs the device position; other devices (and files
+    // without a descriptor) are written span by span. False if any write
+    // fails, including the flush of the file's own write buffer; the queue
+    // is cleared either way and out's errorString() tells why.
+    bool flush(QIODevice& out);
+
+    int patchedSlices() const { return mPatchedSlices; }
+    int rewrittenNals() const { return mRewrittenNals; }   // of those: whole-NAL fallback
+
+private:
+    struct Span {
+        const char* mapped;       // nullptr: scratch span
+        int64_t scratchOffset;
+        int64_t size;
+    };
+
+    void queueMapped(const uchar* data, int64_t size);
+    void queueScratch(int64_t offset, int64_t size);
+    int64_t patchSliceHeader(const uchar* nal, int64_t size);
+
+    int mFrameNumBitWidth;
+    int mFrameNumDelta;
+    QVector<Span> mSpans;
+    QByteArray mScratch;
+    int64_t mPendingBytes;
+    int mPatchedSlices;
+    int mRewrittenNals;
+};
+
+#endif // TTH264COPYPATCH_H
@@ -15,6 +15,7 @@
 #include "ttmkvmergeprovider.h"
 #include "ttffmpegwrapper.h"
 #include "../avstream/ttnaluparser.h"
+#include "../avstream/ttstartcodescanner.h"
 #include "../common/ttmessagelogger.h"
 #include "../common/ttsettings.h"
 
@@ -245,6 +246,7 @@ void TTMkvMergeProvider::setTotalDurationMs(qint64 durationMs)
 // -----------------------------------------------------------------------------
 TTMkvMergeProvider::~TTMkvMergeProvider()
 {
+    abandonStreamMux();
 }
 
 // -----------------------------------------------------------------------------
@@ -290,6 +292,55 @@ void TTMkvMergeProvider::setAudioSyncOffset(int offsetMs)
             qDebug() << "TTMkvMergeProvider: audio sync offset" << offsetMs << "ms";
 }
 
+// -----------------------------------------------------------------------------
+// Title metadata from the output file name, "_cut" suffix stripped
+// -----------------------------------------------------------------------------
+static void setTitleFromOutputName(AVFormatContext* outCtx, const QString& outputFile)
+{
+    QString baseName = QFileInfo(outputFile).completeBaseName();
+    if (baseName.endsWith("_cut")) baseName.chop(4);
+    QString title = decodeVdrName(baseName);
+    if (!title.isEmpty()) {
+        av_dict_set(&outCtx->metadata, "title", title.toUtf8().constData(), 0);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Parameter-set NALs (H.264 SPS/PPS, H.265 VPS/SPS/PPS) in front of the first
+// VCL NAL of an Annex-B frame, with 4-byte start codes - the extradata libav's
+// parser extracts from the first packet of an ES.
+// -----------------------------------------------------------------------------
+static QByteArray leadingParameterSets(const QByteArray& frame, AVCodecID codec)
+{
+    static const char kStartCode[4] = { 0, 0, 0, 1 };
+    const uint8_t* d = reinterpret_cast<const uint8_t*>(frame.constData());
+    const int64_t size = frame.size();
+    QByteArray sets;
+    int64_t sc = (size > 3) ? TTStartCodeScanner::findPrefix(d, 0, size - 3) : -1;
+    while (sc >= 0) {
+        const int64_t body = sc + 3;
+        const int64_t next = (body < size - 3)
+            ? TTStartCodeScanner::findPrefix(d, body, size - 3) : -1;
+        int64_t bodyEnd = (next >= 0) ? next : size;
+        while (bodyEnd > body && d[bodyEnd - 1] == 0)
+            --bodyEnd;
+        if (bodyEnd > body) {
+            if (isVclNalByte(codec, d + body)) break;
+            const int type = (codec == AV_CODEC_ID_HEVC) ? (d[body] >> 1) & 0x3F
+                                                         : d[body] & 0x1F;
+            const bool isParameterSet = (codec == AV_CODEC_ID_HEVC)
+                ? (type >= H265::NAL_VPS && type <= H265::NAL_PPS)
+                : (type == H264::NAL_SPS || type == H264::NAL_PPS);
+            if (isParameterSet) {
+                sets.append(kStartCode, 4);
+                sets.append(frame.constData() + body, int(bodyEnd - body));
+            }
+        }
+        sc = next;
+    }
+    return sets;
+}
+
 // -----------------------------------------------------------------------------
 // Parse OGM chapter file and add chapters to output context
 // -----------------------------------------------------------------------------
@@ -873,12 +924,7 @@ bool TTMkvMergeProvider::mux(const QString& outputFile,
     }
 
     // Set title metadata from output filename, stripping "_cut" suffix
-    QString baseName = QFileInfo(outputFile).completeBaseName();
-    if (baseName.endsWith("_cut")) baseName.chop(4);
-    QString title = decodeVdrName(baseName);
-    if (!title.isEmpty()) {
-        av_dict_set(&outCtx->metadata, "title", title.toUtf8().constData(), 0);
-    }
+    setTitleFromOutputName(outCtx, outputFile);
 
     // Common cleanup lambda — every exit path goes through this.
     // Safe to call multiple times: avformat_close_input nulls its argument.
@@ -1176,6 +1222,324 @@ bool TTMkvMergeProvider::mux(const QString& outputFile,
     return true;
 }
 
+// -----------------------------------------------------------------------------
+// Stream mux session (TTESPacketSink)
+// The video frames come from TTESSmartCut in write order with their display
+// rank; audio and subtitles are read from their files and interleaved the
+// way mux() picks packets (lowest linear video time first).
+//
+// DTS: mux() lowers every DTS by the largest lead of the whole list, which
+// is unknown while streaming. A frame is held until kStreamDtsWindow later
+// frames have arrived instead, and gets dts = min(k, lowest rank among
+// itself and those frames): never above its pts, never below an earlier
+// frame's unless a rank leads its decode position by more than the window
+// (far beyond any B-pyramid; reported as an error).
+// -----------------------------------------------------------------------------
+static const int kStreamDtsWindow = 16;
+
+struct TTMkvMergeProvider::StreamMux
+{
+    struct Frame {
+        QByteArray data;
+        int rank;
+        bool keyframe;
+    };
+
+    QString outputFile;
+    AVFormatContext* outCtx = nullptr;
+    AVFormatContext* videoInCtx = nullptr;   // source ES probe, inputs[0].fmtCtx
+    QList<MuxInput> inputs;                  // [0] = video (never read)
+    int64_t videoDurationNs = 0;
+    bool headerWritten = false;
+    QList<Frame> window;                     // frames waiting for their DTS
+    int64_t lastDtsFrames = INT64_MIN;
+};
+
+bool TTMkvMergeProvider::beginStreamMux(const QString& outputFile,
+                                        const QString& sourceVideoFile,
+                                        const QStringList& audioFiles,
+                                        const QStringList& subtitleFiles)
+{
+    mWasAborted = false;
+    mStreamMuxUnsupported = false;
+    abandonStreamMux();
+
+    if (sourceVideoFile.isEmpty() || !QFile::exists(sourceVideoFile)) {
+        setError(QString("Video file not found: %1").arg(sourceVideoFile));
+        return false;
+    }
+
+    if (TTSettings::instance()->logMkvMux()) {
+        qDebug() << "TTMkvMergeProvider::beginStreamMux (libav matroska)";
+        qDebug() << "  Output:" << outputFile;
+        qDebug() << "  MKV mux: videoCodecId =" << avcodec_get_name(static_cast<AVCodecID>(mVideoCodecId));
+        qDebug() << "  Video parameters from:" << sourceVideoFile;
+    }
+
+    mStream = new StreamMux;
+    mStream->outputFile = outputFile;
+
+    int ret = 0;
+    mStream->videoInCtx = openInput(sourceVideoFile, ret);
+    if (!mStream->videoInCtx) {
+        setError(QString("Cannot open video: %1 (%2)")
+                     .arg(sourceVideoFile, avErrStr(ret)));
+        closeStreamMux(false);
+        return false;
+    }
+
+    ret = avformat_alloc_output_context2(&mStream->outCtx, nullptr, "matroska",
+                                          outputFile.toUtf8().constData());
+    if (ret < 0 || !mStream->outCtx) {
+        setError("Cannot create matroska output context");
+        closeStreamMux(false);
+        return false;
+    }
+    AVFormatContext* outCtx = mStream->outCtx;
+    setTitleFromOutputName(outCtx, outputFile);
+
+    MuxInput vin;
+    if (!setupVideoInput(outCtx, mStream->videoInCtx, vin, mStream->videoDurationNs)) {
+        if (vin.pkt) av_packet_free(&vin.pkt);
+        closeStreamMux(false);
+        return false;
+    }
+    mStream->inputs.append(vin);
+    if (!vin.assignPts) {
+        mStreamMuxUnsupported = true;
+        setError("Stream mux needs the video default duration");
+        closeStreamMux(false);
+        return false;
+    }
+
+    int nextOutIdx = 1;
+    addAudioInputs(outCtx, audioFiles, mAudioLanguages, nextOutIdx, mStream->inputs,
+                    mAudioSyncOffsetMs);
+    addSubtitleInputs(outCtx, subtitleFiles, nextOutIdx, mStream->inputs);
+
+    if (!mChapterFile.isEmpty() && QFile::exists(mChapterFile)) {
+        addChaptersFromFile(outCtx, mChapterFile, mTotalDurationMs);
+    }
+
+    if (!(outCtx->oformat->flags & AVFMT_NOFILE)) {
+        ret = avio_open(&outCtx->pb, outputFile.toUtf8().constData(),
+                         AVIO_FLAG_WRITE);
+        if (ret < 0) {
+            setError(QString("Cannot open output: %1").arg(avErrStr(ret)));
+            closeStreamMux(false);
+            return false;
+        }
+    }
+
+    for (int i = 1; i < mStream->inputs.size(); i++)
+        readNextPacket(mStream->inputs[i]);
+
+    if (TTSettings::instance()->logMkvMux())
+        qDebug() << "  Mode: stream mux, inputs=" << mStream->inputs.size();
+    return true;
+}
+
+// Codec private data from the first frame, then the header. The matroska
+// muxer may change the time base while writing it (see mux()).
+bool TTMkvMergeProvider::writeStreamHeader(const QByteArray& firstFrame)
+{
+    StreamMux& s = *mStream;
+    AVCodecParameters* par = s.outCtx->streams[0]->codecpar;
+    const QByteArray sets = leadingParameterSets(firstFrame, static_cast<AVCodecID>(mVideoCodecId));
+    if (!sets.isEmpty()) {
+        uint8_t* extradata = static_cast<uint8_t*>(
+            av_mallocz(sets.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (!extradata) {
+            setError("av_mallocz failed for video extradata");
+            return false;
+        }
+        memcpy(extradata, sets.constData(), sets.size());
+        av_freep(&par->extradata);
+        par->extradata = extradata;
+        par->extradata_size = sets.size();
+    }
+
+    int ret = avformat_write_header(s.outCtx, nullptr);
+    if (ret < 0) {
+        setError(QString("Cannot write header: %1").arg(avErrStr(ret)));
+        return false;
+    }
+    s.headerWritten = true;
+
+    MuxInput& v = s.inputs[0];
+    AVStream* videoOut = s.outCtx->streams[v.outIdx];
+    v.frameDur = av_rescale_q(s.videoDurationNs,
+        AVRational{1, 1000000000}, videoOut->time_base);
+    if (TTSettings::instance()->logMkvMux())
+        qDebug() << "  Video: frame duration" << s.videoDurationNs << "ns ="
+                 << v.frameDur << "tb-units, extradata" << sets.size() << "bytes";
+    return true;
+}
+
+bool TTMkvMergeProvider::writeAccessUnit(const QByteArray& data, int displayRank,
+                                         bool keyframe)
+{
+    if (!mStream) {
+        setError("writeAccessUnit without a stream mux session");
+        return false;
+    }
+    if (checkAbort()) return false;
+    if (!mStream->headerWritten && !writeStreamHeader(data)) return false;
+
+    mStream->window.append({ data, displayRank, keyframe });
+    if (mStream->window.size() > kStreamDtsWindow)
+        return writeStreamVideoPacket();
+    return true;
+}
+
+// Write the oldest frame of the DTS window, after the audio/subtitle packets
+// mux() would have written before it
+bool TTMkvMergeProvider::writeStreamVideoPacket()
+{
+    StreamMux& s = *mStream;
+    MuxInput& v = s.inputs[0];
+    const StreamMux::Frame frame = s.window.takeFirst();
+
+    int64_t dtsFrames = qMin<int64_t>(v.frameCount, frame.rank);
+    for (const StreamMux::Frame& later : s.window)
+        dtsFrames = qMin<int64_t>(dtsFrames, later.rank);
+    if (dtsFrames < s.lastDtsFrames) {
+        setError(QString("Video frame %1 displays more than %2 frames ahead of "
+                         "its decode position - DTS would go backwards")
+                     .arg(v.frameCount).arg(kStreamDtsWindow));
+        return false;
+    }
+    s.lastDtsFrames = dtsFrames;
+
+    if (!writeStreamInputs(getNormalizedPts(v, s.outCtx))) return false;
+
+    if (av_new_packet(v.pkt, frame.data.size()) < 0) {
+        setError("av_new_packet failed for stream mux video");
+        return false;
+    }
+    memcpy(v.pkt->data, frame.data.constData(), frame.data.size());
+    if (frame.keyframe) v.pkt->flags |= AV_PKT_FLAG_KEY;
+    v.pkt->pts = int64_t(frame.rank) * v.frameDur;
+    v.pkt->dts = dtsFrames * v.frameDur;
+    v.pkt->duration = v.frameDur;
+    if (v.syncMs != 0) {
+        int64_t off = av_rescale_q(v.syncMs, AVRational{1, 1000},
+                                   s.outCtx->streams[v.outIdx]->time_base);
+        v.pkt->pts += off;
+        v.pkt->dts += off;
+    }
+    v.pkt->stream_index = v.outIdx;
+    v.pkt->pos = -1;
+
+    int wfRet = av_interleaved_write_frame(s.outCtx, v.pkt);
+    if (wfRet < 0) {
+        setError(QString("av_interleaved_write_frame failed (stream mux): %1")
+                     .arg(avErrStr(wfRet)));
+        return false;
+    }
+    v.frameCount++;
+    return true;
+}
+
+// Audio/subtitle packets with a normalized PTS below beforePts, in PTS order
+bool TTMkvMergeProvider::writeStreamInputs(int64_t beforePts)
+{
+    StreamMux& s = *mStream;
+    while (true) {
+        int bestIdx = -1;
+        int64_t bestPts = INT64_MAX;
+        for (int i = 1; i < s.inputs.size(); i++) {
+            if (s.inputs[i].eof) continue;
+            int64_t npts = getNormalizedPts(s.inputs[i], s.outCtx);
+            if (npts < bestPts) {
+                bestPts = npts;
+                bestIdx = i;
+            }
+        }
+        if (bestIdx < 0 || bestPts >= beforePts) return true;
+
+        MuxInput& in = s.inputs[bestIdx];
+        av_packet_rescale_ts(in.pkt,
+            in.fmtCtx->streams[in.srcIdx]->time_base,
+            s.outCtx->streams[in.outIdx]->time_base);
+        if (in.syncMs != 0) {
+            int64_t off = av_rescale_q(in.syncMs, AVRational{1, 1000},
+                                       s.outCtx->streams[in.outIdx]->time_base);
+            in.pkt->pts += off;
+            in.pkt->dts += off;
+        }
+        in.pkt->stream_index = in.outIdx;
+        in.pkt->pos = -1;
+
+        int wfRet = av_interleaved_write_frame(s.outCtx, in.pkt);
+        if (wfRet < 0) {
+            setError(QString("av_interleaved_write_frame failed (stream mux): %1")
+                         .arg(avErrStr(wfRet)));
+            return false;
+        }
+        readNextPacket(in);
+    }
+}
+
+bool TTMkvMergeProvider::finishStreamMux()
+{
+    if (!mStream) {
+        setError("finishStreamMux without a stream mux session");
+        return false;
+    }
+    if (!mStream->headerWritten) {
+        setError("Stream mux received no video frames");
+        abandonStreamMux();
+        return false;
+    }
+
+    while (!mStream->window.isEmpty()) {
+        if (checkAbort() || !writeStreamVideoPacket()) {
+            abandonStreamMux();
+            return false;
+        }
+    }
+    if (!writeStreamInputs(INT64_MAX)) {
+        abandonStreamMux();
+        return false;
+    }
+
+    av_write_trailer(mStream->outCtx);
+
+    if (TTSettings::instance()->logMkvMux())
+        qDebug() << "TTMkvMergeProvider::finishStreamMux:" << mStream->inputs[0].frameCount
+                 << "video frames," << mStream->outputFile;
+    closeStreamMux(false);
+    return true;
+}
+
+void TTMkvMergeProvider::abandonStreamMux()
+{
+    if (mStream) closeStreamMux(true);
+}
+
+void TTMkvMergeProvider::closeStreamMux(bool removeOutput)
+{
+    StreamMux* s = mStream;
+    mStream = nullptr;
+    for (auto& mi : s->inputs) {
+        if (mi.pkt) av_packet_free(&mi.pkt);
+        if (mi.ownsCtx && mi.fmtCtx) avformat_close_input(&mi.fmtCtx);
+    }
+    avformat_close_input(&s->videoInCtx);
+    bool opened = false;
+    if (s->outCtx) {
+        if (!(s->outCtx->oformat->flags & AVFMT_NOFILE)) {
+            opened = s->outCtx->pb != nullptr;
+            avio_closep(&s->outCtx->pb);
+        }
+        avformat_free_context(s->outCtx);
+    }
+    if (removeOutput && opened)
+        QFile::remove(s->outputFile);
+    delete s;
+}
+
 // -----------------------------------------------------------------------------
 // Audio-only matroska output (.mka): copies all input audio streams into a
 // single matroska container with optional language tags. Stream-copy only.
@@ -23,6 +23,8 @@
 #include <QMap>
 #include <atomic>
 
+#include "ttespacketsink.h"
+
 // Libav forward decls — keep heavy headers out of this public header.
 struct AVFormatContext;
 struct AVPacket;
@@ -31,7 +33,7 @@ struct AVPacket;
 // TTMkvMergeProvider
 // MKV container output using libav matroska muxer (no external binary needed)
 // -----------------------------------------------------------------------------
-class TTMkvMergeProvider : public QObject
+class TTMkvMergeProvider : public QObject, public TTESPacketSink
 {
     Q_OBJECT
 
@@ -45,6 +47,30 @@ public:
              const QStringList& audioFiles,
              const QStringList& subtitleFiles = QStringList());
 
+    // Stream mux session: the video arrives frame by frame through
+    // writeAccessUnit (TTESSmartCut::setPacketSink) instead of as an ES file,
+    // so the cut video never touches the disk. sourceVideoFile (the uncut ES)
+    // only supplies the stream parameters; the options below must be set
+    // before beginStreamMux, and track 0 needs a default duration. The
+    // header is written with the first frame, whose parameter sets become
+    // the codec private data.
+    bool beginStreamMux(const QString& outputFile,
+                        const QString& sourceVideoFile,
+                        const QStringList& audioFiles,
+                        const QStringList& subtitleFiles = QStringList());
+    bool writeAccessUnit(const QByteArray& data, int displayRank,
+                         bool keyframe) override;
+    // Write the frames still in the DTS window, the remaining audio and
+    // subtitle packets and the trailer; ends the session.
+    bool finishStreamMux();
+    // End the session and delete the partial output (no-op without one)
+    void abandonStreamMux();
+    bool streamMuxActive() const { return mStream != nullptr; }
+    // beginStreamMux() failed because the stream cannot be muxed frame by
+    // frame (no default duration to derive timestamps from) - the ES path
+    // can still mux it. Any other failure is a real error.
+    bool streamMuxUnsupported() const { return mStreamMuxUnsupported; }
+
     // Audio-only matroska output (typically .mka): copies all given audio
     // streams into one matroska container with optional language tags.
     bool muxAudioOnly(const QString& outputFile,
@@ -115,6 +141,7 @@ private:
     // its own; mWasAborted is cleared at the top of mux()/muxAudioOnly().
     std::atomic<bool> mAbortRequested { false };
     bool mWasAborted = false;
+    bool mStreamMuxUnsupported = false;
     QString mChapterFile;
     int mAudioSyncOffsetMs;
     int mVideoSyncOffsetMs;
@@ -190,6 +217,15 @@ private:
     int64_t getNormalizedPts(const MuxInput& in,
                               const AVFormatContext* outCtx) const;
 
+    // Stream mux session state (defined in the .cpp, keeps libav out)
+    struct StreamMux;
+    StreamMux* mStream = nullptr;
+
+    bool writeStreamHeader(const QByteArray& firstFrame);
+    bool writeStreamVideoPacket();
+    bool writeStreamInputs(int64_t beforePts);
+    void closeStreamMux(bool removeOutput);
+
     void setError(const QString& error);
 
     // Poll point for cooperative abort (see mAbortRequested / mWasAborted).
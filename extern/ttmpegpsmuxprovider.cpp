@@ -0,0 +1,468 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// ----------------------------------------------------------------------------
+// TTMPEGPSMUXPROVIDER
+// ----------------------------------------------------------------------------
+
+#include "ttmpegpsmuxprovider.h"
+#include "ttmplexprovider.h"
+#include "ttmkvmergeprovider.h"
+#include "ttffmpegwrapper.h"
+
+#include "../common/ttmessagelogger.h"
+#include "../common/ttsettings.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/avutil.h>
+}
+
+// Packets written between two event-loop pumps: keeps the progress dialog and
+// the Cancel button responsive without a processEvents() per packet
+static const int kEventLoopInterval = 64;
+
+// ----------------------------------------------------------------------------
+// Helpers
+// ----------------------------------------------------------------------------
+static QString avErrStr(int errnum)
+{
+    char buf[AV_ERROR_MAX_STRING_SIZE];
+    av_strerror(errnum, buf, sizeof(buf));
+    return QString::fromUtf8(buf);
+}
+
+// Same detection as TTMkvMergeProvider's openInput(): ES by extension, with a
+// generous probe so the audio/video parameters are known before the header
+static AVFormatContext* openInput(const QString& filePath, int& ret)
+{
+    AVFormatContext* fmtCtx = nullptr;
+    AVDictionary* opts = nullptr;
+    const AVInputFormat* inputFmt = nullptr;
+
+    if (TTFFmpegWrapper::isElementaryStreamPath(filePath)) {
+        av_dict_set(&opts, "probesize", "50000000", 0);
+        av_dict_set(&opts, "analyzeduration", "10000000", 0);
+        inputFmt = TTFFmpegWrapper::esInputFormatForPath(filePath);
+    }
+
+    ret = avformat_open_input(&fmtCtx, filePath.toUtf8().constData(), inputFmt, &opts);
+    av_dict_free(&opts);
+    if (ret < 0)
+        return nullptr;
+
+    ret = avformat_find_stream_info(fmtCtx, nullptr);
+    if (ret < 0) {
+        avformat_close_input(&fmtCtx);
+        return nullptr;
+    }
+    return fmtCtx;
+}
+
+namespace {
+
+// One input of the interleaved write loop
+struct PsInput {
+    AVFormatContext* fmtCtx = nullptr;
+    int      srcIdx   = -1;
+    int      outIdx   = -1;
+    AVPacket* pkt     = nullptr;
+    bool     eof      = false;
+    int64_t  syncMs   = 0;
+    // Raw MPEG-2 ES video: the demuxer has no timestamps, they are assigned
+    // from the frame count and the display order (see assignVideoTimestamps)
+    bool     isVideo  = false;
+    int64_t  frameDur = 0;      // output time_base units
+    int64_t  frameCount = 0;
+    QVector<int> displayOrder;
+    int      reorderOffset = 0;
+    bool     displayOrderWarned = false;
+};
+
+bool readNextPacket(PsInput& in)
+{
+    while (av_read_frame(in.fmtCtx, in.pkt) >= 0) {
+        if (in.pkt->stream_index == in.srcIdx)
+            return true;
+        av_packet_unref(in.pkt);
+    }
+    in.eof = true;
+    return false;
+}
+
+// Decode time in AV_TIME_BASE of the packet waiting in in.pkt
+int64_t nextDts(const PsInput& in, const AVFormatContext* outCtx)
+{
+    int64_t ts = 0;
+    if (in.isVideo)
+        ts = av_rescale_q(in.frameCount * in.frameDur,
+                          outCtx->streams[in.outIdx]->time_base, AV_TIME_BASE_Q);
+    else if (in.pkt->dts != AV_NOPTS_VALUE)
+        ts = av_rescale_q(in.pkt->dts, in.fmtCtx->streams[in.srcIdx]->time_base, AV_TIME_BASE_Q);
+    else if (in.pkt->pts != AV_NOPTS_VALUE)
+        ts = av_rescale_q(in.pkt->pts, in.fmtCtx->streams[in.srcIdx]->time_base, AV_TIME_BASE_Q);
+    return ts + in.syncMs * 1000;
+}
+
+// pts = display position, dts = write position lowered by the largest
+// reorder lead - the TTMkvMergeProvider::assignEsTimestamps() rule, so an
+// .mpg and an .mkv of the same cut carry the same video timing
+void assignVideoTimestamps(PsInput& in)
+{
+    const int64_t linear = in.frameCount * in.frameDur;
+    in.pkt->pts = linear;
+    in.pkt->dts = linear;
+    if (!in.displayOrder.isEmpty()) {
+        if (in.frameCount < in.displayOrder.size()) {
+            in.pkt->pts = int64_t(in.displayOrder[int(in.frameCount)]) * in.frameDur;
+            in.pkt->dts = (in.frameCount - in.reorderOffset) * in.frameDur;
+        } else if (!in.displayOrderWarned) {
+            in.displayOrderWarned = true;
+            TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+                QString("display order exhausted at picture %1 of %2 - "
+                        "linear timestamps for the rest")
+                    .arg(in.frameCount).arg(in.displayOrder.size()));
+        }
+    }
+    in.pkt->duration = in.frameDur;
+    in.frameCount++;
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+TTMpegPsMuxProvider::TTMpegPsMuxProvider(TTMuxListData* muxListData)
+    : IStatusReporter(),
+      log(TTMessageLogger::getInstance()),
+      mpMuxList(muxListData),
+      mAudioSyncOffsetMs(0)
+{
+}
+
+TTMpegPsMuxProvider::~TTMpegPsMuxProvider()
+{
+}
+
+// The mux script is run after TTCut-ng has exited, so it cannot call back
+// into this process: it stays an mplex script
+void TTMpegPsMuxProvider::writeMuxScript()
+{
+    TTMplexProvider scriptWriter(mpMuxList);
+    scriptWriter.setAudioSyncOffset(mAudioSyncOffsetMs);
+    scriptWriter.writeMuxScript();
+}
+
+// ----------------------------------------------------------------------------
+// Mux one entry of the mux list into its .mpg
+// ----------------------------------------------------------------------------
+void TTMpegPsMuxProvider::mplexPart(int index)
+{
+    mWasAborted = false;
+    mSucceeded  = true;
+    mLastError.clear();
+
+    const QString     videoFile  = mpMuxList->videoFilePathAt(index);
+    const QStringList audioFiles = mpMuxList->audioFilePathsAt(index);
+    const QString     outputFile = TTMplexProvider::createOutputFilePath(videoFile);
+
+    emit statusReport(StatusReportArgs::ShowProcessForm, tr("Starting mux"), 0);
+    qApp->processEvents();
+
+    // The cancel can already have arrived in the processEvents() above (or
+    // been seeded by TTAVData before this call): nothing has been written yet
+    if (checkAbort()) {
+        emit statusReport(StatusReportArgs::HideProcessForm, tr("Mux cancelled"), 0);
+        qApp->processEvents();
+        return;
+    }
+
+    const bool ok = mux(outputFile, videoFile, audioFiles);
+
+    if (mWasAborted) {
+        // A cancel deletes what the run created; the cut elementary streams
+        // are removed by TTAVData::onCutFinished()'s abort block
+        if (QFile::exists(outputFile) && !QFile::remove(outputFile))
+            log->warningMsg(__FILE__, __LINE__,
+                QString("abort cleanup: could not remove %1").arg(outputFile));
+        else
+            log->debugMsg(__FILE__, __LINE__,
+                QString("Removed partial mux output %1").arg(outputFile));
+
+        emit statusReport(StatusReportArgs::HideProcessForm, tr("Mux cancelled"), 0);
+        qApp->processEvents();
+        return;
+    }
+
+    if (!ok) {
+        // A failed mux keeps its input (and the partial output) for diagnosis
+        mSucceeded = false;
+        log->errorMsg(__FILE__, __LINE__, QString("MPEG program stream mux failed: %1").arg(mLastError));
+        emit statusReport(StatusReportArgs::HideProcessForm, tr("Mux failed"), 0);
+        qApp->processEvents();
+        return;
+    }
+
+    if (TTSettings::instance()->workingMuxDeleteES())
+        deleteElementaryStreams(videoFile, audioFiles);
+
+    emit statusReport(StatusReportArgs::HideProcessForm, tr("Mux finished"), 0);
+    qApp->processEvents();
+}
+
+// ----------------------------------------------------------------------------
+// Interleaved ES -> program stream write
+// ----------------------------------------------------------------------------
+bool TTMpegPsMuxProvider::mux(const QString& outputFile, const QString& videoFile,
+                              const QStringList& audioFiles)
+{
+    const bool logMux = TTSettings::instance()->logPsMux();
+
+    int ret = 0;
+    AVFormatContext* videoCtx = openInput(videoFile, ret);
+    if (!videoCtx) {
+        setError(QString("Cannot open video %1: %2").arg(videoFile, avErrStr(ret)));
+        return false;
+    }
+
+    AVFormatContext* outCtx = nullptr;
+    ret = avformat_alloc_output_context2(&outCtx, nullptr, "dvd", outputFile.toUtf8().constData());
+    if (ret < 0 || !outCtx) {
+        avformat_close_input(&videoCtx);
+        setError(QString("Cannot create program stream output: %1").arg(avErrStr(ret)));
+        return false;
+    }
+
+    QList<PsInput> inputs;
+    auto cleanupAll = [&]() {
+        for (PsInput& in : inputs) {
+            if (in.pkt) av_packet_free(&in.pkt);
+            if (in.fmtCtx != videoCtx) avformat_close_input(&in.fmtCtx);
+        }
+        avformat_close_input(&videoCtx);
+        if (outCtx) {
+            if (!(outCtx->oformat->flags & AVFMT_NOFILE))
+                avio_closep(&outCtx->pb);
+            avformat_free_context(outCtx);
+            outCtx = nullptr;
+        }
+    };
+
+    // Video: stream 0
+    const int videoIdx = av_find_best_stream(videoCtx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    AVStream* videoOut = (videoIdx >= 0) ? avformat_new_stream(outCtx, nullptr) : nullptr;
+    if (!videoOut || avcodec_parameters_copy(videoOut->codecpar, videoCtx->streams[videoIdx]->codecpar) < 0) {
+        cleanupAll();
+        setError(QString("No usable video stream in %1").arg(videoFile));
+        return false;
+    }
+    videoOut->codecpar->codec_tag = 0;
+
+    const AVRational frameRate = av_guess_frame_rate(videoCtx, videoCtx->streams[videoIdx], nullptr);
+    if (frameRate.num <= 0 || frameRate.den <= 0) {
+        cleanupAll();
+        setError(QString("Unknown frame rate in %1").arg(videoFile));
+        return false;
+    }
+
+    PsInput vin;
+    vin.fmtCtx  = videoCtx;
+    vin.srcIdx  = videoIdx;
+    vin.outIdx  = 0;
+    vin.isVideo = true;
+    vin.pkt     = av_packet_alloc();
+    // temporal_reference per GOP; empty (field pictures, broken GOP) keeps
+    // linear timestamps
+    vin.displayOrder = TTMkvMergeProvider::buildMpeg2DisplayOrder(videoFile);
+    for (int i = 0; i < vin.displayOrder.size(); ++i)
+        vin.reorderOffset = qMax(vin.reorderOffset, i - vin.displayOrder[i]);
+    inputs.append(vin);
+
+    // Audio: one stream per readable file. The per-track delay is already in
+    // the cut audio; only the recording's A/V offset is applied here.
+    for (const QString& audioFile : audioFiles) {
+        AVFormatContext* audioCtx = openInput(audioFile, ret);
+        if (!audioCtx) {
+            log->warningMsg(__FILE__, __LINE__,
+                QString("Cannot open audio %1: %2 - not muxed").arg(audioFile, avErrStr(ret)));
+            continue;
+        }
+        const int audioIdx = av_find_best_stream(audioCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+        AVStream* audioOut = (audioIdx >= 0) ? avformat_new_stream(outCtx, nullptr) : nullptr;
+        if (!audioOut || avcodec_parameters_copy(audioOut->codecpar, audioCtx->streams[audioIdx]->codecpar) < 0) {
+            log->warningMsg(__FILE__, __LINE__,
+                QString("No usable audio stream in %1 - not muxed").arg(audioFile));
+            avformat_close_input(&audioCtx);
+            continue;
+        }
+        audioOut->codecpar->codec_tag = 0;
+
+        PsInput ain;
+        ain.fmtCtx = audioCtx;
+        ain.srcIdx = audioIdx;
+        ain.outIdx = audioOut->index;
+        ain.syncMs = mAudioSyncOffsetMs;
+        ain.pkt    = av_packet_alloc();
+        inputs.append(ain);
+    }
+
+    for (const PsInput& in : inputs) {
+        if (!in.pkt) {
+            cleanupAll();
+            setError("av_packet_alloc failed");
+            return false;
+        }
+    }
+
+    if (!(outCtx->oformat->flags & AVFMT_NOFILE)) {
+        ret = avio_open(&outCtx->pb, outputFile.toUtf8().constData(), AVIO_FLAG_WRITE);
+        if (ret < 0) {
+            cleanupAll();
+            setError(QString("Cannot open %1: %2").arg(outputFile, avErrStr(ret)));
+            return false;
+        }
+    }
+
+    ret = avformat_write_header(outCtx, nullptr);
+    if (ret < 0) {
+        cleanupAll();
+        setError(QString("Cannot write program stream header: %1").arg(avErrStr(ret)));
+        return false;
+    }
+
+    // After the header: the muxer has fixed its time base (90 kHz)
+    inputs[0].frameDur = av_rescale_q(1, av_inv_q(frameRate), outCtx->streams[0]->time_base);
+
+    if (logMux)
+        qDebug() << "TTMpegPsMuxProvider:" << outputFile << "video" << videoFile
+                 << "audio" << audioFiles << "display order" << inputs[0].displayOrder.size()
+                 << "reorderOffset" << inputs[0].reorderOffset
+                 << "frameDur" << inputs[0].frameDur;
+
+    emit statusReport(StatusReportArgs::AddProcessLine,
+                      tr("Multiplexing %1").arg(QFileInfo(outputFile).fileName()), 0);
+
+    for (PsInput& in : inputs)
+        readNextPacket(in);
+
+    const int64_t videoSize   = avio_size(videoCtx->pb);
+    int           lastPercent = 0;
+    int64_t       written     = 0;
+
+    forever {
+        if (checkAbort()) {
+            emit statusReport(StatusReportArgs::AddProcessLine,
+                              tr("Cancel requested - stopping the mux"), 0);
+            cleanupAll();
+            return false;
+        }
+
+        // Lowest decode time first
+        int     best    = -1;
+        int64_t bestDts = INT64_MAX;
+        for (int i = 0; i < inputs.size(); ++i) {
+            if (inputs[i].eof) continue;
+            const int64_t dts = nextDts(inputs[i], outCtx);
+            if (dts < bestDts) {
+                bestDts = dts;
+                best    = i;
+            }
+        }
+        if (best < 0) break;
+
+        PsInput& in = inputs[best];
+        if (in.isVideo)
+            assignVideoTimestamps(in);
+        else
+            av_packet_rescale_ts(in.pkt, in.fmtCtx->streams[in.srcIdx]->time_base,
+                                 outCtx->streams[in.outIdx]->time_base);
+
+        if (in.syncMs != 0) {
+            const int64_t off = av_rescale_q(in.syncMs, AVRational{1, 1000},
+                                             outCtx->streams[in.outIdx]->time_base);
+            if (in.pkt->pts != AV_NOPTS_VALUE) in.pkt->pts += off;
+            if (in.pkt->dts != AV_NOPTS_VALUE) in.pkt->dts += off;
+        }
+        in.pkt->stream_index = in.outIdx;
+        in.pkt->pos          = -1;
+
+        ret = av_interleaved_write_frame(outCtx, in.pkt);
+        if (ret < 0) {
+            cleanupAll();
+            setError(QString("Cannot write packet: %1").arg(avErrStr(ret)));
+            return false;
+        }
+        readNextPacket(in);
+
+        if (++written % kEventLoopInterval == 0) {
+            if (videoSize > 0) {
+                const int percent = int(avio_tell(videoCtx->pb) * 100 / videoSize);
+                if (percent >= lastPercent + 5) {
+                    lastPercent = percent;
+                    emit statusReport(StatusReportArgs::AddProcessLine,
+                                      tr("Multiplexing: %1%").arg(percent), percent);
+                }
+            }
+            qApp->processEvents();
+        }
+    }
+
+    const PsInput& v = inputs[0];
+    if (!v.displayOrder.isEmpty() && v.frameCount != v.displayOrder.size() && !v.displayOrderWarned)
+        log->warningMsg(__FILE__, __LINE__,
+            QString("display order has %1 entries for %2 written pictures")
+                .arg(v.displayOrder.size()).arg(v.frameCount));
+
+    ret = av_write_trailer(outCtx);
+    cleanupAll();
+    if (ret < 0) {
+        setError(QString("Cannot finish %1: %2").arg(outputFile, avErrStr(ret)));
+        return false;
+    }
+
+    if (logMux)
+        qDebug() << "TTMpegPsMuxProvider:" << written << "packets,"
+                 << QFileInfo(outputFile).size() << "bytes";
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Poll point for the cooperative abort. Idempotent.
+// ----------------------------------------------------------------------------
+bool TTMpegPsMuxProvider::checkAbort()
+{
+    if (!mAbortRequested.load(std::memory_order_relaxed)) return false;
+    mWasAborted = true;
+    return true;
+}
+
+void TTMpegPsMuxProvider::setError(const QString& msg)
+{
+    mLastError = msg;
+}
+
+//! Delete the elementary streams of a successful mux
+void TTMpegPsMuxProvider::deleteElementaryStreams(const QString& videoFilePath, const QStringList& audioFilePaths)
+{
+    QStringList files = audioFilePaths;
+    files.prepend(videoFilePath);
+
+    for (const QString& f : files) {
+        const bool success = QFile::remove(f);
+        log->debugMsg(__FILE__, __LINE__, QString("Removing elementary stream %1 (%2)")
+                .arg(f, success ? "success" : "failed"));
+    }
+}
@@ -0,0 +1,86 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// ----------------------------------------------------------------------------
+// TTMPEGPSMUXPROVIDER
+// MPEG-2 program stream (.mpg) muxer using the libav "dvd" output format.
+// Replaces the external mplex run of an MPG-output cut: no process spawn, no
+// wait loop and no parsing of mplex's text output. Same DVD-style stream as
+// mplex -f8 (2048-byte packs with navigation packets).
+//
+// Public surface is TTMplexProvider's, so TTAVData drives both the same way:
+// mplexPart() runs synchronously on the GUI thread and pumps the event loop
+// between packets, requestAbort() arrives re-entrantly from
+// TTAVData::onUserAbortRequest(). writeMuxScript() still writes an mplex
+// script - that script runs after TTCut-ng has exited.
+// ----------------------------------------------------------------------------
+
+#ifndef TTMPEGPSMUXPROVIDER_H
+#define TTMPEGPSMUXPROVIDER_H
+
+#include "../extern/imuxprovider.h"
+#include "../common/istatusreporter.h"
+#include "../data/ttmuxlistdata.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+
+class TTMessageLogger;
+
+class TTMpegPsMuxProvider : public IStatusReporter, public IMuxProvider
+{
+    Q_OBJECT
+
+public:
+    TTMpegPsMuxProvider(TTMuxListData* muxListData);
+    ~TTMpegPsMuxProvider();
+
+    void writeMuxScript() override;
+    void mplexPart(int index) override;
+
+    // A/V sync offset in milliseconds (from .info file), same sign as
+    // mplex --sync-offset: positive delays the audio
+    void setAudioSyncOffset(int offsetMs) { mAudioSyncOffsetMs = offsetMs; }
+
+    // Cooperative abort, same shape as TTMplexProvider: requestAbort() is
+    // thread-safe, the packet loop in mplexPart() polls the flag, and
+    // wasAborted() tells a cancel from a real failure.
+    void requestAbort() { mAbortRequested.store(true, std::memory_order_relaxed); }
+    bool wasAborted() const { return mWasAborted; }
+
+    //! False when the mux failed; lastError() says why. The elementary
+    //! streams are kept then.
+    bool    succeeded() const { return mSucceeded; }
+    QString lastError() const { return mLastError; }
+
+private:
+    bool mux(const QString& outputFile, const QString& videoFile,
+             const QStringList& audioFiles);
+    void setError(const QString& msg);
+    void deleteElementaryStreams(const QString& videoFilePath, const QStringList& audioFilePaths);
+
+    // Poll point for the cooperative abort (see requestAbort())
+    bool checkAbort();
+
+    TTMessageLogger*  log;
+    TTMuxListData*    mpMuxList;
+    int               mAudioSyncOffsetMs;
+    // Created fresh per mux operation (TTAVData::onCutFinished), so
+    // mAbortRequested needs no clearing point; the outputs are cleared at the
+    // top of mplexPart().
+    std::atomic<bool> mAbortRequested { false };
+    bool              mWasAborted     = false;
+    bool              mSucceeded      = true;
+    QString           mLastError;
+};
+
+#endif //TTMPEGPSMUXPROVIDER_H
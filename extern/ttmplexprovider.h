@@ -63,8 +63,11 @@ class TTMplexProvider : public IStatusReporter, public IMuxProvider
     bool    succeeded() const { return mSucceeded; }
     QString lastError() const { return mLastError; }
 
+    //! The .mpg next to the cut video, or in muxOutputPath() when set. Also
+    //! the output of the in-process muxer (TTMpegPsMuxProvider).
+    static QString createOutputFilePath(const QString& videoFilePath);
+
   private:
-    QString     createOutputFilePath(const QString& videoFilePath);
     QStringList createMplexArguments(const QString& videoFilePath, const QStringList& audioFilePaths, bool escapeFileNames);
     void        deleteElementaryStreams(const QString& videoFilePath, const QStringList& audioFilePaths);
     //! Examine one line of mplex output for silent data loss (see the .cpp).
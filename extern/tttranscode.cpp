@@ -161,6 +161,14 @@ void TTTranscodeProvider::freeEncoder()
 /* /////////////////////////////////////////////////////////////////////////////
  * Encode frames from start to end using libmpeg2 decoder + libav encoder
  * Writes encoded MPEG-2 data directly to .m2v file
+ *
+ * The decoder seeks once, to start, and then decodes on in display order:
+ * linear in the range length. (A moveToFrameIndex() per frame re-decoded
+ * the GOP from its I-frame every time - frames x GOP length.) Each frame's
+ * picture type and temporal reference (its display position in the GOP) are
+ * checked against the index; on a mismatch (damaged stream, dropped picture -
+ * also one between two pictures of the same type) the decoder is re-seeked
+ * to the frame it should be at.
  */
 bool TTTranscodeProvider::encodeFrames(TTVideoStream* vs, int start, int end)
 {
@@ -206,14 +214,34 @@ bool TTTranscodeProvider::encodeFrames(TTVideoStream* vs, int start, int end)
 
   int framesSent = 0;
   int packetsReceived = 0;
+  int resyncs = 0;
+
+  // Is the decoder's current picture the index's frame?
+  auto atFrame = [&](int frameIndex) {
+    TTVideoIndexList* indexList = vs->indexList();
+    TTPicturesHeader* picture   = (TTPicturesHeader*)vs->headerList()->headerAt(
+        indexList->headerListIndex(frameIndex));
+    return decoder->currentFrameType() == indexList->pictureCodingType(frameIndex)
+        && (picture == NULL || decoder->currentTemporalReference() == picture->temporal_reference);
+  };
 
   // Decode and encode each frame
   for (int i = 0; i < frameCount; i++) {
     int frameIndex = start + i;
 
-    // Move decoder to frame (in display order)
-    decoder->moveToFrameIndex(frameIndex);
-    TFrameInfo* frameInfo = decoder->getFrameInfo();
+    // Seek to the range start, then one decode step per frame (display order)
+    TFrameInfo* frameInfo;
+    if (i == 0) {
+      decoder->moveToFrameIndex(frameIndex);
+      frameInfo = decoder->getFrameInfo();
+    } else {
+      frameInfo = decoder->decodeNextDisplayFrame();
+      if (!frameInfo || !atFrame(frameIndex)) {
+        decoder->moveToFrameIndex(frameIndex);
+        frameInfo = decoder->getFrameInfo();
+        resyncs++;
+      }
+    }
 
     if (!frameInfo || !frameInfo->Y) {
       log->errorMsg(__FILE__, __LINE__, QString("Failed to decode frame %1").arg(frameIndex));
@@ -291,7 +319,8 @@ bool TTTranscodeProvider::encodeFrames(TTVideoStream* vs, int start, int end)
 
   if (TTSettings::instance()->logSmartCut()) {
       qDebug() << "MPEG-2 encoding complete: sent" << framesSent
-               << "frames, received" << packetsReceived << "packets";
+               << "frames, received" << packetsReceived << "packets,"
+               << resyncs << "decoder re-seeks";
   }
 
 cleanup:
@@ -474,10 +474,18 @@ void TTCurrentFrame::onGotoFrame(int pos, int fast)
 //! follows via onGotoFrame() once the slider is released. Keeps the stream's
 //! current index in sync so the position readout and cut checks stay honest
 //! about what is on screen.
+//! H.264/H.265: showFrameAt() no longer blocks - the decode thread shows the
+//! keyframe itself and drops the exact frame once the slider has moved on -
+//! so the drag takes the exact path and lands on the frame when it pauses.
 void TTCurrentFrame::onGotoFramePreview(int pos)
 {
   if (pos < 0) return;
 
+  if (mpegWindow->isFFmpegStream()) {
+    onGotoFrame(pos, 0);
+    return;
+  }
+
   clearCutContext();
 
   int shownPos = mpegWindow->showKeyframeFastAt(pos);
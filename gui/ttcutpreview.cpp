@@ -836,6 +836,8 @@ void TTCutPreview::regenerateSmartCutPreviewClip(int fileIndex, TTCutList* tmpCu
   // --- Smart Cut video ---
   TTESSmartCut smartCut;
   smartCut.setPresetOverride(TTSettings::instance()->previewPreset());
+  if (auto* h26x = dynamic_cast<TTH26xVideoStream*>(vStream))
+    smartCut.setNaluIndex(h26x->naluIndex());
   if (!smartCut.initialize(sourceFile, frameRate)) {
     TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
         QString("Regenerate: Smart Cut init failed: %1").arg(smartCut.lastError()));
@@ -22,8 +22,8 @@ void TTCutSettingsLogging::resetToDefaults()
 {
   // Compile-time defaults — must match common/ttsettings.h
   // (mCreateLogFile, mLogModeConsole, mLogModeExtended, mLogVideoIndexInfo,
-  //  mLogFFmpegDecoder, mLogSmartCut, mLogMkvMux, mLogCutPipeline,
-  //  mLogAVStream, mLogUI, mLogLibav).
+  //  mLogFFmpegDecoder, mLogSmartCut, mLogMkvMux, mLogPsMux,
+  //  mLogCutPipeline, mLogAVStream, mLogUI, mLogLibav).
   cbCreateLog->setChecked(true);
   cbLogConsole->setChecked(false);
   cbLogExtended->setChecked(true);
@@ -31,6 +31,7 @@ void TTCutSettingsLogging::resetToDefaults()
   cbLogPlusFFmpegDecoder->setChecked(false);
   cbLogPlusSmartCut->setChecked(false);
   cbLogPlusMkvMux->setChecked(false);
+  cbLogPlusPsMux->setChecked(false);
   cbLogPlusCutPipeline->setChecked(false);
   cbLogPlusAVStream->setChecked(false);
   cbLogPlusUI->setChecked(false);
@@ -49,6 +50,7 @@ void TTCutSettingsLogging::setTabData()
   cbLogPlusFFmpegDecoder->setChecked(TTSettings::instance()->logFFmpegDecoder());
   cbLogPlusSmartCut->setChecked(TTSettings::instance()->logSmartCut());
   cbLogPlusMkvMux->setChecked(TTSettings::instance()->logMkvMux());
+  cbLogPlusPsMux->setChecked(TTSettings::instance()->logPsMux());
   cbLogPlusCutPipeline->setChecked(TTSettings::instance()->logCutPipeline());
   cbLogPlusAVStream->setChecked(TTSettings::instance()->logAVStream());
   cbLogPlusUI->setChecked(TTSettings::instance()->logUI());
@@ -66,6 +68,7 @@ void TTCutSettingsLogging::saveTabData()
   TTSettings::instance()->setLogFFmpegDecoder(cbLogPlusFFmpegDecoder->isChecked());
   TTSettings::instance()->setLogSmartCut(cbLogPlusSmartCut->isChecked());
   TTSettings::instance()->setLogMkvMux(cbLogPlusMkvMux->isChecked());
+  TTSettings::instance()->setLogPsMux(cbLogPlusPsMux->isChecked());
   TTSettings::instance()->setLogCutPipeline(cbLogPlusCutPipeline->isChecked());
   TTSettings::instance()->setLogAVStream(cbLogPlusAVStream->isChecked());
   TTSettings::instance()->setLogUI(cbLogPlusUI->isChecked());
@@ -11,6 +11,7 @@
 #include "ttquickjumpmodel.h"
 #include "ttquickjumpdelegate.h"
 #include "ttquickjumpworker.h"
+#include "ttthumbnailatlas.h"
 #include "ttwindowgeometry.h"
 
 #include "../avstream/ttavstream.h"
@@ -29,9 +30,11 @@
 #include <QKeyEvent>
 #include <QScreen>
 #include <QSettings>
+#include <QHash>
 #include <QSpinBox>
 #include <QTimer>
 #include <QDebug>
+#include <algorithm>
 
 #include "../common/ttcut.h"
 #include "../common/ttsettings.h"
@@ -70,7 +73,8 @@ TTQuickJumpDialog::TTQuickJumpDialog(TTVideoStream* videoStream,
     mHighlightKeyframeListIndex(0),
     mCurrentWorker(0),
     mTaskPool(new TTThreadTaskPool()),
-    mResizeTimer(new QTimer(this))
+    mResizeTimer(new QTimer(this)),
+    mAtlas(0)
 {
   mResizeTimer->setSingleShot(true);
   mResizeTimer->setInterval(200);
@@ -82,6 +86,10 @@ TTQuickJumpDialog::TTQuickJumpDialog(TTVideoStream* videoStream,
   mDelegate = new TTQuickJumpDelegate(thumbWidth, THUMB_HEIGHT, this);
   mModel = new TTQuickJumpModel(videoStream, this);
 
+  // Thumbnails of earlier sessions; decoded ones are added as they arrive
+  mAtlas = new TTThumbnailAtlas(videoStream->filePath(), mDelegate->thumbnailSize());
+  mAtlas->open();
+
   // Apply anchor and interval from global settings
   mModel->setAnchorFrame(mCurrentPosition);
   mModel->setIntervalSeconds(TTSettings::instance()->quickJumpIntervalSec());
@@ -117,6 +125,7 @@ TTQuickJumpDialog::~TTQuickJumpDialog()
   ttSaveDialogSize(settings, "QuickJumpDialog", size());
 
   delete mTaskPool;
+  delete mAtlas;
 }
 
 void TTQuickJumpDialog::setupUI()
@@ -246,17 +255,36 @@ void TTQuickJumpDialog::startThumbnailWorker()
   const QList<int>& allKeyframes = mModel->keyframeIndices();
 
   QList<int> pageFrames;
+  QHash<int, int> pagePos;   // frame index -> position on the page
   for (int i = 0; i < count; ++i) {
     int idx = offset + i;
     if (idx < allKeyframes.size()) {
       int frameIndex = allKeyframes.at(idx);
-      // Skip frames that already have thumbnails cached
+      // Thumbnails the model or the atlas already has need no decode
+      if (mModel->hasThumbnail(frameIndex)) continue;
+      const QImage cached = mAtlas->thumbnail(frameIndex);
+      if (!cached.isNull()) {
+        mModel->onThumbnailReady(frameIndex, cached);
+        continue;
+      }
       pageFrames.append(frameIndex);
+      pagePos.insert(frameIndex, i);
     }
   }
 
   if (pageFrames.isEmpty()) return;
 
+  // The workers take frames in list order: the highlighted keyframe and its
+  // neighbours (where the user looks first) before the page corners
+  const int highlightPos = mHighlightKeyframeListIndex - offset;
+  if (highlightPos >= 0 && highlightPos < count) {
+    std::stable_sort(pageFrames.begin(), pageFrames.end(),
+                     [&](int a, int b) {
+                       return qAbs(pagePos.value(a) - highlightPos)
+                            < qAbs(pagePos.value(b) - highlightPos);
+                     });
+  }
+
   int streamType = mVideoStream->streamType();
 
   // Index sharing (spec 2026-06-05): pulls the frame index directly from Owner A
@@ -279,11 +307,19 @@ void TTQuickJumpDialog::startThumbnailWorker()
 
   connect(mCurrentWorker, &TTQuickJumpWorker::thumbnailReady,
           mModel, &TTQuickJumpModel::onThumbnailReady);
+  connect(mCurrentWorker, &TTQuickJumpWorker::thumbnailReady,
+          this, &TTQuickJumpDialog::onThumbnailDecoded);
 
   mTaskPool->init(1);
   mTaskPool->start(mCurrentWorker);
 }
 
+void TTQuickJumpDialog::onThumbnailDecoded(int frameIndex, const QImage& thumbnail)
+{
+  if (!thumbnail.isNull())
+    mAtlas->store(frameIndex, thumbnail);
+}
+
 void TTQuickJumpDialog::abortCurrentWorker()
 {
   if (mCurrentWorker) {
@@ -22,6 +22,7 @@ class TTQuickJumpModel;
 class TTQuickJumpDelegate;
 class TTQuickJumpWorker;
 class TTThreadTaskPool;
+class TTThumbnailAtlas;
 
 class TTQuickJumpDialog : public QDialog
 {
@@ -44,6 +45,7 @@ private slots:
   void onPageForward();
   void onResizeDebounced();
   void onIntervalChanged(int value);
+  void onThumbnailDecoded(int frameIndex, const QImage& thumbnail);
 
 private:
   void setupUI();
@@ -73,6 +75,7 @@ private:
   TTThreadTaskPool*     mTaskPool;
   QTimer*               mResizeTimer;
   QSpinBox*             mIntervalSpinner;
+  TTThumbnailAtlas*     mAtlas;
 };
 
 #endif // TTQUICKJUMPDIALOG_H
@@ -49,6 +49,7 @@ public:
   int keyframeListIndex(int frameIndex) const;
   const QList<int>& keyframeIndices() const;
   bool isFailedFrame(int frameIndex) const;
+  bool hasThumbnail(int frameIndex) const { return mThumbnails.contains(frameIndex); }
 
 public slots:
   void onThumbnailReady(int frameIndex, const QImage& thumbnail);
@@ -13,10 +13,17 @@
 #include "../avstream/ttvideoindexlist.h"
 #include "../avstream/ttvideoheaderlist.h"
 #include "../common/ttmessagelogger.h"
+#include "../common/ttsettings.h"
 #include "../mpeg2decoder/ttmpeg2decoder.h"
 
+#include <QAtomicInt>
 #include <QDebug>
 #include <QImage>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
 
 TTQuickJumpWorker::TTQuickJumpWorker(
     const QString& filePath, int streamType,
@@ -34,91 +41,159 @@ TTQuickJumpWorker::TTQuickJumpWorker(
 {
 }
 
-void TTQuickJumpWorker::operation()
+// ----------------------------------------------------------------------------
+// Decoders: one per pool thread, all sharing the index lists / prebuilt
+// frame index. Created here on the worker thread (TTFFmpegWrapper is a
+// QObject), serially: opening N files at once only contends for the disk.
+// ----------------------------------------------------------------------------
+bool TTQuickJumpWorker::openDecoders(int count)
 {
-  mTotalSteps = mFrameIndices.size();
-  onStatusReport(StatusReportArgs::Start, tr("Decoding thumbnails"), mTotalSteps);
+  const bool isMpeg2 = (mStreamType == TTAVTypes::mpeg2_demuxed_video);
 
-  bool isMpeg2 = (mStreamType == TTAVTypes::mpeg2_demuxed_video);
-
-  // Create decoder ONCE for all frames (thread-safe: own instance per worker)
-  TTMpeg2Decoder* mpeg2Decoder = 0;
-  TTFFmpegWrapper* ffmpegWrapper = 0;
-
-  if (isMpeg2) {
-    try {
-      mpeg2Decoder = new TTMpeg2Decoder(mFilePath, mIndexList, mHeaderList, formatRGB32);
-    } catch (TTMpeg2DecoderException) {
-      TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-          QString("QuickJump: Failed to create MPEG-2 decoder"));
-      return;
+  // Thumbnails are keyframes: both decoders run their reduced profile (intra
+  // pictures only, no deblocking) and scale straight from YUV to mThumbSize.
+  for (int i = 0; i < count && !mIsAborted; ++i) {
+    if (isMpeg2) {
+      try {
+        auto* decoder = new TTMpeg2Decoder(mFilePath, mIndexList, mHeaderList, formatYV12);
+        decoder->setKeyframesOnly(true);
+        mMpeg2Decoders.append(decoder);
+      } catch (TTMpeg2DecoderException) {
+        TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+            QString("QuickJump: Failed to create MPEG-2 decoder %1").arg(i));
+        break;
+      }
+      continue;
     }
-  } else {
-    // TTFFmpegWrapper is QObject-based -- MUST be created in worker thread (here)
-    ffmpegWrapper = new TTFFmpegWrapper();
-    if (!ffmpegWrapper->openFile(mFilePath)) {
+
+    auto* wrapper = new TTFFmpegWrapper();
+    wrapper->setReducedDecode(true);
+    if (!wrapper->openFile(mFilePath)) {
       TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-          QString("QuickJump: Failed to open file: %1").arg(ffmpegWrapper->lastError()));
-      delete ffmpegWrapper;
-      return;
+          QString("QuickJump: Failed to open file: %1").arg(wrapper->lastError()));
+      delete wrapper;
+      break;
     }
-    // Use prebuilt frame index if available (avoids 6s rebuild for H.264/H.265)
+    // Use prebuilt frame index if available (avoids 6s rebuild for H.264/H.265);
+    // without one the first wrapper builds it and the others take a copy
+    if (mPrebuiltFrameIndex.isEmpty() && !mFFmpegWrappers.isEmpty())
+      mPrebuiltFrameIndex = mFFmpegWrappers.first()->frameIndex();
     if (!mPrebuiltFrameIndex.isEmpty()) {
-      ffmpegWrapper->setFrameIndex(mPrebuiltFrameIndex);
-    } else {
-      if (!ffmpegWrapper->buildFrameIndex()) {
-        TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-            QString("QuickJump: Failed to build frame index: %1").arg(ffmpegWrapper->lastError()));
-        delete ffmpegWrapper;
-        return;
-      }
+      wrapper->setFrameIndex(mPrebuiltFrameIndex);
+    } else if (!wrapper->buildFrameIndex()) {
+      TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+          QString("QuickJump: Failed to build frame index: %1").arg(wrapper->lastError()));
+      wrapper->closeFile();
+      delete wrapper;
+      break;
     }
+    mFFmpegWrappers.append(wrapper);
   }
 
-  for (int i = 0; i < mFrameIndices.size(); ++i) {
-    if (mIsAborted) break;
+  // Fewer decoders than asked for (out of file handles, memory) still work
+  return !mMpeg2Decoders.isEmpty() || !mFFmpegWrappers.isEmpty();
+}
 
-    int frameIndex = mFrameIndices.at(i);
-    QImage thumb;
+void TTQuickJumpWorker::closeDecoders()
+{
+  qDeleteAll(mMpeg2Decoders);
+  mMpeg2Decoders.clear();
+  for (TTFFmpegWrapper* wrapper : mFFmpegWrappers) {
+    wrapper->closeFile();
+    delete wrapper;
+  }
+  mFFmpegWrappers.clear();
+}
 
-    if (isMpeg2) {
-      try {
-        mpeg2Decoder->moveToFrameIndex(frameIndex);
-        TFrameInfo* frame = mpeg2Decoder->decodeMPEG2Frame(formatRGB32);
-        if (frame && frame->Y) {
-          QImage img(frame->Y, frame->width, frame->height, QImage::Format_RGB32);
-          thumb = img.scaled(mThumbSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        }
-      } catch (TTMpeg2DecoderException) {
-        TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
-            QString("QuickJump: MPEG-2 decode failed for frame %1").arg(frameIndex));
-      }
-    } else {
-      QImage img = ffmpegWrapper->decodeFrame(frameIndex);
-      if (!img.isNull()) {
-        thumb = img.scaled(mThumbSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-      }
+// Decode one thumbnail with decoder number 'decoder' (pool thread)
+QImage TTQuickJumpWorker::decodeThumbnail(int decoder, int frameIndex)
+{
+  if (!mMpeg2Decoders.isEmpty()) {
+    try {
+      mMpeg2Decoders[decoder]->moveToFrameIndex(frameIndex);
+      return mMpeg2Decoders[decoder]->reducedImage(mThumbSize, false);
+    } catch (TTMpeg2DecoderException) {
+      TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+          QString("QuickJump: MPEG-2 decode failed for frame %1").arg(frameIndex));
+      return QImage();
     }
+  }
+  return mFFmpegWrappers[decoder]->decodeKeyframeReduced(frameIndex, mThumbSize, false);
+}
+
+// ----------------------------------------------------------------------------
+// Operation: N decoders pull frames off mFrameIndices in list order (the
+// dialog puts the rows the user looks at first), so the list is partitioned
+// dynamically and thumbnails are emitted as they complete.
+// ----------------------------------------------------------------------------
+void TTQuickJumpWorker::operation()
+{
+  mTotalSteps = mFrameIndices.size();
+  onStatusReport(StatusReportArgs::Start, tr("Decoding thumbnails"), mTotalSteps);
 
-    // Emit QImage (not QPixmap!) -- QPixmap is NOT thread-safe.
-    // Model converts to QPixmap in main thread.
-    emit thumbnailReady(frameIndex, thumb);  // null QImage = decode failed
+  // Same worker count as the search tasks: 0 = auto (idealThreadCount/2 cap
+  // 4), clamp [1, 16]; never more decoders than thumbnails
+  int n = TTSettings::instance()->searchWorkerCount();
+  if (n <= 0) n = qBound(1, QThread::idealThreadCount() / 2, 4);
+  n = qBound(1, qMin(n, int(mFrameIndices.size())), 16);
 
-    mStepCount = i + 1;
-    onStatusReport(StatusReportArgs::Step, QString(), mStepCount);
+  if (!openDecoders(n)) {
+    closeDecoders();
+    return;
   }
+  n = qMax(mMpeg2Decoders.size(), mFFmpegWrappers.size());
+
+  if (TTSettings::instance()->logUI())
+    qDebug() << "QuickJump: decoding" << mFrameIndices.size() << "thumbnails with"
+             << n << "decoder(s)";
+
+  QAtomicInt next(0);
+  QAtomicInt done(0);
+  auto drain = [&](int decoder) {
+    forever {
+      if (mIsAborted) return;
+      const int i = next.fetchAndAddOrdered(1);
+      if (i >= mFrameIndices.size()) return;
+
+      const int frameIndex = mFrameIndices.at(i);
+      const QImage thumb = decodeThumbnail(decoder, frameIndex);
+
+      // Emit QImage (not QPixmap!) -- QPixmap is NOT thread-safe.
+      // Model converts to QPixmap in main thread (queued from the pool thread).
+      emit thumbnailReady(frameIndex, thumb);  // null QImage = decode failed
+
+      const int steps = done.fetchAndAddOrdered(1) + 1;
+      QMutexLocker lock(&mStatusLock);
+      mStepCount = qMax<quint64>(mStepCount, steps);
+      onStatusReport(StatusReportArgs::Step, QString(), mStepCount);
+    }
+  };
 
-  delete mpeg2Decoder;
-  if (ffmpegWrapper) {
-    ffmpegWrapper->closeFile();
-    delete ffmpegWrapper;
+  if (n == 1) {
+    drain(0);
+  } else {
+    QThreadPool pool;
+    pool.setMaxThreadCount(n);
+    QSemaphore finished(0);
+    for (int d = 0; d < n; ++d) {
+      auto* runnable = QRunnable::create([&, d]() {
+        drain(d);
+        finished.release(1);
+      });
+      runnable->setAutoDelete(true);
+      pool.start(runnable);
+    }
+    finished.acquire(n);
   }
 
+  closeDecoders();
+
   onStatusReport(StatusReportArgs::Finished, tr("Thumbnails complete"), mStepCount);
 }
 
 void TTQuickJumpWorker::cleanUp()
 {
+  closeDecoders();
 }
 
 void TTQuickJumpWorker::onUserAbort()
@@ -14,11 +14,17 @@
 #include "../extern/ttffmpegwrapper.h"
 
 #include <QList>
+#include <QMutex>
 #include <QPixmap>
 #include <QSize>
 
 class TTVideoIndexList;
 class TTVideoHeaderList;
+class TTMpeg2Decoder;
+
+// Decodes the QuickJump thumbnails of mFrameIndices, in list order, on up to
+// TTSettings::searchWorkerCount() decoders in parallel. thumbnailReady is
+// emitted from pool threads in completion order.
 
 class TTQuickJumpWorker : public TTThreadTask
 {
@@ -41,6 +47,10 @@ public slots:
   void onUserAbort() override;
 
 private:
+  bool   openDecoders(int count);
+  void   closeDecoders();
+  QImage decodeThumbnail(int decoder, int frameIndex);
+
   QString             mFilePath;
   int                 mStreamType;
   QList<int>          mFrameIndices;
@@ -48,6 +58,10 @@ private:
   TTVideoIndexList*   mIndexList;
   TTVideoHeaderList*  mHeaderList;
   QList<TTFrameInfo>  mPrebuiltFrameIndex;
+
+  QList<TTMpeg2Decoder*>  mMpeg2Decoders;   // one per pool thread
+  QList<TTFFmpegWrapper*> mFFmpegWrappers;  // one per pool thread
+  QMutex                  mStatusLock;      // onStatusReport from pool threads
 };
 
 #endif // TTQUICKJUMPWORKER_H
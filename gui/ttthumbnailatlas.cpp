@@ -0,0 +1,267 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttthumbnailatlas.h"
+
+#include "../avstream/ttstreamindexcache.h"
+#include "../common/ttmessagelogger.h"
+#include "../common/ttsettings.h"
+
+#include <QDebug>
+#include <QFileInfo>
+
+#include <cstdint>
+#include <cstring>
+
+// Bump whenever the slot layout changes: an old atlas is then started anew
+static const uint32_t kFormatVersion = 1;
+static const char kMagic[8] = { 'T', 'T', 'C', 'U', 'T', 'T', 'H', 'B' };
+
+struct TTThumbHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t reserved;
+  int64_t  streamSize;
+  int64_t  streamMtimeMs;
+  uint64_t sampleHash;
+};
+
+struct TTThumbSlot {
+  int32_t  frameIndex;
+  uint32_t reserved;
+};
+
+// ----------------------------------------------------------------------------
+// Construction
+// ----------------------------------------------------------------------------
+TTThumbnailAtlas::TTThumbnailAtlas(const QString& streamPath, const QSize& thumbSize)
+  : mStreamPath(streamPath),
+    mThumbSize(thumbSize),
+    mMapped(nullptr),
+    mMappedSize(0),
+    mValid(false),
+    mWriteFailed(false)
+{
+}
+
+TTThumbnailAtlas::~TTThumbnailAtlas()
+{
+  unmap();
+}
+
+QString TTThumbnailAtlas::atlasPath(const QString& streamPath, const QSize& thumbSize)
+{
+  return streamPath + QString(".ttthumb-%1x%2").arg(thumbSize.width()).arg(thumbSize.height());
+}
+
+// RGB32 pixels: every slot (and so every pixel block) stays 4-byte aligned
+qint64 TTThumbnailAtlas::slotSize() const
+{
+  return qint64(sizeof(TTThumbSlot)) + qint64(mThumbSize.width()) * mThumbSize.height() * 4;
+}
+
+// ----------------------------------------------------------------------------
+// Open: map the atlas and index its slots
+// ----------------------------------------------------------------------------
+bool TTThumbnailAtlas::open()
+{
+  unmap();
+  mSlots.clear();
+  mValid = false;
+  if (!TTStreamIndexCache::isEnabled() || mThumbSize.isEmpty()) return false;
+
+  const QString path = atlasPath(mStreamPath, mThumbSize);
+  if (!QFileInfo::exists(path)) return false;
+
+  TTStreamIndexCache::StreamKey key;
+  TTStreamIndexCache identity(mStreamPath);
+  if (!identity.streamKey(key)) return false;
+
+  // Read-only media: the atlas is still worth reading
+  mFile.setFileName(path);
+  if (!mFile.open(QIODevice::ReadWrite | QIODevice::Append | QIODevice::Unbuffered)
+      && !mFile.open(QIODevice::ReadOnly))
+    return false;
+
+  if (mFile.size() < qint64(sizeof(TTThumbHeader)) || !remap()) {
+    unmap();
+    return false;
+  }
+
+  TTThumbHeader hdr;
+  memcpy(&hdr, mMapped, sizeof(hdr));
+  const bool current = memcmp(hdr.magic, kMagic, sizeof(kMagic)) == 0
+                    && hdr.version == kFormatVersion
+                    && hdr.width == uint32_t(mThumbSize.width())
+                    && hdr.height == uint32_t(mThumbSize.height())
+                    && hdr.streamSize == key.size
+                    && hdr.streamMtimeMs == key.mtimeMs
+                    && hdr.sampleHash == key.sampleHash;
+  if (!current) {
+    if (TTSettings::instance()->logUI())
+      qDebug() << "TTThumbnailAtlas: stale atlas" << path << "- starting anew";
+    unmap();
+    return false;
+  }
+  mValid = true;
+
+  const qint64 slot = slotSize();
+  qint64 offset = sizeof(TTThumbHeader);
+  for (; offset + slot <= mMappedSize; offset += slot) {
+    TTThumbSlot s;
+    memcpy(&s, mMapped + offset, sizeof(s));
+    mSlots.insert(s.frameIndex, offset + qint64(sizeof(TTThumbSlot)));
+  }
+
+  // A partial last slot (crash while appending) would misalign every slot
+  // after it
+  if (offset != mMappedSize && mFile.isWritable()) {
+    mFile.unmap(mMapped);
+    mMapped = nullptr;
+    mFile.resize(offset);
+    remap();
+  }
+
+  if (TTSettings::instance()->logUI())
+    qDebug() << "TTThumbnailAtlas: using" << path << "(" << mSlots.size() << "thumbnails)";
+  return true;
+}
+
+bool TTThumbnailAtlas::remap()
+{
+  if (mMapped) {
+    mFile.unmap(mMapped);
+    mMapped = nullptr;
+  }
+  mMappedSize = mFile.size();
+  if (mMappedSize <= 0) return false;
+  mMapped = mFile.map(0, mMappedSize);
+  if (!mMapped) mMappedSize = 0;
+  return mMapped != nullptr;
+}
+
+void TTThumbnailAtlas::unmap()
+{
+  if (mMapped) {
+    mFile.unmap(mMapped);
+    mMapped = nullptr;
+  }
+  if (mFile.isOpen())
+    mFile.close();
+  mMappedSize = 0;
+}
+
+// ----------------------------------------------------------------------------
+// Read
+// ----------------------------------------------------------------------------
+QImage TTThumbnailAtlas::thumbnail(int frameIndex)
+{
+  auto it = mSlots.constFind(frameIndex);
+  if (it == mSlots.constEnd()) return QImage();
+
+  const qint64 offset = it.value();
+  const qint64 bytes  = qint64(mThumbSize.width()) * mThumbSize.height() * 4;
+  // Appended since the last mapping
+  if ((!mMapped || offset + bytes > mMappedSize) && !remap()) return QImage();
+  if (offset + bytes > mMappedSize) return QImage();
+
+  // Another process appending at the same time can shift a slot: trust it
+  // only if it is tagged with the frame asked for
+  TTThumbSlot s;
+  memcpy(&s, mMapped + offset - sizeof(TTThumbSlot), sizeof(s));
+  if (s.frameIndex != frameIndex) return QImage();
+
+  return QImage(mMapped + offset, mThumbSize.width(), mThumbSize.height(),
+                mThumbSize.width() * 4, QImage::Format_RGB32).copy();
+}
+
+// ----------------------------------------------------------------------------
+// Write
+// ----------------------------------------------------------------------------
+bool TTThumbnailAtlas::startNew()
+{
+  unmap();
+  mSlots.clear();
+
+  TTStreamIndexCache::StreamKey key;
+  TTStreamIndexCache identity(mStreamPath);
+  if (!identity.streamKey(key)) {
+    mLastError = QString("Cannot read stream %1").arg(mStreamPath);
+    return false;
+  }
+
+  TTThumbHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.version       = kFormatVersion;
+  hdr.width         = uint32_t(mThumbSize.width());
+  hdr.height        = uint32_t(mThumbSize.height());
+  hdr.streamSize    = key.size;
+  hdr.streamMtimeMs = key.mtimeMs;
+  hdr.sampleHash    = key.sampleHash;
+
+  const QString path = atlasPath(mStreamPath, mThumbSize);
+  mFile.setFileName(path);
+  bool ok = mFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+         && mFile.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr)) == qint64(sizeof(hdr));
+  mFile.close();
+  ok = ok && mFile.open(QIODevice::ReadWrite | QIODevice::Append | QIODevice::Unbuffered);
+  if (!ok) {
+    mLastError = QString("Cannot write thumbnail atlas %1: %2").arg(path, mFile.errorString());
+    TTMessageLogger::getInstance()->infoMsg(__FILE__, __LINE__, mLastError);
+    unmap();
+    return false;
+  }
+  mValid = true;
+  return true;
+}
+
+bool TTThumbnailAtlas::store(int frameIndex, const QImage& thumbnail)
+{
+  if (!TTStreamIndexCache::isEnabled() || thumbnail.isNull() || mThumbSize.isEmpty())
+    return false;
+  if (mSlots.contains(frameIndex)) return true;
+  if (mWriteFailed) return false;
+  if (!mValid && !startNew()) return false;
+  if (!mFile.isWritable()) return false;
+
+  QImage image = (thumbnail.size() == mThumbSize)
+      ? thumbnail
+      : thumbnail.scaled(mThumbSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+  image = image.convertToFormat(QImage::Format_RGB32);
+
+  // One write() per slot: in append mode it lands whole at the end
+  const int rowBytes = mThumbSize.width() * 4;
+  QByteArray slot(slotSize(), Qt::Uninitialized);
+  TTThumbSlot s;
+  s.frameIndex = frameIndex;
+  s.reserved   = 0;
+  memcpy(slot.data(), &s, sizeof(s));
+  for (int row = 0; row < mThumbSize.height(); ++row)
+    memcpy(slot.data() + sizeof(s) + qint64(row) * rowBytes, image.constScanLine(row), rowBytes);
+
+  const qint64 end = mFile.size();
+  if (mFile.write(slot) != slot.size() || !mFile.flush()) {
+    mLastError = QString("Cannot append to thumbnail atlas %1: %2")
+                     .arg(mFile.fileName(), mFile.errorString());
+    TTMessageLogger::getInstance()->infoMsg(__FILE__, __LINE__, mLastError);
+    // A partial slot would shift every slot appended after it: cut it off,
+    // and if that fails too, leave the atlas alone for the rest of the session
+    if (!mFile.resize(end)) {
+      mWriteFailed = true;
+      TTMessageLogger::getInstance()->infoMsg(__FILE__, __LINE__,
+          QString("Thumbnail atlas %1 not updated any more").arg(mFile.fileName()));
+    }
+    return false;
+  }
+  mSlots.insert(frameIndex, end + qint64(sizeof(TTThumbSlot)));
+  return true;
+}
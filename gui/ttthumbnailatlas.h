@@ -0,0 +1,75 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTTHUMBNAILATLAS
+// Persistent QuickJump thumbnails: "<stream>.ttthumb-<w>x<h>" next to the
+// video stream, one file per thumbnail size. Opening the dialog shows what
+// the atlas holds at once and decodes only the gaps; every decoded thumbnail
+// is appended, so the atlas fills up over sessions and projects.
+//
+// File layout (native byte order, version-checked):
+//   header  magic, format version, thumbnail size, stream key
+//   slots   (frame index, reserved) + width * height RGB32 pixels, appended
+// The stream key is TTStreamIndexCache's (size + mtime + sampled hash), so
+// an edited stream starts a new atlas. open() maps the file; thumbnail()
+// copies out of the mapping. Slots are appended with one write() in append
+// mode: a crash leaves at most a partial last slot, which open() ignores;
+// a failed write is truncated back to the last complete slot.
+// Gated by TTSettings::createStreamIndex() like the index sidecar.
+
+#ifndef TTTHUMBNAILATLAS_H
+#define TTTHUMBNAILATLAS_H
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+class TTThumbnailAtlas
+{
+  public:
+    TTThumbnailAtlas(const QString& streamPath, const QSize& thumbSize);
+    ~TTThumbnailAtlas();
+
+    static QString atlasPath(const QString& streamPath, const QSize& thumbSize);
+
+    // Map an existing atlas; false if there is none or it belongs to another
+    // version of the stream (store() then starts a new one)
+    bool open();
+
+    bool   contains(int frameIndex) const { return mSlots.contains(frameIndex); }
+    int    count() const { return mSlots.size(); }
+    // Deep copy, RGB32 at the atlas' thumbnail size; null if not cached
+    QImage thumbnail(int frameIndex);
+    // Append a thumbnail (scaled/converted if it does not match). False if
+    // the atlas is disabled or not writable - the caller just keeps it in
+    // memory then.
+    bool   store(int frameIndex, const QImage& thumbnail);
+
+    QString lastError() const { return mLastError; }
+
+  private:
+    bool   startNew();
+    bool   remap();
+    void   unmap();
+    qint64 slotSize() const;
+
+    QString            mStreamPath;
+    QSize              mThumbSize;
+    QFile              mFile;
+    uchar*             mMapped;
+    qint64             mMappedSize;
+    bool               mValid;       // mFile holds a current header
+    bool               mWriteFailed; // a partial slot could not be cut off
+    QHash<int, qint64> mSlots;       // frame index -> offset of its pixels
+    QString            mLastError;
+};
+
+#endif // TTTHUMBNAILATLAS_H
@@ -15,8 +15,6 @@
 
 #include "ttmpeg2decoder.h"
 
-static TFrameInfo frameInfo;
-
 /* /////////////////////////////////////////////////////////////////////////////
  * Constructor with filename, index- and header-list
  */
@@ -32,6 +30,7 @@ TTMpeg2Decoder::TTMpeg2Decoder(QString cFName, TTVideoIndexList* viIndex, TTVide
   videoIndexList     = viIndex;
   videoHeaderList    = viHeader;
   t_frame_info       = NULL;
+  mKeyframesOnly     = false;
 
    if (!ttAssigned(videoIndexList) && !ttAssigned(videoHeaderList))
     throw TTMpeg2DecoderException(TTMpeg2DecoderException::ArgumentNull);
@@ -187,6 +186,12 @@ int TTMpeg2Decoder::decodeNextFrame()
         }
         mpeg2_buffer (mpeg2Decoder, streamBuffer, streamBuffer + readSize);
         break;
+      case STATE_PICTURE:
+        // Reduced profile: decode the slices of I pictures only
+        if (mKeyframesOnly)
+          mpeg2_skip(mpeg2Decoder,
+                     (mpeg2Info->current_picture->flags & PIC_MASK_CODING_TYPE) != PIC_FLAG_CODING_TYPE_I);
+        break;
     case STATE_SEQUENCE:
         switch ( convType )
         {
@@ -216,6 +221,7 @@ int TTMpeg2Decoder::decodeNextFrame()
           frameInfo.width         = mpeg2Info->sequence->width;
           frameInfo.height        = mpeg2Info->sequence->height;
           frameInfo.type          = mpeg2Info->display_picture->flags&0x03;
+          frameInfo.temporal_reference = mpeg2Info->display_picture->temporal_reference;
           frameInfo.chroma_width  = mpeg2Info->sequence->chroma_width;
           frameInfo.chroma_height = mpeg2Info->sequence->chroma_height;
 
@@ -290,6 +296,34 @@ TFrameInfo* TTMpeg2Decoder::decodeMPEG2Frame(TPixelFormat pixelFormat)
   return t_frame_info;
 }
 
+/* /////////////////////////////////////////////////////////////////////////////
+ * Decode the frame following the current one in display order. Unlike
+ * decodeMPEG2Frame() it does not stop at the end of the file: the pictures
+ * libmpeg2 still holds come out after the sequence end code decodeNextFrame()
+ * feeds it there.
+ */
+TFrameInfo* TTMpeg2Decoder::decodeNextDisplayFrame()
+{
+  decodeNextFrame();
+  return t_frame_info;
+}
+
+/* /////////////////////////////////////////////////////////////////////////////
+ * Picture coding type of the current frame
+ */
+int TTMpeg2Decoder::currentFrameType() const
+{
+  return (t_frame_info != NULL) ? t_frame_info->type : 0;
+}
+
+/* /////////////////////////////////////////////////////////////////////////////
+ * Temporal reference of the current frame
+ */
+int TTMpeg2Decoder::currentTemporalReference() const
+{
+  return (t_frame_info != NULL) ? t_frame_info->temporal_reference : -1;
+}
+
 /* /////////////////////////////////////////////////////////////////////////////
  * Move to given index position and decode the frame
  */
@@ -366,11 +400,81 @@ int TTMpeg2Decoder::moveToFrameIndex(int framePosition)
   while (t_frame_info != NULL && frameInfo.type != 1)
     decodeNextFrame();
 
+  if (mKeyframesOnly)
+    return intraFramePosition;
+
   skipFrames(framePosition-intraFramePosition);
 
   return framePosition;
 }
 
+/* /////////////////////////////////////////////////////////////////////////////
+ * Enable/disable the reduced (I pictures only) decode profile
+ */
+void TTMpeg2Decoder::setKeyframesOnly(bool enabled)
+{
+  mKeyframesOnly = enabled;
+  if (!enabled)
+    mpeg2_skip(mpeg2Decoder, 0);
+}
+
+/* /////////////////////////////////////////////////////////////////////////////
+ * Sample the current YUV frame down to size. BT.601 limited range, the
+ * matrix of libmpeg2's own RGB conversion.
+ */
+QImage TTMpeg2Decoder::reducedImage(const QSize& size, bool grayscale) const
+{
+  if (t_frame_info == NULL || convType != formatYV12 || size.isEmpty())
+    return QImage();
+
+  const int w  = t_frame_info->width;
+  const int h  = t_frame_info->height;
+  const int cw = t_frame_info->chroma_width;
+  const int ch = t_frame_info->chroma_height;
+  if (w < 2 || h < 2 || cw <= 0 || ch <= 0)
+    return QImage();
+
+  QImage image(size, grayscale ? QImage::Format_Grayscale8 : QImage::Format_RGB32);
+  if (image.isNull())
+    return image;
+
+  const quint8* yPlane = t_frame_info->Y;
+  const quint8* uPlane = t_frame_info->U;
+  const quint8* vPlane = t_frame_info->V;
+
+  for (int oy = 0; oy < size.height(); oy++)
+  {
+    // 2x2 luma block around the output pixel's centre
+    const int sy  = qMin(h - 2, (2 * oy + 1) * h / (2 * size.height()));
+    const int csy = qMin(ch - 1, sy * ch / h);
+    const quint8* y0 = yPlane + sy * w;
+    const quint8* y1 = y0 + w;
+    uchar* out = image.scanLine(oy);
+
+    for (int ox = 0; ox < size.width(); ox++)
+    {
+      const int sx  = qMin(w - 2, (2 * ox + 1) * w / (2 * size.width()));
+      const int c   = ((y0[sx] + y0[sx + 1] + y1[sx] + y1[sx + 1] + 2) >> 2) - 16;
+      const int lum = 298 * c + 128;
+
+      if (grayscale)
+      {
+        out[ox] = (uchar)qBound(0, lum >> 8, 255);
+        continue;
+      }
+
+      const int ci = csy * cw + qMin(cw - 1, sx * cw / w);
+      const int d  = uPlane[ci] - 128;
+      const int e  = vPlane[ci] - 128;
+      const int r  = qBound(0, (lum + 409 * e) >> 8, 255);
+      const int g  = qBound(0, (lum - 100 * d - 208 * e) >> 8, 255);
+      const int b  = qBound(0, (lum + 516 * d) >> 8, 255);
+      ((QRgb*)out)[ox] = qRgb(r, g, b);
+    }
+  }
+  return image;
+}
+
 /* /////////////////////////////////////////////////////////////////////////////
  * Exception class for TTMpeg2Decoder
  */
@@ -31,6 +31,7 @@ extern "C"
 
 // Qt header files
 #include <qstring.h>
+#include <QImage>
 
 #include "../avstream/ttavheader.h"
 #include "../avstream/ttvideoheaderlist.h"
@@ -61,6 +62,7 @@ typedef struct
   int      height;
   int      size;
   int      type;
+  int      temporal_reference;
   int      chroma_width;
   int      chroma_height;
   int      chroma_size;
@@ -112,6 +114,24 @@ class TTMpeg2Decoder
   TFrameInfo* decodeFirstMPEG2Frame(TPixelFormat pixelFormat=formatRGB32);
   TFrameInfo* decodeMPEG2Frame(TPixelFormat pixelFormat=formatRGB32);
   TFrameInfo* getFrameInfo();
+  // Sequential decode: the frame following the current one in display
+  // order (moveToFrameIndex() positions the decoder once). Also drains the
+  // pictures libmpeg2 still holds at the end of the stream.
+  TFrameInfo* decodeNextDisplayFrame();
+  // Picture coding type of the current frame (1=I, 2=P, 3=B), 0 if none
+  int         currentFrameType() const;
+  // Temporal reference of the current frame (its display position in the
+  // GOP), -1 if none
+  int         currentTemporalReference() const;
+
+  // Reduced profile (thumbnails, keyframe scans): only I pictures are
+  // decoded - libmpeg2 skips the slices of every P/B picture - and
+  // moveToFrameIndex() stops at the I-frame at/before the position.
+  void        setKeyframesOnly(bool enabled);
+  // The current frame sampled down from its YUV planes (decoder created
+  // with formatYV12) to size: RGB32, or Grayscale8 full-range luma. Reads
+  // 2x2 luma pixels per output pixel instead of converting the full frame.
+  QImage      reducedImage(const QSize& size, bool grayscale) const;
 
   int desiredFrameType;
   int desiredFramePos;
@@ -136,6 +156,8 @@ private:
   TTVideoIndexList*   videoIndexList;
   TPixelFormat        convType;
   TFrameInfo*         t_frame_info;
+  TFrameInfo          frameInfo;      // per instance: decoders run in parallel
+  bool                mKeyframesOnly;
 };
 
 /* /////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,154 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttframedecodethread.h"
+
+#include "../common/ttsettings.h"
+#include "../extern/ttffmpegwrapper.h"
+
+#include <QDebug>
+
+TTFrameDecodeThread::TTFrameDecodeThread(TTFFmpegWrapper* wrapper, QObject* parent)
+  : QThread(parent),
+    mWrapper(wrapper),
+    mPending(-1),
+    mPendingBackward(false),
+    mPendingYuv(false),
+    mBusy(false),
+    mStop(false),
+    mGeneration(0),
+    mPixelAspect(1.0)
+{
+}
+
+TTFrameDecodeThread::~TTFrameDecodeThread()
+{
+  stop();
+}
+
+// ----------------------------------------------------------------------------
+// Requests (GUI thread)
+// ----------------------------------------------------------------------------
+void TTFrameDecodeThread::request(int displayPos, bool backward, bool yuv)
+{
+  QMutexLocker lock(&mStateLock);
+  mPending         = displayPos;
+  mPendingBackward = backward;
+  mPendingYuv      = yuv;
+  ++mGeneration;
+  // The decode in flight is for a position nobody wants any more. The
+  // worker clears the abort when that job ends, so it never hits this one.
+  if (mBusy)
+    mWrapper->setDecodeAbort(true);
+  mWake.wakeOne();
+}
+
+void TTFrameDecodeThread::cancel()
+{
+  QMutexLocker lock(&mStateLock);
+  mPending = -1;
+  ++mGeneration;
+  if (mBusy)
+    mWrapper->setDecodeAbort(true);
+  while (mBusy)
+    mIdle.wait(&mStateLock);
+}
+
+void TTFrameDecodeThread::waitForIdle()
+{
+  QMutexLocker lock(&mStateLock);
+  while (mBusy || mPending >= 0)
+    mIdle.wait(&mStateLock);
+}
+
+void TTFrameDecodeThread::stop()
+{
+  if (!isRunning()) return;
+  cancel();
+  {
+    QMutexLocker lock(&mStateLock);
+    mStop = true;
+    mWake.wakeOne();
+  }
+  wait();
+}
+
+// ----------------------------------------------------------------------------
+// Worker
+// ----------------------------------------------------------------------------
+void TTFrameDecodeThread::run()
+{
+  forever {
+    int pos;
+    bool backward, yuv;
+    quint64 generation;
+    {
+      QMutexLocker lock(&mStateLock);
+      while (mPending < 0 && !mStop)
+        mWake.wait(&mStateLock);
+      if (mStop) return;
+      pos        = mPending;
+      backward   = mPendingBackward;
+      yuv        = mPendingYuv;
+      generation = mGeneration.load();
+      mPending   = -1;
+      mBusy      = true;
+    }
+
+    {
+      QMutexLocker decoder(&mDecoderLock);
+
+      // Something to look at while the seek + prefill runs. A keyframe
+      // target comes out of decodeNearestKeyframe() exact and cached, so
+      // decodeFrame() below returns it at once - no preview for it.
+      if (!superseded(generation) && !mWrapper->decodesWithoutSeek(pos)) {
+        int shownPos = -1;
+        const QImage keyframe = mWrapper->decodeNearestKeyframe(pos, &shownPos);
+        mPixelAspect = mWrapper->sampleAspectRatio();
+        if (!keyframe.isNull() && shownPos != pos && !superseded(generation))
+          emit keyframeReady(pos, shownPos, keyframe);
+      }
+
+      // A null image still answers the request (decode failure), unless
+      // the request was superseded or cancelled
+      if (!superseded(generation)) {
+        bool decoded;
+        if (yuv) {
+          // The one copy out of the wrapper's buffers, on this thread
+          TFrameInfo info;
+          decoded = mWrapper->decodePreviewFrameYUV(pos, info);
+          mPixelAspect = mWrapper->sampleAspectRatio();
+          const TTYuvFrame frame = decoded
+              ? TTYuvFrame::fromPlanes(info.Y, info.U, info.V, info.width, info.height,
+                                       info.chroma_width, info.chroma_height)
+              : TTYuvFrame();
+          if (!superseded(generation))
+            emit yuvFrameReady(pos, frame);
+        } else {
+          const QImage image = mWrapper->decodeFrame(pos);
+          decoded = !image.isNull();
+          mPixelAspect = mWrapper->sampleAspectRatio();
+          if (!superseded(generation))
+            emit frameReady(pos, image);
+        }
+        if (superseded(generation)) {
+          if (TTSettings::instance()->logFFmpegDecoder())
+            qDebug() << "Preview decode of display" << pos << "superseded";
+        } else if (backward && decoded) {
+          mWrapper->startBackwardPrefetch(pos);
+        }
+      }
+    }
+
+    QMutexLocker lock(&mStateLock);
+    mBusy = false;
+    mWrapper->setDecodeAbort(false);
+    mIdle.wakeAll();
+  }
+}
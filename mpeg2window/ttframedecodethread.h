@@ -0,0 +1,88 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTFRAMEDECODETHREAD
+// Decodes TTMPEG2Window2's H.264/H.265 preview frames off the GUI thread.
+//
+// Requests are latest-wins: request() replaces a request not yet started
+// and aborts the decode in flight, so scrubbing never queues work for
+// positions the slider has left. A frame that needs a seek is announced
+// with its nearest keyframe first (keyframeReady, ~one seek + a few
+// packets), then the exact frame follows (frameReady, or yuvFrameReady for
+// a YUV request: the planes without RGB conversion). Cached frames and
+// steps that continue the decoder's run skip the keyframe.
+//
+// The wrapper stays owned by the window. Every wrapper call - here and on
+// the GUI thread - holds decoderLock(); synchronous users cancel() first so
+// they do not wait for a stale decode.
+
+#ifndef TTFRAMEDECODETHREAD_H
+#define TTFRAMEDECODETHREAD_H
+
+#include <QImage>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <atomic>
+
+#include "ttyuvframe.h"
+
+class TTFFmpegWrapper;
+
+class TTFrameDecodeThread : public QThread
+{
+  Q_OBJECT
+
+  public:
+    explicit TTFrameDecodeThread(TTFFmpegWrapper* wrapper, QObject* parent = nullptr);
+    ~TTFrameDecodeThread() override;
+
+    // Decode displayPos next, dropping any older request. backward starts
+    // the wrapper's backward prefetch once the frame is shown; yuv answers
+    // with yuvFrameReady instead of frameReady.
+    void request(int displayPos, bool backward, bool yuv = false);
+    // Drop the pending request, abort the one in flight and wait for it
+    void cancel();
+    // Wait until the pending request is decoded (results may still be queued)
+    void waitForIdle();
+    // cancel() and end the thread
+    void stop();
+
+    QMutex& decoderLock() { return mDecoderLock; }
+    // The wrapper's sample aspect ratio as of the last frame delivered
+    // (reading it from the GUI thread would race the decoder)
+    double pixelAspect() const { return mPixelAspect.load(); }
+
+  signals:
+    void keyframeReady(int requestedPos, int shownPos, const QImage& image);
+    void frameReady(int displayPos, const QImage& image);
+    void yuvFrameReady(int displayPos, const TTYuvFrame& frame);
+
+  protected:
+    void run() override;
+
+  private:
+    bool superseded(quint64 generation) const { return generation != mGeneration.load(); }
+
+    TTFFmpegWrapper*     mWrapper;
+    QMutex               mDecoderLock;
+    QMutex               mStateLock;
+    QWaitCondition       mWake;
+    QWaitCondition       mIdle;
+    int                  mPending;       // -1: none
+    bool                 mPendingBackward;
+    bool                 mPendingYuv;
+    bool                 mBusy;
+    bool                 mStop;
+    std::atomic<quint64> mGeneration;    // bumped by every request()/cancel()
+    std::atomic<double>  mPixelAspect;
+};
+
+#endif // TTFRAMEDECODETHREAD_H
@@ -13,6 +13,8 @@
 // ----------------------------------------------------------------------------
 
 #include "ttmpeg2window2.h"
+#include "ttframedecodethread.h"
+#include "ttyuvvideowidget.h"
 #include "../avstream/ttavstream.h"
 #include "../avstream/tth26xvideostream.h"  // provideFrameIndexTo (index sharing)
 
@@ -45,6 +47,11 @@ TTMPEG2Window2::TTMPEG2Window2(QWidget *parent )
   mpeg2Decoder     = 0;
   mpFFmpegWrapper  = 0;
   mUseFFmpeg       = false;
+  mpDecodeThread   = 0;
+  mRequestedIndex  = -1;
+  mInvalidateOnArrival = false;
+  mPixelAspect     = 1.0;
+  mpYuvView        = 0;
   currentIndex     = 0;
   mAspectIndex     = 0;
   picBuffer        = 0;
@@ -60,6 +67,8 @@ TTMPEG2Window2::TTMPEG2Window2(QWidget *parent )
  */
 void TTMPEG2Window2::resizeEvent (QResizeEvent*)
 {
+  if (mpYuvView != 0)
+    mpYuvView->setGeometry(rect());
 	showVideoFrame();
 }
 
@@ -70,6 +79,8 @@ void TTMPEG2Window2::showVideoFrame()
 {
   QImage frameToShow;
 
+  if (mpYuvView != 0 && mpYuvView->isVisible()) return;   // scales itself
+
   if (mUseFFmpeg) {
     // Use FFmpeg decoded frame
     if (mCurrentFrame.isNull()) return;
@@ -128,7 +139,7 @@ void TTMPEG2Window2::showVideoFrame()
     // correct the display aspect in the upscale direction so no detail is
     // lost before the final widget scaling. mpv playback applies the same
     // correction — still frame and playback keep the same shape.
-    double sar = mpFFmpegWrapper->sampleAspectRatio();
+    double sar = mPixelAspect;
     if (sar > 0.0 && qAbs(sar - 1.0) > 0.005) {
       if (sar > 1.0)
         scaleFactorX = (float)sar;          // widen (e.g. 720 -> 1047)
@@ -154,6 +165,7 @@ void TTMPEG2Window2::showVideoFrame()
 void TTMPEG2Window2::setSubtitleStream(TTSubtitleStream* subtitleStream)
 {
   mpSubtitleStream = subtitleStream;
+  leaveYuvView();   // the overlay is drawn into the label's pixmap
 }
 
 /*!
@@ -274,11 +286,144 @@ void TTMPEG2Window2::drawSubtitleOnImage(QImage& image, const QString& text)
 void TTMPEG2Window2::invalidateDisplay()
 {
   currentIndex = -1;
+  // ...also when the frame showFrameAt() asked for is still being decoded
+  mInvalidateOnArrival = mRequestedIndex >= 0;
 }
 
 void TTMPEG2Window2::showFrameAt(int index)
 {
-  moveToVideoFrame(index);
+  if (!mUseFFmpeg || mpDecodeThread == 0) {
+    moveToVideoFrame(index);
+    return;
+  }
+
+  // Compare against the frame on its way, not the one on screen: a repeat
+  // of the request in flight is a no-op, a step back from it is backward
+  const int latest = mRequestedIndex >= 0 ? mRequestedIndex : currentIndex;
+  if (index == latest) return;
+
+  mRequestedIndex      = index;
+  mInvalidateOnArrival = false;
+  mpDecodeThread->request(index, index < latest, yuvViewWanted());
+}
+
+bool TTMPEG2Window2::yuvViewWanted() const
+{
+  return mpYuvView != 0 && mpYuvView->isUsable() && mpSubtitleStream == 0
+      && !mLogoROIOverlay.isValid() && !mLogoSelectionMode;
+}
+
+void TTMPEG2Window2::showYuvView(bool show)
+{
+  if (mpYuvView == 0 || mpYuvView->isVisible() == show) return;
+  mpYuvView->setVisible(show);
+}
+
+/*!
+ * Back to the QLabel path (subtitles, logo tools, GL failure): the frame on
+ * the view is decoded again as RGB - a cache hit in the wrapper
+ */
+void TTMPEG2Window2::leaveYuvView()
+{
+  if (mpYuvView == 0 || !mpYuvView->isVisible()) return;
+  showYuvView(false);
+  if (currentIndex >= 0 && mCurrentFrame.isNull()) {
+    const int pos = currentIndex;
+    currentIndex = -1;
+    moveToVideoFrame(pos);
+  } else {
+    showVideoFrame();
+  }
+}
+
+/*!
+ * Decode thread: the keyframe at/before the requested position, shown
+ * until the exact frame arrives. currentIndex stays -1 meanwhile (the
+ * re-decode marker of invalidateDisplay()) - the screen does not show it.
+ */
+void TTMPEG2Window2::onKeyframeDecoded(int requestedPos, int shownPos, const QImage& image)
+{
+  if (requestedPos != mRequestedIndex) return;   // superseded meanwhile
+
+  mCurrentFrame = image;
+  currentIndex  = -1;
+  mAspectIndex  = shownPos;
+  mPixelAspect  = mpDecodeThread->pixelAspect();
+  if (yuvViewWanted()) {
+    // The exact frame follows as YUV on the same view
+    mpYuvView->setImage(image, mPixelAspect);
+    showYuvView(true);
+    return;
+  }
+  showYuvView(false);
+  showVideoFrame();
+}
+
+void TTMPEG2Window2::onFrameDecoded(int displayPos, const QImage& image)
+{
+  if (displayPos != mRequestedIndex) return;
+  mRequestedIndex = -1;
+  if (image.isNull()) return;   // decodeFrame() logged it; keep what is shown
+
+  mCurrentFrame = image;
+  currentIndex  = mInvalidateOnArrival ? -1 : displayPos;
+  mAspectIndex  = displayPos;
+  mPixelAspect  = mpDecodeThread->pixelAspect();
+  mInvalidateOnArrival = false;
+  showYuvView(false);
+  showVideoFrame();
+}
+
+/*!
+ * Decode thread, YUV request: the planes go to the GL view as they are -
+ * no swscale pass, no QImage scaling. mCurrentFrame stays null until
+ * grabFrameImage() needs it.
+ */
+void TTMPEG2Window2::onYuvFrameDecoded(int displayPos, const TTYuvFrame& frame)
+{
+  if (displayPos != mRequestedIndex) return;
+  mRequestedIndex = -1;
+  if (frame.isNull()) return;   // decodeFrame() logged it; keep what is shown
+
+  mCurrentFrame = QImage();
+  currentIndex  = mInvalidateOnArrival ? -1 : displayPos;
+  mAspectIndex  = displayPos;
+  mPixelAspect  = mpDecodeThread->pixelAspect();
+  mInvalidateOnArrival = false;
+
+  if (!yuvViewWanted()) {
+    // Subtitles or a logo tool came up while the frame was on its way
+    const int pos = displayPos;
+    currentIndex = -1;
+    moveToVideoFrame(pos);
+    return;
+  }
+  mpYuvView->setFrame(frame, mPixelAspect);
+  showYuvView(true);
+}
+
+/*!
+ * The view's shader did not build on this GL: QLabel path from now on
+ */
+void TTMPEG2Window2::onYuvViewUnusable()
+{
+  leaveYuvView();
+}
+
+TTFFmpegWrapper* TTMPEG2Window2::ffmpegWrapper() const
+{
+  if (mpDecodeThread != 0)
+    mpDecodeThread->waitForIdle();
+  return mpFFmpegWrapper;
+}
+
+void TTMPEG2Window2::stopDecodeThread()
+{
+  if (mpDecodeThread == 0) return;
+  mpDecodeThread->stop();
+  delete mpDecodeThread;
+  mpDecodeThread  = 0;
+  mRequestedIndex = -1;
 }
 
 int TTMPEG2Window2::showKeyframeFastAt(int index)
@@ -292,6 +437,11 @@ int TTMPEG2Window2::showKeyframeFastAt(int index)
 
   if (mpFFmpegWrapper == 0) return -1;
 
+  if (mpDecodeThread != 0)
+    mpDecodeThread->cancel();
+  mRequestedIndex = -1;
+  QMutexLocker decoder(mpDecodeThread ? &mpDecodeThread->decoderLock() : nullptr);
+
   int shownPos = -1;
   QImage img = mpFFmpegWrapper->decodeNearestKeyframe(index, &shownPos);
   if (img.isNull()) return -1;
@@ -299,6 +449,8 @@ int TTMPEG2Window2::showKeyframeFastAt(int index)
   mCurrentFrame = img;
   currentIndex  = shownPos;
   mAspectIndex  = shownPos;
+  mPixelAspect  = mpFFmpegWrapper->sampleAspectRatio();
+  showYuvView(false);
   showVideoFrame();
   return shownPos;
 }
@@ -341,12 +493,14 @@ void TTMPEG2Window2::openVideoStream(TTVideoStream* vStream)
     mUseFFmpeg = true;
     qDebug() << "Using FFmpeg for H.264/H.265";
 
+    stopDecodeThread();
     if (mpFFmpegWrapper != 0) {
       mpFFmpegWrapper->closeFile();
       delete mpFFmpegWrapper;
     }
 
     mpFFmpegWrapper = new TTFFmpegWrapper();
+    mpFFmpegWrapper->setDecodeThreads(0);   // frame threads: seek latency
     if (!mpFFmpegWrapper->openFile(vStream->filePath())) {
       log->errorMsg(__FILE__, __LINE__,
           QString("Failed to open H.264/H.265 stream: %1").arg(mpFFmpegWrapper->lastError()));
@@ -377,10 +531,32 @@ void TTMPEG2Window2::openVideoStream(TTVideoStream* vStream)
              << mpFFmpegWrapper->frameCount() << "frames"
              << "(videoStream:" << vStream->frameCount() << "headers)";
 
+    // Interactive navigation decodes off the GUI thread (showFrameAt)
+    mpDecodeThread = new TTFrameDecodeThread(mpFFmpegWrapper);
+    connect(mpDecodeThread, &TTFrameDecodeThread::keyframeReady,
+            this, &TTMPEG2Window2::onKeyframeDecoded);
+    connect(mpDecodeThread, &TTFrameDecodeThread::frameReady,
+            this, &TTMPEG2Window2::onFrameDecoded);
+    connect(mpDecodeThread, &TTFrameDecodeThread::yuvFrameReady,
+            this, &TTMPEG2Window2::onYuvFrameDecoded);
+    mpDecodeThread->start();
+
+    // ...and is shown by the GPU (TTCUT_DIAG_NO_YUV_VIEW=1: QLabel path).
+    // The view outlives the stream: its GL context is set up once.
+    if (mpYuvView == 0 && !qEnvironmentVariableIsSet("TTCUT_DIAG_NO_YUV_VIEW")) {
+      mpYuvView = new TTYuvVideoWidget(this);
+      mpYuvView->setGeometry(rect());
+      mpYuvView->hide();
+      // queued: it is emitted from inside the view's initializeGL()
+      connect(mpYuvView, &TTYuvVideoWidget::unusable,
+              this, &TTMPEG2Window2::onYuvViewUnusable, Qt::QueuedConnection);
+    }
+
     qDebug() << "Opened H.264/H.265 stream with FFmpeg decoder";
   } else {
     // Use MPEG-2 decoder for MPEG-2 streams
     mUseFFmpeg = false;
+    showYuvView(false);
     qDebug() << "Using MPEG-2 decoder";
     TTMpeg2VideoStream* mpeg2Stream = dynamic_cast<TTMpeg2VideoStream*>(vStream);
     if (mpeg2Stream) {
@@ -396,6 +572,11 @@ void TTMPEG2Window2::openVideoStream(TTVideoStream* vStream)
 void TTMPEG2Window2::closeVideoStream()
 {
   // Clean up FFmpeg decoder
+  stopDecodeThread();
+  if (mpYuvView != 0) {
+    showYuvView(false);
+    mpYuvView->clear();
+  }
   if (mpFFmpegWrapper != 0)
   {
     mpFFmpegWrapper->closeFile();
@@ -416,6 +597,7 @@ void TTMPEG2Window2::closeVideoStream()
   mpVideoStream = 0;
   currentIndex = 0;
   mAspectIndex = 0;
+  mPixelAspect = 1.0;
 
   QImage dummy;
   this->setPixmap(QPixmap::fromImage(dummy));
@@ -424,17 +606,31 @@ void TTMPEG2Window2::closeVideoStream()
 
 void TTMPEG2Window2::moveToVideoFrame(int iFramePos)
 {
+  // A frame still on its way from the decode thread is superseded by this one
+  if (mpDecodeThread != 0) {
+    mpDecodeThread->cancel();
+    mRequestedIndex = -1;
+  }
+
   if (iFramePos == currentIndex) return;
 
   if (mUseFFmpeg) {
     // Use FFmpeg decoder for H.264/H.265
     if (mpFFmpegWrapper == 0) return;
+    QMutexLocker decoder(mpDecodeThread ? &mpDecodeThread->decoderLock() : nullptr);
 
+    const bool backward = iFramePos < currentIndex;
     mCurrentFrame = mpFFmpegWrapper->decodeFrame(iFramePos);
     if (!mCurrentFrame.isNull()) {
       currentIndex = iFramePos;
       mAspectIndex = iFramePos;
+      mPixelAspect = mpFFmpegWrapper->sampleAspectRatio();
+      showYuvView(false);
       showVideoFrame();
+      // Stepping backward: have the preceding GOP decoded in the background
+      // by the time the steps reach it (reverse playback by holding the key)
+      if (backward)
+        mpFFmpegWrapper->startBackwardPrefetch(iFramePos);
     }
     return;
   }
@@ -554,6 +750,8 @@ QRect TTMPEG2Window2::widgetToImageRect(const QRect& widgetRect) const
 void TTMPEG2Window2::setLogoSelectionMode(bool enable)
 {
   mLogoSelectionMode = enable;
+  if (enable)
+    leaveYuvView();   // the rubber band maps through the label's pixmap
   setCursor(enable ? Qt::CrossCursor : Qt::ArrowCursor);
   if (!enable && mRubberBand) {
     mRubberBand->hide();
@@ -606,6 +804,8 @@ void TTMPEG2Window2::mouseReleaseEvent(QMouseEvent* event)
 void TTMPEG2Window2::setLogoROIOverlay(const QRect& imageCoords)
 {
   mLogoROIOverlay = imageCoords;
+  if (mLogoROIOverlay.isValid())
+    leaveYuvView();
   update();
 }
 
@@ -633,10 +833,18 @@ void TTMPEG2Window2::paintEvent(QPaintEvent* event)
 // Grab current frame as QImage
 // ---------------------------------------------------------------------------
 
-QImage TTMPEG2Window2::grabFrameImage() const
+QImage TTMPEG2Window2::grabFrameImage()
 {
-  if (mUseFFmpeg)
+  if (mUseFFmpeg) {
+    if (mCurrentFrame.isNull() && currentIndex >= 0 && mpFFmpegWrapper != 0) {
+      if (mpDecodeThread != 0)
+        mpDecodeThread->cancel();
+      mRequestedIndex = -1;
+      QMutexLocker decoder(mpDecodeThread ? &mpDecodeThread->decoderLock() : nullptr);
+      mCurrentFrame = mpFFmpegWrapper->decodeFrame(currentIndex);
+    }
     return mCurrentFrame;
+  }
 
   if (picBuffer && videoWidth > 0 && videoHeight > 0)
     return QImage(picBuffer, videoWidth, videoHeight, QImage::Format_RGB32).copy();
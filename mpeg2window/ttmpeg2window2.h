@@ -36,6 +36,9 @@
 #include "../extern/ttffmpegwrapper.h"
 
 class TTSubtitleStream;
+class TTFrameDecodeThread;
+class TTYuvVideoWidget;
+struct TTYuvFrame;
 
 class TTMPEG2Window2 : public QLabel
 {
@@ -52,12 +55,18 @@ class TTMPEG2Window2 : public QLabel
 
     // Check if using FFmpeg decoder (H.264/H.265)
     bool isFFmpegStream() const { return mUseFFmpeg; }
-    TTFFmpegWrapper* ffmpegWrapper() const { return mpFFmpegWrapper; }
+    // Waits for the preview decode thread to go idle first, so the caller
+    // sees the wrapper (and deliveredDecodeIndex) of the frame requested last
+    TTFFmpegWrapper* ffmpegWrapper() const;
 
-    // navigation
+    // navigation: decodes on the calling thread, the frame is on screen when
+    // it returns (searches, logo profile: moveToVideoFrame + grabFrameImage)
     void moveToVideoFrame(int iFramePos);
 
     void showVideoFrame();
+    // Interactive navigation. H.264/H.265: returns at once - the decode
+    // thread shows the nearest keyframe, then the exact frame; a newer
+    // showFrameAt() supersedes it. MPEG-2: same as moveToVideoFrame().
     void showFrameAt(int index);
     // Slider-drag preview: show the keyframe at/before index (H.26x: decoded
     // without DPB prefill - see TTFFmpegWrapper::decodeNearestKeyframe). For
@@ -77,11 +86,19 @@ class TTMPEG2Window2 : public QLabel
     void setLogoSelectionMode(bool enable);
     void setLogoROIOverlay(const QRect& imageCoords);
     void clearLogoROIOverlay();
-    QImage grabFrameImage() const;
+    // H.264/H.265 frames shown through the YUV view have no RGB copy; this
+    // makes one (a frame cache hit)
+    QImage grabFrameImage();
 
   signals:
     void logoROISelected(QRect imageCoords);
 
+  private slots:
+    void onKeyframeDecoded(int requestedPos, int shownPos, const QImage& image);
+    void onFrameDecoded(int displayPos, const QImage& image);
+    void onYuvFrameDecoded(int displayPos, const TTYuvFrame& frame);
+    void onYuvViewUnusable();
+
   protected:
     void paintEvent(QPaintEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
@@ -126,6 +143,17 @@ class TTMPEG2Window2 : public QLabel
     TTFFmpegWrapper*    mpFFmpegWrapper;
     bool                mUseFFmpeg;
     QImage              mCurrentFrame;   // For FFmpeg decoded frames
+    TTFrameDecodeThread* mpDecodeThread;
+    int                 mRequestedIndex; // showFrameAt() position in flight, -1: none
+    bool                mInvalidateOnArrival;  // invalidateDisplay() during that flight
+    double              mPixelAspect;    // SAR of the FFmpeg frame shown
+    // GPU display of the decode thread's YUV frames, over the label. Off
+    // while subtitles or the logo tools draw on the QLabel pixmap.
+    TTYuvVideoWidget*   mpYuvView;
+    void stopDecodeThread();
+    bool yuvViewWanted() const;
+    void showYuvView(bool show);
+    void leaveYuvView();
 };
 
 #endif //TTMPEG2WINDOW_H
@@ -0,0 +1,61 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTYUVFRAME
+// One decoded frame as tight-packed 8-bit 4:2:0 planes: Y, then U, then V.
+// Implicitly shared (QByteArray), so it crosses from TTFrameDecodeThread to
+// the GUI thread without a copy; TTYuvVideoWidget uploads it as is.
+
+#ifndef TTYUVFRAME_H
+#define TTYUVFRAME_H
+
+#include <QByteArray>
+#include <QMetaType>
+
+#include <cstring>
+
+struct TTYuvFrame
+{
+  int        width        = 0;
+  int        height       = 0;
+  int        chromaWidth  = 0;
+  int        chromaHeight = 0;
+  QByteArray planes;
+
+  bool isNull() const { return planes.isEmpty(); }
+
+  const char* y() const { return planes.constData(); }
+  const char* u() const { return y() + qsizetype(width) * height; }
+  const char* v() const { return u() + qsizetype(chromaWidth) * chromaHeight; }
+
+  // Copies the three planes (TTFFmpegWrapper::decodePreviewFrameYUV output)
+  static TTYuvFrame fromPlanes(const quint8* y, const quint8* u, const quint8* v,
+                               int width, int height, int chromaWidth, int chromaHeight)
+  {
+    TTYuvFrame frame;
+    const qsizetype lumaSize   = qsizetype(width) * height;
+    const qsizetype chromaSize = qsizetype(chromaWidth) * chromaHeight;
+    if (y == nullptr || u == nullptr || v == nullptr || lumaSize <= 0 || chromaSize <= 0)
+      return frame;
+
+    frame.width        = width;
+    frame.height       = height;
+    frame.chromaWidth  = chromaWidth;
+    frame.chromaHeight = chromaHeight;
+    frame.planes.resize(lumaSize + 2 * chromaSize);
+    char* out = frame.planes.data();
+    memcpy(out, y, lumaSize);
+    memcpy(out + lumaSize, u, chromaSize);
+    memcpy(out + lumaSize + chromaSize, v, chromaSize);
+    return frame;
+  }
+};
+Q_DECLARE_METATYPE(TTYuvFrame)
+
+#endif // TTYUVFRAME_H
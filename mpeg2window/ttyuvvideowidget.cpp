@@ -0,0 +1,218 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+#include "ttyuvvideowidget.h"
+
+#include "../common/ttmessagelogger.h"
+
+#include <QOpenGLShaderProgram>
+
+// GLSL 1.00 / 1.10: Qt defines the precision qualifiers away on desktop GL
+static const char* kVertexShader =
+  "attribute highp vec2 position;\n"
+  "attribute highp vec2 texCoord;\n"
+  "varying highp vec2 vTexCoord;\n"
+  "void main() {\n"
+  "  vTexCoord = texCoord;\n"
+  "  gl_Position = vec4(position, 0.0, 1.0);\n"
+  "}\n";
+
+// BT.601 limited range, the coefficients swscale uses for YUV -> RGB32.
+// RGB mode samples texture 0 as RGBA.
+static const char* kFragmentShader =
+  "varying highp vec2 vTexCoord;\n"
+  "uniform sampler2D texY;\n"
+  "uniform sampler2D texU;\n"
+  "uniform sampler2D texV;\n"
+  "uniform mediump float rgbMode;\n"
+  "void main() {\n"
+  "  if (rgbMode > 0.5) {\n"
+  "    gl_FragColor = vec4(texture2D(texY, vTexCoord).rgb, 1.0);\n"
+  "    return;\n"
+  "  }\n"
+  "  highp float y = 1.164384 * (texture2D(texY, vTexCoord).r - 0.062745);\n"
+  "  highp float u = texture2D(texU, vTexCoord).r - 0.501961;\n"
+  "  highp float v = texture2D(texV, vTexCoord).r - 0.501961;\n"
+  "  gl_FragColor = vec4(y + 1.596027 * v,\n"
+  "                      y - 0.391762 * u - 0.812968 * v,\n"
+  "                      y + 2.017232 * u,\n"
+  "                      1.0);\n"
+  "}\n";
+
+// ----------------------------------------------------------------------------
+// TTYuvVideoWidget
+// ----------------------------------------------------------------------------
+TTYuvVideoWidget::TTYuvVideoWidget(QWidget* parent)
+  : QOpenGLWidget(parent),
+    mProgram(nullptr),
+    mTextures{ 0, 0, 0 },
+    mTextureFormat{ 0, 0, 0 },
+    mUsable(true),
+    mDirty(false),
+    mRgb(false),
+    mPixelAspect(1.0)
+{
+  setAttribute(Qt::WA_TransparentForMouseEvents);   // the window handles the mouse
+}
+
+TTYuvVideoWidget::~TTYuvVideoWidget()
+{
+  releaseGL();
+}
+
+void TTYuvVideoWidget::setFrame(const TTYuvFrame& frame, double pixelAspect)
+{
+  mFrame       = frame;
+  mImage       = QImage();
+  mRgb         = false;
+  mPixelAspect = pixelAspect > 0.0 ? pixelAspect : 1.0;
+  mDirty       = true;
+  update();
+}
+
+void TTYuvVideoWidget::setImage(const QImage& image, double pixelAspect)
+{
+  mImage       = image.convertToFormat(QImage::Format_RGBA8888);
+  mFrame       = TTYuvFrame();
+  mRgb         = true;
+  mPixelAspect = pixelAspect > 0.0 ? pixelAspect : 1.0;
+  mDirty       = true;
+  update();
+}
+
+void TTYuvVideoWidget::clear()
+{
+  mFrame = TTYuvFrame();
+  mImage = QImage();
+  mDirty = true;
+  update();
+}
+
+// ----------------------------------------------------------------------------
+// GL
+// ----------------------------------------------------------------------------
+void TTYuvVideoWidget::initializeGL()
+{
+  initializeOpenGLFunctions();
+  connect(context(), &QOpenGLContext::aboutToBeDestroyed,
+          this, &TTYuvVideoWidget::releaseGL, Qt::DirectConnection);
+
+  mProgram = new QOpenGLShaderProgram();
+  mUsable = mProgram->addShaderFromSourceCode(QOpenGLShader::Vertex, kVertexShader)
+         && mProgram->addShaderFromSourceCode(QOpenGLShader::Fragment, kFragmentShader)
+         && mProgram->link();
+  if (!mUsable) {
+    TTMessageLogger::getInstance()->warningMsg(__FILE__, __LINE__,
+        QString("YUV display: shader failed, using the RGB path: %1").arg(mProgram->log()));
+    delete mProgram;
+    mProgram = nullptr;
+    emit unusable();
+    return;
+  }
+
+  glGenTextures(3, mTextures);
+  for (GLuint texture : mTextures) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+  mDirty = true;
+}
+
+void TTYuvVideoWidget::releaseGL()
+{
+  if (mProgram == nullptr && mTextures[0] == 0) return;
+  makeCurrent();
+  if (mTextures[0] != 0)
+    glDeleteTextures(3, mTextures);
+  for (int i = 0; i < 3; ++i) {
+    mTextures[i] = 0;
+    mTextureSize[i] = QSize();
+  }
+  delete mProgram;
+  mProgram = nullptr;
+  doneCurrent();
+}
+
+// (Re)allocate on a size or format change, otherwise replace the pixels
+void TTYuvVideoWidget::upload(int unit, GLuint texture, GLenum format, int width, int height,
+                              const void* pixels)
+{
+  glActiveTexture(GL_TEXTURE0 + unit);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  if (mTextureSize[unit] != QSize(width, height) || mTextureFormat[unit] != format) {
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+    mTextureSize[unit]   = QSize(width, height);
+    mTextureFormat[unit] = format;
+  } else {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, pixels);
+  }
+}
+
+void TTYuvVideoWidget::paintGL()
+{
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glClear(GL_COLOR_BUFFER_BIT);
+  if (mProgram == nullptr) return;
+
+  const bool haveFrame = mRgb ? !mImage.isNull() : !mFrame.isNull();
+  if (!haveFrame) return;
+  const int width  = mRgb ? mImage.width()  : mFrame.width;
+  const int height = mRgb ? mImage.height() : mFrame.height;
+
+  if (mDirty) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (mRgb) {
+      // RGBA8888 scan lines are 4-byte multiples: bytesPerLine == 4 * width
+      upload(0, mTextures[0], GL_RGBA, width, height, mImage.constBits());
+    } else {
+      upload(0, mTextures[0], GL_LUMINANCE, mFrame.width, mFrame.height, mFrame.y());
+      upload(1, mTextures[1], GL_LUMINANCE, mFrame.chromaWidth, mFrame.chromaHeight, mFrame.u());
+      upload(2, mTextures[2], GL_LUMINANCE, mFrame.chromaWidth, mFrame.chromaHeight, mFrame.v());
+    }
+    mDirty = false;
+  }
+
+  // Letterbox the display aspect (storage aspect x pixel aspect) into the
+  // widget, in device pixels
+  const qreal dpr = devicePixelRatioF();
+  const int   vw  = qRound(this->width() * dpr);
+  const int   vh  = qRound(this->height() * dpr);
+  const double frameAspect  = (double(width) * mPixelAspect) / height;
+  const double widgetAspect = double(vw) / qMax(1, vh);
+  float sx = 1.0f, sy = 1.0f;
+  if (frameAspect > widgetAspect)
+    sy = float(widgetAspect / frameAspect);
+  else
+    sx = float(frameAspect / widgetAspect);
+
+  const GLfloat position[] = { -sx, -sy,   sx, -sy,   -sx, sy,   sx, sy };
+  const GLfloat texCoord[] = { 0.0f, 1.0f,  1.0f, 1.0f,  0.0f, 0.0f,  1.0f, 0.0f };
+
+  glViewport(0, 0, vw, vh);
+  mProgram->bind();
+  mProgram->setUniformValue("texY", 0);
+  mProgram->setUniformValue("texU", 1);
+  mProgram->setUniformValue("texV", 2);
+  mProgram->setUniformValue("rgbMode", mRgb ? 1.0f : 0.0f);
+  for (int unit = 0; unit < 3; ++unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, mTextures[unit]);
+  }
+  mProgram->enableAttributeArray("position");
+  mProgram->enableAttributeArray("texCoord");
+  mProgram->setAttributeArray("position", position, 2);
+  mProgram->setAttributeArray("texCoord", texCoord, 2);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  mProgram->disableAttributeArray("position");
+  mProgram->disableAttributeArray("texCoord");
+  mProgram->release();
+}
@@ -0,0 +1,74 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTYUVVIDEOWIDGET
+// Still-frame display for TTMPEG2Window2 that takes the decoder's YUV 4:2:0
+// planes as they are: three luminance textures, colour conversion and
+// scaling in a fragment shader. Showing a frame costs the plane upload, a
+// resize costs a redraw - no swscale RGB pass, no QImage::scaled().
+//
+// The matrix is the one swscale applies on the RGB path (BT.601, limited
+// range), so a frame looks the same here and in the QImage the searches and
+// the logo tools get. Needs nothing beyond OpenGL ES 2.0 / GL 2.1 - Mesa's
+// software rasterizer will do. isUsable() turns false when the shader does
+// not build; the window then stays on its QLabel path.
+
+#ifndef TTYUVVIDEOWIDGET_H
+#define TTYUVVIDEOWIDGET_H
+
+#include <QImage>
+#include <QOpenGLFunctions>
+#include <QOpenGLWidget>
+
+#include "ttyuvframe.h"
+
+class QOpenGLShaderProgram;
+
+class TTYuvVideoWidget : public QOpenGLWidget, protected QOpenGLFunctions
+{
+  Q_OBJECT
+
+  public:
+    explicit TTYuvVideoWidget(QWidget* parent = nullptr);
+    ~TTYuvVideoWidget() override;
+
+    // pixelAspect: sample aspect ratio (width / height of one pixel)
+    void setFrame(const TTYuvFrame& frame, double pixelAspect);
+    // RGB stand-in (keyframe preview) until the next setFrame()
+    void setImage(const QImage& image, double pixelAspect);
+    void clear();
+
+    bool isUsable() const { return mUsable; }
+
+  signals:
+    // The shader did not build on this GL: the frame handed over is not shown
+    void unusable();
+
+  protected:
+    void initializeGL() override;
+    void paintGL() override;
+
+  private:
+    void upload(int unit, GLuint texture, GLenum format, int width, int height,
+                const void* pixels);
+    void releaseGL();
+
+    QOpenGLShaderProgram* mProgram;
+    GLuint                mTextures[3];
+    QSize                 mTextureSize[3];
+    GLenum                mTextureFormat[3];
+    bool                  mUsable;
+    bool                  mDirty;
+    bool                  mRgb;          // mImage instead of mFrame
+    TTYuvFrame            mFrame;
+    QImage                mImage;
+    double                mPixelAspect;
+};
+
+#endif // TTYUVVIDEOWIDGET_H
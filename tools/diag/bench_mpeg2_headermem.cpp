@@ -0,0 +1,193 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// Memory and build time of the MPEG-2 header list: the header list of a long
+// recording (default: 6 hours, 25 fps, 12-picture GOPs with a sequence header
+// each - generated) built once with a heap allocation per header, the way
+// the parser used to, and once in the list's arena. Prints the resident set
+// growth, the build time and the deleteAll() time of each.
+//
+// A list mixing arena and heap headers must destroy every header exactly
+// once on deleteAll(); counted by a picture header subclass.
+//
+// With an elementary stream given, also prints the load time (header list +
+// index list) and resident set growth of opening it.
+//
+//   usage: bench_mpeg2_headermem [hours] [es-file.m2v]
+
+#include "../../avstream/ttmpeg2videoheader.h"
+#include "../../avstream/ttmpeg2videostream.h"
+#include "../../avstream/ttvideoheaderlist.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+static qint64 rssKiB()
+{
+    QFile f("/proc/self/status");
+    if (!f.open(QIODevice::ReadOnly)) return 0;
+    for (const QByteArray& line : f.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').first().toLongLong();
+    }
+    return 0;
+}
+
+// Give freed memory back, so the next measurement starts from a clean heap
+static void trimHeap()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
+static int destroyed = 0;
+class CountedPicturesHeader : public TTPicturesHeader
+{
+public:
+    ~CountedPicturesHeader() override { ++destroyed; }
+};
+
+template <class T>
+static T* newHeader(TTVideoHeaderList& list, bool arena)
+{
+    return arena ? list.create<T>() : new T();
+}
+
+// Sequence + GOP + I B B P B B P B B P B B per GOP
+static void buildList(TTVideoHeaderList& list, int pictures, bool arena)
+{
+    static const int gopTypes[12] = { 1, 3, 3, 2, 3, 3, 2, 3, 3, 2, 3, 3 };
+    quint64 offset = 0;
+
+    for (int pic = 0; pic < pictures; ++pic) {
+        if (pic % 12 == 0) {
+            TTSequenceHeader* seq = newHeader<TTSequenceHeader>(list, arena);
+            seq->setHeaderOffset(offset);
+            list.add(seq);
+            offset += 150;
+            TTGOPHeader* gop = newHeader<TTGOPHeader>(list, arena);
+            gop->setHeaderOffset(offset);
+            list.add(gop);
+            offset += 8;
+        }
+        TTPicturesHeader* p = newHeader<TTPicturesHeader>(list, arena);
+        p->setHeaderOffset(offset);
+        p->picture_coding_type = gopTypes[pic % 12];
+        p->temporal_reference  = pic % 12;
+        list.add(p);
+        offset += 20000;
+    }
+}
+
+struct BuildResult {
+    int    headers = 0;
+    qint64 rssGrowthKiB = 0;
+    qint64 buildMs = 0;
+    qint64 deleteMs = 0;
+};
+
+static BuildResult measureBuild(int pictures, bool arena)
+{
+    BuildResult r;
+    trimHeap();
+    const qint64 rssBefore = rssKiB();
+
+    TTVideoHeaderList list(2000);
+    QElapsedTimer t;
+    t.start();
+    buildList(list, pictures, arena);
+    r.buildMs      = t.elapsed();
+    r.headers      = list.count();
+    r.rssGrowthKiB = rssKiB() - rssBefore;
+
+    t.restart();
+    list.deleteAll();
+    r.deleteMs = t.elapsed();
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const double hours    = (argc > 1) ? atof(argv[1]) : 6.0;
+    const int    pictures = int(hours * 3600 * 25);
+    if (pictures < 12) {
+        fprintf(stderr, "usage: %s [hours] [es-file.m2v]\n", argv[0]);
+        return 2;
+    }
+
+    const BuildResult heap  = measureBuild(pictures, false);
+    const BuildResult arena = measureBuild(pictures, true);
+    printf("%.1f h, %d headers\n", hours, heap.headers);
+    printf("  heap:  %6lld KiB resident, built in %lld ms, deleted in %lld ms\n",
+           (long long)heap.rssGrowthKiB, (long long)heap.buildMs, (long long)heap.deleteMs);
+    printf("  arena: %6lld KiB resident, built in %lld ms, deleted in %lld ms\n",
+           (long long)arena.rssGrowthKiB, (long long)arena.buildMs, (long long)arena.deleteMs);
+    check(arena.headers == heap.headers, "both lists hold the same headers");
+
+    // Ownership: arena and heap headers in one list, each destroyed once
+    {
+        TTVideoHeaderList list(16);
+        const int total = 1000;
+        for (int i = 0; i < total; ++i) {
+            TTPicturesHeader* p = (i % 3 == 0) ? new CountedPicturesHeader()
+                                               : list.create<CountedPicturesHeader>();
+            p->setHeaderOffset(quint64(i) * 100);
+            list.add(p);
+        }
+        int arenaOwned = 0;
+        for (int i = 0; i < list.count(); ++i)
+            arenaOwned += list.at(i)->arenaOwned() ? 1 : 0;
+        check(arenaOwned == total - (total + 2) / 3, "create() marks its headers arena owned");
+
+        destroyed = 0;
+        list.deleteAll();
+        check(destroyed == total && list.isEmpty(),
+              "deleteAll() destroys arena and heap headers of a mixed list once each");
+    }
+
+    if (argc > 2) {
+        QFileInfo fi(QString::fromLocal8Bit(argv[2]));
+        if (!fi.exists()) {
+            fprintf(stderr, "%s: no such file\n", argv[2]);
+            return 2;
+        }
+        trimHeap();
+        const qint64 rssBefore = rssKiB();
+        TTMpeg2VideoStream vs(fi);
+        QElapsedTimer t;
+        t.start();
+        vs.createHeaderList();
+        vs.createIndexList();
+        const qint64 loadMs = t.elapsed();
+        printf("%s: %d headers, %d pictures, loaded in %lld ms, %lld KiB resident\n",
+               qPrintable(fi.fileName()), vs.headerList()->count(), vs.indexList()->count(),
+               (long long)loadMs, (long long)(rssKiB() - rssBefore));
+    }
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// Header navigation of TTVideoHeaderList on the header list of a long MPEG-2
+// recording (default: 6 hours, 25 fps, 12-picture GOPs with a sequence header
+// each, a sequence end every hour - generated, no input file):
+//
+//  - the walk of TTMpeg2VideoStream::transferCutObjects() over a cut of the
+//    whole recording: getNextHeader(current) per header, plus the next
+//    picture per GOP header,
+//  - the checkIFrameSequence() lookups for every I-frame: next sequence
+//    header and its headerIndex(),
+//  - the same walk the way getNextHeader() used to do it (indexOf() per
+//    step) on the first minutes, extrapolated, for comparison.
+//
+// Every answer is checked against next/previous-of-type tables built in one
+// linear pass.
+//
+//   usage: bench_mpeg2_headernav [hours]
+
+#include "../../avstream/ttmpeg2videoheader.h"
+#include "../../avstream/ttvideoheaderlist.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QVector>
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+static const TTMpeg2VideoHeader::mpeg2StartCodes types[] = {
+    TTMpeg2VideoHeader::sequence_start_code,
+    TTMpeg2VideoHeader::group_start_code,
+    TTMpeg2VideoHeader::picture_start_code,
+    TTMpeg2VideoHeader::sequence_end_code,
+};
+
+// Sequence + GOP + I B B P B B P B B P B B per GOP
+static void buildList(TTVideoHeaderList& list, int pictures)
+{
+    static const int gopTypes[12] = { 1, 3, 3, 2, 3, 3, 2, 3, 3, 2, 3, 3 };
+    const int picturesPerHour = 25 * 3600;
+    quint64 offset = 0;
+
+    for (int pic = 0; pic < pictures; ++pic) {
+        if (pic % 12 == 0) {
+            if (pic > 0 && pic % picturesPerHour == 0) {
+                TTSequenceEndHeader* end = list.create<TTSequenceEndHeader>();
+                end->setHeaderOffset(offset);
+                list.add(end);
+                offset += 4;
+            }
+            TTSequenceHeader* seq = list.create<TTSequenceHeader>();
+            seq->setHeaderOffset(offset);
+            list.add(seq);
+            offset += 150;
+            TTGOPHeader* gop = list.create<TTGOPHeader>();
+            gop->setHeaderOffset(offset);
+            list.add(gop);
+            offset += 8;
+        }
+        TTPicturesHeader* p = list.create<TTPicturesHeader>();
+        p->setHeaderOffset(offset);
+        p->picture_coding_type = gopTypes[pic % 12];
+        p->temporal_reference  = pic % 12;
+        list.add(p);
+        offset += 20000;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    const double hours    = (argc > 1) ? atof(argv[1]) : 6.0;
+    const int    pictures = int(hours * 3600 * 25);
+    if (pictures < 12) {
+        fprintf(stderr, "usage: %s [hours]\n", argv[0]);
+        return 2;
+    }
+
+    TTVideoHeaderList list(2000);
+    QElapsedTimer t;
+    t.start();
+    buildList(list, pictures);
+    const int n = list.count();
+    printf("%.1f h: %d pictures, %d headers, built in %lld ms\n",
+           hours, pictures, n, (long long)t.elapsed());
+
+    // Reference: next/previous header of every type, one linear pass each way
+    QVector<QVector<int>> nextOf(4, QVector<int>(n + 1, -1));
+    QVector<QVector<int>> prevOf(4, QVector<int>(n + 1, -1));
+    for (int k = 0; k < 4; ++k) {
+        for (int i = n - 1; i >= 0; --i)
+            nextOf[k][i] = (list.at(i)->headerType() == types[k]) ? i : nextOf[k][i + 1];
+        int last = -1;
+        for (int i = 0; i < n; ++i) {
+            if (list.at(i)->headerType() == types[k]) last = i;
+            prevOf[k][i] = last;
+        }
+    }
+
+    bool typedOk = true;
+    for (int i = 0; i < n && typedOk; ++i) {
+        for (int k = 0; k < 4; ++k) {
+            const int next = (i + 1 < n) ? nextOf[k][i + 1] : -1;
+            const int prev = (i > 0) ? prevOf[k][i - 1] : -1;
+            TTVideoHeader* nh = list.getNextHeader(i, types[k]);
+            TTVideoHeader* ph = list.getPrevHeader(i, types[k]);
+            if (nh != (next >= 0 ? (TTVideoHeader*)list.at(next) : nullptr) ||
+                ph != (prev >= 0 ? (TTVideoHeader*)list.at(prev) : nullptr)) {
+                printf("position %d type %02x: wrong next/previous header\n", i, int(types[k]));
+                typedOk = false;
+            }
+        }
+    }
+    check(typedOk, "next/previous header of every type matches the linear scan");
+
+    // transferCutObjects over the whole recording
+    t.restart();
+    TTVideoHeader* current = list.headerAt(0);
+    int  steps  = 0;
+    bool walkOk = true;
+    while (current != nullptr) {
+        if (current->headerType() == TTMpeg2VideoHeader::group_start_code) {
+            TTVideoHeader* pic = list.getNextHeader(current, TTMpeg2VideoHeader::picture_start_code);
+            walkOk = walkOk && pic == list.at(steps + 1);
+        }
+        TTVideoHeader* next = list.getNextHeader(current);
+        walkOk = walkOk && (next == (steps + 1 < n ? list.at(steps + 1) : nullptr));
+        current = next;
+        ++steps;
+    }
+    const qint64 walkMs = t.elapsed();
+    check(walkOk && steps == n, "cut walk visits every header in order");
+
+    // checkIFrameSequence for every I-frame
+    t.restart();
+    bool seqOk = true;
+    int  iFrames = 0;
+    for (int i = 0; i < n; ++i) {
+        TTVideoHeader* h = list.headerAt(i);
+        if (h->headerType() != TTMpeg2VideoHeader::picture_start_code ||
+            static_cast<TTPicturesHeader*>(h)->picture_coding_type != 1)
+            continue;
+        ++iFrames;
+        const int from = qMax(0, i - 2);
+        TTVideoHeader* seq = list.getNextHeader(from, TTMpeg2VideoHeader::sequence_start_code);
+        const int expected = nextOf[0][from + 1];
+        seqOk = seqOk && seq == (expected >= 0 ? list.at(expected) : nullptr);
+        if (seq != nullptr)
+            seqOk = seqOk && list.headerIndex(seq) == expected;
+    }
+    const qint64 seqMs = t.elapsed();
+    check(seqOk, "sequence header lookup and headerIndex() for every I-frame");
+
+    // The old getNextHeader(current): indexOf() per step, on a prefix
+    const int prefix = qMin(n, 20000);
+    t.restart();
+    int found = 0;
+    for (int i = 0; i < prefix; ++i)
+        found += (list.indexOf(list.at(i)) == i);
+    const qint64 prefixMs = t.elapsed();
+    const double oldMs = double(prefixMs) * (double(n) / prefix) * (double(n) / prefix);
+
+    printf("cut walk: %d headers in %lld ms\n", steps, (long long)walkMs);
+    printf("I-frame sequence lookups: %d in %lld ms\n", iFrames, (long long)seqMs);
+    printf("indexOf walk: %d headers in %lld ms, whole list extrapolated ~%.0f s\n",
+           found, (long long)prefixMs, oldMs / 1000.0);
+
+    list.deleteAll();
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Benchmark for TTStartCodeScanner: walks a whole ES file the way            */
+/* TTNaluParser::findNextStartCode() does (prefix search + 3/4-byte check,    */
+/* resume after the start code) once per implementation, and verifies every  */
+/* vector variant reports the identical start-code list as the scalar loop.  */
+/*                                                                            */
+/*   usage: bench_startcode_scan <input.264|input.265|input.m2v> [rounds]     */
+/*----------------------------------------------------------------------------*/
+
+#include "../../avstream/ttstartcodescanner.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <cstdio>
+#include <cstdlib>
+
+struct ScanResult {
+    int64_t  count    = 0;
+    int64_t  fourByte = 0;
+    uint64_t checksum = 0;   // order-sensitive hash over (offset, length)
+    double   secs     = 0.0;
+};
+
+static ScanResult scanAll(TTStartCodeScanner::Impl impl, const uint8_t* data, int64_t size)
+{
+    ScanResult r;
+    QElapsedTimer t;
+    t.start();
+
+    int64_t pos = 0;
+    while (pos < size) {
+        int64_t i = TTStartCodeScanner::findPrefixWith(impl, data, pos, size - 3);
+        if (i < 0) break;
+        int64_t codePos = i;
+        int     codeLen = 3;
+        if (i > 0 && data[i-1] == 0) {
+            codePos = i - 1;
+            codeLen = 4;
+            r.fourByte++;
+        }
+        r.count++;
+        r.checksum = r.checksum * 1099511628211ULL ^ (uint64_t)(codePos * 8 + codeLen);
+        pos = codePos + codeLen;
+    }
+
+    r.secs = t.nsecsElapsed() / 1e9;
+    return r;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <input.264|input.265|input.m2v> [rounds]\n", argv[0]);
+        return 2;
+    }
+    const int rounds = (argc > 2) ? qMax(1, atoi(argv[2])) : 3;
+
+    QFile file(argv[1]);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    const int64_t size = file.size();
+    const uint8_t* data = file.map(0, size);
+    if (!data) {
+        fprintf(stderr, "cannot map %s\n", argv[1]);
+        return 1;
+    }
+    const double mb = size / 1048576.0;
+
+    printf("file: %s (%.1f MB), active impl: %s\n", argv[1], mb,
+           TTStartCodeScanner::implName(TTStartCodeScanner::activeImpl()));
+
+    // Warm the page cache so the first measured impl is not charged for I/O.
+    scanAll(TTStartCodeScanner::ImplScalar, data, size);
+
+    const TTStartCodeScanner::Impl impls[] = {
+        TTStartCodeScanner::ImplScalar,
+        TTStartCodeScanner::ImplSSE2,
+        TTStartCodeScanner::ImplAVX2
+    };
+
+    ScanResult reference;
+    double scalarBest = 0.0;
+    bool ok = true;
+
+    for (TTStartCodeScanner::Impl impl : impls) {
+        if (!TTStartCodeScanner::isSupported(impl)) {
+            printf("  %-6s: not supported on this CPU\n", TTStartCodeScanner::implName(impl));
+            continue;
+        }
+        ScanResult best;
+        for (int n = 0; n < rounds; n++) {
+            ScanResult r = scanAll(impl, data, size);
+            if (n == 0 || r.secs < best.secs) best = r;
+        }
+        if (impl == TTStartCodeScanner::ImplScalar) {
+            reference  = best;
+            scalarBest = best.secs;
+        }
+        const bool same = best.count == reference.count
+                       && best.fourByte == reference.fourByte
+                       && best.checksum == reference.checksum;
+        ok = ok && same;
+        printf("  %-6s: %8.3f s  %8.0f MB/s  x%.2f  start codes %lld (4-byte %lld)  %s\n",
+               TTStartCodeScanner::implName(impl), best.secs, mb / best.secs,
+               scalarBest / best.secs, (long long)best.count, (long long)best.fourByte,
+               same ? "identical" : "MISMATCH");
+    }
+
+    file.unmap(const_cast<uint8_t*>(data));
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
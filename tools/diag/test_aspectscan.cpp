@@ -96,11 +96,7 @@ int main(int argc, char** argv)
     for (int i = 0; i < frames.size(); ++i) {
         const int disp = map.isValid() ? map.decodeToDisplay(i) : i;
         if (disp < 0) continue;
-        TTVideoIndex* vi = new TTVideoIndex();
-        vi->setDisplayOrder(disp);
-        vi->setHeaderListIndex(i);
-        vi->setPictureCodingType(codingTypeOf(frames[i].frameType));
-        indexList.add(vi);
+        indexList.add(disp, i, codingTypeOf(frames[i].frameType));
     }
     indexList.sortDisplayOrder();
     printf("index entries=%d\n", indexList.count());
@@ -50,7 +50,7 @@ int main(int argc, char* argv[])
                stName);
 
         // Show NAL types in this AU
-        for (int ni : au.nalIndices) {
+        for (int ni = au.firstNal; ni < au.firstNal + au.nalCount; ++ni) {
             TTNalUnit nal = parser.nalUnitAt(ni);
             printf(" %d", nal.type);
             if (nal.isSlice) {
@@ -0,0 +1,152 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTByteRangeCopy with each method forced first (copy_file_range, sendfile,
+// buffered read, buffered from a mapping) on a generated file of several
+// chunks. The target already holds bytes Qt has not flushed yet and gets
+// more written behind the copy, so the result also checks that the kernel
+// paths start at QFileDevice::pos() and re-sync it afterwards. Then: a
+// QBuffer target (no descriptor), a stop from the progress callback and a
+// range running past the end of the source. Prints the time of each method.
+//
+//   usage: test_byterangecopy
+
+#include <QCoreApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryFile>
+#include <cstdio>
+
+#include "avstream/ttbyterangecopy.h"
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+static const QByteArray kPrefix("bytes written before the copy");
+static const QByteArray kSuffix("bytes written behind the copy");
+
+// Copies [offset, offset+length[ of source into a new file behind kPrefix,
+// appends kSuffix and returns the file's contents (empty on failure)
+static QByteArray copyToFile(QFile& source, qint64 offset, qint64 length,
+                             TTByteRangeCopy::Method first, const uchar* mapped,
+                             qint64& copied, qint64& ms)
+{
+    QTemporaryFile out;
+    if (!out.open())
+        return QByteArray();
+    out.write(kPrefix);      // still in Qt's write buffer
+
+    TTByteRangeCopy::setFirstMethod(first);
+    QElapsedTimer t;
+    t.start();
+    copied = TTByteRangeCopy::copy(source, offset, out, length,
+                                   TTByteRangeCopy::Progress(), mapped);
+    ms = t.elapsed();
+    if (copied < 0 || out.pos() != kPrefix.size() + copied)
+        return QByteArray();
+
+    out.write(kSuffix);
+    out.flush();
+    out.seek(0);
+    return out.readAll();
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // 2.5 chunks of random bytes, so every method loops
+    const qint64 size = TTByteRangeCopy::kChunkSize * 5 / 2;
+    QByteArray data(int(size), Qt::Uninitialized);
+    QRandomGenerator rng(0x5eed);
+    rng.fillRange(reinterpret_cast<quint32*>(data.data()), int(size / 4));
+
+    QTemporaryFile source;
+    if (!source.open() || source.write(data) != size || !source.flush()) {
+        fprintf(stderr, "cannot create the source file\n");
+        return 2;
+    }
+    uchar* mapped = source.map(0, size);
+
+    const qint64 offset = 12345;
+    const qint64 length = size - offset - 6789;
+    const QByteArray expected = kPrefix + data.mid(int(offset), int(length)) + kSuffix;
+
+    struct Run { TTByteRangeCopy::Method first; bool useMapping; const char* name; };
+    const Run runs[] = {
+        { TTByteRangeCopy::MethodCopyFileRange, false, "copy_file_range" },
+        { TTByteRangeCopy::MethodSendFile,      false, "sendfile" },
+        { TTByteRangeCopy::MethodBuffered,      false, "buffered read" },
+        { TTByteRangeCopy::MethodBuffered,      true,  "buffered from mapping" },
+    };
+    for (const Run& r : runs) {
+        if (r.useMapping && !mapped) {
+            printf("SKIP: %s (source not mapped)\n", r.name);
+            continue;
+        }
+        qint64 copied = 0, ms = 0;
+        const QByteArray result = copyToFile(source, offset, length, r.first,
+                                             r.useMapping ? mapped + offset : nullptr, copied, ms);
+        printf("%s: %lld bytes in %lld ms via %s\n", r.name, (long long)copied, (long long)ms,
+               TTByteRangeCopy::methodName(TTByteRangeCopy::lastMethod()));
+        check(copied == length, qPrintable(QString("%1 copies the whole range").arg(r.name)));
+        check(result == expected,
+              qPrintable(QString("%1 lands between the bytes written around it").arg(r.name)));
+        if (r.first == TTByteRangeCopy::MethodBuffered)
+            check(TTByteRangeCopy::lastMethod() == TTByteRangeCopy::MethodBuffered,
+                  qPrintable(QString("%1 skips the kernel paths").arg(r.name)));
+    }
+    TTByteRangeCopy::setFirstMethod(TTByteRangeCopy::MethodCopyFileRange);
+
+    // A target without a descriptor takes the buffered path
+    {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        buffer.write(kPrefix);
+        const qint64 copied = TTByteRangeCopy::copy(source, offset, buffer, length);
+        buffer.write(kSuffix);
+        check(copied == length && buffer.data() == expected
+              && TTByteRangeCopy::lastMethod() == TTByteRangeCopy::MethodBuffered,
+              "QBuffer target copies through the buffered path");
+    }
+
+    // Progress returning false stops after the chunk it reports
+    {
+        QTemporaryFile out;
+        out.open();
+        int calls = 0;
+        const qint64 copied = TTByteRangeCopy::copy(source, 0, out, size, [&](qint64 done) {
+            ++calls;
+            return done < TTByteRangeCopy::kChunkSize;
+        });
+        check(calls >= 1 && copied >= TTByteRangeCopy::kChunkSize && copied < size,
+              "progress callback stops the copy");
+        check(out.pos() == copied, "stopped copy leaves the target behind the bytes copied");
+        out.seek(0);
+        check(out.readAll() == data.left(int(copied)), "stopped copy wrote the leading bytes");
+    }
+
+    // A range past the end of the source copies what there is
+    {
+        QTemporaryFile out;
+        out.open();
+        const qint64 copied = TTByteRangeCopy::copy(source, size - 1000, out, 5000);
+        out.seek(0);
+        check(copied == 1000 && out.readAll() == data.right(1000),
+              "range past the end of the source stops at its end");
+    }
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
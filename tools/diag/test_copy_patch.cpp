@@ -0,0 +1,231 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: TTH264CopyPatcher (in-place frame_num patch + writev) against  */
+/* the whole-NAL reference (unescape, patch, re-escape every slice NAL) that  */
+/* streamCopyFrames used for every AU. Patches all AUs of an H.264 ES with   */
+/* several deltas, writes them through the patcher into a temp file and      */
+/* compares it byte for byte with the reference output; also times both.     */
+/* Without an input only the built-in fixtures run: synthetic slices whose    */
+/* frame_num byte is zero before the patch, so the split behind it has to     */
+/* run over the zero bytes that follow - within the header bytes, and past    */
+/* them into the whole-NAL fallback.                                          */
+/*                                                                            */
+/* usage: test_copy_patch [input.264]                                         */
+/*----------------------------------------------------------------------------*/
+
+#include "../../avstream/ttnaluparser.h"
+#include "../../extern/tth264copypatch.h"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryFile>
+#include <cstdio>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+// --- Reference: the whole-NAL patch (same steps as patchFrameNumInAU) ---
+
+static QByteArray unescape(const QByteArray& nal)
+{
+  QByteArray rbsp;
+  for (int i = 0; i < nal.size(); ++i) {
+    if (i + 2 < nal.size() && nal[i] == 0 && nal[i + 1] == 0 && nal[i + 2] == 3) {
+      rbsp.append(nal[i]);
+      rbsp.append(nal[i + 1]);
+      i += 2;
+    } else {
+      rbsp.append(nal[i]);
+    }
+  }
+  return rbsp;
+}
+
+static QByteArray escape(const QByteArray& rbsp)
+{
+  QByteArray nal;
+  for (int i = 0; i < rbsp.size(); ++i) {
+    if (i + 2 < rbsp.size() && rbsp[i] == 0 && rbsp[i + 1] == 0 && uint8_t(rbsp[i + 2]) <= 3) {
+      nal.append(rbsp[i]);
+      nal.append(rbsp[i + 1]);
+      nal.append(char(3));
+      i += 1;
+    } else {
+      nal.append(rbsp[i]);
+    }
+  }
+  return nal;
+}
+
+static uint32_t readBits(const QByteArray& d, int& pos, int n)
+{
+  uint32_t v = 0;
+  for (int i = 0; i < n; ++i, ++pos)
+    v = (v << 1) | ((uint8_t(d[pos >> 3]) >> (7 - (pos & 7))) & 1);
+  return v;
+}
+
+static void readUE(const QByteArray& d, int& pos)
+{
+  int zeros = 0;
+  while (readBits(d, pos, 1) == 0) ++zeros;
+  readBits(d, pos, zeros);
+}
+
+static QByteArray referencePatch(const QByteArray& au, int width, int delta)
+{
+  QByteArray out;
+  int pos = 0;
+  while (pos < au.size()) {
+    int sc = -1;
+    for (int i = pos; i + 3 < au.size(); i++) {
+      if (au[i] == 0 && au[i + 1] == 0 && (au[i + 2] == 1 || (au[i + 2] == 0 && au[i + 3] == 1))) {
+        sc = i;
+        break;
+      }
+    }
+    if (sc < 0) { out.append(au.mid(pos)); break; }
+    out.append(au.mid(pos, sc - pos));
+    const int scLen = (au[sc + 2] == 0) ? 4 : 3;
+    int end = au.size();
+    for (int i = sc + scLen + 1; i + 2 < au.size(); i++) {
+      if (au[i] == 0 && au[i + 1] == 0 && (au[i + 2] == 0 || au[i + 2] == 1)) { end = i; break; }
+    }
+    const QByteArray body = au.mid(sc + scLen, end - sc - scLen);
+    const int type = body.isEmpty() ? -1 : (body[0] & 0x1F);
+    if ((type == 1 || type == 5) && body.size() >= 3) {
+      QByteArray rbsp = unescape(body);
+      int bit = 8;
+      readUE(rbsp, bit); readUE(rbsp, bit); readUE(rbsp, bit);
+      const int at = bit;
+      const int fn = int(readBits(rbsp, bit, width));
+      const int nfn = ((fn + delta) % (1 << width) + (1 << width)) % (1 << width);
+      for (int i = 0; i < width; ++i) {
+        const int p = at + i;
+        const char mask = char(1 << (7 - (p & 7)));
+        if ((nfn >> (width - 1 - i)) & 1) rbsp[p >> 3] = char(rbsp[p >> 3] | mask);
+        else                              rbsp[p >> 3] = char(rbsp[p >> 3] & ~mask);
+      }
+      out.append(au.mid(sc, scLen));
+      out.append(escape(rbsp));
+    } else {
+      out.append(au.mid(sc, end - sc));
+    }
+    pos = end;
+  }
+  return out;
+}
+
+// --- Fixtures: one P slice, log2_max_frame_num 4 ---
+// RBSP 41 | 25 | 0 ffff 000 | zeroBytes x 00 | 80: nal_ref_idc 2, type 1;
+// first_mb_in_slice 3 (00100), slice_type 0 (1), pic_parameter_set_id 1
+// (010) fill the first byte and one bit of the second, frame_num takes the
+// next four bits.
+static QByteArray fixtureRbsp(int frameNum, int zeroBytes)
+{
+  QByteArray rbsp;
+  rbsp.append(char(0x41));
+  rbsp.append(char(0x25));
+  rbsp.append(char((frameNum & 0x0F) << 3));
+  rbsp.append(QByteArray(zeroBytes, '\0'));
+  rbsp.append(char(0x80));
+  return rbsp;
+}
+
+static void checkFixture(int zeroBytes, bool wholeNal)
+{
+  const int width = 4;
+  const int delta = 1;
+  const QByteArray startCode("\0\0\0\1", 4);
+  const QByteArray au       = startCode + escape(fixtureRbsp(0, zeroBytes));
+  const QByteArray expected = startCode + escape(fixtureRbsp(1, zeroBytes));
+
+  QBuffer out;
+  out.open(QIODevice::WriteOnly);
+  TTH264CopyPatcher patcher(width, delta);
+  patcher.addMapped(reinterpret_cast<const uchar*>(au.constData()), au.size());
+  const bool ok = patcher.flush(out);
+
+  printf("fixture, %d zero bytes behind frame_num: %d slices patched (%d as whole NALs)\n",
+         zeroBytes, patcher.patchedSlices(), patcher.rewrittenNals());
+  check(ok, "fixture written");
+  check(patcher.patchedSlices() == 1, "fixture slice patched");
+  check(patcher.rewrittenNals() == (wholeNal ? 1 : 0),
+        wholeNal ? "long zero run takes the whole-NAL fallback"
+                 : "short zero run stays in the header bytes");
+  check(out.data() == expected, "fixture output has frame_num 1, escaping intact");
+  check(out.data() == referencePatch(au, width, delta), "fixture output identical to whole-NAL patch");
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+
+  checkFixture(8, false);
+  checkFixture(40, true);
+  if (argc < 2) {
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+  }
+
+  TTNaluParser parser;
+  if (!parser.openFile(QString::fromLocal8Bit(argv[1])) || !parser.parseFile()
+      || parser.codecType() != NALU_CODEC_H264 || !parser.isMapped()) {
+    fprintf(stderr, "need a mapped H.264 ES: %s\n", qPrintable(parser.lastError()));
+    return 2;
+  }
+  const TTNaluIndex index = parser.index();
+  const int width = index.spsInfoMap.isEmpty()
+                  ? 0 : index.spsInfoMap.first().log2MaxFrameNumMinus4 + 4;
+  if (width <= 0) {
+    fprintf(stderr, "no frame_num width\n");
+    return 2;
+  }
+  printf("%d AUs, log2_max_frame_num %d\n", parser.accessUnitCount(), width);
+
+  const int deltas[] = { 1, 7, (1 << width) - 3, -5 };
+  for (int delta : deltas) {
+    QElapsedTimer t;
+    t.start();
+    QByteArray reference;
+    for (int i = 0; i < parser.accessUnitCount(); ++i)
+      reference.append(referencePatch(parser.readAccessUnitData(i), width, delta));
+    const double refMs = t.nsecsElapsed() / 1e6;
+
+    QTemporaryFile out;
+    if (!out.open()) return 2;
+    t.restart();
+    TTH264CopyPatcher patcher(width, delta);
+    bool ok = true;
+    for (int i = 0; ok && i < parser.accessUnitCount(); ++i) {
+      int64_t size = 0;
+      const uchar* au = parser.accessUnitPtr(i, size);
+      if (i % 97 == 5)        // an AU patched elsewhere, as for inline SPS
+        patcher.addBytes(referencePatch(QByteArray(reinterpret_cast<const char*>(au), size), width, delta));
+      else
+        patcher.addMapped(au, size);
+      if (patcher.needsFlush())
+        ok = patcher.flush(out);
+    }
+    ok = ok && patcher.flush(out);
+    // Plain writes after writev must land behind it (device position re-synced)
+    ok = ok && out.write("\0\0\1", 3) == 3 && out.flush();
+    const double patchMs = t.nsecsElapsed() / 1e6;
+
+    out.seek(0);
+    const QByteArray written = out.readAll();
+    printf("delta %d: reference %.1f ms, patcher %.1f ms, %d slices patched (%d as whole NALs)\n",
+           delta, refMs, patchMs, patcher.patchedSlices(), patcher.rewrittenNals());
+    check(ok, "patcher writes succeed");
+    check(written == reference + QByteArray("\0\0\1", 3), "output identical to whole-NAL patch");
+  }
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
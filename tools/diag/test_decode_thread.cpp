@@ -0,0 +1,160 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: TTFrameDecodeThread (asynchronous preview decode). Fires a     */
+/* burst of requests as slider scrubbing does and checks that only the last   */
+/* one is answered, with the image a synchronous decodeFrame() gives; that a  */
+/* keyframe preview comes before an exact frame that needs a seek; that       */
+/* cancel() leaves the wrapper usable on the calling thread; that a YUV       */
+/* request delivers the planes decodePreviewFrameYUV() gives; and how long    */
+/* the GUI thread spends inside request() (should be microseconds).           */
+/*                                                                            */
+/* usage: test_decode_thread <input> [display position]                       */
+/*----------------------------------------------------------------------------*/
+
+#include "../../extern/ttffmpegwrapper.h"
+#include "../../mpeg2window/ttframedecodethread.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+static bool openWrapper(TTFFmpegWrapper& w, const char* path)
+{
+  return w.openFile(QString::fromLocal8Bit(path)) && w.buildFrameIndex(w.findBestVideoStream());
+}
+
+struct Answers
+{
+  QList<int> keyframes;    // requested positions of keyframe previews
+  QList<int> frames;       // positions answered with an exact frame
+  QImage     last;
+  TTYuvFrame lastYuv;
+};
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <input> [display position]\n", argv[0]);
+    return 2;
+  }
+  TTFFmpegWrapper::initializeFFmpeg();
+
+  TTFFmpegWrapper async, reference;
+  if (!openWrapper(async, argv[1]) || !openWrapper(reference, argv[1])) {
+    fprintf(stderr, "cannot open/index %s\n", argv[1]);
+    return 2;
+  }
+  reference.setFrameCacheBudget(0);
+
+  const int count = async.displayOrderMap().isValid()
+                  ? async.displayOrderMap().displayCount() : async.frameCount();
+  const int center = argc > 2 ? atoi(argv[2]) : count / 2;
+  if (count < 8 || center < 0 || center >= count) {
+    fprintf(stderr, "need a video with a few frames (%d), position in range\n", count);
+    return 2;
+  }
+  printf("%d frames, %d GOPs, position %d\n", count, async.gopCount(), center);
+
+  TTFrameDecodeThread thread(&async);
+  Answers answers;
+  QObject::connect(&thread, &TTFrameDecodeThread::keyframeReady, &app,
+                   [&answers](int requested, int, const QImage&) {
+                     answers.keyframes.append(requested);
+                   });
+  QObject::connect(&thread, &TTFrameDecodeThread::frameReady, &app,
+                   [&answers](int pos, const QImage& image) {
+                     answers.frames.append(pos);
+                     answers.last = image;
+                   });
+  QObject::connect(&thread, &TTFrameDecodeThread::yuvFrameReady, &app,
+                   [&answers](int pos, const TTYuvFrame& frame) {
+                     answers.frames.append(pos);
+                     answers.lastYuv = frame;
+                   });
+  thread.start();
+
+  // Scrubbing: 32 requests in a row over the stream, the last one at center
+  srand(1);
+  QElapsedTimer t;
+  qint64 requestNs = 0;
+  for (int i = 0; i < 32; ++i) {
+    const int pos = i == 31 ? center : rand() % count;
+    t.start();
+    thread.request(pos, false);
+    requestNs += t.nsecsElapsed();
+  }
+  t.start();
+  thread.waitForIdle();
+  const double settleMs = t.nsecsElapsed() / 1e6;
+  QCoreApplication::processEvents();
+  printf("32 requests: %.3f ms in request(), last frame after %.1f ms; "
+         "%d frames and %d keyframe previews delivered\n",
+         requestNs / 1e6, settleMs, int(answers.frames.size()), int(answers.keyframes.size()));
+
+  const QImage expected = reference.decodeFrame(center);
+  check(!answers.frames.isEmpty() && answers.frames.last() == center,
+        "last request answered last");
+  check(answers.frames.size() < 32, "superseded requests dropped");
+  check(!answers.last.isNull() && answers.last == expected, "image equals synchronous decode");
+  check(async.frameAt(center).deliveredDecodeIndex == reference.frameAt(center).deliveredDecodeIndex,
+        "deliveredDecodeIndex equal");
+
+  // A far jump needs a seek: keyframe preview first, then the exact frame
+  {
+    const int far = (center + count / 2) % count;
+    answers = Answers();
+    async.clearFrameCache();
+    thread.request(far, false);
+    thread.waitForIdle();
+    QCoreApplication::processEvents();
+    int keyAU = far;
+    if (async.displayOrderMap().isValid()) keyAU = async.displayOrderMap().displayToDecode(far);
+    const bool isKeyframe = async.frameAt(keyAU).isKeyframe;
+    check(answers.frames == QList<int>{ far }
+          && (isKeyframe || answers.keyframes == QList<int>{ far }),
+          "seek shows the keyframe before the exact frame");
+  }
+
+  // YUV request: the planes, unconverted
+  {
+    const int pos = qMax(0, center - 3);
+    answers = Answers();
+    thread.request(pos, false, true);
+    thread.waitForIdle();
+    QCoreApplication::processEvents();
+    TFrameInfo info;
+    const bool ok = reference.decodePreviewFrameYUV(pos, info);
+    const TTYuvFrame expectedYuv = ok
+        ? TTYuvFrame::fromPlanes(info.Y, info.U, info.V, info.width, info.height,
+                                 info.chroma_width, info.chroma_height)
+        : TTYuvFrame();
+    check(answers.frames.size() == 1 && answers.frames.last() == pos && answers.last.isNull(),
+          "YUV request answered with yuvFrameReady");
+    check(ok && !answers.lastYuv.isNull() && answers.lastYuv.planes == expectedYuv.planes
+          && answers.lastYuv.width == expectedYuv.width,
+          "YUV planes equal synchronous decodePreviewFrameYUV()");
+  }
+
+  // cancel() in the middle of a decode: the wrapper works synchronously after
+  {
+    async.clearFrameCache();
+    thread.request(qMax(0, center - 1), false);
+    thread.cancel();
+    const QImage sync = async.decodeFrame(center);
+    check(!sync.isNull() && sync == expected, "synchronous decode after cancel()");
+  }
+
+  thread.stop();
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: TTFFmpegWrapper's decoded-frame cache. Steps forward and back  */
+/* around a position and jumps around the stream with the cache on, and       */
+/* checks every image and deliveredDecodeIndex against a wrapper with the     */
+/* cache disabled (a fresh seek per frame). Also checks that one decodeFrame  */
+/* leaves the target GOP's frames up to the target cached, that a small       */
+/* budget is kept, and single steps backward over three GOPs with the         */
+/* background prefetch.                                                       */
+/*                                                                            */
+/* usage: test_frame_cache <input> [display position]                         */
+/*----------------------------------------------------------------------------*/
+
+#include "../../extern/ttffmpegwrapper.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+static bool openWrapper(TTFFmpegWrapper& w, const char* path)
+{
+  return w.openFile(QString::fromLocal8Bit(path)) && w.buildFrameIndex(w.findBestVideoStream());
+}
+
+static int displayOf(const TTFFmpegWrapper& w, int au)
+{
+  return w.displayOrderMap().isValid() ? w.displayOrderMap().decodeToDisplay(au) : au;
+}
+
+static int decodeOf(const TTFFmpegWrapper& w, int display)
+{
+  return w.displayOrderMap().isValid() ? w.displayOrderMap().displayToDecode(display) : display;
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <input> [display position]\n", argv[0]);
+    return 2;
+  }
+  TTFFmpegWrapper::initializeFFmpeg();
+
+  TTFFmpegWrapper cached, fresh;
+  if (!openWrapper(cached, argv[1]) || !openWrapper(fresh, argv[1])) {
+    fprintf(stderr, "cannot open/index %s\n", argv[1]);
+    return 2;
+  }
+  fresh.setFrameCacheBudget(0);
+
+  const int count = cached.displayOrderMap().isValid()
+                  ? cached.displayOrderMap().displayCount() : cached.frameCount();
+  const int center = argc > 2 ? atoi(argv[2]) : count / 2;
+  if (count < 8 || center < 0 || center >= count) {
+    fprintf(stderr, "need a video with a few frames (%d), position in range\n", count);
+    return 2;
+  }
+  printf("%d frames, %d GOPs, position %d\n", count, cached.gopCount(), center);
+
+  // One decode keeps the target GOP up to the target
+  {
+    TTFFmpegWrapper w;
+    openWrapper(w, argv[1]);
+    const bool decoded = !w.decodeFrame(center).isNull();
+    int keyAU = decodeOf(w, center);
+    while (keyAU > 0 && !w.frameAt(keyAU).isKeyframe) --keyAU;
+    bool gopCached = decoded;
+    int gopFrames = 0;
+    for (int d = displayOf(w, keyAU); gopCached && d <= center; ++d, ++gopFrames)
+      gopCached = w.frameCache().contains(d);
+    printf("%d frames cached (%.1f MiB) after one decode, %d of the target GOP\n",
+           w.frameCache().count(), w.frameCache().bytes() / 1048576.0, gopFrames);
+    check(gopCached, "target GOP cached from its keyframe up to the target");
+  }
+
+  // Walk: forward over two GOPs, back over two, then jumps
+  const int gopLen = qMax(1, count / qMax(1, cached.gopCount()));
+  QList<int> walk;
+  for (int d = center; d < qMin(count, center + 2 * gopLen); ++d) walk.append(d);
+  for (int d = qMin(count, center + 2 * gopLen) - 1; d >= qMax(0, center - 2 * gopLen); --d)
+    walk.append(d);
+  srand(1);
+  for (int i = 0; i < 16; ++i) walk.append(rand() % count);
+
+  qint64 cachedNs = 0, freshNs = 0;
+  bool imagesMatch = true, deliveredMatch = true;
+  QElapsedTimer t;
+  for (int d : walk) {
+    t.start();
+    const QImage a = cached.decodeFrame(d);
+    cachedNs += t.nsecsElapsed();
+    t.start();
+    const QImage b = fresh.decodeFrame(d);
+    freshNs += t.nsecsElapsed();
+    if (a.isNull() || a != b) {
+      if (imagesMatch) printf("  display %d: image differs from a fresh decode\n", d);
+      imagesMatch = false;
+    }
+    if (cached.frameAt(d).deliveredDecodeIndex != fresh.frameAt(d).deliveredDecodeIndex)
+      deliveredMatch = false;
+  }
+  printf("%d steps: cached %.1f ms, fresh %.1f ms; %d frames (%.1f MiB) cached\n",
+         int(walk.size()), cachedNs / 1e6, freshNs / 1e6,
+         cached.frameCache().count(), cached.frameCache().bytes() / 1048576.0);
+  check(imagesMatch, "cached images equal fresh decodes");
+  check(deliveredMatch, "deliveredDecodeIndex equal");
+  check(fresh.frameCache().count() == 0, "budget 0 caches nothing");
+
+  // A budget of a few frames is kept while stepping
+  {
+    const qint64 frameBytes = cached.frameCache().bytes() / qMax(1, cached.frameCache().count());
+    TTFFmpegWrapper w;
+    openWrapper(w, argv[1]);
+    w.setFrameCacheBudget(4 * frameBytes);
+    bool kept = true, match = true;
+    for (int d = center; d < qMin(count, center + gopLen); ++d) {
+      match = match && w.decodeFrame(d) == fresh.decodeFrame(d);
+      kept = kept && (w.frameCache().bytes() <= w.frameCache().budget() || w.frameCache().count() == 1);
+    }
+    check(kept && match, "small budget kept, images still equal");
+  }
+
+  // Reverse stepping: one frame back at a time, prefetch after each step
+  {
+    TTFFmpegWrapper w;
+    openWrapper(w, argv[1]);
+    const int last = qMax(0, center - 3 * gopLen);
+    int steps = 0, slow = 0;
+    double slowestMs = 0, totalMs = 0;
+    bool match = true;
+    for (int d = center; d >= last; --d, ++steps) {
+      t.start();
+      const QImage img = w.decodeFrame(d);
+      const double ms = t.nsecsElapsed() / 1e6;
+      w.startBackwardPrefetch(d);
+      totalMs += ms;
+      slowestMs = qMax(slowestMs, ms);
+      if (ms > 20.0) ++slow;
+      if (img.isNull() || img != fresh.decodeFrame(d)) {
+        if (match) printf("  display %d: reverse step differs from a fresh decode\n", d);
+        match = false;
+      }
+    }
+    w.cancelBackwardPrefetch();
+    printf("%d steps back: %.1f ms total, slowest %.1f ms, %d over 20 ms\n",
+           steps, totalMs, slowestMs, slow);
+    check(match, "reverse steps equal fresh decodes");
+  }
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
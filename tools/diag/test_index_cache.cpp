@@ -0,0 +1,194 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: the .ttidx stream index sidecar (TTStreamIndexCache).          */
+/* Copies the ES into a temp dir, parses the copy twice with TTNaluParser     */
+/* (scan + store, then load from the sidecar) and compares every NAL, AU,     */
+/* GOP and parameter set of the two runs. Also checks that a second writer    */
+/* merges instead of replacing the parser's sections and that touching the   */
+/* stream invalidates the sidecar, and that TTNaluParser::adoptIndex takes  */
+/* over an in-memory index unchanged.                                         */
+/*                                                                            */
+/* usage: test_index_cache <input.264|input.265>   (a short sample: copied)   */
+/*----------------------------------------------------------------------------*/
+
+#include "../../avstream/ttnaluparser.h"
+#include "../../avstream/ttstreamindexcache.h"
+#include "../../common/ttsettings.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <cstring>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+static bool sameNal(const TTNalUnit& a, const TTNalUnit& b)
+{
+  return a.fileOffset == b.fileOffset && a.dataOffset == b.dataOffset
+      && a.size == b.size && a.dataSize == b.dataSize && a.type == b.type
+      && a.refIdc == b.refIdc && a.temporalId == b.temporalId
+      && a.isKeyframe == b.isKeyframe && a.isIDR == b.isIDR && a.isSlice == b.isSlice
+      && a.isSPS == b.isSPS && a.isPPS == b.isPPS && a.isVPS == b.isVPS
+      && a.isSEI == b.isSEI && a.isFiller == b.isFiller && a.isAUD == b.isAUD
+      && a.sliceType == b.sliceType && a.frameNum == b.frameNum
+      && a.firstMbInSlice == b.firstMbInSlice && a.ppsId == b.ppsId
+      && a.isField == b.isField && a.isBottomField == b.isBottomField;
+}
+
+static bool sameAu(const TTAccessUnit& a, const TTAccessUnit& b)
+{
+  return a.index == b.index && a.decodeIndex == b.decodeIndex
+      && a.firstNal == b.firstNal && a.nalCount == b.nalCount
+      && a.startOffset == b.startOffset && a.endOffset == b.endOffset
+      && a.isKeyframe == b.isKeyframe && a.isIDR == b.isIDR
+      && a.sliceType == b.sliceType && a.poc == b.poc
+      && a.gopIndex == b.gopIndex && a.isFieldCoded == b.isFieldCoded;
+}
+
+static bool sameGop(const TTGopInfo& a, const TTGopInfo& b)
+{
+  return a.index == b.index && a.startAU == b.startAU && a.endAU == b.endAU
+      && a.keyframeAU == b.keyframeAU && a.frameCount == b.frameCount
+      && a.isClosed == b.isClosed;
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <input.264|input.265>\n", argv[0]);
+    return 2;
+  }
+
+  QTemporaryDir tmp;
+  const QString stream = tmp.path() + "/" + QFileInfo(QString::fromLocal8Bit(argv[1])).fileName();
+  if (!tmp.isValid() || !QFile::copy(QString::fromLocal8Bit(argv[1]), stream)) {
+    fprintf(stderr, "cannot copy %s into a temp dir\n", argv[1]);
+    return 2;
+  }
+  const QString sidecar = TTStreamIndexCache::sidecarPath(stream);
+  TTSettings::instance()->setCreateStreamIndex(true);
+
+  // Run 1: full scan, stores the sidecar
+  TTNaluParser scanned;
+  QElapsedTimer t;
+  t.start();
+  if (!scanned.openFile(stream) || !scanned.parseFile()) {
+    fprintf(stderr, "parse failed: %s\n", qPrintable(scanned.lastError()));
+    return 2;
+  }
+  const double scanMs = t.nsecsElapsed() / 1e6;
+  check(QFileInfo::exists(sidecar), "sidecar written after the scan");
+
+  // Run 2: must come from the sidecar
+  TTNaluParser loaded;
+  t.restart();
+  if (!loaded.openFile(stream) || !loaded.parseFile()) {
+    fprintf(stderr, "second parse failed: %s\n", qPrintable(loaded.lastError()));
+    return 2;
+  }
+  const double loadMs = t.nsecsElapsed() / 1e6;
+  printf("scan %.1f ms, sidecar load %.1f ms (%lld KB)\n", scanMs, loadMs,
+         (long long)(QFileInfo(sidecar).size() / 1024));
+
+  check(loaded.nalUnitCount() == scanned.nalUnitCount(), "NAL count");
+  check(loaded.accessUnitCount() == scanned.accessUnitCount(), "AU count");
+  check(loaded.gopCount() == scanned.gopCount(), "GOP count");
+  check(loaded.isPAFF() == scanned.isPAFF(), "PAFF flag");
+  check(loaded.isMapped() == scanned.isMapped(), "stream mapped after load");
+
+  bool nals = loaded.nalUnitCount() == scanned.nalUnitCount();
+  for (int i = 0; nals && i < scanned.nalUnitCount(); ++i)
+    nals = sameNal(loaded.nalUnitAt(i), scanned.nalUnitAt(i));
+  check(nals, "every NAL unit identical");
+
+  bool aus = loaded.accessUnitCount() == scanned.accessUnitCount();
+  for (int i = 0; aus && i < scanned.accessUnitCount(); ++i)
+    aus = sameAu(loaded.accessUnitAt(i), scanned.accessUnitAt(i));
+  check(aus, "every access unit identical");
+
+  bool gops = loaded.gopCount() == scanned.gopCount();
+  for (int i = 0; gops && i < scanned.gopCount(); ++i)
+    gops = sameGop(loaded.gopAt(i), scanned.gopAt(i));
+  check(gops, "every GOP identical");
+
+  bool params = loaded.spsCount() == scanned.spsCount()
+             && loaded.ppsCount() == scanned.ppsCount()
+             && loaded.vpsCount() == scanned.vpsCount();
+  for (int i = 0; params && i < scanned.spsCount(); ++i)
+    params = loaded.getSPS(i) == scanned.getSPS(i);
+  for (int i = 0; params && i < scanned.ppsCount(); ++i)
+    params = loaded.getPPS(i) == scanned.getPPS(i);
+  for (int i = 0; params && i < scanned.vpsCount(); ++i)
+    params = loaded.getVPS(i) == scanned.getVPS(i);
+  check(params, "SPS/PPS/VPS identical");
+
+  bool au0 = true;
+  if (scanned.accessUnitCount() > 0)
+    au0 = loaded.readAccessUnitData(0) == scanned.readAccessUnitData(0);
+  check(au0, "AU 0 payload readable after load");
+
+  // In-memory hand-over (TTFFmpegWrapper -> TTESSmartCut) without a rescan
+  {
+    TTNaluParser adopter;
+    const bool adopted = adopter.openFile(stream) && adopter.adoptIndex(scanned.index());
+    check(adopted, "index adopted by a second parser");
+    bool same = adopted && adopter.accessUnitCount() == scanned.accessUnitCount()
+             && adopter.nalUnitCount() == scanned.nalUnitCount()
+             && adopter.isPAFF() == scanned.isPAFF();
+    for (int i = 0; same && i < scanned.accessUnitCount(); ++i)
+      same = sameAu(adopter.accessUnitAt(i), scanned.accessUnitAt(i));
+    if (same && scanned.accessUnitCount() > 0)
+      same = adopter.readAccessUnitData(0) == scanned.readAccessUnitData(0);
+    check(same, "adopted index identical");
+    TTNaluIndex foreign = scanned.index();
+    foreign.fileSize += 1;
+    TTNaluParser rejecter;
+    check(rejecter.openFile(stream) && !rejecter.adoptIndex(foreign),
+          "index of another file rejected");
+  }
+
+  // A second producer adds a section; the parser's sections must survive
+  const uint32_t probeTag = TTStreamIndexCache::tag("TEST");
+  {
+    TTStreamIndexCache writer(stream);
+    writer.setSection(probeTag, QByteArray("probe"));
+    check(writer.save(), "second writer saves");
+  }
+  {
+    TTStreamIndexCache reader(stream);
+    check(reader.load(), "merged sidecar loads");
+    check(reader.section(probeTag) == QByteArray("probe"), "added section present");
+    check(reader.hasSection(TTStreamIndexCache::tag("NALO")), "parser section kept");
+  }
+
+  // Touching the stream invalidates the sidecar
+  {
+    QFile f(stream);
+    const bool touched = f.open(QIODevice::ReadWrite)
+                      && f.setFileTime(QDateTime::currentDateTime().addSecs(60),
+                                       QFileDevice::FileModificationTime);
+    f.close();
+    TTStreamIndexCache reader(stream);
+    check(touched && !reader.load(), "stale after mtime change");
+  }
+
+  // And the setting switches the sidecar off entirely
+  TTSettings::instance()->setCreateStreamIndex(false);
+  QFile::remove(sidecar);
+  TTNaluParser off;
+  check(off.openFile(stream) && off.parseFile() && !QFileInfo::exists(sidecar),
+        "no sidecar when disabled");
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
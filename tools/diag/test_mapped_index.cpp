@@ -0,0 +1,117 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: the mapped parser scan of an H.26x ES                          */
+/* (scanMappedStreamIntoRawIndex) against the demuxer scan it replaced        */
+/* (scanPacketsIntoRawIndex). Builds the frame index of each stream twice -   */
+/* once per scan, sidecar off - and compares every entry (offset, size,       */
+/* type, key/IDR/RASL flags, field coding, POC, timestamps), the PAFF         */
+/* raw->merged map and the display-order ranks. Prints the time of each scan. */
+/*                                                                            */
+/* usage: test_mapped_index <input.264> <input.265> [more ES ...]             */
+/*----------------------------------------------------------------------------*/
+
+#include "../../extern/ttffmpegwrapper.h"
+#include "../../common/ttsettings.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <cstdio>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+static bool sameFrame(const TTFrameInfo& a, const TTFrameInfo& b)
+{
+  return a.pts == b.pts && a.dts == b.dts
+      && a.fileOffset == b.fileOffset && a.packetSize == b.packetSize
+      && a.frameType == b.frameType && a.isKeyframe == b.isKeyframe
+      && a.gopIndex == b.gopIndex && a.frameIndex == b.frameIndex
+      && a.isFieldCoded == b.isFieldCoded && a.poc == b.poc
+      && a.isIDR == b.isIDR && a.isDroppedLeading == b.isDroppedLeading;
+}
+
+// Opens path into w and builds its index through the chosen scan
+static bool buildIndex(TTFFmpegWrapper& w, const QString& path, bool mapped, qint64& ms)
+{
+  w.setMappedIndexScan(mapped);
+  if (!w.openFile(path)) {
+    fprintf(stderr, "open failed: %s\n", qPrintable(w.lastError()));
+    return false;
+  }
+  QElapsedTimer t;
+  t.start();
+  const bool ok = w.buildFrameIndex(w.findBestVideoStream());
+  ms = t.elapsed();
+  if (!ok)
+    fprintf(stderr, "index failed: %s\n", qPrintable(w.lastError()));
+  return ok;
+}
+
+static void compareStream(const QString& path)
+{
+  const QString name = QFileInfo(path).fileName();
+  printf("--- %s\n", qPrintable(name));
+
+  TTFFmpegWrapper mapped, demuxed;
+  qint64 mappedMs = 0, demuxedMs = 0;
+  if (!buildIndex(mapped, path, true, mappedMs) || !buildIndex(demuxed, path, false, demuxedMs)) {
+    check(false, qPrintable(QString("%1: both indexes built").arg(name)));
+    return;
+  }
+  printf("mapped scan: %lld ms, demuxer scan: %lld ms\n",
+         (long long)mappedMs, (long long)demuxedMs);
+
+  const QList<TTFrameInfo>& a = mapped.frameIndex();
+  const QList<TTFrameInfo>& b = demuxed.frameIndex();
+  check(!a.isEmpty() && a.size() == b.size(),
+        qPrintable(QString("%1: same frame count (%2 / %3)").arg(name).arg(a.size()).arg(b.size())));
+
+  int firstDiff = -1;
+  for (int i = 0; i < qMin(a.size(), b.size()) && firstDiff < 0; ++i) {
+    if (!sameFrame(a[i], b[i])) firstDiff = i;
+  }
+  if (firstDiff >= 0) {
+    const TTFrameInfo& x = a[firstDiff];
+    const TTFrameInfo& y = b[firstDiff];
+    printf("  frame %d: offset %lld/%lld size %lld/%lld type %d/%d key %d/%d poc %d/%d pts %lld/%lld\n",
+           firstDiff, (long long)x.fileOffset, (long long)y.fileOffset,
+           (long long)x.packetSize, (long long)y.packetSize, x.frameType, y.frameType,
+           x.isKeyframe, y.isKeyframe, x.poc, y.poc, (long long)x.pts, (long long)y.pts);
+  }
+  check(firstDiff < 0, qPrintable(QString("%1: every entry identical").arg(name)));
+
+  bool sameMap = mapped.isPAFF() == demuxed.isPAFF()
+              && mapped.rawPacketCount() == demuxed.rawPacketCount();
+  for (int r = 0; sameMap && r < mapped.rawPacketCount(); ++r)
+    sameMap = mapped.rawToMergedIndex(r) == demuxed.rawToMergedIndex(r);
+  check(sameMap, qPrintable(QString("%1: same PAFF raw->merged map (%2 raw packets)")
+                                .arg(name).arg(mapped.rawPacketCount())));
+
+  check(mapped.displayOrderMap().decodeToDisplayRanks()
+            == demuxed.displayOrderMap().decodeToDisplayRanks(),
+        qPrintable(QString("%1: same display-order ranks").arg(name)));
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <input.264> <input.265> [more ES ...]\n", argv[0]);
+    return 2;
+  }
+
+  // The sidecar would hand the second build the first one's index
+  TTSettings::instance()->setCreateStreamIndex(false);
+  TTFFmpegWrapper::initializeFFmpeg();
+
+  for (int i = 1; i < argc; ++i)
+    compareStream(QString::fromLocal8Bit(argv[i]));
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
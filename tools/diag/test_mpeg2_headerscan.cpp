@@ -0,0 +1,172 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// The MPEG-2 header list from TTMpeg2HeaderScanner (createHeaderListFromMpeg2)
+// against the TTFileBuffer walk it replaced: nextStartCodeTS() + readByte()
+// + readHeader(TTFileBuffer*), reproduced here. Both scanner modes run -
+// mapped, and windowed reads with a small window so the seams are crossed
+// thousands of times. Every header must agree in type, offset and fields;
+// prints the time of each.
+//
+//   usage: test_mpeg2_headerscan <es-file.m2v>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <cstdio>
+
+#include "avstream/ttfilebuffer.h"
+#include "avstream/ttmpeg2headerscanner.h"
+#include "avstream/ttmpeg2videoheader.h"
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+// Type, offset and every parsed field as one comparable line
+static QString describe(TTMpeg2VideoHeader* h)
+{
+    QString s = QString("%1 @%2").arg(int(h->headerType()), 2, 16, QChar('0')).arg(h->headerOffset());
+    switch (h->headerType()) {
+        case TTMpeg2VideoHeader::sequence_start_code: {
+            TTSequenceHeader* q = static_cast<TTSequenceHeader*>(h);
+            s += QString(" %1x%2 ar%3 fr%4 br%5 vbv%6 prog%7")
+                     .arg(q->horizontal_size_value).arg(q->vertical_size_value)
+                     .arg(q->aspect_ratio_information).arg(q->frame_rate_code)
+                     .arg(q->bit_rate_value).arg(q->vbv_buffer_size_value)
+                     .arg(q->progressive_sequence);
+            break;
+        }
+        case TTMpeg2VideoHeader::group_start_code: {
+            TTGOPHeader* g = static_cast<TTGOPHeader*>(h);
+            s += QString(" closed%1 broken%2").arg(g->closed_gop).arg(g->broken_link);
+            break;
+        }
+        case TTMpeg2VideoHeader::picture_start_code: {
+            TTPicturesHeader* p = static_cast<TTPicturesHeader*>(h);
+            s += QString(" tr%1 type%2 vbv%3 struct%4")
+                     .arg(p->temporal_reference).arg(p->picture_coding_type)
+                     .arg(p->vbv_delay).arg(p->picture_structure);
+            break;
+        }
+        default:
+            break;
+    }
+    return s;
+}
+
+static TTMpeg2VideoHeader* createHeader(int type)
+{
+    switch (type) {
+        case TTMpeg2VideoHeader::sequence_start_code: return new TTSequenceHeader();
+        case TTMpeg2VideoHeader::picture_start_code:  return new TTPicturesHeader();
+        case TTMpeg2VideoHeader::group_start_code:    return new TTGOPHeader();
+        case TTMpeg2VideoHeader::sequence_end_code:   return new TTSequenceEndHeader();
+        default:                                      return nullptr;
+    }
+}
+
+// The header-list loop as it was before TTMpeg2HeaderScanner
+static QStringList legacyWalk(const QString& path)
+{
+    QStringList out;
+    TTFileBuffer buffer(path, QIODevice::ReadOnly);
+    buffer.open();
+    try {
+        while (!buffer.atEnd()) {
+            quint8 headerType = 0xFF;
+            while (headerType != TTMpeg2VideoHeader::picture_start_code  &&
+                   headerType != TTMpeg2VideoHeader::sequence_start_code &&
+                   headerType != TTMpeg2VideoHeader::group_start_code    &&
+                   headerType != TTMpeg2VideoHeader::sequence_end_code   &&
+                   !buffer.atEnd()) {
+                buffer.nextStartCodeTS();
+                buffer.readByte(headerType);
+            }
+            TTMpeg2VideoHeader* h = createHeader(headerType);
+            if (h) {
+                h->readHeader(&buffer);
+                out.append(describe(h));
+                delete h;
+            }
+        }
+    } catch (const TTFileBufferException&) {
+    }
+    return out;
+}
+
+static QStringList scannerWalk(const QString& path, bool windowed)
+{
+    QStringList out;
+    TTMpeg2HeaderScanner scanner(path);
+    // 64 KB: the smallest sensible window, many seams
+    scanner.setWindowed(windowed, 64 * 1024);
+    if (!scanner.open()) return out;
+
+    int type;
+    while ((type = scanner.nextHeader()) >= 0) {
+        TTMpeg2VideoHeader* h = createHeader(type);
+        int length;
+        const quint8* data = scanner.span(TTMpeg2HeaderScanner::kMaxHeaderSpan, length);
+        scanner.advance(h->parseHeader(data, length, scanner.position()));
+        out.append(describe(h));
+        delete h;
+    }
+    return out;
+}
+
+static int firstDifference(const QStringList& a, const QStringList& b)
+{
+    for (int i = 0; i < qMin(a.size(), b.size()); ++i)
+        if (a[i] != b[i]) return i;
+    return (a.size() == b.size()) ? -1 : qMin(a.size(), b.size());
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <es-file.m2v>\n", argv[0]);
+        return 2;
+    }
+    const QString path = QString::fromLocal8Bit(argv[1]);
+
+    QElapsedTimer t;
+    t.start();
+    const QStringList legacy = legacyWalk(path);
+    const qint64 legacyMs = t.restart();
+    const QStringList mapped = scannerWalk(path, false);
+    const qint64 mappedMs = t.restart();
+    const QStringList windowed = scannerWalk(path, true);
+    const qint64 windowedMs = t.elapsed();
+
+    printf("%d headers: TTFileBuffer %lld ms, mapped %lld ms, windowed %lld ms\n",
+           int(legacy.size()), (long long)legacyMs, (long long)mappedMs, (long long)windowedMs);
+
+    int d = firstDifference(legacy, mapped);
+    if (d >= 0)
+        printf("header %d: legacy '%s' scanner '%s'\n", d,
+               d < legacy.size() ? qPrintable(legacy[d]) : "-",
+               d < mapped.size() ? qPrintable(mapped[d]) : "-");
+    check(!legacy.isEmpty() && d < 0, "mapped scan matches the TTFileBuffer walk");
+
+    d = firstDifference(mapped, windowed);
+    if (d >= 0)
+        printf("header %d: mapped '%s' windowed '%s'\n", d,
+               d < mapped.size() ? qPrintable(mapped[d]) : "-",
+               d < windowed.size() ? qPrintable(windowed[d]) : "-");
+    check(d < 0, "windowed scan matches the mapped scan");
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// The partitioned MPEG-2 header scan (createHeaderListFromMpeg2 with several
+// workers, split at sequence headers) against the serial one. Header list,
+// index list (display order, picture type, header index) and the
+// field-picture extras must be identical; the partition size is forced down
+// so that even a small sample is cut at many seams. Prints the time of each.
+//
+//   usage: test_mpeg2_parallelscan <es-file.m2v> [workers]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QStringList>
+#include <cstdio>
+#include <cstdlib>
+
+#include "avstream/ttmpeg2videostream.h"
+#include "avstream/ttvideoheaderlist.h"
+#include "avstream/ttvideoindexlist.h"
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+struct ScanResult {
+    QStringList headers;
+    QStringList index;
+    QList<int>  extras;
+    qint64      ms = 0;
+};
+
+static ScanResult scan(const QFileInfo& fi, int workers, qint64 minPartition)
+{
+    ScanResult r;
+    TTMpeg2VideoStream vs(fi);
+    vs.setHeaderScanWorkers(workers, minPartition);
+
+    QElapsedTimer t;
+    t.start();
+    vs.createHeaderList();
+    vs.createIndexList();
+    r.ms = t.elapsed();
+
+    TTVideoHeaderList* hl = vs.headerList();
+    for (int i = 0; i < hl->count(); ++i) {
+        TTVideoHeader* h = hl->headerAt(i);
+        QString s = QString("%1 @%2").arg(int(h->headerType()), 2, 16, QChar('0')).arg(h->headerOffset());
+        if (h->headerType() == TTMpeg2VideoHeader::picture_start_code) {
+            TTPicturesHeader* p = static_cast<TTPicturesHeader*>(h);
+            s += QString(" tr%1 type%2 struct%3").arg(p->temporal_reference)
+                     .arg(p->picture_coding_type).arg(p->picture_structure);
+        }
+        if (h->listIndex() != i)
+            s += " (wrong list index)";
+        r.headers.append(s);
+    }
+
+    TTVideoIndexList* il = vs.indexList();
+    il->sortDisplayOrder();
+    for (int i = 0; i < il->count(); ++i) {
+        TTVideoIndex* vi = il->videoIndexAt(i);
+        r.index.append(QString("%1 %2 %3").arg(vi->getDisplayOrder())
+                           .arg(vi->getPictureCodingType()).arg(vi->getHeaderListIndex()));
+    }
+    r.extras = vs.extraIndices();
+    return r;
+}
+
+static int firstDifference(const QStringList& a, const QStringList& b)
+{
+    for (int i = 0; i < qMin(a.size(), b.size()); ++i)
+        if (a[i] != b[i]) return i;
+    return (a.size() == b.size()) ? -1 : qMin(a.size(), b.size());
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <es-file.m2v> [workers]\n", argv[0]);
+        return 2;
+    }
+    const QFileInfo fi(QString::fromLocal8Bit(argv[1]));
+    const int workers = qBound(2, argc > 2 ? atoi(argv[2]) : 4, 16);
+
+    const ScanResult serial = scan(fi, 1, fi.size() + 1);
+    // workers partitions, then the most there can be: 16, at least 256 KB
+    const ScanResult parallel = scan(fi, workers, qMax<qint64>(1, fi.size() / workers));
+    const ScanResult fine     = scan(fi, 16, 256 * 1024);
+
+    printf("%d headers, %d pictures, %d extras: serial %lld ms, %d workers %lld ms, 16 partitions %lld ms\n",
+           int(serial.headers.size()), int(serial.index.size()), int(serial.extras.size()),
+           (long long)serial.ms, workers, (long long)parallel.ms, (long long)fine.ms);
+
+    const ScanResult* runs[] = { &parallel, &fine };
+    const char* names[] = { "partitioned", "fine-partitioned" };
+    for (int r = 0; r < 2; ++r) {
+        int d = firstDifference(serial.headers, runs[r]->headers);
+        if (d >= 0)
+            printf("%s header %d: serial '%s' partitioned '%s'\n", names[r], d,
+                   d < serial.headers.size() ? qPrintable(serial.headers[d]) : "-",
+                   d < runs[r]->headers.size() ? qPrintable(runs[r]->headers[d]) : "-");
+        check(!serial.headers.isEmpty() && d < 0,
+              qPrintable(QString("%1 header list matches the serial one").arg(names[r])));
+
+        d = firstDifference(serial.index, runs[r]->index);
+        if (d >= 0)
+            printf("%s index %d: serial '%s' partitioned '%s'\n", names[r], d,
+                   d < serial.index.size() ? qPrintable(serial.index[d]) : "-",
+                   d < runs[r]->index.size() ? qPrintable(runs[r]->index[d]) : "-");
+        check(d < 0, qPrintable(QString("%1 display order matches the serial one").arg(names[r])));
+        check(serial.extras == runs[r]->extras,
+              qPrintable(QString("%1 field-picture extras match the serial ones").arg(names[r])));
+    }
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
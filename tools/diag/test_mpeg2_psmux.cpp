@@ -0,0 +1,210 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTMpegPsMuxProvider on an MPEG-2 video + MP2 audio pair: mplexPart() muxes
+// copies of the two elementary streams into a temporary directory, then the
+// .mpg is reopened with libav. Besides the navigation packs it must hold
+// exactly one MPEG-2 video and one MP2 stream with all the pictures and audio
+// frames of the input, and its video and container durations must match the
+// input's within one frame - the program stream is what the user plays, the
+// in-process muxer must not lose or stretch anything mplex used to write.
+//
+// Short material is enough (a few seconds each); keep the audio about as long
+// as the video.
+//
+//   usage: test_mpeg2_psmux <video-m2v> <audio-mp2>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QVector>
+#include <cmath>
+#include <cstdio>
+
+#include "common/ttsettings.h"
+#include "data/ttmuxlistdata.h"
+#include "extern/ttmplexprovider.h"
+#include "extern/ttmpegpsmuxprovider.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+struct StreamSummary {
+    AVMediaType type     = AVMEDIA_TYPE_UNKNOWN;
+    AVCodecID   codec    = AV_CODEC_ID_NONE;
+    int         packets  = 0;
+    double      seconds  = 0.0;
+};
+
+struct FileSummary {
+    bool                 ok = false;
+    QList<StreamSummary> streams;
+    double               containerSeconds = 0.0;
+};
+
+// Every stream of path, its packet count and the time its packets cover:
+// from the timestamps (first pts to last pts + duration) in a container,
+// from the packet count in an elementary stream, which carries no reliable
+// timestamps of its own
+static FileSummary summarize(const QString& path, bool fromTimestamps)
+{
+    FileSummary r;
+    AVFormatContext* ctx = nullptr;
+    if (avformat_open_input(&ctx, path.toUtf8().constData(), nullptr, nullptr) < 0)
+        return r;
+    if (avformat_find_stream_info(ctx, nullptr) < 0) {
+        avformat_close_input(&ctx);
+        return r;
+    }
+
+    QVector<int64_t> first(ctx->nb_streams, AV_NOPTS_VALUE);
+    QVector<int64_t> end(ctx->nb_streams, AV_NOPTS_VALUE);
+    for (unsigned i = 0; i < ctx->nb_streams; ++i) {
+        StreamSummary s;
+        s.type  = ctx->streams[i]->codecpar->codec_type;
+        s.codec = ctx->streams[i]->codecpar->codec_id;
+        r.streams.append(s);
+    }
+
+    AVPacket* pkt = av_packet_alloc();
+    while (av_read_frame(ctx, pkt) >= 0) {
+        const int idx = pkt->stream_index;
+        StreamSummary& s = r.streams[idx];
+        s.packets++;
+        if (pkt->pts != AV_NOPTS_VALUE) {
+            if (first[idx] == AV_NOPTS_VALUE || pkt->pts < first[idx])
+                first[idx] = pkt->pts;
+            if (end[idx] == AV_NOPTS_VALUE || pkt->pts + pkt->duration > end[idx])
+                end[idx] = pkt->pts + pkt->duration;
+        }
+        av_packet_unref(pkt);
+    }
+    av_packet_free(&pkt);
+
+    for (unsigned i = 0; i < ctx->nb_streams; ++i) {
+        AVStream* st = ctx->streams[i];
+        StreamSummary& s = r.streams[int(i)];
+        if (fromTimestamps) {
+            if (first[int(i)] != AV_NOPTS_VALUE)
+                s.seconds = (end[int(i)] - first[int(i)]) * av_q2d(st->time_base);
+        } else if (s.type == AVMEDIA_TYPE_VIDEO) {
+            const AVRational fr = av_guess_frame_rate(ctx, st, nullptr);
+            if (fr.num > 0 && fr.den > 0)
+                s.seconds = s.packets * av_q2d(av_inv_q(fr));
+        } else if (s.type == AVMEDIA_TYPE_AUDIO && st->codecpar->sample_rate > 0
+                   && st->codecpar->frame_size > 0) {
+            s.seconds = double(s.packets) * st->codecpar->frame_size / st->codecpar->sample_rate;
+        }
+    }
+    if (ctx->duration != AV_NOPTS_VALUE)
+        r.containerSeconds = double(ctx->duration) / AV_TIME_BASE;
+
+    avformat_close_input(&ctx);
+    r.ok = true;
+    return r;
+}
+
+static const StreamSummary* firstOfType(const FileSummary& f, AVMediaType type)
+{
+    for (const StreamSummary& s : f.streams) {
+        if (s.type == type)
+            return &s;
+    }
+    return nullptr;
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <video-m2v> <audio-mp2>\n", argv[0]);
+        return 2;
+    }
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        fprintf(stderr, "cannot create a temporary directory\n");
+        return 2;
+    }
+    // Copies: the provider may delete its input after a successful mux
+    const QString video = workDir.filePath("psmux.m2v");
+    const QString audio = workDir.filePath("psmux.mp2");
+    if (!QFile::copy(QString::fromLocal8Bit(argv[1]), video) ||
+        !QFile::copy(QString::fromLocal8Bit(argv[2]), audio)) {
+        fprintf(stderr, "cannot copy the input streams\n");
+        return 2;
+    }
+
+    const FileSummary videoIn = summarize(video, false);
+    const FileSummary audioIn = summarize(audio, false);
+    const StreamSummary* vIn = firstOfType(videoIn, AVMEDIA_TYPE_VIDEO);
+    const StreamSummary* aIn = firstOfType(audioIn, AVMEDIA_TYPE_AUDIO);
+    if (!vIn || vIn->codec != AV_CODEC_ID_MPEG2VIDEO || !aIn || aIn->codec != AV_CODEC_ID_MP2) {
+        fprintf(stderr, "need an MPEG-2 video and an MP2 audio elementary stream\n");
+        return 2;
+    }
+
+    TTSettings::instance()->setLogPsMux(true);
+    TTSettings::instance()->setMuxOutputPath(workDir.path());
+    TTSettings::instance()->setWorkingMuxDeleteES(false);
+
+    TTMuxListData muxList;
+    muxList.appendItem(TTMuxListDataItem(video, QStringList() << audio));
+    TTMpegPsMuxProvider provider(&muxList);
+    provider.mplexPart(0);
+    if (!provider.succeeded())
+        fprintf(stderr, "mux failed: %s\n", qPrintable(provider.lastError()));
+    check(provider.succeeded() && !provider.wasAborted(), "mux succeeds");
+
+    const QString mpg = TTMplexProvider::createOutputFilePath(video);
+    check(QFileInfo(mpg).size() > 0, "program stream written next to its input");
+
+    const FileSummary out = summarize(mpg, true);
+    check(out.ok, "libav reopens the program stream");
+    // The dvd muxer's navigation packs come back as a data stream (DVD_NAV)
+    int avStreams = 0;
+    for (const StreamSummary& st : out.streams)
+        avStreams += (st.type == AVMEDIA_TYPE_VIDEO || st.type == AVMEDIA_TYPE_AUDIO) ? 1 : 0;
+    check(avStreams == 2, "program stream holds one video and one audio stream");
+
+    const StreamSummary* vOut = firstOfType(out, AVMEDIA_TYPE_VIDEO);
+    const StreamSummary* aOut = firstOfType(out, AVMEDIA_TYPE_AUDIO);
+    check(vOut && vOut->codec == AV_CODEC_ID_MPEG2VIDEO, "one MPEG-2 video stream");
+    check(aOut && aOut->codec == AV_CODEC_ID_MP2, "one MP2 audio stream");
+
+    const double frame = (vIn->packets > 0) ? vIn->seconds / vIn->packets : 0.04;
+    const double expected = qMax(vIn->seconds, aIn->seconds);
+    printf("input:  video %d pictures %.3f s, audio %d frames %.3f s\n",
+           vIn->packets, vIn->seconds, aIn->packets, aIn->seconds);
+    if (vOut && aOut)
+        printf("output: video %d pictures %.3f s, audio %d frames %.3f s, container %.3f s\n",
+               vOut->packets, vOut->seconds, aOut->packets, aOut->seconds, out.containerSeconds);
+
+    if (vOut && aOut) {
+        check(vOut->packets == vIn->packets, "every picture muxed");
+        check(aOut->packets == aIn->packets, "every audio frame muxed");
+        check(std::fabs(vOut->seconds - vIn->seconds) <= frame,
+              "video duration matches the input within one frame");
+        check(std::fabs(out.containerSeconds - expected) <= frame + 0.05,
+              "container duration matches the longer input");
+    }
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// The MPEG-2 re-encode path of TTTranscodeProvider::encodeFrames: one
+// moveToFrameIndex() to the range start, then decodeNextDisplayFrame() per
+// frame. Checks it against a moveToFrameIndex() per frame (the old path):
+// every frame must come out with the same picture type and temporal
+// reference as the index and the same luma plane, and prints the time of
+// both.
+//
+//   usage: test_mpeg2_sequential <es-file.m2v> [start] [count]
+//
+// Same construction as the application (see test_mpeg2_seek): header and
+// index list from TTMpeg2VideoStream, sortDisplayOrder(), YV12 decoder.
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <cstdio>
+#include <cstdlib>
+
+#include "avstream/ttmpeg2videostream.h"
+#include "avstream/ttvideoheaderlist.h"
+#include "avstream/ttvideoindexlist.h"
+#include "mpeg2decoder/ttmpeg2decoder.h"
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+static QByteArray lumaSum(const TFrameInfo* info)
+{
+    if (!info || !info->Y) return QByteArray();
+    return QCryptographicHash::hash(
+        QByteArray::fromRawData(reinterpret_cast<const char*>(info->Y), info->width * info->height),
+        QCryptographicHash::Md5);
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <es-file.m2v> [start] [count]\n", argv[0]);
+        return 2;
+    }
+
+    QFileInfo fi(QString::fromLocal8Bit(argv[1]));
+    TTMpeg2VideoStream vs(fi);
+    vs.createHeaderList();
+    vs.createIndexList();
+    TTVideoHeaderList* headerList = vs.headerList();
+    TTVideoIndexList*  indexList  = vs.indexList();
+    if (!headerList || !indexList || indexList->count() < 2) {
+        fprintf(stderr, "header/index list empty\n");
+        return 2;
+    }
+    indexList->sortDisplayOrder();
+
+    const int frames = indexList->count();
+    // Default: a range starting on a B-frame well inside the stream
+    const int start = qBound(0, argc > 2 ? atoi(argv[2]) : frames / 3 + 1, frames - 1);
+    const int count = qBound(1, argc > 3 ? atoi(argv[3]) : 300, frames - start);
+    printf("frames=%d range=%d..%d\n", frames, start, start + count - 1);
+
+    QList<QByteArray> seekSums;
+    QElapsedTimer t;
+    t.start();
+    {
+        TTMpeg2Decoder decoder(vs.filePath(), indexList, headerList, formatYV12);
+        for (int i = 0; i < count; ++i) {
+            decoder.moveToFrameIndex(start + i);
+            seekSums.append(lumaSum(decoder.getFrameInfo()));
+        }
+    }
+    const qint64 seekMs = t.elapsed();
+
+    int typeMismatch = 0, pictureMismatch = 0;
+    t.start();
+    {
+        TTMpeg2Decoder decoder(vs.filePath(), indexList, headerList, formatYV12);
+        decoder.moveToFrameIndex(start);
+        for (int i = 0; i < count; ++i) {
+            const TFrameInfo* info = (i == 0) ? decoder.getFrameInfo()
+                                              : decoder.decodeNextDisplayFrame();
+            const TTPicturesHeader* picture = (TTPicturesHeader*)headerList->headerAt(
+                indexList->headerListIndex(start + i));
+            if (decoder.currentFrameType() != indexList->videoIndexAt(start + i)->getPictureCodingType()
+                || decoder.currentTemporalReference() != picture->temporal_reference)
+                ++typeMismatch;
+            if (lumaSum(info) != seekSums[i]) {
+                if (pictureMismatch++ < 5)
+                    printf("frame %d: sequential picture differs from the seeked one\n", start + i);
+            }
+        }
+    }
+    const qint64 seqMs = t.elapsed();
+
+    printf("%d frames: seek per frame %lld ms, sequential %lld ms\n",
+           count, (long long)seekMs, (long long)seqMs);
+    check(typeMismatch == 0, "sequential picture types and temporal references match the index");
+    check(pictureMismatch == 0, "sequential pictures match the seek-per-frame pictures");
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,366 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// TTMpeg2VideoStream::transferCutObjects() - the header-list walk with
+// kernel copies between the patched headers - against the 256 KB buffer
+// loop it replaced, kept below verbatim as legacyTransferCutObjects(). Both
+// transfer the same header range into their own file, and the outputs must
+// be byte-identical:
+//
+//   - a range across a sequence end code (dropped by both). The test builds
+//     its stream from the sample: its first GOPs, a sequence end code, then
+//     the same GOPs again - the way concatenated recordings look;
+//   - a range starting at an open GOP (first I with temporal_reference > 0)
+//     whose leading B-frames are orphaned: dropped, and the temporal
+//     references behind them rewritten.
+//
+// Prints the time of each transfer.
+//
+// Usage: test_mpeg2_transfer <file.m2v>   (an IBBP sample with open GOPs)
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <cstdio>
+
+#include "common/ttsettings.h"
+#include "common/ttexception.h"
+#include "avstream/ttmpeg2videostream.h"
+#include "avstream/ttvideoheaderlist.h"
+#include "avstream/ttfilebuffer.h"
+#include "data/ttcutparameter.h"
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+    printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+    if (!cond) ++failures;
+}
+
+class TransferProbe : public TTMpeg2VideoStream
+{
+public:
+    explicit TransferProbe(const QFileInfo& info) : TTMpeg2VideoStream(info) {}
+
+    TTVideoHeaderList* headers() { return header_list; }
+
+    // Transfers [start, end] into outFile, through the current or the
+    // legacy loop; false on an exception
+    bool transfer(TTVideoHeader* start, TTVideoHeader* end, const QString& outFile,
+                  bool legacy, qint64& ms)
+    {
+        TTFileBuffer target(outFile, QIODevice::WriteOnly);
+        target.open();
+        TTCutParameter cp(&target);
+        QElapsedTimer t;
+        bool ok = true;
+        openStream();
+        t.start();
+        try {
+            if (legacy)
+                legacyTransferCutObjects(start, end, &cp);
+            else
+                transferCutObjects(start, end, &cp);
+        } catch (const TTException& e) {
+            fprintf(stderr, "transfer failed: %s\n", qPrintable(e.getMessage()));
+            ok = false;
+        }
+        ms = t.elapsed();
+        closeStream();
+        target.close();
+        return ok;
+    }
+
+    // transferCutObjects() before the kernel copy (256 KB buffer loop)
+    void legacyTransferCutObjects(TTVideoHeader* startObject, TTVideoHeader* endObject, TTCutParameter* cr);
+};
+
+void TransferProbe::legacyTransferCutObjects(TTVideoHeader* startObject, TTVideoHeader* endObject, TTCutParameter* cr)
+{
+  QByteArray bufferStorage(262144, '\0');
+  quint8*   buffer = reinterpret_cast<quint8*>(bufferStorage.data());
+  quint64   bytesToWrite      = getByteCount(startObject, endObject);
+  quint64   bufferStartOffset = startObject->headerOffset();
+  int       numPicsWritten    = cr->getNumPicturesWritten();
+  bool      closeNextGOP      = true;  // remove B-frames
+  int       tempRefDelta      = 0;     // delta for temporal reference if closed GOP
+  const int watermark         = 12;    // size of header type-code (12 byte)
+  bool      objectProcessed   = false;
+  bool      isContinue        = false;
+
+  TTVideoHeader*          currentObject = startObject;
+  QStack<TTBreakObject*>* break_objects = new QStack<TTBreakObject*>;
+
+  stream_buffer->seekAbsolute( startObject->headerOffset() );
+
+  while( bytesToWrite > 0 )
+  {
+   int bytesProcessed = (bytesToWrite < 262144)
+        ? stream_buffer->readByte(buffer, bytesToWrite)
+        : stream_buffer->readByte(buffer, 262144);
+
+    if (bytesProcessed <= 0)
+      throw TTIOException(QString("%1 bytes from stream buffer read").arg(bytesProcessed));
+
+    do
+    {
+      isContinue = false;
+
+      // is start address not in current buffer
+      if (currentObject->headerOffset() < bufferStartOffset || currentObject->headerOffset() > (bufferStartOffset+bytesProcessed-1)) {
+        break;
+      }
+
+      objectProcessed = (currentObject->headerOffset() < bufferStartOffset+bytesProcessed-watermark);
+
+      if (!objectProcessed) {
+        if (static_cast<quint64>(bytesProcessed) >= bytesToWrite) {
+          break;
+        }
+        stream_buffer->seekBackward(watermark);
+        bytesProcessed -= watermark;
+        break;
+      }
+
+      // removing unwanted objects
+      if ( break_objects->count() > 0 )
+      {
+        TTBreakObject* current_break = (TTBreakObject*)break_objects->top();
+
+        if ( current_break->stopObject() != NULL &&
+            current_break->stopObject()->headerOffset() == currentObject->headerOffset() )
+        {
+          quint64 adress_delta = current_break->restartObject()->headerOffset()-currentObject->headerOffset();
+          bytesProcessed       = (int)(currentObject->headerOffset()-bufferStartOffset);
+          bytesToWrite        -= adress_delta;
+          bufferStartOffset   += adress_delta;
+          currentObject        = current_break->restartObject(); // hier gehts weiter
+
+          stream_buffer->seekAbsolute(current_break->restartObject()->headerOffset());
+          current_break->setStopObject((TTVideoHeader*)NULL );
+
+          objectProcessed = false;
+          continue;
+        }
+
+        if (current_break->restartObject()->headerOffset() == currentObject->headerOffset())
+        {
+          TTBreakObject* tmpBreak = break_objects->pop();
+          if (ttAssigned(tmpBreak))
+            delete tmpBreak;
+        }
+      }
+
+      switch(currentObject->headerType())
+      {
+        case TTMpeg2VideoHeader::sequence_start_code:
+           break;
+
+        case TTMpeg2VideoHeader::sequence_end_code: {
+          TTBreakObject* new_break = new TTBreakObject();
+
+          new_break->setStopObject(currentObject);
+          new_break->setRestartObject(header_list->getNextHeader(currentObject));
+          break_objects->push( new_break );
+          isContinue = true;
+        }
+          break;
+
+        case TTMpeg2VideoHeader::group_start_code:
+          {
+            TTPicturesHeader* nextPic = (TTPicturesHeader*)header_list->getNextHeader(
+              currentObject, TTMpeg2VideoHeader::picture_start_code);
+
+          if (closeNextGOP && (ttAssigned(nextPic)) && (nextPic->temporal_reference == 0))
+            closeNextGOP = false;
+
+          rewriteGOP(buffer, 262144, bufferStartOffset, (TTGOPHeader*)currentObject, closeNextGOP, cr);
+        }
+          break;
+
+        case TTMpeg2VideoHeader::picture_start_code: {
+          TTPicturesHeader* currentPicture = (TTPicturesHeader*)currentObject;
+
+          if (closeNextGOP       &&
+              tempRefDelta  != 0 &&
+              currentPicture->picture_coding_type == MPEG2_PIC_B)
+          {
+            removeOrphanedBFrames(break_objects, currentObject);
+            closeNextGOP = false;
+            isContinue   = true;
+            break;
+          }
+
+          numPicsWritten++;
+          cr->setNumPicturesWritten(numPicsWritten);
+
+          if (currentPicture->picture_coding_type == MPEG2_PIC_I) {
+            tempRefDelta = (closeNextGOP)
+              ? currentPicture->temporal_reference
+              : 0;
+          }
+
+          if ( tempRefDelta != 0)
+          {
+            rewriteTempRefData(buffer, 262144, currentPicture, bufferStartOffset, tempRefDelta);
+          }
+        }
+          break;
+      }
+
+      if (isContinue)
+        continue;
+
+      if (currentObject == endObject) {
+        break;
+      }
+
+      currentObject = header_list->getNextHeader(currentObject);
+
+     }while(objectProcessed);
+
+    cr->getTargetStreamBuffer()->directWrite(buffer, bytesProcessed);
+
+    bytesToWrite      -= bytesProcessed;
+    bufferStartOffset += bytesProcessed;
+  }
+
+  for (int i = 0; i < break_objects->size(); i++) {
+    TTBreakObject* tmpBreak = break_objects->at(i);
+    if (ttAssigned(tmpBreak))
+      delete tmpBreak;
+  }
+  delete break_objects;
+}
+
+// Header-list index of the n-th header of type at or after from (-1: none)
+static int nthHeader(TTVideoHeaderList* list, int from, quint8 type, int n)
+{
+    for (int i = from; i < list->count(); ++i) {
+        if (list->headerAt(i)->headerType() == type && n-- == 0)
+            return i;
+    }
+    return -1;
+}
+
+// Transfers [list[start], list[end]] through both loops and compares
+static void compareTransfer(TransferProbe& vs, int start, int end, const QString& dir,
+                            const char* name)
+{
+    TTVideoHeaderList* list = vs.headers();
+    const QString legacyFile = dir + "/" + name + "-legacy.m2v";
+    const QString currentFile = dir + "/" + name + "-current.m2v";
+    qint64 legacyMs = 0, currentMs = 0;
+    const bool legacyOk  = vs.transfer(list->headerAt(start), list->headerAt(end), legacyFile, true, legacyMs);
+    const bool currentOk = vs.transfer(list->headerAt(start), list->headerAt(end), currentFile, false, currentMs);
+    check(legacyOk && currentOk, qPrintable(QString("%1: both transfers succeed").arg(name)));
+
+    QFile a(legacyFile), b(currentFile);
+    a.open(QIODevice::ReadOnly);
+    b.open(QIODevice::ReadOnly);
+    const QByteArray legacy = a.readAll();
+    const QByteArray current = b.readAll();
+    printf("%s: headers %d..%d, %lld bytes; legacy %lld ms, current %lld ms\n", name, start, end,
+           (long long)current.size(), (long long)legacyMs, (long long)currentMs);
+    check(!legacy.isEmpty() && legacy == current,
+          qPrintable(QString("%1: output byte-identical to the buffer loop").arg(name)));
+
+    const qint64 source = qint64(list->headerAt(end + 1 < list->count() ? end + 1 : end)->headerOffset())
+                        - qint64(list->headerAt(start)->headerOffset());
+    check(current.size() < source,
+          qPrintable(QString("%1: dropped bytes (%2 of %3 written)").arg(name)
+                         .arg(current.size()).arg(source)));
+}
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file.m2v>\n", argv[0]);
+        return 2;
+    }
+    TTSettings::instance()->setEncoderMode(true);
+
+    QTemporaryDir tmp;
+    const QString source = QString::fromLocal8Bit(argv[1]);
+
+    // Open GOP with orphaned leading B-frames, on the sample itself
+    {
+        TransferProbe vs{QFileInfo(source)};
+        vs.createHeaderList();
+        vs.createIndexList();
+        TTVideoHeaderList* list = vs.headers();
+
+        int start = -1;
+        for (int g = nthHeader(list, 1, TTMpeg2VideoHeader::group_start_code, 0);
+             g >= 0 && start < 0;
+             g = nthHeader(list, g + 1, TTMpeg2VideoHeader::group_start_code, 0)) {
+            const int i = nthHeader(list, g, TTMpeg2VideoHeader::picture_start_code, 0);
+            const int b = nthHeader(list, g, TTMpeg2VideoHeader::picture_start_code, 1);
+            if (i < 0 || b < 0) break;
+            const TTPicturesHeader* iPic = (TTPicturesHeader*)list->headerAt(i);
+            const TTPicturesHeader* bPic = (TTPicturesHeader*)list->headerAt(b);
+            if (iPic->picture_coding_type == MPEG2_PIC_I && iPic->temporal_reference > 0
+                && bPic->picture_coding_type == MPEG2_PIC_B)
+                start = g;
+        }
+        const int next = (start >= 0) ? nthHeader(list, start + 1, TTMpeg2VideoHeader::group_start_code, 2) : -1;
+        check(start >= 0 && next > 0, "sample has an open GOP with leading B-frames");
+        if (start >= 0 && next > 0)
+            compareTransfer(vs, start, next - 1, tmp.path(), "orphaned-b");
+    }
+
+    // Sequence end code between two copies of the sample's first GOPs
+    {
+        QFile in(source);
+        if (!in.open(QIODevice::ReadOnly)) {
+            fprintf(stderr, "cannot read %s\n", argv[1]);
+            return 2;
+        }
+        qint64 cutOff = 0;
+        {
+            TransferProbe vs{QFileInfo(source)};
+            vs.createHeaderList();
+            TTVideoHeaderList* list = vs.headers();
+            const int gop = nthHeader(list, 0, TTMpeg2VideoHeader::group_start_code, 4);
+            if (gop > 0) {
+                // the GOP's own sequence header, if it has one, stays with it
+                const int from = (list->headerAt(gop - 1)->headerType() == TTMpeg2VideoHeader::sequence_start_code)
+                               ? gop - 1 : gop;
+                cutOff = qint64(list->headerAt(from)->headerOffset());
+            }
+        }
+        check(cutOff > 0, "sample has five GOPs");
+        if (cutOff > 0) {
+            const QByteArray head = in.read(cutOff);
+            const QString joined = tmp.path() + "/joined.m2v";
+            QFile out(joined);
+            out.open(QIODevice::WriteOnly);
+            out.write(head + QByteArray("\x00\x00\x01\xb7", 4) + head);
+            out.close();
+
+            TransferProbe vs{QFileInfo(joined)};
+            vs.createHeaderList();
+            vs.createIndexList();
+            TTVideoHeaderList* list = vs.headers();
+            const int seqEnd = nthHeader(list, 0, TTMpeg2VideoHeader::sequence_end_code, 0);
+            const int gopBefore = nthHeader(list, 0, TTMpeg2VideoHeader::group_start_code, 2);
+            const int gopAfter = (seqEnd >= 0) ? nthHeader(list, seqEnd, TTMpeg2VideoHeader::group_start_code, 2) : -1;
+            check(seqEnd > gopBefore && gopBefore >= 0 && gopAfter > seqEnd,
+                  "joined stream has a sequence end code between GOPs");
+            if (seqEnd > gopBefore && gopBefore >= 0 && gopAfter > seqEnd)
+                compareTransfer(vs, gopBefore, gopAfter - 1, tmp.path(), "sequence-end");
+        }
+    }
+
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+}
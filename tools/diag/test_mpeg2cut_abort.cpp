@@ -35,24 +35,24 @@
 //      is the operation's SECOND pool run (TTMuxTask), so this Step arrives on
 //      a worker thread and the cancel travels the same queued GUI-thread route
 //      the Cancel button uses.
-//   5c. For phase "mplexabort": arms on the AddProcessLine that
-//      TTMplexProvider::onProcStarted() emits, i.e. after QProcess has
-//      reported the external mplex as genuinely started. The cancel therefore
-//      has to travel the kill path in TTMplexProvider::mplexPart()'s wait
-//      loop, not the "request arrived before proc->start()" shortcut, and the
-//      earlier phases (audio, video pool run) have necessarily completed
-//      first - which is exactly what the human tester had to do by hand.
-//      mplex is NOT a pool task: it runs synchronously on the GUI thread
-//      inside TTAVData::onCutFinished(), so the cancel is delivered through
-//      TTAVData::mpMplexProvider, and the Canceled bracket is emitted by that
-//      slot's own abort block (there is no pool run left to emit it).
+//   5c. For phase "mplexabort": arms on a "Multiplexing: N%" progress line of
+//      TTMpegPsMuxProvider, i.e. after the MPG mux has genuinely written
+//      packets. The cancel therefore has to travel the poll in the packet
+//      loop of TTMpegPsMuxProvider::mplexPart(), not the "request arrived
+//      before the mux started" shortcut, and the earlier phases (audio, video
+//      pool run) have necessarily completed first - which is exactly what the
+//      human tester had to do by hand. The MPG mux is NOT a pool task: it runs
+//      synchronously on the GUI thread inside TTAVData::onCutFinished(), so
+//      the cancel is delivered through TTAVData::mpPsMuxProvider, and the
+//      Canceled bracket is emitted by that slot's own abort block (there is no
+//      pool run left to emit it). (The phase names predate the in-process
+//      muxer, which replaced the external mplex run.)
 //   5d. For phase "mplexearly": arms on the ShowProcessForm mplexPart() emits
-//      BEFORE proc->start(). TTAVData::onStatusReport() pumps the event loop
+//      BEFORE the mux starts. TTAVData::onStatusReport() pumps the event loop
 //      right after re-emitting that report, so the cancel is already delivered
-//      when mplexPart()'s pre-start check runs and no mplex process is ever
-//      launched - the other reachable branch of the same abort, and
-//      deterministic rather than a race (the pump sits between the emit and
-//      the check).
+//      when mplexPart()'s pre-start check runs and nothing is ever written -
+//      the other reachable branch of the same abort, and deterministic rather
+//      than a race (the pump sits between the emit and the check).
 //   6. After every abort run, the SAME cut is re-run without an abort in the
 //      same process (the "restart after cancel" acceptance item). For the two
 //      mplex phases that re-run is the "mplex" control, so the same
@@ -89,16 +89,15 @@
 //     file and the cut elementary streams that fed the mux are all gone.
 //
 // Assertions for phase "mplexabort":
-//   - the arming message was reached, i.e. mplex really started;
-//   - "Cancel requested - stopping the mplex process" was seen: the abort was
-//     taken by the wait loop's poll and the child process was stopped there,
-//     not shortcut before proc->start();
+//   - the arming message was reached, i.e. the mux really wrote packets;
+//   - "Cancel requested - stopping the mux" was seen: the abort was taken by
+//     the packet loop's poll, not shortcut before the mux started;
 //   - at least one video-cut Step and audio progress that reached 100%, i.e.
 //     the abort landed in the mux phase and not in an earlier one;
 //   - exactly one Canceled bracket, text "Cut cancelled";
 //   - NO Exit bracket and NO cutFinished();
 //   - the cut directory is EMPTY afterwards: the partial .mpg (deleted by
-//     TTMplexProvider) and the cut elementary streams that fed it (deleted by
+//     TTMpegPsMuxProvider) and the cut elementary streams that fed it (deleted by
 //     onCutFinished()'s abort block) are all gone.
 //
 // Assertions for phase "mplexearly": the same bracket/cleanup set as
@@ -201,13 +200,12 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
   // Deterministic products regardless of this machine's persisted GUI
   // settings (TTSettings::instance() loads real QSettings on construction).
   // Phase "mplex" is the MPG container control run (no abort); "mplexabort"
-  // is the same MPG path with a cancel delivered while the external mplex
-  // process is running.
+  // is the same MPG path with a cancel delivered while the mux is running.
   const bool useMplex = (phase == "mplex" || phase == "mplexabort" ||
                          phase == "mplexearly" || phase == "mplexlate");
   TTSettings::instance()->setWorkingOutputContainer(useMplex ? 0 : 1);
   if (useMplex) {
-    TTSettings::instance()->setWorkingMuxMode(0);   // run mplex, not a script
+    TTSettings::instance()->setWorkingMuxMode(0);   // mux now, not a script
     // TTMplexProvider::createOutputFilePath() honours muxOutputPath() before
     // the video file's own directory. Without this the .mpg lands in whatever
     // this machine's persisted GUI setting points at (measured: it did).
@@ -236,7 +234,7 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
   for (const auto& c : cuts) cutList->append(avItem, c.first, c.second);
 
   Recorder rec;
-  // The .mpg TTMplexProvider will write (muxOutputPath is workDir, see above).
+  // The .mpg TTMpegPsMuxProvider will write (muxOutputPath is workDir, see above).
   // Read by the mplexabort arming condition so the cleanup assertion is about
   // a file that really existed.
   const QString mpgPath =
@@ -291,16 +289,14 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
 
         bool arm = false;
         if (phase == "mplexabort") {
-          // Arm on mplex's OWN output, and only once the .mpg it is writing
-          // actually has bytes in it. Arming on "Starting mplex process"
-          // (which TTMplexProvider emits as soon as QProcess reports the child
-          // started) was enough to prove the process was running, but it let
-          // the cancel land before mplex had created its output at all - and
-          // then "cut directory empty afterwards" is true for a file that
-          // never existed. Review called that out as a vacuous assertion.
-          // mpgSizeAtArm > 0 is asserted below, so the cleanup check is now
-          // about a partial file that demonstrably existed.
-          if (state == StatusReportArgs::AddProcessLine && msg.contains("INFO:")) {
+          // Arm on the muxer's progress, and only once the .mpg it is
+          // writing actually has bytes in it. Arming on the start of the mux
+          // let the cancel land before the output existed at all - and then
+          // "cut directory empty afterwards" is true for a file that never
+          // existed. Review called that out as a vacuous assertion.
+          // mpgSizeAtArm > 0 is asserted below, so the cleanup check is about
+          // a partial file that demonstrably existed.
+          if (state == StatusReportArgs::AddProcessLine && msg.startsWith("Multiplexing:")) {
             const qint64 sz = QFileInfo(mpgPath).size();
             if (sz > 0) { mpgSizeAtArm = sz; arm = true; }
           }
@@ -337,15 +333,15 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
           return;
         } else if (phase == "mplexearly") {
           // The other reachable window: mplexPart() emits ShowProcessForm
-          // BEFORE proc->start(), and TTAVData::onStatusReport() pumps the
+          // BEFORE the mux starts, and TTAVData::onStatusReport() pumps the
           // event loop right after re-emitting it - so a cancel posted here
           // is already delivered when mplexPart()'s pre-start check runs, and
-          // no mplex process is ever launched. Deterministic, not a race:
+          // nothing is ever written. Deterministic, not a race:
           // the pump sits between the emit and the check.
           // Matched on the message, not just the state: the MPEG-2 re-encoder
           // emits ShowProcessForm too (during the video phase), and arming on
           // that aborted the wrong phase - measured, videoCutSteps went to 0.
-          if (state == StatusReportArgs::ShowProcessForm && msg == "Starting mplex")
+          if (state == StatusReportArgs::ShowProcessForm && msg == "Starting mux")
             arm = true;
         } else if (state != StatusReportArgs::Step) {
           return;
@@ -399,13 +395,13 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
   quint64 maxAudioPercent = 0;
   bool sawMuxMsg = false;
   quint64 maxMuxPercent = 0;
-  // Proof that the cancel was taken by the wait loop's poll and stopped a
-  // RUNNING mplex, rather than by mplexPart()'s pre-start check.
+  // Proof that the cancel was taken by the packet loop's poll and stopped a
+  // RUNNING mux, rather than by mplexPart()'s pre-start check.
   bool sawMplexStopMsg = false;
 
   for (const Event& e : events) {
     if (e.state == StatusReportArgs::AddProcessLine &&
-        e.msg == "Cancel requested - stopping the mplex process")
+        e.msg == "Cancel requested - stopping the mux")
       sawMplexStopMsg = true;
     if (e.state == StatusReportArgs::Init)     initCount++;
     if (e.state == StatusReportArgs::Exit)   { exitCount++;   exitMsg   = e.msg; }
@@ -529,11 +525,10 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
                       .arg(maxAudioPercent));
     if (cutStepMsgs.load() < 1)
       return fail("mplexabort: no video-cut Step - the abort landed before the mux phase");
-    // Distinguishes the kill path from mplexPart()'s pre-start check: only
-    // the wait loop's poll emits this line, and it emits it before stopping
-    // the child.
+    // Distinguishes the packet loop's poll from mplexPart()'s pre-start
+    // check: only the former emits this line.
     if (!sawMplexStopMsg)
-      return fail("mplexabort: mplex was never stopped from the wait loop");
+      return fail("mplexabort: the mux was never stopped from its packet loop");
     // Non-vacuity of the cleanup check: the .mpg had real content when the
     // cancel was posted, so its absence below is a removal and not an absence
     // that was always going to hold.
@@ -550,9 +545,9 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
       return fail("mplexlate: no video-cut Step - the abort landed before the mux phase");
     // The request was recorded before the provider existed, so the seed in
     // onCutFinished() is what has to carry it into mplexPart()'s pre-start
-    // check - no process may be started, hence no wait-loop stop message.
+    // check - the mux may not start, hence no packet-loop stop message.
     if (sawMplexStopMsg)
-      return fail("mplexlate: mplex was started - the seed did not carry the request");
+      return fail("mplexlate: the mux was started - the seed did not carry the request");
     if (!left.isEmpty())
       return fail(QString("mplexlate: files left behind: %1").arg(left.join(", ")));
   } else if (phase == "mplexearly") {
@@ -562,9 +557,9 @@ int runCut(TTAVItem* avItem, const QString& workDir, const QString& target,
     if (cutStepMsgs.load() < 1)
       return fail("mplexearly: no video-cut Step - the abort landed before the mux phase");
     // The complement of the mplexabort assertion: this cancel must be taken
-    // by the pre-start check, so the wait loop's stop message must NOT appear.
+    // by the pre-start check, so the packet loop's stop message must NOT appear.
     if (sawMplexStopMsg)
-      return fail("mplexearly: the process was started after all - wrong branch");
+      return fail("mplexearly: the mux was started after all - wrong branch");
     if (!left.isEmpty())
       return fail(QString("mplexearly: files left behind: %1").arg(left.join(", ")));
   }
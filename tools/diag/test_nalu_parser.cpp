@@ -1,11 +1,14 @@
 /*
  * Test program for TTNaluParser
  * Build: cmake --build build --target test_nalu_parser
- * Usage: ./test_nalu_parser <input.264|input.265>
+ * Usage: ./test_nalu_parser <input.264|input.265> [threads]
+ *        threads: NAL scan workers, 0 = auto (default), 1 = serial scan
  */
 
 #include "../../avstream/ttnaluparser.h"
+#include "../../common/ttsettings.h"
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <iostream>
 
@@ -14,7 +17,7 @@ int main(int argc, char* argv[])
     QCoreApplication app(argc, argv);
 
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <input.264|input.265>" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <input.264|input.265> [threads]" << std::endl;
         return 1;
     }
 
@@ -31,7 +34,13 @@ int main(int argc, char* argv[])
     std::cout << "Input: " << inputFile.toStdString() << std::endl;
     std::cout << std::endl;
 
+    // Time the scan itself, not a .ttidx sidecar from an earlier run
+    // (test_index_cache covers the sidecar path).
+    TTSettings::instance()->setCreateStreamIndex(false);
+
     TTNaluParser parser;
+    if (argc > 2)
+        parser.setParseThreadCount(QString(argv[2]).toInt());
 
     // Open file
     std::cout << "Opening file..." << std::endl;
@@ -41,12 +50,16 @@ int main(int argc, char* argv[])
     }
     std::cout << "  Codec: " << parser.codecName().toStdString() << std::endl;
 
-    // Parse file
+    // Parse file (timed: the NAL/slice/SPS/PPS parsers read straight from
+    // the mapping, so this is the number to compare across parser changes)
     std::cout << "Parsing file..." << std::endl;
+    QElapsedTimer parseTimer;
+    parseTimer.start();
     if (!parser.parseFile()) {
         std::cerr << "Error: " << parser.lastError().toStdString() << std::endl;
         return 1;
     }
+    const qint64 parseNs = parseTimer.nsecsElapsed();
 
     // Print statistics
     std::cout << std::endl;
@@ -62,6 +75,17 @@ int main(int argc, char* argv[])
         std::cout << "VPS count:      " << parser.vpsCount() << std::endl;
     }
 
+    const double parseMs = parseNs / 1e6;
+    const double fileMB  = QFileInfo(inputFile).size() / 1048576.0;
+    std::cout << "Memory-mapped:  " << (parser.isMapped() ? "yes" : "no") << std::endl;
+    std::cout << "Scan threads:   " << parser.parseThreadCount() << " (0 = auto)" << std::endl;
+    std::cout << "Parse time:     " << parseMs << " ms ("
+              << (parseMs > 0 ? fileMB / (parseMs / 1000.0) : 0.0) << " MB/s, "
+              << (parser.nalUnitCount() > 0 ? parseNs / parser.nalUnitCount() : 0)
+              << " ns/NAL)" << std::endl;
+    std::cout << "Index memory:   " << parser.indexMemoryBytes() / 1024 << " KB packed, "
+              << parser.unpackedIndexMemoryBytes() / 1024 << " KB as unpacked lists" << std::endl;
+
     // Print first 10 GOPs
     std::cout << std::endl;
     std::cout << "First 10 GOPs:" << std::endl;
@@ -78,7 +102,7 @@ int main(int argc, char* argv[])
         TTAccessUnit au = parser.accessUnitAt(i);
         QString type = au.isKeyframe ? "I" : (au.sliceType == 0 ? "P" : (au.sliceType == 1 ? "B" : "?"));
         std::cout << "  Frame " << i << ": " << type.toStdString()
-                  << ", NALs: " << au.nalIndices.size()
+                  << ", NALs: " << au.nalCount
                   << ", GOP: " << au.gopIndex << std::endl;
     }
 
@@ -0,0 +1,347 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: TTESPacketSinkDevice (Annex-B byte stream -> mux frames)       */
+/* against the TTNaluParser AU index. Writes an H.264/H.265 ES through the    */
+/* device in odd-sized chunks - with an EOS + parameter set block spliced in  */
+/* as between smart-cut segments, and display ranks handed out late - and     */
+/* checks frame count, frame slices, rank order and keyframe flags. Also      */
+/* checks that a frame without a rank and a rejecting sink fail the stream.   */
+/* The split itself is checked against libav: the same byte stream through    */
+/* av_parser_parse2, packets without a slice folded into the next one and     */
+/* PAFF field pairs merged, must give the same frame bytes and key flags.     */
+/*                                                                            */
+/* usage: test_packet_sink <input.264|.265>                                   */
+/*----------------------------------------------------------------------------*/
+
+#include "../../avstream/ttnaluparser.h"
+#include "../../extern/ttespacketsink.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <cstdio>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+struct RecordingSink : public TTESPacketSink
+{
+  QList<QByteArray> frames;
+  QList<int> ranks;
+  QList<bool> keyframes;
+  int rejectAt = -1;
+
+  bool writeAccessUnit(const QByteArray& data, int displayRank, bool keyframe) override
+  {
+    if (frames.size() == rejectAt) return false;
+    frames.append(data);
+    ranks.append(displayRank);
+    keyframes.append(keyframe);
+    return true;
+  }
+};
+
+// The slice NALs of a frame, trailing zeros stripped. Parameter sets, SEI
+// and zero bytes between two AUs may land on either side of the boundary
+// (TTNaluParser and libav's parser differ there); the pictures may not.
+static QList<QByteArray> sliceNals(const QByteArray& d, TTNaluCodecType codec)
+{
+  QList<QByteArray> slices;
+  int nal = -1;
+  for (int i = 0; i <= d.size(); ++i) {
+    const bool sc = i + 2 < d.size() && d[i] == 0 && d[i + 1] == 0 && d[i + 2] == 1;
+    if (!sc && i < d.size()) continue;
+    if (nal >= 0) {
+      int end = i;
+      while (end > nal && d[end - 1] == 0) --end;
+      const int type = codec == NALU_CODEC_H265 ? (uint8_t(d[nal]) >> 1) & 0x3F : d[nal] & 0x1F;
+      const bool vcl = codec == NALU_CODEC_H265 ? type < 32 : (type == 1 || type == 5);
+      if (vcl) slices.append(d.mid(nal, end - nal));
+    }
+    nal = i + 3;
+    i += 2;
+  }
+  return slices;
+}
+
+// Feed stream in chunks of 1..~40 KiB (tiny ones to split start codes)
+static bool feed(TTESPacketSinkDevice& dev, const QByteArray& stream)
+{
+  static const int chunks[] = { 1, 2, 3, 7, 188, 4093, 40961, 5 };
+  int pos = 0, n = 0;
+  while (pos < stream.size()) {
+    const int len = qMin(chunks[n++ % 8], stream.size() - pos);
+    if (dev.write(stream.constData() + pos, len) != len) return false;
+    pos += len;
+  }
+  return true;
+}
+
+struct Packet {
+  QByteArray data;
+  bool keyframe;
+};
+
+// The stream as libav's parser packetizes it (the split the muxer's ES path
+// reads back), key flag as TTFFmpegWrapper takes it. Fed in the same odd
+// chunk sizes as the device, zero-padded as av_parser_parse2 requires.
+static QList<Packet> libavPackets(const QByteArray& stream, TTNaluCodecType codec)
+{
+  QList<Packet> packets;
+  const AVCodecID id = codec == NALU_CODEC_H265 ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264;
+  AVCodecContext* ctx = avcodec_alloc_context3(avcodec_find_decoder(id));
+  AVCodecParserContext* parser = ctx ? av_parser_init(id) : nullptr;
+  if (!parser) {
+    if (ctx) avcodec_free_context(&ctx);
+    return packets;
+  }
+
+  auto take = [&](const uint8_t* out, int outSize) {
+    const bool key = parser->key_frame == 1 ||
+                     (parser->key_frame == -1 && parser->pict_type == AV_PICTURE_TYPE_I);
+    packets.append({ QByteArray(reinterpret_cast<const char*>(out), outSize), key });
+  };
+
+  static const int chunks[] = { 1, 2, 3, 7, 188, 4093, 40961, 5 };
+  int pos = 0, n = 0;
+  while (pos < stream.size()) {
+    const int len = qMin(chunks[n++ % 8], stream.size() - pos);
+    QByteArray chunk = stream.mid(pos, len);
+    chunk.append(QByteArray(AV_INPUT_BUFFER_PADDING_SIZE, '\0'));
+    const uint8_t* buf = reinterpret_cast<const uint8_t*>(chunk.constData());
+    int offset = 0;
+    while (offset < len) {
+      uint8_t* out = nullptr;
+      int outSize = 0;
+      const int used = av_parser_parse2(parser, ctx, &out, &outSize, buf + offset, len - offset,
+                                        AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
+      if (outSize > 0) take(out, outSize);
+      if (used <= 0 && outSize == 0) break;
+      offset += used;
+    }
+    pos += len;
+  }
+  for (;;) {
+    uint8_t* out = nullptr;
+    int outSize = 0;
+    av_parser_parse2(parser, ctx, &out, &outSize, nullptr, 0, AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
+    if (outSize <= 0) break;
+    take(out, outSize);
+  }
+  av_parser_close(parser);
+  avcodec_free_context(&ctx);
+  return packets;
+}
+
+// field_pic_flag of the first slice in an H.264 packet
+static bool isFieldPacket(const QByteArray& d, int log2MaxFrameNum)
+{
+  for (int i = 0; i + 4 < d.size(); ++i) {
+    if (d[i] != 0 || d[i + 1] != 0 || d[i + 2] != 1) continue;
+    const int type = d[i + 3] & 0x1F;
+    if (type != 1 && type != 5) continue;
+    QByteArray rbsp;
+    for (int k = i + 4; k < d.size() && rbsp.size() < 32; ++k) {
+      if (k >= i + 6 && d[k] == 3 && d[k - 1] == 0 && d[k - 2] == 0) continue;
+      rbsp.append(d[k]);
+    }
+    const uint8_t* b = reinterpret_cast<const uint8_t*>(rbsp.constData());
+    int bit = 0;
+    TTNaluParser::readExpGolombUE(b, rbsp.size(), bit);   // first_mb_in_slice
+    TTNaluParser::readExpGolombUE(b, rbsp.size(), bit);   // slice_type
+    TTNaluParser::readExpGolombUE(b, rbsp.size(), bit);   // pic_parameter_set_id
+    TTNaluParser::readBits(b, rbsp.size(), bit, log2MaxFrameNum);
+    return TTNaluParser::readBits(b, rbsp.size(), bit, 1) == 1;
+  }
+  return false;
+}
+
+// libav packets as the muxer's ES path turns them into frames: a packet
+// without a slice (parameter sets, EOS) travels with the next frame, and a
+// PAFF field is merged with the one after it
+static QList<Packet> libavFrames(const QList<Packet>& packets, TTNaluCodecType codec,
+                                 bool paff, int log2MaxFrameNum)
+{
+  QList<Packet> frames;
+  QByteArray pending;
+  bool haveField = false;
+  for (const Packet& p : packets) {
+    if (sliceNals(p.data, codec).isEmpty()) {
+      pending.append(p.data);
+      continue;
+    }
+    const QByteArray data = pending + p.data;
+    pending.clear();
+    if (haveField) {
+      frames.last().data.append(data);
+      haveField = false;
+      continue;
+    }
+    frames.append({ data, p.keyframe });
+    haveField = paff && codec == NALU_CODEC_H264 && isFieldPacket(p.data, log2MaxFrameNum);
+  }
+  if (!pending.isEmpty() && !frames.isEmpty())
+    frames.last().data.append(pending);
+  return frames;
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <input.264|.265>\n", argv[0]);
+    return 2;
+  }
+
+  TTNaluParser parser;
+  if (!parser.openFile(QString::fromLocal8Bit(argv[1])) || !parser.parseFile()
+      || parser.accessUnitCount() < 4) {
+    fprintf(stderr, "need an H.264/H.265 ES with a few AUs: %s\n", qPrintable(parser.lastError()));
+    return 2;
+  }
+  const TTNaluCodecType codec = parser.codecType();
+  const TTNaluIndex index = parser.index();
+  const int width = index.spsInfoMap.isEmpty()
+                  ? 0 : index.spsInfoMap.first().log2MaxFrameNumMinus4 + 4;
+  const int auCount = parser.accessUnitCount();
+  printf("%s, %d AUs%s\n", codec == NALU_CODEC_H265 ? "H.265" : "H.264",
+         auCount, parser.isPAFF() ? ", PAFF" : "");
+
+  // The ES as the engine writes it: all AUs, and in the middle the segment
+  // seam the smart cut emits (end of sequence, then fresh parameter sets)
+  const int seam = auCount / 2;
+  QByteArray paramSets;
+  for (int i = parser.accessUnitAt(0).firstNal; i < parser.accessUnitAt(1).firstNal; ++i) {
+    const TTNalUnit nal = parser.nalUnitAt(i);
+    if (nal.isSPS || nal.isPPS || nal.isVPS)
+      paramSets.append(parser.readNalDataWithStartCode(i));
+  }
+  const QByteArray eos = codec == NALU_CODEC_H265 ? QByteArray("\0\0\0\1\x48\x01", 6)
+                                                  : QByteArray("\0\0\0\1\x0b", 5);
+  QList<QByteArray> aus;
+  QByteArray stream;
+  for (int i = 0; i < auCount; ++i) {
+    aus.append(parser.readAccessUnitData(i));
+    if (i == seam) stream.append(eos + paramSets);
+    stream.append(aus.last());
+  }
+
+  // Ranks appear a few frames late, the way the engine records them
+  // segment by segment; rank k = k ^ 1 (pairs swapped)
+  RecordingSink sink;
+  int ranksKnown = 0;
+  TTESPacketSinkDevice dev(&sink, codec, parser.isPAFF(), width,
+                           [&ranksKnown](int k) { return k < ranksKnown ? (k ^ 1) : -1; });
+  dev.open(QIODevice::WriteOnly);
+
+  QElapsedTimer t;
+  t.start();
+  bool ok = true;
+  for (int i = 0; ok && i < stream.size(); i += 65536) {
+    ok = feed(dev, stream.mid(i, 65536));
+    ranksKnown = qMax(0, (sink.frames.size() + int(i / 4096)) - 3);
+  }
+  ranksKnown = auCount;
+  ok = ok && dev.finish();
+  const double ms = t.nsecsElapsed() / 1e6;
+  printf("%d frames from %lld bytes in %.1f ms\n", dev.framesEmitted(),
+         (long long)dev.bytesReceived(), ms);
+  if (!ok) printf("  %s\n", qPrintable(dev.errorString()));
+
+  check(ok, "stream accepted and finished");
+  check(sink.frames.size() == auCount, "one frame per parser AU (field pairs merged)");
+  check(dev.bytesReceived() == stream.size(), "all bytes received");
+
+  QByteArray joined;
+  for (const QByteArray& f : sink.frames) joined.append(f);
+  check(joined == stream, "frames cover the byte stream without gaps");
+
+  bool slicesMatch = sink.frames.size() == auCount;
+  for (int i = 0; slicesMatch && i < auCount; ++i) {
+    slicesMatch = sliceNals(sink.frames[i], codec) == sliceNals(aus[i], codec);
+    if (!slicesMatch) printf("  frame %d: slices differ from AU %d\n", i, i);
+  }
+  check(slicesMatch, "frame k carries the slices of parser AU k");
+
+  bool ranksInOrder = true;
+  for (int k = 0; k < sink.ranks.size(); ++k)
+    ranksInOrder = ranksInOrder && sink.ranks[k] == (k ^ 1);
+  check(ranksInOrder, "late ranks delivered in write order");
+
+  // IDR / IRAP frames always flagged; a flagged non-IDR frame is an
+  // H.265 CRA/BLA or an H.264 recovery point (a frame with SEI)
+  bool keyframesMatch = sink.frames.size() == auCount;
+  int keyframeCount = 0;
+  for (int i = 0; keyframesMatch && i < auCount; ++i) {
+    const TTAccessUnit au = parser.accessUnitAt(i);
+    const bool flagged = sink.keyframes[i];
+    const QByteArray& f = sink.frames[i];
+    bool hasSei = false;
+    for (int b = 0; !hasSei && b + 3 < f.size(); ++b)
+      hasSei = f[b] == 0 && f[b + 1] == 0 && f[b + 2] == 1 && (f[b + 3] & 0x1F) == 6;
+    if (flagged) ++keyframeCount;
+    keyframesMatch = (!au.isIDR || flagged)
+                  && (!flagged || au.isIDR || (codec == NALU_CODEC_H265 ? au.isKeyframe : hasSei));
+    if (!keyframesMatch) printf("  frame %d keyframe %d, AU idr %d key %d\n",
+                                i, int(flagged), int(au.isIDR), int(au.isKeyframe));
+  }
+  printf("%d keyframes\n", keyframeCount);
+  check(keyframesMatch && keyframeCount > 0, "keyframe flags match IDR/IRAP/recovery AUs");
+
+  // The same split libav's parser makes: frame bytes and key flags
+  {
+    const QList<Packet> packets = libavPackets(stream, codec);
+    const QList<Packet> frames = libavFrames(packets, codec, parser.isPAFF(), width);
+    printf("libav parser: %d packets, %d frames\n", int(packets.size()), int(frames.size()));
+    check(frames.size() == sink.frames.size(), "frame count matches av_parser_parse2");
+
+    int firstSize = -1, firstKey = -1;
+    for (int i = 0; i < qMin(frames.size(), sink.frames.size()); ++i) {
+      if (firstSize < 0 && frames[i].data != sink.frames[i])
+        firstSize = i;
+      if (firstKey < 0 && frames[i].keyframe != sink.keyframes[i])
+        firstKey = i;
+    }
+    if (firstSize >= 0)
+      printf("  frame %d: %d bytes, libav %d bytes\n", firstSize,
+             int(sink.frames[firstSize].size()), int(frames[firstSize].data.size()));
+    if (firstKey >= 0)
+      printf("  frame %d: keyframe %d, libav %d\n", firstKey,
+             int(sink.keyframes[firstKey]), int(frames[firstKey].keyframe));
+    check(firstSize < 0, "frame boundaries and sizes match av_parser_parse2");
+    check(firstKey < 0, "keyframe flags match av_parser_parse2");
+  }
+
+  // A frame that never gets a rank must fail finish()
+  {
+    RecordingSink s;
+    TTESPacketSinkDevice d(&s, codec, parser.isPAFF(), width,
+                           [auCount](int k) { return k < auCount - 1 ? k : -1; });
+    d.open(QIODevice::WriteOnly);
+    const bool fed = feed(d, stream);
+    const bool finished = d.finish();
+    check(fed && !finished && d.failed() && s.frames.size() == auCount - 1,
+          "missing rank fails finish()");
+  }
+
+  // A rejecting sink stops the writes
+  {
+    RecordingSink s;
+    s.rejectAt = 2;
+    TTESPacketSinkDevice d(&s, codec, parser.isPAFF(), width, [](int k) { return k; });
+    d.open(QIODevice::WriteOnly);
+    const bool fed = feed(d, stream);
+    check(!fed && d.failed() && !d.finish() && s.frames.size() == 2,
+          "sink rejection fails the write");
+  }
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/*                                                                            */
+/* TTCut-ng - frame-accurate video cutter                                     */
+/* Copyright (c) 2026 MINIXJR                                                 */
+/*                                                                            */
+/* Free software under the GNU GPL v3 or later - see the LICENSE file.        */
+/*----------------------------------------------------------------------------*/
+
+// Boundary re-encodes of TTESSmartCut: cut the same multi-range keep list
+// four times and require byte-identical output plus identical actual output
+// ranges and output display order:
+//   - every boundary rendered inline (1 worker) and with the heads/tails
+//     prerendered on helper engines (4 workers) - setBoundaryWorkerCount;
+//   - each of those with every re-encode collecting its decode window (no
+//     limit) and with every run streaming (limit 0) -
+//     setReencodeMemoryLimit.
+// Prints the wall times and the peak RSS growth of each cut.
+//
+// The keep ranges start 7 frames after a multiple of 50 and end 11 frames
+// before one, so on the I-every-50 test sources every segment has a head
+// re-encode, a stream-copy middle and a tail re-encode; the last range is
+// shorter than a GOP (pure re-encode).
+//
+// Usage: test_parallel_boundary <es> [frameRate]
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <cstdio>
+#include <cstdlib>
+#include "extern/ttessmartcut.h"
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+// VmHWM of this process in KiB (0 = unknown). Monotonic, so only the
+// growth of the first cut that needs more memory than the ones before it
+// shows; the streaming cuts therefore run first.
+static qint64 peakRssKiB()
+{
+  QFile f("/proc/self/status");
+  if (!f.open(QIODevice::ReadOnly)) return 0;
+  for (const QByteArray& line : f.readAll().split('\n')) {
+    if (line.startsWith("VmHWM:"))
+      return line.mid(6).trimmed().split(' ').first().toLongLong();
+  }
+  return 0;
+}
+
+struct CutResult {
+  bool ok = false;
+  QByteArray hash;
+  qint64 bytes = 0;
+  QList<QPair<int, int>> ranges;
+  QVector<int> displayOrder;
+  int reencoded = 0;
+  double ms = 0.0;
+  qint64 peakGrowthKiB = 0;
+};
+
+static CutResult runCut(const QString& es, double fr, const QString& out,
+                        const QList<QPair<int, int>>& keep, qint64 limit, int workers)
+{
+  CutResult r;
+  TTESSmartCut sc;
+  if (!sc.initialize(es, fr)) {
+    fprintf(stderr, "initialize failed: %s\n", qPrintable(sc.lastError()));
+    return r;
+  }
+  sc.setReencodeMemoryLimit(limit);
+  sc.setBoundaryWorkerCount(workers);
+  const qint64 peakBefore = peakRssKiB();
+  QElapsedTimer t;
+  t.start();
+  r.ok = sc.smartCutFrames(out, keep);
+  r.ms = t.nsecsElapsed() / 1e6;
+  r.peakGrowthKiB = peakRssKiB() - peakBefore;
+  if (!r.ok) {
+    fprintf(stderr, "cut (limit %lld, %d workers) failed: %s\n",
+            (long long)limit, workers, qPrintable(sc.lastError()));
+    return r;
+  }
+  r.ranges = sc.actualOutputFrameRanges();
+  r.displayOrder = sc.outputDisplayOrder();
+  r.reencoded = sc.framesReencoded();
+
+  QFile f(out);
+  if (f.open(QIODevice::ReadOnly)) {
+    QCryptographicHash h(QCryptographicHash::Sha1);
+    h.addData(&f);
+    r.hash = h.result();
+    r.bytes = f.size();
+  }
+  return r;
+}
+
+static bool sameCut(const CutResult& a, const CutResult& b)
+{
+  return a.ok && b.ok && !a.hash.isEmpty() && a.hash == b.hash && a.ranges == b.ranges
+      && a.displayOrder == b.displayOrder && a.reencoded == b.reencoded;
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <es> [frameRate]\n", argv[0]);
+    return 2;
+  }
+  const QString es = argv[1];
+  const double fr = (argc > 2) ? atof(argv[2]) : 25.0;
+
+  int frames = 0;
+  {
+    TTESSmartCut probe;
+    if (!probe.initialize(es, fr)) {
+      fprintf(stderr, "initialize failed: %s\n", qPrintable(probe.lastError()));
+      return 2;
+    }
+    frames = probe.frameCount();
+  }
+
+  QList<QPair<int, int>> keep;
+  for (int start = 57; start + 132 < frames - 50; start += 200)
+    keep.append(qMakePair(start, start + 132));
+  if (!keep.isEmpty() && keep.last().second + 40 < frames)
+    keep.append(qMakePair(keep.last().second + 10, keep.last().second + 30));
+  if (keep.size() < 2) {
+    fprintf(stderr, "source too short for a multi-segment cut (%d frames)\n", frames);
+    return 2;
+  }
+  printf("%d frames, %d keep ranges\n", frames, int(keep.size()));
+
+  QTemporaryDir tmp;
+  const CutResult streamInline    = runCut(es, fr, tmp.path() + "/s1.es", keep, 0, 1);
+  const CutResult streamParallel  = runCut(es, fr, tmp.path() + "/s4.es", keep, 0, 4);
+  const CutResult collectInline   = runCut(es, fr, tmp.path() + "/c1.es", keep, -1, 1);
+  const CutResult collectParallel = runCut(es, fr, tmp.path() + "/c4.es", keep, -1, 4);
+  check(streamInline.ok && streamParallel.ok && collectInline.ok && collectParallel.ok,
+        "all cuts succeed");
+  printf("streaming: inline %.1f ms (+%lld KiB peak), parallel %.1f ms (+%lld KiB peak)\n",
+         streamInline.ms, (long long)streamInline.peakGrowthKiB,
+         streamParallel.ms, (long long)streamParallel.peakGrowthKiB);
+  printf("collecting: inline %.1f ms (+%lld KiB peak), parallel %.1f ms (+%lld KiB peak)\n",
+         collectInline.ms, (long long)collectInline.peakGrowthKiB,
+         collectParallel.ms, (long long)collectParallel.peakGrowthKiB);
+  printf("%lld bytes, %d frames re-encoded\n",
+         (long long)collectInline.bytes, collectInline.reencoded);
+
+  check(sameCut(collectInline, collectParallel), "collecting: parallel output identical");
+  check(sameCut(streamInline, streamParallel), "streaming: parallel output identical");
+  check(sameCut(collectInline, streamInline), "inline: streaming output identical");
+  check(sameCut(collectParallel, streamParallel), "parallel: streaming output identical");
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
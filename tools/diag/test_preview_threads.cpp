@@ -0,0 +1,109 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: frame-threaded preview decoding. Decodes the same display      */
+/* positions - random seeks and a sequential run - with a single-threaded     */
+/* wrapper and one with setDecodeThreads(0), both with the frame cache off,   */
+/* and checks images and deliveredDecodeIndex are equal. Prints the seek      */
+/* latency (mean / median / max) of both, e.g. for a UHD HEVC recording.      */
+/*                                                                            */
+/* usage: test_preview_threads <input> [seeks]                                */
+/*----------------------------------------------------------------------------*/
+
+#include "../../extern/ttffmpegwrapper.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+static bool openWrapper(TTFFmpegWrapper& w, const char* path, int threads)
+{
+  w.setDecodeThreads(threads);
+  if (!w.openFile(QString::fromLocal8Bit(path)) || !w.buildFrameIndex(w.findBestVideoStream()))
+    return false;
+  w.setFrameCacheBudget(0);
+  return true;
+}
+
+static void report(const char* name, QList<double> ms)
+{
+  if (ms.isEmpty()) return;
+  std::sort(ms.begin(), ms.end());
+  double sum = 0;
+  for (double v : ms) sum += v;
+  printf("  %-10s mean %7.1f ms, median %7.1f ms, max %7.1f ms\n",
+         name, sum / ms.size(), ms[ms.size() / 2], ms.last());
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <input> [seeks]\n", argv[0]);
+    return 2;
+  }
+  TTFFmpegWrapper::initializeFFmpeg();
+
+  TTFFmpegWrapper single, threaded;
+  if (!openWrapper(single, argv[1], 1) || !openWrapper(threaded, argv[1], 0)) {
+    fprintf(stderr, "cannot open/index %s\n", argv[1]);
+    return 2;
+  }
+
+  const int count = single.displayOrderMap().isValid()
+                  ? single.displayOrderMap().displayCount() : single.frameCount();
+  const int seeks = argc > 2 ? qMax(1, atoi(argv[2])) : 24;
+  if (count < 8) {
+    fprintf(stderr, "need a video with a few frames (%d)\n", count);
+    return 2;
+  }
+  printf("%d frames, %d GOPs, %d random seeks\n", count, single.gopCount(), seeks);
+
+  // Random seeks, then a sequential run across a GOP boundary
+  QList<int> positions;
+  srand(1);
+  for (int i = 0; i < seeks; ++i) positions.append(rand() % count);
+  const int gopLen = qMax(1, count / qMax(1, single.gopCount()));
+  const int start = qMax(0, count / 2 - gopLen / 2);
+  for (int d = start; d < qMin(count, start + 2 * gopLen); ++d) positions.append(d);
+
+  QList<double> singleMs, threadedMs;
+  bool imagesMatch = true, deliveredMatch = true;
+  QElapsedTimer t;
+  for (int d : positions) {
+    t.start();
+    const QImage a = single.decodeFrame(d);
+    singleMs.append(t.nsecsElapsed() / 1e6);
+    t.start();
+    const QImage b = threaded.decodeFrame(d);
+    threadedMs.append(t.nsecsElapsed() / 1e6);
+    if (a.isNull() || a != b) {
+      if (imagesMatch) printf("  display %d: threaded image differs\n", d);
+      imagesMatch = false;
+    }
+    if (single.frameAt(d).deliveredDecodeIndex != threaded.frameAt(d).deliveredDecodeIndex) {
+      if (deliveredMatch) printf("  display %d: deliveredDecodeIndex %d vs %d\n", d,
+                                 single.frameAt(d).deliveredDecodeIndex,
+                                 threaded.frameAt(d).deliveredDecodeIndex);
+      deliveredMatch = false;
+    }
+  }
+
+  printf("seek + decode latency over %d positions:\n", int(positions.size()));
+  report("1 thread", singleMs);
+  report("threaded", threadedMs);
+  check(imagesMatch, "threaded images equal single-threaded");
+  check(deliveredMatch, "deliveredDecodeIndex equal");
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
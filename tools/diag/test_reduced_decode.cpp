@@ -0,0 +1,292 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: reduced decode profile (setReducedDecode). Decodes every Nth   */
+/* I-frame of the video index list (type 1, as the QuickJump dialog and the  */
+/* aspect scan pick them) as a thumbnail both ways - decodeFrame() + smooth   */
+/* QImage scaling on a normal wrapper, decodeKeyframeReduced() on a reduced   */
+/* one - and checks the thumbnails agree (mean absolute difference per        */
+/* channel), i.e. a non-IDR I-frame is not answered with the IDR before it,   */
+/* and that the grayscale output is full-range luma. Prints the time per      */
+/* thumbnail of both.                                                         */
+/* An MPEG-2 ES (.m2v/.mpv) runs the same comparison on TTMpeg2Decoder        */
+/* (RGB32 frame vs setKeyframesOnly + reducedImage) and checks the reduced    */
+/* size and that a keyframes-only decoder hands out I-frames only.            */
+/*                                                                            */
+/* usage: test_reduced_decode <input> [keyframes]                             */
+/*----------------------------------------------------------------------------*/
+
+#include "../../extern/ttffmpegwrapper.h"
+#include "../../avstream/ttmpeg2videostream.h"
+#include "../../avstream/ttvideoheaderlist.h"
+#include "../../avstream/ttvideoindexlist.h"
+#include "../../mpeg2decoder/ttmpeg2decoder.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImage>
+#include <cstdio>
+#include <cstdlib>
+
+extern "C" {
+#include <libavutil/avutil.h>
+}
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+static bool openWrapper(TTFFmpegWrapper& w, const char* path, bool reduced)
+{
+  w.setReducedDecode(reduced);
+  if (!w.openFile(QString::fromLocal8Bit(path)) || !w.buildFrameIndex(w.findBestVideoStream()))
+    return false;
+  w.setFrameCacheBudget(0);
+  return true;
+}
+
+// Mean absolute difference over the R, G and B channels
+static double meanDiff(const QImage& a, const QImage& b)
+{
+  if (a.size() != b.size()) return 255.0;
+  const QImage x = a.convertToFormat(QImage::Format_RGB32);
+  const QImage y = b.convertToFormat(QImage::Format_RGB32);
+  qint64 sum = 0;
+  for (int row = 0; row < x.height(); ++row) {
+    const QRgb* p = reinterpret_cast<const QRgb*>(x.constScanLine(row));
+    const QRgb* q = reinterpret_cast<const QRgb*>(y.constScanLine(row));
+    for (int col = 0; col < x.width(); ++col)
+      sum += qAbs(qRed(p[col]) - qRed(q[col])) + qAbs(qGreen(p[col]) - qGreen(q[col]))
+           + qAbs(qBlue(p[col]) - qBlue(q[col]));
+  }
+  return double(sum) / (3.0 * x.width() * x.height());
+}
+
+// MPEG-2: TTMpeg2Decoder's reduced profile against its RGB32 frames
+static int runMpeg2(const char* path, int wanted, const QSize& thumbSize)
+{
+  TTMpeg2VideoStream vs{QFileInfo(QString::fromLocal8Bit(path))};
+  vs.createHeaderList();
+  vs.createIndexList();
+  TTVideoHeaderList* headerList = vs.headerList();
+  TTVideoIndexList*  indexList  = vs.indexList();
+  if (!headerList || !indexList) {
+    fprintf(stderr, "cannot index %s\n", path);
+    return 2;
+  }
+  indexList->sortDisplayOrder();
+
+  QList<int> keyframes;
+  int nonIntra = -1;
+  for (int pos = 0; pos < indexList->count(); ++pos) {
+    if (indexList->pictureCodingType(pos) == MPEG2_PIC_I)
+      keyframes.append(pos);
+    else if (nonIntra < 0 && !keyframes.isEmpty())
+      nonIntra = pos;
+  }
+  if (keyframes.size() < 2 || nonIntra < 0 || wanted <= 0) {
+    fprintf(stderr, "need a video with keyframes\n");
+    return 2;
+  }
+  const int step = qMax(1, int(keyframes.size()) / wanted);
+
+  TTMpeg2Decoder full(vs.filePath(), indexList, headerList, formatRGB32);
+  TTMpeg2Decoder reduced(vs.filePath(), indexList, headerList, formatYV12);
+  reduced.setKeyframesOnly(true);
+
+  QElapsedTimer t;
+  qint64 fullNs = 0, reducedNs = 0;
+  int    count = 0, posMismatch = 0, sizeMismatch = 0;
+  double worst = 0.0;
+  for (int i = 0; i < keyframes.size(); i += step) {
+    const int pos = keyframes[i];
+
+    t.start();
+    full.moveToFrameIndex(pos);
+    const TFrameInfo* frame = full.getFrameInfo();
+    const QImage expected = (frame && frame->Y)
+        ? QImage(frame->Y, frame->width, frame->height, QImage::Format_RGB32)
+              .scaled(thumbSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+        : QImage();
+    fullNs += t.nsecsElapsed();
+
+    t.start();
+    const int shown = reduced.moveToFrameIndex(pos);
+    const QImage thumb = reduced.reducedImage(thumbSize, false);
+    reducedNs += t.nsecsElapsed();
+
+    if (shown != pos) ++posMismatch;
+    if (thumb.size() != thumbSize) ++sizeMismatch;
+    if (expected.isNull() || thumb.isNull()) {
+      printf("keyframe %d: decode failed (full %d, reduced %d)\n",
+             pos, !expected.isNull(), !thumb.isNull());
+      worst = 255.0;
+    } else {
+      worst = qMax(worst, meanDiff(expected, thumb));
+    }
+    ++count;
+  }
+
+  printf("MPEG-2, %d thumbnails: full decode + scale %.1f ms each, reduced %.1f ms each, "
+         "worst mean difference %.2f\n",
+         count, fullNs / 1e6 / count, reducedNs / 1e6 / count, worst);
+  check(posMismatch == 0, "MPEG-2 reduced decode stays on the requested keyframe");
+  check(sizeMismatch == 0, "MPEG-2 reduced frame has the requested size");
+  // 2x2 point sampling instead of an area filter: more aliasing than the
+  // H.26x swscale path, still the same picture
+  check(worst < 12.0, "MPEG-2 reduced thumbnails match the full decode");
+
+  {
+    const QImage gray = reduced.reducedImage(thumbSize, true);
+    check(gray.format() == QImage::Format_Grayscale8 && gray.size() == thumbSize,
+          "MPEG-2 grayscale output is Grayscale8 at the requested size");
+  }
+
+  // Keyframes only: a P/B position lands on the I-frame before it, and the
+  // frames decoded behind it are I-frames as well
+  {
+    const int intra = reduced.moveToFrameIndex(nonIntra);
+    check(intra < nonIntra && indexList->pictureCodingType(intra) == MPEG2_PIC_I
+          && reduced.currentFrameType() == MPEG2_PIC_I,
+          "MPEG-2 keyframes-only seek to a P/B position returns the I-frame before it");
+
+    int frames = 0, nonI = 0;
+    while (frames < 3 * (keyframes[1] - keyframes[0]) && reduced.decodeNextDisplayFrame()) {
+      if (reduced.currentFrameType() != MPEG2_PIC_I) ++nonI;
+      ++frames;
+    }
+    printf("MPEG-2 keyframes-only: %d frames decoded behind the seek, %d not I\n", frames, nonI);
+    check(frames > 0 && nonI == 0, "MPEG-2 keyframes-only decoder returns I-frames only");
+  }
+  return 0;
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <input> [keyframes]\n", argv[0]);
+    return 2;
+  }
+
+  const QString suffix = QFileInfo(QString::fromLocal8Bit(argv[1])).suffix().toLower();
+  if (suffix == "m2v" || suffix == "mpv") {
+    const int rc = runMpeg2(argv[1], argc > 2 ? atoi(argv[2]) : 24, QSize(192, 108));
+    if (rc != 0) return rc;
+    printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+    return failures == 0 ? 0 : 1;
+  }
+
+  TTFFmpegWrapper::initializeFFmpeg();
+
+  TTFFmpegWrapper full, reduced;
+  if (!openWrapper(full, argv[1], false) || !openWrapper(reduced, argv[1], true)) {
+    fprintf(stderr, "cannot open/index %s\n", argv[1]);
+    return 2;
+  }
+
+  // I-frame display positions from a video index list built like
+  // TTH26xVideoStream::createIndexList(), walked like TTQuickJumpModel
+  const QList<TTFrameInfo>& index = full.frameIndex();
+  const TTDisplayOrderMap&  map   = full.displayOrderMap();
+  TTVideoIndexList indexList;
+  for (int au = 0; au < index.size(); ++au) {
+    const int disp = map.isValid() ? map.decodeToDisplay(au) : au;
+    if (disp < 0) continue;
+    const int type = index[au].frameType == AV_PICTURE_TYPE_I ? 1
+                   : index[au].frameType == AV_PICTURE_TYPE_P ? 2 : 3;
+    indexList.add(disp, au, type);
+  }
+  indexList.sortDisplayOrder();
+
+  QList<int> keyframes;
+  QList<bool> nonKey;     // an I-frame libav does not flag as key
+  int nonKeyIntra = 0;
+  for (int pos = indexList.moveToNextIndexPos(-1, 1); pos >= 0;
+       pos = indexList.moveToNextIndexPos(pos, 1)) {
+    const int au = map.isValid() ? map.displayToDecode(pos) : pos;
+    keyframes.append(pos);
+    nonKey.append(au >= 0 && au < index.size() && !index[au].isKeyframe);
+    if (nonKey.last()) ++nonKeyIntra;
+  }
+  const int wanted = argc > 2 ? atoi(argv[2]) : 24;
+  if (keyframes.size() < 2 || wanted <= 0) {
+    fprintf(stderr, "need a video with keyframes\n");
+    return 2;
+  }
+  const int step = qMax(1, int(keyframes.size()) / wanted);
+  const QSize thumbSize(192, 108);
+
+  QElapsedTimer t;
+  qint64 fullNs = 0, reducedNs = 0;
+  int    count = 0, shownMismatch = 0, nonKeyChecked = 0;
+  double worst = 0.0, worstNonKey = 0.0;
+  for (int i = 0; i < keyframes.size(); ++i) {
+    // Every Nth, plus the first N non-key I-frames wherever they are: those
+    // are the ones a walk back to the keyframe would answer wrongly
+    if (i % step != 0 && !(nonKey[i] && nonKeyChecked < wanted)) continue;
+    const int pos = keyframes[i];
+
+    t.start();
+    const QImage image = full.decodeFrame(pos);
+    const QImage expected = image.isNull() ? QImage()
+        : image.scaled(thumbSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    fullNs += t.nsecsElapsed();
+
+    int shown = -1;
+    t.start();
+    const QImage thumb = reduced.decodeKeyframeReduced(pos, thumbSize, false, &shown);
+    reducedNs += t.nsecsElapsed();
+
+    if (shown != pos) ++shownMismatch;
+    if (expected.isNull() || thumb.isNull()) {
+      printf("keyframe %d: decode failed (full %d, reduced %d)\n",
+             pos, !expected.isNull(), !thumb.isNull());
+      worst = 255.0;
+    } else {
+      const double diff = meanDiff(expected, thumb);
+      worst = qMax(worst, diff);
+      if (nonKey[i]) {
+        worstNonKey = qMax(worstNonKey, diff);
+        ++nonKeyChecked;
+      }
+    }
+    ++count;
+  }
+
+  printf("%d thumbnails (%d of %d I-frames not libav keyframes, %d of them compared): "
+         "full decode + scale %.1f ms each, reduced %.1f ms each, "
+         "worst mean difference %.2f (non-key I %.2f)\n",
+         count, nonKeyIntra, int(keyframes.size()), nonKeyChecked,
+         fullNs / 1e6 / count, reducedNs / 1e6 / count, worst, worstNonKey);
+  check(shownMismatch == 0, "reduced decode delivers the requested I-frame");
+  // Deblocking off and a different scaler: a few levels, not a different picture
+  check(worst < 8.0, "reduced thumbnails match the full decode of the same frame");
+
+  // Grayscale: full-range luma of the same frame, compared against Qt's
+  // grayscale of the RGB thumbnail
+  {
+    const int pos = keyframes[keyframes.size() / 2];
+    const QImage rgb  = reduced.decodeKeyframeReduced(pos, thumbSize, false);
+    const QImage gray = reduced.decodeKeyframeReduced(pos, thumbSize, true);
+    check(gray.format() == QImage::Format_Grayscale8 && gray.size() == thumbSize,
+          "grayscale output is Grayscale8 at the requested size");
+    check(!rgb.isNull() && meanDiff(rgb.convertToFormat(QImage::Format_Grayscale8), gray) < 6.0,
+          "grayscale output is full-range luma");
+  }
+
+  // A zero height keeps the frame's proportions
+  {
+    const QImage scaled = reduced.decodeKeyframeReduced(keyframes.first(), QSize(320, 0), true);
+    const QImage native = reduced.decodeKeyframeReduced(keyframes.first(), QSize(), true);
+    check(!native.isNull() && scaled.width() == 320
+          && qAbs(scaled.height() - qRound(320.0 * native.height() / native.width())) <= 1,
+          "zero height keeps the proportions");
+  }
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*----------------------------------------------------------------------------*/
+/* SPDX-License-Identifier: GPL-3.0-or-later                                  */
+/* Diagnostic: the QuickJump thumbnail atlas (TTThumbnailAtlas). Uses a       */
+/* generated stand-in stream in a temp dir: stores thumbnails, reopens the    */
+/* atlas and compares the pixels, checks that a partial last slot (crash      */
+/* while appending) is dropped, that another thumbnail size is a separate     */
+/* atlas and that touching the stream invalidates it. Needs no input file.    */
+/*                                                                            */
+/* usage: test_thumbnail_atlas                                                */
+/*----------------------------------------------------------------------------*/
+
+#include "../../gui/ttthumbnailatlas.h"
+#include "../../common/ttsettings.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QTemporaryDir>
+#include <cstdio>
+
+static int failures = 0;
+static void check(bool cond, const char* what)
+{
+  printf(cond ? "PASS: %s\n" : "FAIL: %s\n", what);
+  if (!cond) ++failures;
+}
+
+static QImage pattern(const QSize& size, int seed)
+{
+  QImage image(size, QImage::Format_RGB32);
+  for (int y = 0; y < size.height(); ++y)
+    for (int x = 0; x < size.width(); ++x)
+      image.setPixel(x, y, qRgb((x * 7 + seed) & 0xff, (y * 5 + seed) & 0xff, (x ^ y ^ seed) & 0xff));
+  return image;
+}
+
+int main(int argc, char** argv)
+{
+  QCoreApplication app(argc, argv);
+  TTSettings::instance()->setCreateStreamIndex(true);
+
+  QTemporaryDir dir;
+  const QString stream = dir.filePath("stream.m2v");
+  {
+    QFile f(stream);
+    if (!f.open(QIODevice::WriteOnly)) { fprintf(stderr, "cannot create %s\n", qPrintable(stream)); return 2; }
+    QByteArray data(256 * 1024, '\0');
+    for (int i = 0; i < data.size(); ++i) data[i] = char(i * 31);
+    f.write(data);
+  }
+
+  const QSize size(147, 83);
+  const QList<int> frames = { 0, 12, 250, 4711 };
+
+  {
+    TTThumbnailAtlas atlas(stream, size);
+    check(!atlas.open(), "no atlas before the first store");
+    for (int i = 0; i < frames.size(); ++i)
+      check(atlas.store(frames[i], pattern(size, i)), "store");
+    check(atlas.thumbnail(12) == pattern(size, 1), "read back in the writing session");
+  }
+
+  {
+    TTThumbnailAtlas atlas(stream, size);
+    check(atlas.open() && atlas.count() == frames.size(), "reopened with all thumbnails");
+    bool same = true;
+    for (int i = 0; i < frames.size(); ++i)
+      same = same && atlas.thumbnail(frames[i]) == pattern(size, i);
+    check(same, "pixels survive the reopen");
+    check(atlas.thumbnail(13).isNull(), "missing frame is null");
+    // A thumbnail of another size is scaled on store
+    check(atlas.store(99, pattern(QSize(320, 180), 9)) && atlas.thumbnail(99).size() == size,
+          "foreign size scaled to the atlas size");
+  }
+
+  // Crash while appending: a partial slot at the end
+  {
+    QFile f(TTThumbnailAtlas::atlasPath(stream, size));
+    f.open(QIODevice::Append);
+    f.write(QByteArray(1000, 'x'));
+    f.close();
+    TTThumbnailAtlas atlas(stream, size);
+    check(atlas.open() && atlas.count() == frames.size() + 1, "partial slot ignored");
+    check(atlas.store(7, pattern(size, 7)), "append after the cut-off slot");
+    TTThumbnailAtlas again(stream, size);
+    check(again.open() && again.thumbnail(7) == pattern(size, 7)
+          && again.thumbnail(4711) == pattern(size, 3), "slots aligned after repair");
+  }
+
+  // Another size is another atlas
+  {
+    TTThumbnailAtlas other(stream, QSize(110, 83));
+    check(!other.open(), "other thumbnail size: separate atlas");
+  }
+
+  // Touching the stream invalidates the atlas
+  {
+    QFile f(stream);
+    f.open(QIODevice::ReadWrite);
+    f.setFileTime(QDateTime::currentDateTime().addSecs(60), QFileDevice::FileModificationTime);
+    f.close();
+    TTThumbnailAtlas atlas(stream, size);
+    check(!atlas.open(), "modified stream: atlas stale");
+    check(atlas.store(1, pattern(size, 1)) && atlas.count() == 1, "stale atlas started anew");
+  }
+
+  printf("%s\n", failures == 0 ? "ALL PASS" : "FAILURES");
+  return failures == 0 ? 0 : 1;
+}